@@ -65,7 +65,7 @@ setup(
     long_description='',
     ext_modules=[CMakeExtension('gridpack')],
     cmdclass=dict(build_ext=CMakeBuild),
-    install_requires=["mpi4py"],
+    install_requires=["mpi4py", "numpy"],
     zip_safe=False,
     scripts=[
         'src/hello.py',
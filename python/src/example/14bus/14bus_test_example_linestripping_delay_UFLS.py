@@ -566,7 +566,7 @@ while (not hadapp.isDynSimuDone()):
             lineflowonesteplist.append(Q_from)
         
         # add time in the head of the observation data list
-        ob_vals.insert(0,isteps*simu_time_step)	
+        ob_vals = [isteps*simu_time_step] + ob_vals.tolist()
         observation_list.append(ob_vals)
         
         # add time in the head of the line flow data list
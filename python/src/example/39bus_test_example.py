@@ -176,7 +176,7 @@ while (not hadapp.isDynSimuDone()):
         after_getob_time = time.time()	
         total_dataconv_time += (after_getob_time - before_getob_time)
         print('Before insert')
-        ob_vals.insert(0,isteps*simu_time_step)	
+        ob_vals = [isteps*simu_time_step] + ob_vals.tolist()
         observation_list.append(ob_vals)
         print('After insert')
 	
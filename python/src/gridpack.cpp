@@ -17,6 +17,7 @@
 namespace py = pybind11;
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
+#include <pybind11/numpy.h>
 
 #include <gridpack/environment/environment.hpp>
 #include <gridpack/configuration/no_print.hpp>
@@ -78,6 +79,36 @@ PYBIND11_DECLARE_HOLDER_TYPE(T, boost::shared_ptr<T>, false);
 // Some pybind11 magic for a vector of Event
 PYBIND11_MAKE_OPAQUE( std::vector< gpds::Event > )
 
+// -------------------------------------------------------------
+// NumPy conversions
+//
+// Results are handed to NumPy by moving the std::vector into a capsule
+// that owns it, so the array is a view of the C++ data and no Python
+// object is created per element. Array arguments accept anything NumPy
+// can convert (lists included) and are copied into a vector in one
+// block.
+// -------------------------------------------------------------
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> DoubleArray;
+typedef py::array_t<int, py::array::c_style | py::array::forcecast> IntArray;
+
+template <typename T>
+py::array_t<T>
+vector_to_array(std::vector<T>&& v)
+{
+  std::vector<T> *owned = new std::vector<T>(std::move(v));
+  py::capsule owner(owned, [](void *p) {
+      delete reinterpret_cast<std::vector<T> *>(p);
+    });
+  return py::array_t<T>(owned->size(), owned->data(), owner);
+}
+
+template <typename T>
+std::vector<T>
+array_to_vector(const py::array_t<T, py::array::c_style | py::array::forcecast>& a)
+{
+  return std::vector<T>(a.data(), a.data() + a.size());
+}
+
 // -------------------------------------------------------------
 // gridpack::utility::Configuration wrapping
 //
@@ -116,6 +147,15 @@ public:
   {
     p_tskmgr->set(ntask);
   }
+  void setLeased(int ntask, gpp::Communicator &comm, int minLease)
+  {
+    p_tskmgr->setLeased(ntask, comm, minLease);
+  }
+  void setLeasedCost(const std::vector<double> &cost, gpp::Communicator &comm,
+                     int minLease)
+  {
+    p_tskmgr->setLeased(cost, comm, minLease);
+  }
   bool nextTask(TaskCounter &next)
   {
     return p_tskmgr->nextTask(&next.task_id);
@@ -300,6 +340,10 @@ PYBIND11_MODULE(gridpack, gpm) {
   py::class_<TaskManagerWrapper> (gpm, "TaskManager")
     .def(py::init<gpp::Communicator&>())
     .def("set", &TaskManagerWrapper::set)
+    .def("setLeased", &TaskManagerWrapper::setLeased,
+         py::arg("ntask"), py::arg("comm"), py::arg("minLease") = 1)
+    .def("setLeased", &TaskManagerWrapper::setLeasedCost,
+         py::arg("cost"), py::arg("comm"), py::arg("minLease") = 1)
     .def("nextTask",
          (bool (TaskManagerWrapper::*)(TaskCounter&))
          &TaskManagerWrapper::nextTask)
@@ -348,28 +392,76 @@ PYBIND11_MODULE(gridpack, gpm) {
     .def("solvePowerFlowBeforeDynSimu",
          [](gpds::DSFullApp& self, const std::string& inputfile, const int& pf_idx) {
            self.solvePowerFlowBeforeDynSimu(inputfile.c_str(), pf_idx);
-         })
+         },
+         py::call_guard<py::gil_scoped_release>())
     .def("readGenerators", &gpds::DSFullApp::readGenerators,
          py::arg("ds_idx") = -1)
     .def("readSequenceData", &gpds::DSFullApp::readSequenceData)
-    .def("initialize", &gpds::DSFullApp::initialize)
+    .def("initialize", &gpds::DSFullApp::initialize,
+         py::call_guard<py::gil_scoped_release>())
     .def("reload", &gpds::DSFullApp::reload)
     .def("reset", &gpds::DSFullApp::reset)
-    .def("solve", &gpds::DSFullApp::solve)
-    .def("solvePreInitialize", &gpds::DSFullApp::solvePreInitialize)
-    .def("setup", &gpds::DSFullApp::setup)
-    .def("executeOneSimuStep", &gpds::DSFullApp::executeOneSimuStep)
+    .def("solve", &gpds::DSFullApp::solve,
+         py::call_guard<py::gil_scoped_release>())
+    .def("solvePreInitialize", &gpds::DSFullApp::solvePreInitialize,
+         py::call_guard<py::gil_scoped_release>())
+    .def("setup", &gpds::DSFullApp::setup,
+         py::call_guard<py::gil_scoped_release>())
+    .def("executeOneSimuStep", &gpds::DSFullApp::executeOneSimuStep,
+         py::call_guard<py::gil_scoped_release>())
     // .def("run", [](gpds::DSFullApp& self) {self.run();})
-    .def("run", py::overload_cast<>(&gpds::DSFullApp::run))
-    .def("run", py::overload_cast<double>(&gpds::DSFullApp::run))
-    .def("scatterInjectionLoad", &gpds::DSFullApp::scatterInjectionLoad)
-    .def("scatterInjectionLoadNew", &gpds::DSFullApp::scatterInjectionLoadNew)
+    .def("run", py::overload_cast<>(&gpds::DSFullApp::run),
+         py::call_guard<py::gil_scoped_release>())
+    .def("run", py::overload_cast<double>(&gpds::DSFullApp::run),
+         py::call_guard<py::gil_scoped_release>())
+    .def("scatterInjectionLoad",
+         [](gpds::DSFullApp& self, const IntArray& vbusNum,
+            const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoad(bus, p, q);
+         })
+    .def("scatterInjectionLoadNew",
+         [](gpds::DSFullApp& self, const IntArray& vbusNum,
+            const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew(bus, p, q);
+         })
     .def("scatterInjectionLoadNew_compensateY",
-         &gpds::DSFullApp::scatterInjectionLoadNew_compensateY)
+         [](gpds::DSFullApp& self, const IntArray& vbusNum,
+            const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew_compensateY(bus, p, q);
+         })
     .def("scatterInjectionLoadNew_Norton",
-         &gpds::DSFullApp::scatterInjectionLoadNew_Norton)
+         [](gpds::DSFullApp& self, const IntArray& vbusNum,
+            const DoubleArray& vloadP, const DoubleArray& vloadQ,
+            const DoubleArray& vimpedanceR, const DoubleArray& vimpedanceI) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           std::vector<double> zr(array_to_vector(vimpedanceR));
+           std::vector<double> zi(array_to_vector(vimpedanceI));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew_Norton(bus, p, q, zr, zi);
+         })
     .def("scatterInjectionLoadNewConstCur",
-         &gpds::DSFullApp::scatterInjectionLoadNewConstCur)
+         [](gpds::DSFullApp& self, const IntArray& vbusNum,
+            const DoubleArray& vCurR, const DoubleArray& vCurI) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> cr(array_to_vector(vCurR));
+           std::vector<double> ci(array_to_vector(vCurI));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNewConstCur(bus, cr, ci);
+         })
     .def("applyLoadShedding", &gpds::DSFullApp::applyLoadShedding)
     .def("applyConstYLoadShedding", &gpds::DSFullApp::applyConstYLoadShedding)
     .def("setWideAreaControlSignal", &gpds::DSFullApp::setWideAreaControlSignal)
@@ -456,11 +548,18 @@ PYBIND11_MODULE(gridpack, gpm) {
 
   dsapp
     .def("getTimeSeriesMap",
-         &gpds::DSFullApp::getTimeSeriesMap,
-         py::return_value_policy::copy)
+         [](gpds::DSFullApp& self) {
+           return vector_to_array(self.getTimeSeriesMap());
+         })
     .def("getGeneratorTimeSeries",
-         &gpds::DSFullApp::getGeneratorTimeSeries,
-         py::return_value_policy::copy)
+         [](gpds::DSFullApp& self) {
+           std::vector<std::vector<double> > series(self.getGeneratorTimeSeries());
+           py::list result;
+           for (size_t i = 0; i < series.size(); ++i) {
+             result.append(vector_to_array(std::move(series[i])));
+           }
+           return result;
+         })
     .def("getListWatchedGenerators",
          [](gpds::DSFullApp& self) -> py::object {
            std::vector<int> bus_ids;
@@ -489,8 +588,10 @@ PYBIND11_MODULE(gridpack, gpm) {
                                      load_zone, gen_scale, load_scale,
                                      file.c_str());
          })
-    .def("getFrequencyFailures", &gpds::DSFullApp::getFrequencyFailures,
-         py::return_value_policy::copy)
+    .def("getFrequencyFailures",
+         [](gpds::DSFullApp& self) {
+           return vector_to_array(self.getFrequencyFailures());
+         })
     .def("setFrequencyMonitoring", &gpds::DSFullApp::setFrequencyMonitoring)
     ;
 
@@ -525,17 +626,45 @@ PYBIND11_MODULE(gridpack, gpm) {
     .def("getObservations",
          [](gpds::DSFullApp& self) -> py::object {
            std::vector<double> vMag, vAng, rSpd, rAng, genP, genQ, fOnline;
-           self.getObservations(vMag, vAng, rSpd, rAng, genP, genQ, fOnline);
-           return py::make_tuple(vMag, vAng, rSpd, rAng, genP, genQ, fOnline);
+           {
+             py::gil_scoped_release release;
+             self.getObservations(vMag, vAng, rSpd, rAng, genP, genQ, fOnline);
+           }
+           return py::make_tuple(vector_to_array(std::move(vMag)),
+                                 vector_to_array(std::move(vAng)),
+                                 vector_to_array(std::move(rSpd)),
+                                 vector_to_array(std::move(rAng)),
+                                 vector_to_array(std::move(genP)),
+                                 vector_to_array(std::move(genQ)),
+                                 vector_to_array(std::move(fOnline)));
          })
     .def("getObservations_withBusFreq", 
          [](gpds::DSFullApp& self) -> py::object {
            std::vector<double> vMag, vAng, rSpd, rAng, genP, genQ, fOnline, busfreq;
-           self.getObservations_withBusFreq(vMag, vAng, rSpd, rAng,
-                                            genP, genQ, fOnline, busfreq);
-           return py::make_tuple(vMag, vAng, rSpd, rAng,
-                                 genP, genQ, fOnline, busfreq);
+           {
+             py::gil_scoped_release release;
+             self.getObservations_withBusFreq(vMag, vAng, rSpd, rAng,
+                                              genP, genQ, fOnline, busfreq);
+           }
+           return py::make_tuple(vector_to_array(std::move(vMag)),
+                                 vector_to_array(std::move(vAng)),
+                                 vector_to_array(std::move(rSpd)),
+                                 vector_to_array(std::move(rAng)),
+                                 vector_to_array(std::move(genP)),
+                                 vector_to_array(std::move(genQ)),
+                                 vector_to_array(std::move(fOnline)),
+                                 vector_to_array(std::move(busfreq)));
          })
+    .def("getObservationValues",
+         [](gpds::DSFullApp& self, bool rootOnly) {
+           std::vector<double> values;
+           {
+             py::gil_scoped_release release;
+             self.getObservationValues(values, rootOnly);
+           }
+           return vector_to_array(std::move(values));
+         },
+         py::arg("rootOnly") = false)
     ;         
 
   dsapp
@@ -766,13 +895,52 @@ PYBIND11_MODULE(gridpack, gpm) {
   py::class_<gph::HADRECAppModule> hadapp(hadm, "Module");
   hadapp
     .def(py::init<>())
-    .def("transferPFtoDS", &gph::HADRECAppModule::transferPFtoDS)
-    .def("executeDynSimuOneStep", &gph::HADRECAppModule::executeDynSimuOneStep)
+    .def("transferPFtoDS", &gph::HADRECAppModule::transferPFtoDS,
+         py::call_guard<py::gil_scoped_release>())
+    .def("executeDynSimuOneStep", &gph::HADRECAppModule::executeDynSimuOneStep,
+         py::call_guard<py::gil_scoped_release>())
     .def("updateData", &gph::HADRECAppModule::updateData)
     .def("isDynSimuDone",  &gph::HADRECAppModule::isDynSimuDone)
-    .def("applyAction", &gph::HADRECAppModule::applyAction)
-    .def("getObservations", &gph::HADRECAppModule::getObservations,
-         py::return_value_policy::copy)
+    .def("applyAction", &gph::HADRECAppModule::applyAction,
+         py::call_guard<py::gil_scoped_release>())
+    .def("applyActions",
+         [](gph::HADRECAppModule& self,
+            const std::vector<gph::HADRECAction>& actions) {
+           py::gil_scoped_release release;
+           self.applyActions(actions);
+         })
+    .def("applyActions",
+         [](gph::HADRECAppModule& self, const IntArray& actiontype,
+            const IntArray& bus_number, const DoubleArray& percentage,
+            const std::vector<std::string>& componentID) {
+           if (actiontype.size() != bus_number.size() ||
+               actiontype.size() != percentage.size() ||
+               (!componentID.empty() &&
+                componentID.size() != static_cast<size_t>(actiontype.size()))) {
+             throw py::value_error("applyActions: argument lengths differ");
+           }
+           std::vector<gph::HADRECAction> actions(actiontype.size());
+           for (size_t i = 0; i < actions.size(); ++i) {
+             actions[i].actiontype = actiontype.data()[i];
+             actions[i].bus_number = bus_number.data()[i];
+             actions[i].percentage = percentage.data()[i];
+             if (!componentID.empty()) actions[i].componentID = componentID[i];
+           }
+           py::gil_scoped_release release;
+           self.applyActions(actions);
+         },
+         py::arg("actiontype"), py::arg("bus_number"), py::arg("percentage"),
+         py::arg("componentID") = std::vector<std::string>())
+    .def("getObservations",
+         [](gph::HADRECAppModule& self, bool rootOnly) {
+           std::vector<double> values;
+           {
+             py::gil_scoped_release release;
+             values = self.getObservations(rootOnly);
+           }
+           return vector_to_array(std::move(values));
+         },
+         py::arg("rootOnly") = false)
     ;
 
   // These are some network topology/analytics query methods
@@ -896,48 +1064,72 @@ PYBIND11_MODULE(gridpack, gpm) {
   // These methods need to be reworked char * and/or optional args
   hadapp
     .def("scatterInjectionLoad",
-         [](gph::HADRECAppModule& self, const std::vector<int>& vbusNum, const std::vector<double>& vloadP, const std::vector<double>& vloadQ) {
-           self.scatterInjectionLoad(vbusNum, vloadP, vloadQ);
+         [](gph::HADRECAppModule& self, const IntArray& vbusNum, const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoad(bus, p, q);
          },
-         py::arg("vbusNum") = std::vector< int >(), py::arg("vloadP") = std::vector< double >(), py::arg("vloadQ") = std::vector< double >()
+         py::arg("vbusNum") = IntArray(), py::arg("vloadP") = DoubleArray(), py::arg("vloadQ") = DoubleArray()
          )
 	.def("scatterInjectionLoadNew",
-         [](gph::HADRECAppModule& self, const std::vector<int>& vbusNum, const std::vector<double>& vloadP, const std::vector<double>& vloadQ) {
-           self.scatterInjectionLoadNew(vbusNum, vloadP, vloadQ);
+         [](gph::HADRECAppModule& self, const IntArray& vbusNum, const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew(bus, p, q);
          },
-         py::arg("vbusNum") = std::vector< int >(), py::arg("vloadP") = std::vector< double >(), py::arg("vloadQ") = std::vector< double >()
+         py::arg("vbusNum") = IntArray(), py::arg("vloadP") = DoubleArray(), py::arg("vloadQ") = DoubleArray()
          )
 	.def("scatterInjectionLoadNew_compensateY",
-         [](gph::HADRECAppModule& self, const std::vector<int>& vbusNum, const std::vector<double>& vloadP, const std::vector<double>& vloadQ) {
-           self.scatterInjectionLoadNew_compensateY(vbusNum, vloadP, vloadQ);
+         [](gph::HADRECAppModule& self, const IntArray& vbusNum, const DoubleArray& vloadP, const DoubleArray& vloadQ) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew_compensateY(bus, p, q);
          },
-         py::arg("vbusNum") = std::vector< int >(), py::arg("vloadP") = std::vector< double >(), py::arg("vloadQ") = std::vector< double >()
+         py::arg("vbusNum") = IntArray(), py::arg("vloadP") = DoubleArray(), py::arg("vloadQ") = DoubleArray()
          )
 	.def("scatterInjectionLoadNew_Norton",
-         [](gph::HADRECAppModule& self, const std::vector<int>& vbusNum, const std::vector<double>& vloadP, const std::vector<double>& vloadQ, 
-		   const std::vector<double>& vimpedanceR, const std::vector<double>& vimpedanceI) {
-           self.scatterInjectionLoadNew_Norton(vbusNum, vloadP, vloadQ, vimpedanceR, vimpedanceI);
+         [](gph::HADRECAppModule& self, const IntArray& vbusNum, const DoubleArray& vloadP, const DoubleArray& vloadQ, 
+		   const DoubleArray& vimpedanceR, const DoubleArray& vimpedanceI) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> p(array_to_vector(vloadP));
+           std::vector<double> q(array_to_vector(vloadQ));
+           std::vector<double> zr(array_to_vector(vimpedanceR));
+           std::vector<double> zi(array_to_vector(vimpedanceI));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNew_Norton(bus, p, q, zr, zi);
          },
-         py::arg("vbusNum") = std::vector< int >(), py::arg("vloadP") = std::vector< double >(), py::arg("vloadQ") = std::vector< double >(),
-		 py::arg("vimpedanceR") = std::vector< double >(), py::arg("vimpedanceI") = std::vector< double >()
+         py::arg("vbusNum") = IntArray(), py::arg("vloadP") = DoubleArray(), py::arg("vloadQ") = DoubleArray(),
+		 py::arg("vimpedanceR") = DoubleArray(), py::arg("vimpedanceI") = DoubleArray()
          )
 	.def("scatterInjectionLoadNewConstCur",
-         [](gph::HADRECAppModule& self, const std::vector<int>& vbusNum, const std::vector<double>& vCurR, const std::vector<double>& vCurI) {
-           self.scatterInjectionLoadNewConstCur(vbusNum, vCurR, vCurI);
+         [](gph::HADRECAppModule& self, const IntArray& vbusNum, const DoubleArray& vCurR, const DoubleArray& vCurI) {
+           std::vector<int> bus(array_to_vector(vbusNum));
+           std::vector<double> cr(array_to_vector(vCurR));
+           std::vector<double> ci(array_to_vector(vCurI));
+           py::gil_scoped_release release;
+           self.scatterInjectionLoadNewConstCur(bus, cr, ci);
          },
-         py::arg("vbusNum") = std::vector< int >(), py::arg("vCurR") = std::vector< double >(), py::arg("vCurI") = std::vector< double >()
+         py::arg("vbusNum") = IntArray(), py::arg("vCurR") = DoubleArray(), py::arg("vCurI") = DoubleArray()
          )
     .def("initializeDynSimu",
          [](gph::HADRECAppModule& self, std::vector< gpds::Event > faults, int dscase_idx) {
            self.initializeDynSimu(faults, dscase_idx);
          },
-         py::arg("faults") = std::vector< gpds::Event >(), py::arg("dscase_idx") = -1
+         py::arg("faults") = std::vector< gpds::Event >(), py::arg("dscase_idx") = -1,
+         py::call_guard<py::gil_scoped_release>()
          )
     .def("solvePowerFlowBeforeDynSimu",
          [](gph::HADRECAppModule& self, const std::string& s, int pfcase_idx) {
            self.solvePowerFlowBeforeDynSimu(s.c_str(), pfcase_idx);
          },
-         py::arg("s") = "", py::arg("pfcase_idx") = -1
+         py::arg("s") = "", py::arg("pfcase_idx") = -1,
+         py::call_guard<py::gil_scoped_release>()
          )
 	.def("exportPSSE23",
          [](gph::HADRECAppModule& self, const std::string& s) {
@@ -963,7 +1155,8 @@ PYBIND11_MODULE(gridpack, gpm) {
            flag = self.solvePowerFlowBeforeDynSimu_withFlag(s.c_str(), pfcase_idx);
 		   return flag;
          },
-         py::arg("s") = "", py::arg("pfcase_idx") = -1
+         py::arg("s") = "", py::arg("pfcase_idx") = -1,
+         py::call_guard<py::gil_scoped_release>()
          )
 	.def("readPowerFlowData",
          [](gph::HADRECAppModule& self, const std::string& s, int pfcase_idx) {
@@ -976,7 +1169,8 @@ PYBIND11_MODULE(gridpack, gpm) {
 		   bool flag;
            flag = self.solvePowerFlow();
 		   return flag;
-         }
+         },
+         py::call_guard<py::gil_scoped_release>()
          )
 	.def("setWideAreaControlSignal",
          [](gph::HADRECAppModule& self, int bus_number, const std::string& genid, double wideAreaControlSignal) {
@@ -1049,7 +1243,8 @@ PYBIND11_MODULE(gridpack, gpm) {
          py::arg("s") = "",
          py::arg("BusFaults") = std::vector<gpds::Event>(),
          py::arg("pfcase_idx") = -1,
-         py::arg("dscase_idx")
+         py::arg("dscase_idx"),
+         py::call_guard<py::gil_scoped_release>()
          )
     .def("setState",
          [](gph::HADRECAppModule& self, const int& bus_id, const std::string& dev_id,
@@ -170,7 +170,7 @@ while (not hadapp.isDynSimuDone()):
     # get the observations
     ob_vals = hadapp.getObservations()
 
-    ob_vals.insert(0,isteps*simu_time_step)	
+    ob_vals = [isteps*simu_time_step] + ob_vals.tolist()
     observation_list.append(ob_vals)
 
     isteps = isteps + 1
@@ -46,6 +46,10 @@ gridpack::powerflow::PFBus::PFBus(void)
   p_theta = 0.0;
   p_angle = 0.0;
   p_voltage = 0.0;
+  p_vSave = 0.0;
+  p_aSave = 0.0;
+  p_qlimIsPV = false;
+  p_qlimSave2isPV = false;
   /*p_pl = 0.0;
   p_ql = 0.0;
   p_ip = 0.0;
@@ -61,6 +65,9 @@ gridpack::powerflow::PFBus::PFBus(void)
   p_vMag_ptr = NULL;
   p_vAng_ptr = NULL;
   p_PV_ptr = NULL;
+  p_dcInj = 0.0;
+  p_dcAng = 0.0;
+  p_dcAng_ptr = NULL;
 }
 
 /**
@@ -99,6 +106,13 @@ bool gridpack::powerflow::PFBus::matrixDiagSize(int *isize, int *jsize) const
     } else {
       return false;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    if (isIsolated() || getReferenceBus()) return false;
+    if (p_mode == FastDecoupledQ && p_isPV) return false;
+    *isize = 1;
+    *jsize = 1;
+    return true;
   } else if (p_mode == YBus) {
     return YMBus::matrixDiagSize(isize,jsize);
   }
@@ -124,6 +138,12 @@ bool gridpack::powerflow::PFBus::matrixDiagValues(ComplexType *values)
     } else  {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    double rval;
+    if (!fastDecoupledDiagValue(&rval)) return false;
+    values[0] = rval;
+    return true;
   }
   return false;
 }
@@ -137,6 +157,9 @@ bool gridpack::powerflow::PFBus::matrixDiagValues(RealType *values)
     } else  {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    return fastDecoupledDiagValue(values);
   }
   return false;
 }
@@ -169,6 +192,11 @@ bool gridpack::powerflow::PFBus::vectorSize(int *size) const
     }
   } else if (p_mode == S_Cal){
     *size = 1;
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    if (isIsolated() || getReferenceBus()) return false;
+    if (p_mode == FastDecoupledQ && p_isPV) return false;
+    *size = 1;
   } else {
     *size = 2;
   }
@@ -202,6 +230,15 @@ bool gridpack::powerflow::PFBus::vectorValues(ComplexType *values)
     } else {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ) {
+    double rval;
+    if (!fastDecoupledMismatch(&rval)) return false;
+    values[0] = rval;
+    return true;
+  } else if (p_mode == DCSensitivity) {
+    if (isIsolated() || getReferenceBus()) return false;
+    values[0] = p_dcInj;
+    return true;
   }
   return false;
 }
@@ -221,6 +258,13 @@ bool gridpack::powerflow::PFBus::vectorValues(RealType *values)
       return true;
     }
   }
+  if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ) {
+    return fastDecoupledMismatch(values);
+  } else if (p_mode == DCSensitivity) {
+    if (isIsolated() || getReferenceBus()) return false;
+    values[0] = p_dcInj;
+    return true;
+  }
   return false;
 }
 
@@ -333,6 +377,36 @@ void gridpack::powerflow::PFBus::clearQlim()
   if (p_PV_ptr) *p_PV_ptr = p_isPV;
 }
 
+/**
+ * Save PV status and the generator and load values that are modified
+ * by chkQlim
+ */
+void gridpack::powerflow::PFBus::saveQlimState()
+{
+  p_qlimIsPV = p_isPV;
+  p_qlimSave2isPV = p_save2isPV;
+  p_qlimGstatus = p_gstatus;
+  p_qlimGstatusSave = p_gstatus_save;
+  p_qlimQg = p_qg;
+  p_qlimPl = p_pl;
+  p_qlimQl = p_ql;
+}
+
+/**
+ * Undo all changes made by chkQlim since the last call to saveQlimState
+ */
+void gridpack::powerflow::PFBus::restoreQlimState()
+{
+  p_isPV = p_qlimIsPV;
+  p_save2isPV = p_qlimSave2isPV;
+  p_gstatus = p_qlimGstatus;
+  p_gstatus_save = p_qlimGstatusSave;
+  p_qg = p_qlimQg;
+  p_pl = p_qlimPl;
+  p_ql = p_qlimQl;
+  if (p_PV_ptr) *p_PV_ptr = p_isPV;
+}
+
 
 /**
  * Set the internal values of the voltage magnitude and phase angle. Need this
@@ -341,16 +415,28 @@ void gridpack::powerflow::PFBus::clearQlim()
  */
 void gridpack::powerflow::PFBus::setValues(gridpack::ComplexType *values)
 {
+  if (p_mode == DCSensitivity) {
+    // DC angles are kept separate from the powerflow solution
+    p_dcAng = real(values[0]);
+    if (p_dcAng_ptr) *p_dcAng_ptr = p_dcAng;
+    return;
+  }
   double vt = p_v;
   double at = p_a;
-  p_a -= real(values[0]);
+  if (p_mode == FastDecoupledP) {
+    p_a -= real(values[0]);
+  } else if (p_mode == FastDecoupledQ) {
+    p_v -= real(values[0]);
+  } else {
+    p_a -= real(values[0]);
 #ifdef LARGE_MATRIX
-  p_v -= real(values[1]);
-#else
-  if (!p_isPV) {
     p_v -= real(values[1]);
-  }
+#else
+    if (!p_isPV) {
+      p_v -= real(values[1]);
+    }
 #endif
+  }
   *p_vMag_ptr = p_v;
   double pi = 4.0*atan(1.0);
   if (p_a >= 0.0) {
@@ -362,17 +448,29 @@ void gridpack::powerflow::PFBus::setValues(gridpack::ComplexType *values)
 
 void gridpack::powerflow::PFBus::setValues(gridpack::RealType *values)
 {
+  if (p_mode == DCSensitivity) {
+    // DC angles are kept separate from the powerflow solution
+    p_dcAng = values[0];
+    if (p_dcAng_ptr) *p_dcAng_ptr = p_dcAng;
+    return;
+  }
   double vt = p_v;
   double at = p_a;
-  p_a -= values[0];
+  if (p_mode == FastDecoupledP) {
+    p_a -= values[0];
+  } else if (p_mode == FastDecoupledQ) {
+    p_v -= values[0];
+  } else {
+    p_a -= values[0];
 #ifdef LARGE_MATRIX
-  //p_v -= real(values[1]);
-  p_v -= values[1];
-#else
-  if (!p_isPV) {
+    //p_v -= real(values[1]);
     p_v -= values[1];
-  }
+#else
+    if (!p_isPV) {
+      p_v -= values[1];
+    }
 #endif
+  }
   *p_vMag_ptr = p_v;
   double pi = 4.0*atan(1.0);
   if (p_a >= 0.0) {
@@ -389,7 +487,7 @@ void gridpack::powerflow::PFBus::setValues(gridpack::RealType *values)
  */
 int gridpack::powerflow::PFBus::getXCBufSize(void)
 {
-  return (2*sizeof(double)+sizeof(bool));
+  return (3*sizeof(double)+sizeof(bool));
 }
 
 /**
@@ -399,7 +497,8 @@ void gridpack::powerflow::PFBus::setXCBuf(void *buf)
 {
   p_vAng_ptr = static_cast<double*>(buf);
   p_vMag_ptr = p_vAng_ptr+1;
-  void *ptr = static_cast<void*>(p_vMag_ptr+1);
+  p_dcAng_ptr = p_vMag_ptr+1;
+  void *ptr = static_cast<void*>(p_dcAng_ptr+1);
   p_PV_ptr = static_cast<bool*>(ptr);
   // Note: we are assuming that the load function has been called BEFORE
   // the factory setExchange method, so p_a and p_v are set with their initial
@@ -412,7 +511,7 @@ void gridpack::powerflow::PFBus::setXCBuf(void *buf)
     *p_vAng_ptr = fmod(p_a-pi,2.0*pi)+pi;
   }
   *p_PV_ptr = p_isPV;
-  
+  *p_dcAng_ptr = p_dcAng;
 }
 
 /**
@@ -454,6 +553,8 @@ void gridpack::powerflow::PFBus::load(
   double pi = 4.0*atan(1.0);
   p_angle = p_angle*pi/180.0;
   p_a = p_angle;
+  p_vSave = p_voltage;
+  p_aSave = p_angle;
   data->getValue(BUS_TYPE, &p_type);
   if (p_type == 3) {
     setReferenceBus(true);
@@ -643,6 +744,54 @@ void gridpack::powerflow::PFBus::resetVoltage(void)
   }
 }
 
+/**
+ * Save current voltage and phase angle so that they can be used as the
+ * starting point for subsequent calculations
+ */
+void gridpack::powerflow::PFBus::saveVoltage(void)
+{
+  p_vSave = p_v;
+  p_aSave = p_a;
+}
+
+/**
+ * Restore voltage and phase angle to values stored by saveVoltage
+ */
+void gridpack::powerflow::PFBus::restoreVoltage(void)
+{
+  p_v = p_vSave;
+  p_a = p_aSave;
+  if (p_vMag_ptr) *p_vMag_ptr = p_v;
+  if (p_vAng_ptr) {
+    double pi = 4.0*atan(1.0);
+    if (p_a >= 0.0) {
+      *p_vAng_ptr = fmod(p_a+pi,2.0*pi)-pi;
+    } else {
+      *p_vAng_ptr = fmod(p_a-pi,2.0*pi)+pi;
+    }
+  }
+}
+
+/**
+ * Set voltage magnitude and phase angle
+ * @param v voltage magnitude
+ * @param a phase angle
+ */
+void gridpack::powerflow::PFBus::setVoltage(double v, double a)
+{
+  p_v = v;
+  p_a = a;
+  if (p_vMag_ptr) *p_vMag_ptr = p_v;
+  if (p_vAng_ptr) {
+    double pi = 4.0*atan(1.0);
+    if (p_a >= 0.0) {
+      *p_vAng_ptr = fmod(p_a+pi,2.0*pi)-pi;
+    } else {
+      *p_vAng_ptr = fmod(p_a-pi,2.0*pi)+pi;
+    }
+  }
+}
+
 /**
  * Set voltage limits on bus
  * @param vmin lower value of voltage
@@ -1601,6 +1750,96 @@ int gridpack::powerflow::PFBus::rhsValues(double *rvals)
   }
 }
 
+/**
+ * Evaluate diagonal element of the B' (FastDecoupledP mode) or B''
+ * (FastDecoupledQ mode) matrix of the fast decoupled powerflow. B' only
+ * contains the series reactances of the branches, B'' is the negative of
+ * the imaginary part of the admittance matrix
+ * @param rval value of diagonal element
+ * @return false if bus does not contribute to matrix
+ */
+bool gridpack::powerflow::PFBus::fastDecoupledDiagValue(double *rval)
+{
+  if (isIsolated() || getReferenceBus()) return false;
+  if (p_mode == FastDecoupledP || p_mode == DCSensitivity) {
+    std::vector<boost::shared_ptr<BaseComponent> > branches;
+    getNeighborBranches(branches);
+    int size = branches.size();
+    int i;
+    double bsum = 0.0;
+    for (i=0; i<size; i++) {
+      gridpack::powerflow::PFBranch *branch
+        = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
+      bsum += branch->getSeriesSusceptance();
+    }
+    *rval = bsum;
+    return true;
+  } else if (p_mode == FastDecoupledQ && !p_isPV) {
+    *rval = -p_ybusi;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Evaluate real (FastDecoupledP mode) or reactive (FastDecoupledQ mode)
+ * power mismatch divided by the voltage magnitude for the fast decoupled
+ * powerflow
+ * @param rval value of mismatch
+ * @return false if bus does not contribute to vector
+ */
+bool gridpack::powerflow::PFBus::fastDecoupledMismatch(double *rval)
+{
+  if (isIsolated() || getReferenceBus()) return false;
+  double rvals[2];
+  rhsValues(rvals);
+  if (p_mode == FastDecoupledP) {
+    *rval = rvals[0]/p_v;
+    return true;
+  } else if (p_mode == FastDecoupledQ && !p_isPV) {
+    *rval = rvals[1]/p_v;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Set real power injection used as the right hand side of DC sensitivity
+ * calculations
+ * @param p real power injection (p.u.)
+ */
+void gridpack::powerflow::PFBus::setDCInjection(double p)
+{
+  p_dcInj = p;
+}
+
+/**
+ * Get phase angle from the last DC sensitivity calculation
+ * @return DC phase angle (radians)
+ */
+double gridpack::powerflow::PFBus::getDCAngle(void) const
+{
+  if (p_dcAng_ptr) return *p_dcAng_ptr;
+  return p_dcAng;
+}
+
+/**
+ * Get real power of an individual generator
+ * @param tag generator ID
+ * @return real power (MW). This is zero if generator is out of service
+ */
+double gridpack::powerflow::PFBus::getGeneratorRealPower(std::string tag)
+{
+  int i;
+  for (i=0; i<p_ngen; i++) {
+    if (p_gid[i] == tag) {
+      if (p_gstatus[i]) return p_pg[i];
+      return 0.0;
+    }
+  }
+  return 0.0;
+}
+
 /**
  * Get vector containing generator participation
  * @return vector of generator participation factors
@@ -1919,6 +2158,12 @@ bool gridpack::powerflow::PFBranch::matrixForwardSize(int *isize, int *jsize) co
     } else {
       return false;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    if (!fastDecoupledActive()) return false;
+    *isize = 1;
+    *jsize = 1;
+    return true;
   } else if (p_mode == YBus) {
     return YMBranch::matrixForwardSize(isize,jsize);
   }
@@ -1965,6 +2210,12 @@ bool gridpack::powerflow::PFBranch::matrixReverseSize(int *isize, int *jsize) co
     } else {
       return false;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    if (!fastDecoupledActive()) return false;
+    *isize = 1;
+    *jsize = 1;
+    return true;
   } else if (p_mode == YBus) {
     return YMBranch::matrixReverseSize(isize,jsize);
   }
@@ -1988,6 +2239,12 @@ bool gridpack::powerflow::PFBranch::matrixForwardValues(ComplexType *values)
     } else {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    double rval;
+    if (!fastDecoupledValue(true, &rval)) return false;
+    values[0] = rval;
+    return true;
   } else if (p_mode == YBus) {
     return YMBranch::matrixForwardValues(values);
   }
@@ -2003,6 +2260,9 @@ bool gridpack::powerflow::PFBranch::matrixForwardValues(RealType *values)
     } else {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    return fastDecoupledValue(true, values);
   }
   return false;
 }
@@ -2018,6 +2278,12 @@ bool gridpack::powerflow::PFBranch::matrixReverseValues(ComplexType *values)
     } else {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    double rval;
+    if (!fastDecoupledValue(false, &rval)) return false;
+    values[0] = rval;
+    return true;
   } else if (p_mode == YBus) {
     return YMBranch::matrixReverseValues(values);
   }
@@ -2033,6 +2299,9 @@ bool gridpack::powerflow::PFBranch::matrixReverseValues(RealType *values)
     } else {
       return true;
     }
+  } else if (p_mode == FastDecoupledP || p_mode == FastDecoupledQ ||
+      p_mode == DCSensitivity) {
+    return fastDecoupledValue(false, values);
   }
   return false;
 }
@@ -2675,3 +2944,89 @@ int gridpack::powerflow::PFBranch::reverseJacobianValues(double *rvals)
     return 0;
   }
 }
+
+/**
+ * Return true if branch contributes off-diagonal elements to the B' or B''
+ * matrix of the fast decoupled powerflow in the current mode. Branches
+ * connected to the reference bus or to isolated buses do not contribute
+ * and B'' has no rows or columns for PV buses
+ */
+bool gridpack::powerflow::PFBranch::fastDecoupledActive(void) const
+{
+  gridpack::powerflow::PFBus *bus1
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus1().get());
+  gridpack::powerflow::PFBus *bus2
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
+  bool ok = !bus1->getReferenceBus();
+  ok = ok && !bus2->getReferenceBus();
+  ok = ok && !bus1->isIsolated();
+  ok = ok && !bus2->isIsolated();
+  ok = ok && (p_active);
+  if (p_mode == FastDecoupledQ) {
+    ok = ok && !bus1->isPV() && !bus2->isPV();
+  }
+  return ok;
+}
+
+/**
+ * Evaluate off-diagonal element of the B' or B'' matrix of the fast
+ * decoupled powerflow
+ * @param forward evaluate forward (true) or reverse element
+ * @param rval value of element
+ * @return false if branch does not contribute to matrix
+ */
+bool gridpack::powerflow::PFBranch::fastDecoupledValue(bool forward,
+    double *rval)
+{
+  if (!fastDecoupledActive()) return false;
+  if (p_mode == FastDecoupledP || p_mode == DCSensitivity) {
+    *rval = -getSeriesSusceptance();
+  } else if (forward) {
+    *rval = -p_ybusi_frwd;
+  } else {
+    *rval = -p_ybusi_rvrs;
+  }
+  return true;
+}
+
+/**
+ * Get the DC susceptance of an individual transmission element
+ * @param tag transmission element ID
+ * @return 1/x of element. This is zero if the element is out of service
+ */
+double gridpack::powerflow::PFBranch::getDCSusceptance(std::string tag)
+{
+  int i;
+  for (i=0; i<p_elems; i++) {
+    if (p_ckt[i] == tag) {
+      if (p_branch_status[i] && p_reactance[i] != 0.0) {
+        return 1.0/p_reactance[i];
+      }
+      return 0.0;
+    }
+  }
+  return 0.0;
+}
+
+/**
+ * Get difference of the DC phase angles at the two ends of the branch
+ * from the last DC sensitivity calculation. The angle of the reference
+ * bus and of isolated buses is zero
+ * @return angle at "from" bus minus angle at "to" bus
+ */
+double gridpack::powerflow::PFBranch::getDCAngleDifference(void)
+{
+  gridpack::powerflow::PFBus *bus1
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus1().get());
+  gridpack::powerflow::PFBus *bus2
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
+  double a1 = 0.0;
+  double a2 = 0.0;
+  if (!bus1->getReferenceBus() && !bus1->isIsolated()) {
+    a1 = bus1->getDCAngle();
+  }
+  if (!bus2->getReferenceBus() && !bus2->isIsolated()) {
+    a2 = bus2->getDCAngle();
+  }
+  return a1 - a2;
+}
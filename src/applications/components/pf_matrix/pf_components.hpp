@@ -27,7 +27,12 @@
 namespace gridpack {
 namespace powerflow {
 
-enum PFMode{YBus, Jacobian, RHS, S_Cal, State};
+// FastDecoupledP and FastDecoupledQ build the B' and B'' matrices of the
+// fast decoupled method and the corresponding P and Q mismatch vectors.
+// DCSensitivity builds the DC B matrix (same as B') with the injections set
+// by setDCInjection as right hand side and stores solutions as DC angles
+enum PFMode{YBus, Jacobian, RHS, S_Cal, State, FastDecoupledP,
+  FastDecoupledQ, DCSensitivity};
 
 class PFBus
   : public gridpack::ymatrix::YMBus
@@ -132,6 +137,17 @@ class PFBus
      */
     void resetVoltage(void);
 
+    /**
+     * Save current voltage and phase angle so that they can be used as the
+     * starting point for subsequent calculations
+     */
+    void saveVoltage(void);
+
+    /**
+     * Restore voltage and phase angle to values stored by saveVoltage
+     */
+    void restoreVoltage(void);
+
     /**
      * Set voltage limits on bus
      * @param vmin lower value of voltage
@@ -194,6 +210,13 @@ class PFBus
      */
     void setVoltage(void);
 
+    /**
+     * Set voltage magnitude and phase angle
+     * @param v voltage magnitude
+     * @param a phase angle
+     */
+    void setVoltage(double v, double a);
+
     /**
      * Set phase angle value
      */
@@ -253,6 +276,17 @@ class PFBus
      */
     void clearQlim();
 
+    /**
+     * Save PV status and the generator and load values that are modified
+     * by chkQlim
+     */
+    void saveQlimState();
+
+    /**
+     * Undo all changes made by chkQlim since the last call to saveQlimState
+     */
+    void restoreQlimState();
+
     /**
      * Save state variables inside the component to a DataCollection object.
      * This can be used as a way of moving data in a way that is useful for
@@ -340,6 +374,43 @@ class PFBus
      */
     int rhsValues(double *rvals);
 
+    /**
+     * Evaluate diagonal element of the B' (FastDecoupledP mode) or B''
+     * (FastDecoupledQ mode) matrix of the fast decoupled powerflow
+     * @param rval value of diagonal element
+     * @return false if bus does not contribute to matrix
+     */
+    bool fastDecoupledDiagValue(double *rval);
+
+    /**
+     * Evaluate real (FastDecoupledP mode) or reactive (FastDecoupledQ mode)
+     * power mismatch divided by the voltage magnitude for the fast
+     * decoupled powerflow
+     * @param rval value of mismatch
+     * @return false if bus does not contribute to vector
+     */
+    bool fastDecoupledMismatch(double *rval);
+
+    /**
+     * Set real power injection used as the right hand side of DC
+     * sensitivity calculations
+     * @param p real power injection (p.u.)
+     */
+    void setDCInjection(double p);
+
+    /**
+     * Get phase angle from the last DC sensitivity calculation
+     * @return DC phase angle (radians)
+     */
+    double getDCAngle(void) const;
+
+    /**
+     * Get real power of an individual generator
+     * @param tag generator ID
+     * @return real power (MW). This is zero if generator is out of service
+     */
+    double getGeneratorRealPower(std::string tag);
+
     /**
      * Push p_isPV values from exchange buffer to p_isPV variable
      */
@@ -453,6 +524,7 @@ class PFBus
     double p_P0, p_Q0; //double p_sbusr, p_sbusi;
     double p_angle;   // initial bus angle read from parser
     double p_voltage; // initial bus voltage read from parser
+    double p_vSave, p_aSave; // voltage and angle stored by saveVoltage
     // newly added priavate variables:
     std::vector<double> p_pg, p_qg, p_pFac;
     std::vector<double> p_savePg;
@@ -473,6 +545,10 @@ class PFBus
     double p_Pinj, p_Qinj;
     double p_vmin, p_vmax;
     bool p_isPV, p_saveisPV, p_save2isPV;
+    // values stored by saveQlimState
+    bool p_qlimIsPV, p_qlimSave2isPV;
+    std::vector<int> p_qlimGstatus, p_qlimGstatusSave;
+    std::vector<double> p_qlimQg, p_qlimPl, p_qlimQl;
     bool *p_PV_ptr;
     int p_ngen;
     int p_nload;
@@ -489,6 +565,13 @@ class PFBus
      */
     double* p_vMag_ptr;
     double* p_vAng_ptr;
+    double* p_dcAng_ptr;
+
+    /**
+     * Right hand side and solution of DC sensitivity calculations
+     */
+    double p_dcInj;
+    double p_dcAng;
     
     /**
      * Cache a pointer to DataCollection object
@@ -514,6 +597,7 @@ private:
       & p_ybusr & p_ybusi
       & p_P0 & p_Q0
       & p_angle & p_voltage
+      & p_vSave & p_aSave
       & p_pg & p_qg & p_pFac & p_qmin & p_qmax
       & p_qmin_orig & p_qmax_orig & p_pFac_orig
       & p_gstatus
@@ -693,6 +777,35 @@ class PFBranch
     int forwardJacobianValues(double *rvals);
     int reverseJacobianValues(double *rvals);
 
+    /**
+     * Return true if branch contributes off-diagonal elements to the B'
+     * or B'' matrix of the fast decoupled powerflow in the current mode
+     */
+    bool fastDecoupledActive(void) const;
+
+    /**
+     * Evaluate off-diagonal element of the B' or B'' matrix of the fast
+     * decoupled powerflow
+     * @param forward evaluate forward (true) or reverse element
+     * @param rval value of element
+     * @return false if branch does not contribute to matrix
+     */
+    bool fastDecoupledValue(bool forward, double *rval);
+
+    /**
+     * Get the DC susceptance of an individual transmission element
+     * @param tag transmission element ID
+     * @return 1/x of element. This is zero if the element is out of service
+     */
+    double getDCSusceptance(std::string tag);
+
+    /**
+     * Get difference of the DC phase angles at the two ends of the branch
+     * from the last DC sensitivity calculation
+     * @return angle at "from" bus minus angle at "to" bus
+     */
+    double getDCAngleDifference(void);
+
   private:
     std::vector<bool> p_ignore;
     std::vector<double> p_reactance;
@@ -622,6 +622,24 @@ gridpack::ymatrix::YMBranch::getShunt(gridpack::ymatrix::YMBus *bus)
   return gridpack::ComplexType(retr,reti);
 }
 
+/**
+ * Return the susceptance of the branch in the simplified admittance
+ * matrix used by the fast decoupled powerflow. Resistance, charging,
+ * shunts and transformer taps and phase shifts are neglected
+ * @return sum of 1/x over all active transmission elements
+ */
+double gridpack::ymatrix::YMBranch::getSeriesSusceptance(void)
+{
+  double ret = 0.0;
+  int i;
+  for (i=0; i<p_elems; i++) {
+    if (p_branch_status[i] && p_reactance[i] != 0.0) {
+      ret += 1.0/p_reactance[i];
+    }
+  }
+  return ret;
+}
+
 /**
  * Return contributions to Y-matrix from a specific transmission element
  * @param tag character string for transmission element
@@ -234,6 +234,14 @@ class YMBranch
      */
     gridpack::ComplexType getShunt(YMBus *bus);
 
+    /**
+     * Return the susceptance of the branch in the simplified admittance
+     * matrix used by the fast decoupled powerflow. Resistance, charging,
+     * shunts and transformer taps and phase shifts are neglected
+     * @return sum of 1/x over all active transmission elements
+     */
+    double getSeriesSusceptance(void);
+
     /**
      * Return contributions to Y-matrix from a specific transmission element
      * @param tag character string for transmission element
@@ -20,6 +20,7 @@
 
 #include "gridpack/include/gridpack.hpp"
 #include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/applications/modules/powerflow/dc_sensitivity_module.hpp"
 #include "ca_driver.hpp"
 
 #define USE_SUCCESS
@@ -141,6 +142,91 @@ std::vector<gridpack::powerflow::Contingency>
   return ret;
 }
 
+// Append an int or a string to a byte buffer
+static void packInt(int value, std::vector<char> &buf)
+{
+  const char *ptr = reinterpret_cast<const char*>(&value);
+  buf.insert(buf.end(), ptr, ptr+sizeof(int));
+}
+
+static void packString(const std::string &str, std::vector<char> &buf)
+{
+  packInt(str.size(), buf);
+  buf.insert(buf.end(), str.begin(), str.end());
+}
+
+// Read an int or a string from a byte buffer starting at offset and advance
+// offset past it
+static int unpackInt(const std::vector<char> &buf, size_t &offset)
+{
+  int value;
+  memcpy(&value, &buf[offset], sizeof(int));
+  offset += sizeof(int);
+  return value;
+}
+
+static std::string unpackString(const std::vector<char> &buf, size_t &offset)
+{
+  int len = unpackInt(buf, offset);
+  std::string str(buf.begin()+offset, buf.begin()+offset+len);
+  offset += len;
+  return str;
+}
+
+/**
+ * Copy a contingency into a buffer of bytes so that it can be kept in a
+ * GlobalStore
+ * @param event contingency
+ * @param buf returned buffer
+ */
+void gridpack::contingency_analysis::CADriver::packContingency(
+    const gridpack::powerflow::Contingency &event, std::vector<char> &buf)
+{
+  int i;
+  buf.clear();
+  packInt(event.p_type, buf);
+  packString(event.p_name, buf);
+  packInt(event.p_from.size(), buf);
+  for (i=0; i<event.p_from.size(); i++) {
+    packInt(event.p_from[i], buf);
+    packInt(event.p_to[i], buf);
+    packString(event.p_ckt[i], buf);
+  }
+  packInt(event.p_busid.size(), buf);
+  for (i=0; i<event.p_busid.size(); i++) {
+    packInt(event.p_busid[i], buf);
+    packString(event.p_genid[i], buf);
+  }
+}
+
+/**
+ * Recover a contingency from a buffer created by packContingency
+ * @param buf buffer holding contingency
+ * @param event returned contingency
+ */
+void gridpack::contingency_analysis::CADriver::unpackContingency(
+    const std::vector<char> &buf, gridpack::powerflow::Contingency &event)
+{
+  int i, n;
+  size_t offset = 0;
+  event = gridpack::powerflow::Contingency();
+  event.p_type = unpackInt(buf, offset);
+  event.p_name = unpackString(buf, offset);
+  n = unpackInt(buf, offset);
+  for (i=0; i<n; i++) {
+    event.p_from.push_back(unpackInt(buf, offset));
+    event.p_to.push_back(unpackInt(buf, offset));
+    event.p_ckt.push_back(unpackString(buf, offset));
+    event.p_saveLineStatus.push_back(true);
+  }
+  n = unpackInt(buf, offset);
+  for (i=0; i<n; i++) {
+    event.p_busid.push_back(unpackInt(buf, offset));
+    event.p_genid.push_back(unpackString(buf, offset));
+    event.p_saveGenStatus.push_back(true);
+  }
+}
+
 /**
  * Execute application. argc and argv are standard runtime parameters
  */
@@ -204,6 +290,37 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   if (!cursor->get("checkQLimit",&check_Qlim)) {
     check_Qlim = false;
   }
+  // Number of contingencies that are fetched from the task manager at one
+  // time
+  int tasks_per_fetch;
+  if (!cursor->get("tasksPerFetch",&tasks_per_fetch)) {
+    tasks_per_fetch = 1;
+  }
+  if (tasks_per_fetch < 1) tasks_per_fetch = 1;
+  // Check whether contingencies should be handed out in leases taken from
+  // ranges assigned to each task communicator
+  bool lease_tasks;
+  if (!cursor->get("leaseTasks",&lease_tasks)) {
+    lease_tasks = false;
+  }
+  // Check whether contingency calculations should start from the base case
+  // solution instead of the voltages in the network configuration file
+  bool warm_start;
+  if (!cursor->get("warmStart",&warm_start)) {
+    warm_start = false;
+  }
+  // Check whether contingencies should be screened with DC sensitivities.
+  // Contingencies with an estimated loading below screeningLoading on all
+  // lines are not evaluated with the AC powerflow and the remaining
+  // contingencies are evaluated in order of decreasing estimated loading
+  bool dc_screening;
+  if (!cursor->get("dcScreening",&dc_screening)) {
+    dc_screening = false;
+  }
+  double screening_loading;
+  if (!cursor->get("screeningLoading",&screening_loading)) {
+    screening_loading = 0.9;
+  }
   gridpack::parallel::Communicator task_comm = world.divide(grp_size);
 
   // Keep track of failed calculations
@@ -237,6 +354,17 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   // Some buses may violate the voltage limits in the base problem. Flag these
   // buses to ignore voltage violations on them.
   pf_app.ignoreVoltageViolations();
+  // Store base case solution so that it can be used as the starting point for
+  // the contingency calculations
+  if (warm_start) pf_app.saveVoltages();
+  // Factor DC B matrix for screening using the linear solver parameters in
+  // the Powerflow block
+  boost::shared_ptr<gridpack::powerflow::DCSensitivityModule> dc_sens;
+  if (dc_screening) {
+    dc_sens.reset(new gridpack::powerflow::DCSensitivityModule(pf_network,
+          config->getCursor("Configuration.Powerflow")));
+    dc_sens->setup();
+  }
 
   // Read in contingency file name
   std::string contingencyfile;
@@ -281,11 +409,76 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   }
 
 
+  // Find contingencies that are evaluated with the AC powerflow. Task i
+  // evaluates contingency task_order[i]
+  int ntasks = events.size();
+  std::vector<int> task_order;
+  std::vector<bool> screened(ntasks, false);
+  if (dc_screening) {
+    int t_screen = timer->createCategory("DC Contingency Screening");
+    timer->start(t_screen);
+    std::vector<gridpack::powerflow::ScreeningResult> results
+      = dc_sens->screen(events, world);
+    std::vector<int> skipped;
+    task_order = gridpack::powerflow::DCSensitivityModule::rank(results,
+        screening_loading, skipped);
+    int icnt;
+    for (icnt=0; icnt<skipped.size(); icnt++) {
+      screened[skipped[icnt]] = true;
+      if (world.rank() == 0) {
+        printf("Screened out: %s (estimated loading %f)\n",
+            events[skipped[icnt]].p_name.c_str(),
+            results[skipped[icnt]].maxLoading);
+      }
+    }
+    if (world.rank() == 0) {
+      printf("DC screening: %d of %d contingencies evaluated with AC"
+          " powerflow\n",static_cast<int>(task_order.size()),ntasks);
+    }
+    timer->stop(t_screen);
+  } else {
+    int icnt;
+    for (icnt=0; icnt<ntasks; icnt++) task_order.push_back(icnt);
+  }
+
   // Set up task manager on the world communicator. The number of tasks is
-  // equal to the number of contingencies
+  // equal to the number of contingencies that are evaluated
   gridpack::parallel::TaskManager taskmgr(world);
-  int ntasks = events.size();
-  taskmgr.set(ntasks);
+  int nrun = task_order.size();
+  if (lease_tasks) {
+    // Hand out contingencies in leases, starting with the contingencies
+    // that have the largest number of elements
+    std::vector<double> cost(nrun);
+    int icnt;
+    for (icnt=0; icnt<nrun; icnt++) {
+      int ievt = task_order[icnt];
+      if (events[ievt].p_type == Branch) {
+        cost[icnt] = static_cast<double>(events[ievt].p_from.size());
+      } else {
+        cost[icnt] = static_cast<double>(events[ievt].p_busid.size());
+      }
+    }
+    taskmgr.setLeased(cost, task_comm);
+  } else {
+    taskmgr.set(nrun);
+  }
+
+  // The full list of contingencies is no longer needed on every process.
+  // Keep one copy on each node in shared memory and release the local
+  // copies. Each process packs a share of the contingencies into the store.
+  gridpack::parallel::GlobalStore<char> event_store(world, true);
+  {
+    std::vector<char> buf;
+    int ievt;
+    for (ievt=world.rank(); ievt<ntasks; ievt += world.size()) {
+      packContingency(events[ievt], buf);
+      event_store.addVector(ievt, buf);
+    }
+    if (ntasks > 0) event_store.upload();
+    std::vector<gridpack::powerflow::Contingency>().swap(events);
+  }
+  gridpack::powerflow::Contingency event;
+  std::vector<char> event_buf;
 
   int nbus = pf_network->totalBuses();
   // Get bus voltage information for base case
@@ -454,11 +647,22 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   // Evaluate contingencies using the task manager
   int task_id;
   char sbuf[128];
-  // nextTask returns the same task_id on all processors in task_comm. When the
-  // calculation runs out of task, nextTask will return false.
-  while (taskmgr.nextTask(task_comm, &task_id)) {
+  // nextTaskBlock returns the same list of tasks on all processors in
+  // task_comm. Tasks are fetched in blocks of size tasks_per_fetch to reduce
+  // the number of accesses to the task counter. When the calculation runs
+  // out of tasks, nextTaskBlock will return false.
+  std::vector<int> task_block;
+  int iblock = 0;
+  while (true) {
+    if (iblock >= task_block.size()) {
+      if (!taskmgr.nextTaskBlock(task_comm, tasks_per_fetch, task_block)) break;
+      iblock = 0;
+    }
+    task_id = task_order[task_block[iblock++]];
+    event_store.getVector(task_id, event_buf);
+    unpackContingency(event_buf, event);
     printf("Executing task %d on process %d\n",task_id,world.rank());
-    sprintf(sbuf,"%s.out",events[task_id].p_name.c_str());
+    sprintf(sbuf,"%s.out",event.p_name.c_str());
     // Open a new file, based on the contingency name, to store results from
     // this particular contingency calculation
     if (print_calcs) pf_app.open(sbuf);
@@ -466,34 +670,39 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
     // information on the contingency
     sprintf(sbuf,"\nRunning task on %d processes\n",task_comm.size());
     if (print_calcs) pf_app.writeHeader(sbuf);
-    if (events[task_id].p_type == Branch) {
-      int nlines = events[task_id].p_from.size();
+    if (event.p_type == Branch) {
+      int nlines = event.p_from.size();
       int j;
       for (j=0; j<nlines; j++) {
         sprintf(sbuf," Line: (from) %d (to) %d (line) \'%s\'\n",
-            events[task_id].p_from[j],events[task_id].p_to[j],
-            events[task_id].p_ckt[j].c_str());
+            event.p_from[j],event.p_to[j],
+            event.p_ckt[j].c_str());
         printf("p[%d] Line: (from) %d (to) %d (line) \'%s\'\n",
             pf_network->communicator().rank(),
-            events[task_id].p_from[j],events[task_id].p_to[j],
-            events[task_id].p_ckt[j].c_str());
+            event.p_from[j],event.p_to[j],
+            event.p_ckt[j].c_str());
       }
-    } else if (events[task_id].p_type == Generator) {
-      int nbus = events[task_id].p_busid.size();
+    } else if (event.p_type == Generator) {
+      int nbus = event.p_busid.size();
       int j;
       for (j=0; j<nbus; j++) {
         sprintf(sbuf," Generator: (bus) %d (generator ID) \'%s\'\n",
-            events[task_id].p_busid[j],events[task_id].p_genid[j].c_str());
+            event.p_busid[j],event.p_genid[j].c_str());
         printf("p[%d] Generator: (bus) %d (generator ID) \'%s\'\n",
             pf_network->communicator().rank(),
-            events[task_id].p_busid[j],events[task_id].p_genid[j].c_str());
+            event.p_busid[j],event.p_genid[j].c_str());
       }
     }
     if (print_calcs) pf_app.writeHeader(sbuf);
-    // Reset all voltages back to their original values
-    pf_app.resetVoltages();
+    // Reset all voltages back to their original values or, if a warm
+    // start is requested, to the base case solution
+    if (warm_start) {
+      pf_app.restoreVoltages();
+    } else {
+      pf_app.resetVoltages();
+    }
     // Set contingency
-    pf_app.setContingency(events[task_id]);
+    pf_app.setContingency(event);
     // Solve power flow equations for this system
 #ifdef USE_SUCCESS
     contingency_idx.push_back(task_id);
@@ -514,20 +723,20 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       // Include results of violation checks in output
       if (ok) {
         sprintf(sbuf,"\nNo violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
 #ifdef USE_SUCCESS
         contingency_violation.push_back(1);
 #endif
       } 
       if (!ok1) {
         sprintf(sbuf,"\nBus Violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
       }
       if (print_calcs) pf_app.print(sbuf);
       if (print_calcs) pf_app.writeCABus();
       if (!ok2) {
         sprintf(sbuf,"\nBranch Violation for contingency %s\n",
-            events[task_id].p_name.c_str());
+            event.p_name.c_str());
       }
 
 #ifdef USE_SUCCESS
@@ -644,7 +853,7 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       contingency_violation.push_back(0);
 #endif
       sprintf(sbuf,"\nDivergent for contingency %s\n",
-          events[task_id].p_name.c_str());
+          event.p_name.c_str());
       if (print_calcs) pf_app.print(sbuf);
       // Add dummy values to StatBlock object. Mask value is set to 0 for all
       // network elements to indicate calculation failure
@@ -734,7 +943,7 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
 #endif
     } 
     // Return network to its original base case state
-    pf_app.unSetContingency(events[task_id]);
+    pf_app.unSetContingency(event);
     // Close output file for this contingency
     if (print_calcs) pf_app.close();
   }
@@ -744,6 +953,18 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
 
   // Gather stats on successful contingency calculations
 #ifdef USE_SUCCESS
+  // Contingencies that were screened out were not evaluated by any task.
+  // Record them as converged without violations so that every contingency
+  // has an entry in the global vectors
+  if (world.rank() == 0) {
+    for (i=0; i<ntasks; i++) {
+      if (screened[i]) {
+        contingency_idx.push_back(i);
+        contingency_success.push_back(true);
+        contingency_violation.push_back(1);
+      }
+    }
+  }
   if (task_comm.rank() == 0) {
     ca_success.addElements(contingency_idx, contingency_success);
     ca_violation.addElements(contingency_idx, contingency_violation);
@@ -762,7 +983,10 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
     std::ofstream fout;
     fout.open("success.txt");
     for (i=0; i<ntasks; i++) {
-      if (contingency_success[i]) {
+      if (screened[i]) {
+        fout << "contingency: " << i+1 << " screened: true"
+          << " violation: none" << std::endl;
+      } else if (contingency_success[i]) {
         fout << "contingency: " << i+1 << " success: true";
         if (contingency_violation[i] == 1) {
           fout << " violation: none" << std::endl;
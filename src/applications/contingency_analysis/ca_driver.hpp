@@ -75,6 +75,23 @@ class CADriver
     void execute(int argc, char** argv);
 
     private:
+
+    /**
+     * Copy a contingency into a buffer of bytes so that it can be kept in a
+     * GlobalStore
+     * @param event contingency
+     * @param buf returned buffer
+     */
+    void packContingency(const gridpack::powerflow::Contingency &event,
+        std::vector<char> &buf);
+
+    /**
+     * Recover a contingency from a buffer created by packContingency
+     * @param buf buffer holding contingency
+     * @param event returned contingency
+     */
+    void unpackContingency(const std::vector<char> &buf,
+        gridpack::powerflow::Contingency &event);
 };
 
 } // contingency analysis 
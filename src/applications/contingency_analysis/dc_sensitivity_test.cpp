@@ -0,0 +1,280 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dc_sensitivity_test.cpp
+ *
+ * @brief
+ * Compare PTDF and LODF factors from the DCSensitivityModule with flows
+ * from a dense DC solve of the complete network, with and without the
+ * outaged element. The outage is specified with its buses in both orders.
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include <map>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/applications/modules/powerflow/dc_sensitivity_module.hpp"
+
+// Transmission element 4-5 of the IEEE 14 bus network
+#define OUT_FROM 4
+#define OUT_TO 5
+#define OUT_TAG "BL"
+// Bus with injection for PTDF factors
+#define INJ_BUS 3
+#define TOLERANCE 1.0e-6
+
+typedef gridpack::powerflow::PFNetwork PFNetwork;
+
+/**
+ * Assemble dense DC B matrix of the complete network on all processes
+ * @param network powerflow network
+ * @param gidx map of original bus indices to global bus indices
+ * @param outage if true, leave out element OUT_FROM-OUT_TO
+ * @param B dense matrix (row major)
+ * @param ref reference bus flags
+ */
+void assembleB(boost::shared_ptr<PFNetwork> network,
+    std::map<int,int> &gidx, bool outage, std::vector<double> &B,
+    std::vector<int> &ref)
+{
+  int nbus = network->totalBuses();
+  int i, j;
+  B.assign(nbus*nbus,0.0);
+  ref.assign(nbus,0);
+  std::vector<int> orig(nbus,0);
+  for (i=0; i<network->numBuses(); i++) {
+    if (!network->getActiveBus(i)) continue;
+    int g = network->getGlobalBusIndex(i);
+    orig[g] = network->getOriginalBusIndex(i);
+    if (network->getBus(i)->getReferenceBus()) ref[g] = 1;
+  }
+  network->communicator().sum(&orig[0],nbus);
+  network->communicator().sum(&ref[0],nbus);
+  gidx.clear();
+  for (i=0; i<nbus; i++) gidx.insert(std::pair<int,int>(orig[i],i));
+  for (i=0; i<network->numBranches(); i++) {
+    if (!network->getActiveBranch(i)) continue;
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          network->getBranch(i).get());
+    int from = branch->getBus1OriginalIndex();
+    int to = branch->getBus2OriginalIndex();
+    int g1 = gidx[from];
+    int g2 = gidx[to];
+    std::vector<std::string> tags = branch->getLineTags();
+    for (j=0; j<tags.size(); j++) {
+      if (outage && tags[j] == OUT_TAG && ((from == OUT_FROM && to == OUT_TO)
+            || (from == OUT_TO && to == OUT_FROM))) continue;
+      double b = branch->getDCSusceptance(tags[j]);
+      B[g1*nbus+g1] += b;
+      B[g2*nbus+g2] += b;
+      B[g1*nbus+g2] -= b;
+      B[g2*nbus+g1] -= b;
+    }
+  }
+  network->communicator().sum(&B[0],nbus*nbus);
+}
+
+/**
+ * Solve B theta = p with zero angle at the reference bus
+ * @param B dense matrix
+ * @param ref reference bus flags
+ * @param inj global index of bus with unit injection
+ * @param theta bus angles
+ */
+void denseSolve(std::vector<double> B, const std::vector<int> &ref, int inj,
+    std::vector<double> &theta)
+{
+  int n = ref.size();
+  int i, j, k;
+  theta.assign(n,0.0);
+  theta[inj] = 1.0;
+  for (i=0; i<n; i++) {
+    if (!ref[i]) continue;
+    for (j=0; j<n; j++) B[i*n+j] = 0.0;
+    B[i*n+i] = 1.0;
+    theta[i] = 0.0;
+  }
+  for (k=0; k<n; k++) {
+    int piv = k;
+    for (i=k+1; i<n; i++) {
+      if (fabs(B[i*n+k]) > fabs(B[piv*n+k])) piv = i;
+    }
+    if (piv != k) {
+      for (j=0; j<n; j++) std::swap(B[k*n+j],B[piv*n+j]);
+      std::swap(theta[k],theta[piv]);
+    }
+    for (i=k+1; i<n; i++) {
+      double fac = B[i*n+k]/B[k*n+k];
+      for (j=k; j<n; j++) B[i*n+j] -= fac*B[k*n+j];
+      theta[i] -= fac*theta[k];
+    }
+  }
+  for (k=n-1; k>=0; k--) {
+    for (j=k+1; j<n; j++) theta[k] -= B[k*n+j]*theta[j];
+    theta[k] /= B[k*n+k];
+  }
+}
+
+/**
+ * Flow on a locally held element for a set of bus angles
+ * @param network powerflow network
+ * @param gidx map of original bus indices to global bus indices
+ * @param theta bus angles
+ * @param from original index of "from" bus of element
+ * @param to original index of "to" bus of element
+ * @param tag identifier of element
+ * @return flow from "from" to "to" bus or 0 if element is not local
+ */
+double elementFlow(boost::shared_ptr<PFNetwork> network,
+    std::map<int,int> &gidx, const std::vector<double> &theta, int from,
+    int to, const std::string &tag)
+{
+  std::vector<int> lids = network->getLocalBranchIndices(from,to);
+  int i;
+  for (i=0; i<lids.size(); i++) {
+    if (!network->getActiveBranch(lids[i])) continue;
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          network->getBranch(lids[i]).get());
+    double b = branch->getDCSusceptance(tag);
+    return b*(theta[gidx[branch->getBus1OriginalIndex()]]
+        - theta[gidx[branch->getBus2OriginalIndex()]]);
+  }
+  return 0.0;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int nerr = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    // read configuration file
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      char inputfile[256];
+      sprintf(inputfile,"%s",argv[1]);
+      config->open(inputfile,world);
+    } else {
+      config->open("input_14.xml",world);
+    }
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = config->getCursor("Configuration.Powerflow");
+
+    // Solve base case and factor DC B matrix
+    boost::shared_ptr<PFNetwork> network(new PFNetwork(world));
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(network,config);
+    pf_app.initialize();
+    pf_app.solve();
+    gridpack::powerflow::DCSensitivityModule dc_sens(network,cursor);
+    dc_sens.setThreshold(0.0);
+    dc_sens.setup();
+
+    // Reference angles for an injection at INJ_BUS, with and without the
+    // outaged element
+    std::map<int,int> gidx;
+    std::vector<double> B;
+    std::vector<int> ref;
+    std::vector<double> theta_pre, theta_post;
+    assembleB(network,gidx,false,B,ref);
+    denseSolve(B,ref,gidx[INJ_BUS],theta_pre);
+    assembleB(network,gidx,true,B,ref);
+    denseSolve(B,ref,gidx[INJ_BUS],theta_post);
+    double fout = elementFlow(network,gidx,theta_pre,OUT_FROM,OUT_TO,OUT_TAG);
+    world.sum(&fout,1);
+
+    int i, j;
+    int nchecked = 0;
+    std::vector<gridpack::powerflow::SensitivityFactor> factors;
+    dc_sens.getPTDF(INJ_BUS,factors);
+    for (i=0; i<factors.size(); i++) {
+      double expect = elementFlow(network,gidx,theta_pre,factors[i].from,
+          factors[i].to,factors[i].tag);
+      if (fabs(factors[i].value-expect) > TOLERANCE) {
+        printf("p[%d] PTDF %d-%d %s: %f expected: %f\n",world.rank(),
+            factors[i].from,factors[i].to,factors[i].tag.c_str(),
+            factors[i].value,expect);
+        nerr++;
+      }
+      nchecked++;
+    }
+
+    // The LODF factors must not depend on the order in which the buses of
+    // the outaged element are given
+    int ends[2][2] = {{OUT_FROM, OUT_TO}, {OUT_TO, OUT_FROM}};
+    for (j=0; j<2; j++) {
+      if (!dc_sens.getLODF(ends[j][0],ends[j][1],OUT_TAG,factors)) {
+        if (world.rank() == 0) {
+          printf("LODF for outage %d-%d not found\n",ends[j][0],ends[j][1]);
+          nerr++;
+        }
+        continue;
+      }
+      for (i=0; i<factors.size(); i++) {
+        double pre = elementFlow(network,gidx,theta_pre,factors[i].from,
+            factors[i].to,factors[i].tag);
+        double post = elementFlow(network,gidx,theta_post,factors[i].from,
+            factors[i].to,factors[i].tag);
+        double expect = (post-pre)/fout;
+        if (fabs(factors[i].value-expect) > TOLERANCE) {
+          printf("p[%d] LODF %d-%d %s for outage %d-%d: %f expected: %f\n",
+              world.rank(),factors[i].from,factors[i].to,
+              factors[i].tag.c_str(),ends[j][0],ends[j][1],
+              factors[i].value,expect);
+          nerr++;
+        }
+        nchecked++;
+      }
+    }
+
+    // Screening estimates must also be independent of the bus order
+    double loading[2];
+    for (j=0; j<2; j++) {
+      gridpack::powerflow::Contingency event;
+      event.p_type = gridpack::powerflow::Branch;
+      event.p_name = "outage";
+      event.p_from.push_back(ends[j][0]);
+      event.p_to.push_back(ends[j][1]);
+      event.p_ckt.push_back(OUT_TAG);
+      gridpack::powerflow::ScreeningResult result = dc_sens.screen(event);
+      loading[j] = result.maxLoading;
+      if (!result.estimated) {
+        if (world.rank() == 0) {
+          printf("Outage %d-%d not estimated\n",ends[j][0],ends[j][1]);
+          nerr++;
+        }
+      }
+    }
+    if (fabs(loading[0]-loading[1]) > TOLERANCE) {
+      if (world.rank() == 0) {
+        printf("Estimated loading %f for outage %d-%d, %f for %d-%d\n",
+            loading[0],OUT_FROM,OUT_TO,loading[1],OUT_TO,OUT_FROM);
+        nerr++;
+      }
+    }
+
+    world.sum(&nerr,1);
+    world.sum(&nchecked,1);
+    if (nchecked == 0) nerr++;
+    if (world.rank() == 0) {
+      if (nerr == 0) {
+        printf("DC sensitivity test passed (%d factors checked)\n",nchecked);
+      } else {
+        printf("DC sensitivity test failed with %d errors\n",nerr);
+      }
+    }
+  }
+
+  return (nerr == 0 ? 0 : 1);
+}
@@ -0,0 +1,269 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   quantile_sketch.cpp
+ *
+ * @brief
+ * Streaming estimate of the distribution of a single variable using a
+ * merging t-digest with the arcsine scale function.
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <utility>
+#include "quantile_sketch.hpp"
+
+namespace {
+
+// Scale function of the t-digest. Centroids may span at most one unit of
+// k, which keeps centroids near the tails of the distribution small
+inline double scaleK(double q, double delta)
+{
+  double pi = 4.0*atan(1.0);
+  return delta/(2.0*pi)*asin(2.0*q-1.0);
+}
+
+// Inverse of scale function
+inline double scaleQ(double k, double delta)
+{
+  double pi = 4.0*atan(1.0);
+  if (k >= 0.25*delta) return 1.0;
+  return 0.5*(sin(2.0*pi*k/delta)+1.0);
+}
+
+}
+
+/**
+ * Basic constructor
+ * @param compression number of centroids that are kept. Larger values
+ *                    give more accurate quantiles and use more memory
+ */
+gridpack::contingency_analysis::QuantileSketch::QuantileSketch(int compression)
+{
+  p_compression = compression;
+  if (p_compression < 10) p_compression = 10;
+  p_nsorted = 0;
+  p_count = 0.0;
+  p_mean = 0.0;
+  p_m2 = 0.0;
+  p_min = DBL_MAX;
+  p_max = -DBL_MAX;
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::contingency_analysis::QuantileSketch::~QuantileSketch()
+{
+}
+
+/**
+ * Add a single value to the sketch
+ * @param x new value
+ */
+void gridpack::contingency_analysis::QuantileSketch::add(double x)
+{
+  // Update running statistics
+  p_count += 1.0;
+  double delta = x - p_mean;
+  p_mean += delta/p_count;
+  p_m2 += delta*(x-p_mean);
+  if (x < p_min) p_min = x;
+  if (x > p_max) p_max = x;
+  // Buffer value as a centroid of weight 1
+  p_centroids.push_back(x);
+  p_centroids.push_back(1.0);
+  if (static_cast<int>(p_centroids.size()) >= 4*p_compression) compress();
+}
+
+/**
+ * Add all values of another sketch to this sketch
+ * @param other sketch to be merged
+ */
+void gridpack::contingency_analysis::QuantileSketch::merge(
+    const QuantileSketch &other)
+{
+  mergeStats(other.p_count, other.p_mean, other.p_m2, other.p_min,
+      other.p_max);
+  p_centroids.insert(p_centroids.end(),other.p_centroids.begin(),
+      other.p_centroids.end());
+  compress();
+}
+
+/**
+ * Combine buffered values into centroids
+ */
+void gridpack::contingency_analysis::QuantileSketch::compress()
+{
+  int ncent = p_centroids.size()/2;
+  if (ncent == p_nsorted) return;
+  // Sort all centroids by mean
+  std::vector<std::pair<double,double> > items(ncent);
+  int i;
+  double total = 0.0;
+  for (i=0; i<ncent; i++) {
+    items[i].first = p_centroids[2*i];
+    items[i].second = p_centroids[2*i+1];
+    total += items[i].second;
+  }
+  std::sort(items.begin(),items.end());
+  p_centroids.clear();
+  if (ncent <= p_compression) {
+    // Few enough centroids to keep all of them
+    for (i=0; i<ncent; i++) {
+      p_centroids.push_back(items[i].first);
+      p_centroids.push_back(items[i].second);
+    }
+  } else {
+    // Combine neighboring centroids as long as the combined centroid
+    // spans less than one unit of the scale function
+    double delta = static_cast<double>(p_compression);
+    double wsofar = 0.0;
+    double cmean = items[0].first;
+    double cweight = items[0].second;
+    double wlimit = total*scaleQ(scaleK(0.0,delta)+1.0,delta);
+    for (i=1; i<ncent; i++) {
+      if (wsofar+cweight+items[i].second <= wlimit) {
+        cweight += items[i].second;
+        cmean += (items[i].first-cmean)*items[i].second/cweight;
+      } else {
+        p_centroids.push_back(cmean);
+        p_centroids.push_back(cweight);
+        wsofar += cweight;
+        wlimit = total*scaleQ(scaleK(wsofar/total,delta)+1.0,delta);
+        cmean = items[i].first;
+        cweight = items[i].second;
+      }
+    }
+    p_centroids.push_back(cmean);
+    p_centroids.push_back(cweight);
+  }
+  p_nsorted = p_centroids.size()/2;
+}
+
+/**
+ * Estimate a quantile. The quantile is linearly interpolated between
+ * sorted values, so it is exact if no centroids have been combined
+ * @param q quantile (between 0 and 1)
+ * @return value of quantile or 0 if sketch is empty
+ */
+double gridpack::contingency_analysis::QuantileSketch::quantile(double q)
+{
+  compress();
+  int ncent = p_centroids.size()/2;
+  if (ncent == 0) return 0.0;
+  if (q <= 0.0) return p_min;
+  if (q >= 1.0) return p_max;
+  // Each centroid represents the values with ranks cum to cum+weight-1 and
+  // is placed at the center of this range
+  double rank = q*(p_count-1.0);
+  double cum = 0.0;
+  double center = 0.5*(p_centroids[1]-1.0);
+  if (rank <= center) {
+    if (center <= 0.0) return p_centroids[0];
+    return p_min + (p_centroids[0]-p_min)*rank/center;
+  }
+  int i;
+  double pcenter = center;
+  double pmean = p_centroids[0];
+  cum = p_centroids[1];
+  for (i=1; i<ncent; i++) {
+    double mean = p_centroids[2*i];
+    double weight = p_centroids[2*i+1];
+    center = cum + 0.5*(weight-1.0);
+    if (rank <= center) {
+      return pmean + (mean-pmean)*(rank-pcenter)/(center-pcenter);
+    }
+    cum += weight;
+    pcenter = center;
+    pmean = mean;
+  }
+  // Rank lies between the center of the last centroid and the maximum
+  double top = p_count-1.0;
+  if (top <= pcenter) return pmean;
+  return pmean + (p_max-pmean)*(rank-pcenter)/(top-pcenter);
+}
+
+/**
+ * Statistics of all values added so far
+ */
+double gridpack::contingency_analysis::QuantileSketch::count() const
+{
+  return p_count;
+}
+
+double gridpack::contingency_analysis::QuantileSketch::mean() const
+{
+  return p_mean;
+}
+
+double gridpack::contingency_analysis::QuantileSketch::variance() const
+{
+  if (p_count > 1.0) return p_m2/(p_count-1.0);
+  return 0.0;
+}
+
+double gridpack::contingency_analysis::QuantileSketch::min() const
+{
+  if (p_count > 0.0) return p_min;
+  return 0.0;
+}
+
+double gridpack::contingency_analysis::QuantileSketch::max() const
+{
+  if (p_count > 0.0) return p_max;
+  return 0.0;
+}
+
+/**
+ * Append sketch to a buffer so that it can be sent to another processor
+ * @param buf buffer of serialized sketches
+ */
+void gridpack::contingency_analysis::QuantileSketch::pack(
+    std::vector<double> &buf)
+{
+  compress();
+  buf.push_back(p_count);
+  buf.push_back(p_mean);
+  buf.push_back(p_m2);
+  buf.push_back(p_min);
+  buf.push_back(p_max);
+  buf.push_back(static_cast<double>(p_centroids.size()/2));
+  buf.insert(buf.end(),p_centroids.begin(),p_centroids.end());
+}
+
+/**
+ * Merge a sketch that was serialized by pack
+ * @param buf pointer to start of serialized sketch
+ * @return number of values read from buffer
+ */
+int gridpack::contingency_analysis::QuantileSketch::unpack(const double *buf)
+{
+  mergeStats(buf[0],buf[1],buf[2],buf[3],buf[4]);
+  int ncent = static_cast<int>(buf[5]);
+  p_centroids.insert(p_centroids.end(),buf+6,buf+6+2*ncent);
+  if (static_cast<int>(p_centroids.size()) >= 4*p_compression) compress();
+  return 6+2*ncent;
+}
+
+/**
+ * Add statistics of another set of values to running statistics
+ */
+void gridpack::contingency_analysis::QuantileSketch::mergeStats(double count,
+    double mean, double m2, double min, double max)
+{
+  if (count <= 0.0) return;
+  double total = p_count + count;
+  double delta = mean - p_mean;
+  p_mean += delta*count/total;
+  p_m2 += m2 + delta*delta*p_count*count/total;
+  p_count = total;
+  if (min < p_min) p_min = min;
+  if (max > p_max) p_max = max;
+}
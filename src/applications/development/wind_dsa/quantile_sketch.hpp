@@ -0,0 +1,112 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   quantile_sketch.hpp
+ *
+ * @brief
+ * Streaming estimate of the distribution of a single variable. Values are
+ * summarized by a merging t-digest (a sorted list of weighted centroids)
+ * together with the running mean, variance, minimum and maximum. Sketches
+ * built on different processors can be merged. The quantiles are exact as
+ * long as the number of values does not exceed the compression parameter.
+ */
+// -------------------------------------------------------------
+
+#ifndef _quantile_sketch_h_
+#define _quantile_sketch_h_
+
+#include <vector>
+
+namespace gridpack {
+namespace contingency_analysis {
+
+class QuantileSketch
+{
+  public:
+  /**
+   * Basic constructor
+   * @param compression number of centroids that are kept. Larger values
+   *                    give more accurate quantiles and use more memory
+   */
+  QuantileSketch(int compression = 100);
+
+  /**
+   * Basic destructor
+   */
+  ~QuantileSketch();
+
+  /**
+   * Add a single value to the sketch
+   * @param x new value
+   */
+  void add(double x);
+
+  /**
+   * Add all values of another sketch to this sketch
+   * @param other sketch to be merged
+   */
+  void merge(const QuantileSketch &other);
+
+  /**
+   * Combine buffered values into centroids
+   */
+  void compress();
+
+  /**
+   * Estimate a quantile. The quantile is linearly interpolated between
+   * sorted values, so it is exact if no centroids have been combined
+   * @param q quantile (between 0 and 1)
+   * @return value of quantile or 0 if sketch is empty
+   */
+  double quantile(double q);
+
+  /**
+   * Statistics of all values added so far
+   */
+  double count() const;
+  double mean() const;
+  double variance() const;
+  double min() const;
+  double max() const;
+
+  /**
+   * Append sketch to a buffer so that it can be sent to another processor
+   * @param buf buffer of serialized sketches
+   */
+  void pack(std::vector<double> &buf);
+
+  /**
+   * Merge a sketch that was serialized by pack
+   * @param buf pointer to start of serialized sketch
+   * @return number of values read from buffer
+   */
+  int unpack(const double *buf);
+
+  private:
+
+  /**
+   * Add statistics of another set of values to running statistics
+   */
+  void mergeStats(double count, double mean, double m2, double min,
+      double max);
+
+  int p_compression;
+  // interleaved centroid means and weights. Centroids are sorted by mean
+  // up to p_nsorted, the remaining centroids have not been compressed
+  std::vector<double> p_centroids;
+  int p_nsorted;
+  // running statistics
+  double p_count;
+  double p_mean;
+  double p_m2;
+  double p_min;
+  double p_max;
+};
+
+} // contingency_analysis
+} // gridpack
+#endif
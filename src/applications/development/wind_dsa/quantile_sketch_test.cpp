@@ -0,0 +1,211 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   quantile_sketch_test.cpp
+ *
+ * @brief
+ * Unit tests for QuantileSketch. Quantiles must match linear interpolation
+ * between sorted values as long as the number of values does not exceed
+ * the compression, and sketches must give the same results after they are
+ * merged or sent through pack and unpack.
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+#include "quantile_sketch.hpp"
+
+typedef gridpack::contingency_analysis::QuantileSketch QuantileSketch;
+
+static const double delta(1.0e-8);
+
+// -------------------------------------------------------------
+// make_values
+// -------------------------------------------------------------
+/**
+ * Generate a reproducible set of unsorted values
+ * @param n number of values
+ * @param vals generated values
+ */
+void make_values(int n, std::vector<double> &vals)
+{
+  int i;
+  unsigned int seed = 12345;
+  vals.resize(n);
+  for (i=0; i<n; i++) {
+    seed = 1103515245*seed + 12345;
+    vals[i] = 10.0*static_cast<double>((seed>>8)%100000)/100000.0 - 3.0;
+  }
+}
+
+// -------------------------------------------------------------
+// exact_quantile
+// -------------------------------------------------------------
+/**
+ * Quantile by linear interpolation between sorted values
+ * @param sorted sorted values
+ * @param q quantile (between 0 and 1)
+ * @return value of quantile
+ */
+double exact_quantile(const std::vector<double> &sorted, double q)
+{
+  int n = sorted.size();
+  double rank = q*static_cast<double>(n-1);
+  int lo = static_cast<int>(rank);
+  if (lo >= n-1) return sorted[n-1];
+  double f = rank - static_cast<double>(lo);
+  return sorted[lo] + f*(sorted[lo+1]-sorted[lo]);
+}
+
+static const double quantiles[] = {0.0, 0.05, 0.25, 0.33, 0.5, 0.75, 0.9,
+  0.99, 1.0};
+static const int nquantiles = sizeof(quantiles)/sizeof(double);
+
+// -------------------------------------------------------------
+// check_exact
+// -------------------------------------------------------------
+/**
+ * Compare quantiles and statistics of sketch with values computed directly
+ * @param sketch sketch containing all values
+ * @param vals values
+ */
+void check_exact(QuantileSketch &sketch, const std::vector<double> &vals)
+{
+  int i;
+  int n = vals.size();
+  std::vector<double> sorted(vals);
+  std::sort(sorted.begin(), sorted.end());
+  for (i=0; i<nquantiles; i++) {
+    BOOST_CHECK_SMALL(sketch.quantile(quantiles[i])
+        - exact_quantile(sorted, quantiles[i]), delta);
+  }
+  double mean = 0.0;
+  for (i=0; i<n; i++) mean += vals[i];
+  mean /= static_cast<double>(n);
+  double var = 0.0;
+  for (i=0; i<n; i++) var += (vals[i]-mean)*(vals[i]-mean);
+  if (n > 1) var /= static_cast<double>(n-1);
+  BOOST_CHECK_CLOSE(sketch.count(), static_cast<double>(n), delta);
+  BOOST_CHECK_SMALL(sketch.mean() - mean, delta);
+  BOOST_CHECK_SMALL(sketch.variance() - var, delta);
+  BOOST_CHECK_EQUAL(sketch.min(), sorted[0]);
+  BOOST_CHECK_EQUAL(sketch.max(), sorted[n-1]);
+}
+
+BOOST_AUTO_TEST_SUITE(QuantileSketchTest)
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+  QuantileSketch sketch(20);
+  BOOST_CHECK_EQUAL(sketch.count(), 0.0);
+  BOOST_CHECK_EQUAL(sketch.quantile(0.5), 0.0);
+  BOOST_CHECK_EQUAL(sketch.min(), 0.0);
+  BOOST_CHECK_EQUAL(sketch.max(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( ExactBelowCompression )
+{
+  int compression = 50;
+  int n;
+  // Sizes up to and including the compression (1, 8, ..., 50) are exact
+  for (n=1; n<=compression; n += 7) {
+    std::vector<double> vals;
+    make_values(n, vals);
+    QuantileSketch sketch(compression);
+    int i;
+    for (i=0; i<n; i++) sketch.add(vals[i]);
+    check_exact(sketch, vals);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( MergeAndPack )
+{
+  int compression = 100;
+  int n = 80;
+  int nsplit = 35;
+  int i;
+  std::vector<double> vals;
+  make_values(n, vals);
+
+  QuantileSketch first(compression), second(compression);
+  for (i=0; i<nsplit; i++) first.add(vals[i]);
+  for (i=nsplit; i<n; i++) second.add(vals[i]);
+
+  // Merge directly
+  QuantileSketch merged(first);
+  merged.merge(second);
+  check_exact(merged, vals);
+
+  // Merge through a buffer holding several sketches, the way sketches are
+  // sent between processors
+  std::vector<double> buf;
+  QuantileSketch empty(compression);
+  empty.pack(buf);
+  second.pack(buf);
+  QuantileSketch unpacked(first), other(compression);
+  const double *ptr = &buf[0];
+  ptr += other.unpack(ptr);
+  ptr += unpacked.unpack(ptr);
+  BOOST_CHECK_EQUAL(static_cast<int>(ptr - &buf[0]),
+      static_cast<int>(buf.size()));
+  BOOST_CHECK_EQUAL(other.count(), 0.0);
+  check_exact(unpacked, vals);
+}
+
+BOOST_AUTO_TEST_CASE( Compressed )
+{
+  // With many more values than centroids quantiles are approximate, but
+  // the extremes and statistics are still exact
+  int compression = 100;
+  int n = 20000;
+  int i;
+  std::vector<double> vals;
+  make_values(n, vals);
+  QuantileSketch first(compression), second(compression);
+  for (i=0; i<n/2; i++) first.add(vals[i]);
+  for (i=n/2; i<n; i++) second.add(vals[i]);
+  std::vector<double> buf;
+  second.pack(buf);
+  first.unpack(&buf[0]);
+
+  std::vector<double> sorted(vals);
+  std::sort(sorted.begin(), sorted.end());
+  double range = sorted[n-1] - sorted[0];
+  for (i=0; i<nquantiles; i++) {
+    BOOST_CHECK_SMALL(first.quantile(quantiles[i])
+        - exact_quantile(sorted, quantiles[i]), 0.01*range);
+  }
+  BOOST_CHECK_EQUAL(first.quantile(0.0), sorted[0]);
+  BOOST_CHECK_EQUAL(first.quantile(1.0), sorted[n-1]);
+  BOOST_CHECK_CLOSE(first.count(), static_cast<double>(n), delta);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// -------------------------------------------------------------
+// init_function
+// -------------------------------------------------------------
+bool init_function()
+{
+  return true;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
@@ -24,37 +24,27 @@
 // can be run concurrently
 
 /**
- * Basic constructor
+ * Basic constructor. Each processor keeps a quantile sketch for every
+ * watched variable and time step, so memory does not depend on the
+ * number of scenarios
  * @param comm communicator used for analysis
  * @param nwatch number of generator variables being watched
  * @param nconf number of scenarios
  * @param nsteps number of timesteps being stored
+ * @param compression number of centroids kept in each quantile sketch.
+ *                    Quantiles are exact if the number of scenarios does
+ *                    not exceed this value
  */
 gridpack::contingency_analysis::QuantileAnalysis::QuantileAnalysis(
-    gridpack::parallel::Communicator comm, int nwatch, int nconf, int nsteps)
+    gridpack::parallel::Communicator comm, int nwatch, int nconf, int nsteps,
+    int compression)
 {
-  int dims[3];
-  int three = 3;
-  int chunk[3];
   p_nwatch = nwatch;
   p_nconf = nconf;
   p_nsteps = nsteps;
-  dims[0] = nconf;
-  dims[1] = nwatch;
-  dims[2] = nsteps;
-  // Keep all steps for a time series on one processor
-  chunk[0] = -1;
-  chunk[1] = -1;
-  chunk[2] = nsteps;
-  // Create GA
-  p_GA = GA_Create_handle();
-  int grp = comm.getGroup();
-  GA_Set_data(p_GA,three,dims,C_DBL);
-  GA_Set_pgroup(p_GA,grp);
-  GA_Set_chunk(p_GA,chunk);
-  GA_Allocate(p_GA);
-  // Initialize all values to zero
-  GA_Zero(p_GA);
+  if (p_nsteps < 0) p_nsteps = 0;
+  p_sketches.assign(p_nwatch*p_nsteps,QuantileSketch(compression));
+  p_merged = false;
 
   p_comm = comm;
 }
@@ -64,11 +54,10 @@ gridpack::contingency_analysis::QuantileAnalysis::QuantileAnalysis(
  */
 gridpack::contingency_analysis::QuantileAnalysis::~QuantileAnalysis()
 {
-  GA_Destroy(p_GA);
 }
 
 /**
- * Save data for a single time step for a single generator
+ * Add time series for a single generator to the quantile sketches
  * @param cfg_idx scenario index for time series
  * @param gen_idx generator index for time series
  * @param vals vector of time series values for a generator
@@ -76,19 +65,18 @@ gridpack::contingency_analysis::QuantileAnalysis::~QuantileAnalysis()
 void gridpack::contingency_analysis::QuantileAnalysis::saveData(int cfg_idx,
     int gen_idx, std::vector<double> &vals)
 {
-  int lo[3], hi[3], ld[2];
-  lo[0] = cfg_idx;
-  lo[1] = gen_idx;
-  lo[2] = 0;
-  hi[0] = cfg_idx;
-  hi[1] = gen_idx;
-  hi[2] = p_nsteps-1;
-  ld[0] = 1;
-  ld[1] = p_nsteps;
-  if (vals.size() > 0) {
-    NGA_Put(p_GA,lo,hi,&(vals[0]),ld);
+  if (gen_idx < 0 || gen_idx >= p_nwatch) {
+    printf("Generator index %d out of range for scenario %d\n",
+        gen_idx,cfg_idx);
+    return;
+  }
+  int i;
+  int nvals = vals.size();
+  if (nvals > p_nsteps) nvals = p_nsteps;
+  QuantileSketch *sketch = &p_sketches[gen_idx*p_nsteps];
+  for (i=0; i<nvals; i++) {
+    sketch[i].add(vals[i]);
   }
-
 }
 
 /**
@@ -105,15 +93,65 @@ void gridpack::contingency_analysis::QuantileAnalysis::saveVarNames(
 }
 
 /**
- * Stream data in storage array
+ * Compress buffered values in the local quantile sketches
  */
 void gridpack::contingency_analysis::QuantileAnalysis::writeData()
 {
-  GA_Sync();
+  int i;
+  int nsketch = p_sketches.size();
+  for (i=0; i<nsketch; i++) {
+    p_sketches[i].compress();
+  }
+}
+
+/**
+ * Merge sketches from all processors onto process 0. This is only done
+ * once, after all data has been saved
+ */
+void gridpack::contingency_analysis::QuantileAnalysis::mergeSketches()
+{
+  if (p_merged) return;
+  p_merged = true;
+  if (p_nsteps == 0) return;
+  const boost::mpi::communicator &comm = p_comm.getCommunicator();
+  int me = p_comm.rank();
+  int nprocs = p_comm.size();
+  int i, j, nbuf;
+  std::vector<double> buf;
+  // Binary tree reduction. Sketches for one variable are sent at a time to
+  // limit the size of the buffers
+  int stride;
+  for (stride=1; stride<nprocs; stride *= 2) {
+    if (me%(2*stride) == stride) {
+      for (i=0; i<p_nwatch; i++) {
+        buf.clear();
+        for (j=0; j<p_nsteps; j++) {
+          p_sketches[i*p_nsteps+j].pack(buf);
+        }
+        nbuf = buf.size();
+        comm.send(me-stride,0,nbuf);
+        comm.send(me-stride,1,&buf[0],nbuf);
+      }
+      break;
+    } else if (me%(2*stride) == 0 && me+stride < nprocs) {
+      for (i=0; i<p_nwatch; i++) {
+        comm.recv(me+stride,0,nbuf);
+        buf.resize(nbuf);
+        comm.recv(me+stride,1,&buf[0],nbuf);
+        const double *ptr = &buf[0];
+        for (j=0; j<p_nsteps; j++) {
+          ptr += p_sketches[i*p_nsteps+j].unpack(ptr);
+        }
+      }
+    }
+  }
 }
 
 /**
- * Calculate quantiles and write them to a file
+ * Calculate quantiles and write them to a file. Scenarios that were not
+ * saved (e.g. because the power flow failed) are left out and the number
+ * of excluded scenarios is reported. This is collective on the
+ * communicator used for analysis
  * @param quantiles values describing quantiles to be calculated.
  *                  These values should be between 0 and 1.
  * @param dt magnitude time step (in seconds)
@@ -126,133 +164,40 @@ void gridpack::contingency_analysis::QuantileAnalysis::exportQuantiles(
   // Check quantile values to make sure they lie between 0.0 and 1.0
   for (i=0; i<nvals; i++) {
     if (quantiles[i]<0.0 || quantiles[i] > 1.0) {
-      //TODO: out of range error
+      if (p_comm.rank() == 0) {
+        printf("Quantile %f out of range, using nearest limit\n",
+            quantiles[i]);
+      }
     }
   }
-  // Create global array of size n_vals*p_nwatch*p_nsteps to hold nvals
-  // quantile values for all watched generators over all timesteps
-  int g_quant = GA_Create_handle();
-  int dims[3];
-  dims[0] = nvals;
-  dims[1] = p_nwatch;
-  dims[2] = p_nsteps;
-  NGA_Set_data(g_quant,3,dims,C_DBL);
-  GA_Allocate(g_quant);
   // Sort quantile values so that they run from lowest to highest
   std::sort(quantiles.begin(),quantiles.end());
-  std::vector<int> partition(nvals);
-  std::vector<double> weight(nvals);
-
-  // find indices that bracket quantiles
-  for (i=0; i<nvals; i++) {
-    partition[i] = static_cast<int>(quantiles[i]
-        * static_cast<double>(p_nconf-1));
-  }
-  if (quantiles[0] == 0.0) partition[0] = 0;
-  if (quantiles[nvals-1] == 1.0) partition[nvals-1] = p_nconf-1;
-  // calculate weights for each partition
-  for (i=0; i<nvals; i++) {
-    if (i == 0 && quantiles[0] == 0.0) {
-      weight[0] = 1.0;
-    } else if (i == nvals-1 && quantiles[i] == 1.0) {
-      weight[nvals-1] = 1.0;
-    } else {
-      if (p_nconf > 1) {
-        double lo = static_cast<double>(partition[i])
-          / static_cast<double>(p_nconf-1);
-        double hi = static_cast<double>(partition[i]+1)
-          / static_cast<double>(p_nconf-1);
-        weight[i] = 1.0 - (quantiles[i]-lo)/(hi-lo);
-      } else {
-        weight[i] = 1.0;
-      }
-    }
-  }
-  int lo[3], hi[3], ld[2];
-  printf("Quantiles: [%d,%f] [%d,%f] [%d,%f] [%d,%f] [%d,%f]\n",
-      partition[0],weight[0],partition[1],weight[1],partition[2],weight[2],
-      partition[3],weight[3],partition[4],weight[4]);
-  // nconf, nwatch, nsteps
-  std::vector<double> time_slice(p_nconf*p_nwatch);
-  lo[0] = 0;
-  hi[0] = p_nconf-1;
-  lo[1] = 0;
-  hi[1] = p_nwatch-1;
-  ld[0] = p_nwatch;
-  ld[1] = 1;
-  // Set up task manager to iterate over steps;
-  gridpack::parallel::TaskManager counter(p_comm);
-  counter.set(p_nsteps);
-  int step;
-  int nquar = quantiles.size();
-  int rlo[3], rhi[3];
-  rlo[0] = 0;
-  rlo[1] = 0;
-  rhi[0] = nvals-1;
-  rhi[1] = p_nwatch-1;
-  // loop over steps
-  std::vector<double> results(p_nwatch*nvals);
-  std::vector<double> qvalues(nvals);
-  while (counter.nextTask(&step)){
-    lo[2] = step;
-    hi[2] = step;
-    // Get all data for this step
-    NGA_Get(p_GA,lo,hi,&time_slice[0],ld);
-    // loop over watched variables
-    for (i=0; i<p_nwatch; i++) {
-      // get all configuration values for each variable
-      std::vector<double> conf(p_nconf);
-      for (j=0; j<p_nconf; j++) {
-        conf[j] = time_slice[j*p_nwatch+i];
-      }
-      // Sort values from lowest to highest
-      std::sort(conf.begin(),conf.end());
-      // Find quantile values 
-      for (k=0; k<nvals; k++) {
-        int kdx = partition[k];
-        if (k == 0 && quantiles[k] == 0.0) {
-          qvalues[0] = conf[kdx];
-        } else if (k == nvals-1 && quantiles[k] == 1.0) {
-          qvalues[k] = conf[kdx];
-        } else {
-          if (partition[k] < p_nconf-1) {
-            qvalues[k] = weight[k]*conf[kdx]+(1.0-weight[k])*conf[kdx+1];
-          } else {
-            //TODO: report error
-          }
-        }
+  mergeSketches();
+  // Write out results to files. Currently writing out each variable to a
+  // separate file
+  if (p_comm.rank() == 0) {
+    // Scenarios whose power flow did not converge were never saved and are
+    // not part of the quantiles
+    if (p_nsteps > 0) {
+      int nused = p_nconf;
+      for (i=0; i<p_nwatch; i++) {
+        int ncount = static_cast<int>(p_sketches[i*p_nsteps].count());
+        if (ncount < nused) nused = ncount;
       }
-      // copy quantile values into results buffer
-      for (k=0; k<nvals; k++) {
-        results[k*p_nwatch+i] = qvalues[k];
+      if (nused < p_nconf) {
+        printf("Quantiles calculated from %d of %d scenarios. %d scenarios"
+            " with a failed power flow were excluded\n",nused,p_nconf,
+            p_nconf-nused);
       }
     }
-    rlo[2] = step;
-    rhi[2] = step;
-    // copy results values into global array containing results for all steps
-    NGA_Put(g_quant,rlo,rhi,&results[0],ld);
-  }
-  GA_Sync();
-  // Write out results to files. Currently writing out each variable to a
-  // separate file
-  if (GA_Pgroup_nodeid(p_comm.getGroup()) == 0) {
     // loop over watched variables
-    std::vector<double> wbuf(nvals*p_nsteps);
-    lo[0] = 0;
-    lo[2] = 0;
-    hi[0] = nvals-1;
-    hi[2] = p_nsteps-1;
-    ld[0] = 1;
-    ld[1] = p_nsteps;
     for (i=0; i<p_nwatch; i++) {
-      lo[1] = i;
-      hi[1] = i;
-      NGA_Get(g_quant,lo,hi,&wbuf[0],ld);
       FILE *fd = fopen(p_var_names[i].c_str(),"w");
       for (j=0; j<p_nsteps; j++) {
+        QuantileSketch &sketch = p_sketches[i*p_nsteps+j];
         fprintf(fd,"%16.4f",j*dt);
         for (k=0; k<nvals; k++) {
-          fprintf(fd," %16.8f",wbuf[k*p_nsteps+j]);
+          fprintf(fd," %16.8f",sketch.quantile(quantiles[k]));
         }
         fprintf(fd,"\n");
       }
@@ -261,6 +206,32 @@ void gridpack::contingency_analysis::QuantileAnalysis::exportQuantiles(
   }
 }
 
+/**
+ * Write mean, standard deviation, minimum and maximum of each variable
+ * to a file with the suffix "_stats". This is collective on the
+ * communicator used for analysis
+ * @param dt magnitude time step (in seconds)
+ */
+void gridpack::contingency_analysis::QuantileAnalysis::exportStatistics(
+    double dt)
+{
+  int i, j;
+  mergeSketches();
+  if (p_comm.rank() == 0) {
+    for (i=0; i<p_nwatch; i++) {
+      std::string filename = p_var_names[i] + "_stats";
+      FILE *fd = fopen(filename.c_str(),"w");
+      for (j=0; j<p_nsteps; j++) {
+        QuantileSketch &sketch = p_sketches[i*p_nsteps+j];
+        fprintf(fd,"%16.4f %16.8f %16.8f %16.8f %16.8f\n",j*dt,
+            sketch.mean(),sqrt(sketch.variance()),sketch.min(),
+            sketch.max());
+      }
+      fclose(fd);
+    }
+  }
+}
+
 /**
  * Basic constructor
  */
@@ -694,6 +665,10 @@ void gridpack::contingency_analysis::WindDriver::execute(int argc, char** argv)
   for (i=0; i<tokens.size(); i++) {
     quantiles.push_back(atof(tokens[i].c_str()));
   }
+  // Number of centroids kept in each quantile sketch
+  int compression = cursor->get("quantileCompression",100);
+  // Write mean, standard deviation, minimum and maximum to _stats files
+  bool export_stats = cursor->get("exportStatistics",false);
 
 
   // Find number of generators being watched
@@ -792,7 +767,7 @@ void gridpack::contingency_analysis::WindDriver::execute(int argc, char** argv)
   int t_quantile = timer->createCategory("Quantile Analysis");
   timer->start(t_quantile);
   gridpack::contingency_analysis::QuantileAnalysis analysis(world,
-      4*bus_ids.size(),ntasks*numConfigs,nsteps-1);
+      4*bus_ids.size(),ntasks*numConfigs,nsteps-1,compression);
   timer->stop(t_quantile);
   // Construct variable names
   std::vector<std::string> var_names;
@@ -973,6 +948,7 @@ void gridpack::contingency_analysis::WindDriver::execute(int argc, char** argv)
 
   timer->start(t_quantile);
   analysis.exportQuantiles(quantiles, time_step);
+  if (export_stats) analysis.exportStatistics(time_step);
   timer->stop(t_quantile);
   timer->stop(t_total);
   if (ntasks*numConfigs >= world.size()/task_comm.size()) {
@@ -21,6 +21,7 @@
 #include "gridpack/include/gridpack.hpp"
 #include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
 #include "gridpack/applications/modules/dynamic_simulation_full_y/dsf_app_module.hpp"
+#include "quantile_sketch.hpp"
 
 namespace gridpack {
 namespace contingency_analysis {
@@ -29,13 +30,19 @@ class QuantileAnalysis
 {
   public:
   /**
-   * Basic constructor
+   * Basic constructor. Each processor keeps a quantile sketch for every
+   * watched variable and time step, so memory does not depend on the
+   * number of scenarios
    * @param comm communicator used for analysis
    * @param nwatch number of generators being watched
    * @param nconf number of scenarios
    * @param nsteps number of timesteps being stored
+   * @param compression number of centroids kept in each quantile sketch.
+   *                    Quantiles are exact if the number of scenarios does
+   *                    not exceed this value
    */
-  QuantileAnalysis(gridpack::parallel::Communicator comm, int nwatch, int nconf, int nsteps);
+  QuantileAnalysis(gridpack::parallel::Communicator comm, int nwatch, int nconf,
+      int nsteps, int compression = 100);
 
   /**
    * Basic destructor
@@ -43,7 +50,7 @@ class QuantileAnalysis
   ~QuantileAnalysis();
 
   /**
-   * Save data for a single time step for a single generator
+   * Add time series for a single generator to the quantile sketches
    * @param cfg_idx scenario index for time series
    * @param gen_idx generator index for time series
    * @param vals vector of time series values for a generator
@@ -57,26 +64,45 @@ class QuantileAnalysis
   void saveVarNames(std::vector<std::string> &names);
 
   /**
-   * Stream data in storage array
+   * Compress buffered values in the local quantile sketches
    */
   void writeData();
 
   /**
-   * Calculate quantiles and write them to a file
+   * Calculate quantiles and write them to a file. Scenarios that were not
+   * saved (e.g. because the power flow failed) are left out and the number
+   * of excluded scenarios is reported. This is collective on the
+   * communicator used for analysis
    * @param quantiles values describing quantiles to be calculated.
    *                  These values should be between 0 and 1.
    * @param dt magnitude time step (in seconds)
    */
   void exportQuantiles(std::vector<double> quantiles, double dt);
 
+  /**
+   * Write mean, standard deviation, minimum and maximum of each variable
+   * to a file with the suffix "_stats". This is collective on the
+   * communicator used for analysis
+   * @param dt magnitude time step (in seconds)
+   */
+  void exportStatistics(double dt);
+
   private:
 
+  /**
+   * Merge sketches from all processors onto process 0. This is only done
+   * once, after all data has been saved
+   */
+  void mergeSketches();
+
     gridpack::parallel::Communicator p_comm;
     int p_nwatch;
     std::vector<std::string> p_var_names;
     int p_nconf;
     int p_nsteps;
-    int p_GA;
+    // sketches for all watched variables and steps, ordered by variable
+    std::vector<QuantileSketch> p_sketches;
+    bool p_merged;
 };
 
 typedef gridpack::dynamic_simulation::DSFullNetwork DSFullNetwork;
@@ -163,6 +163,10 @@ void gridpack::contingency_analysis::WindDriver::execute2(int argc, char** argv)
   for (i=0; i<tokens.size(); i++) {
     quantiles.push_back(atof(tokens[i].c_str()));
   }
+  // Number of centroids kept in each quantile sketch
+  int compression = cursor->get("quantileCompression",100);
+  // Write mean, standard deviation, minimum and maximum to _stats files
+  bool export_stats = cursor->get("exportStatistics",false);
 
     /* Get list of generator watch */
   std::string watchlistfile;
@@ -284,7 +288,7 @@ void gridpack::contingency_analysis::WindDriver::execute2(int argc, char** argv)
 
   // Create distributed storage object
   gridpack::contingency_analysis::QuantileAnalysis analysis(world,
-      4*bus_ids.size(),ntasks*numConfigs,nsteps-1);
+      4*bus_ids.size(),ntasks*numConfigs,nsteps-1,compression);
   // Construct variable names
   std::vector<std::string> var_names;
   char sbuf[128];
@@ -466,6 +470,7 @@ void gridpack::contingency_analysis::WindDriver::execute2(int argc, char** argv)
   }
 
   analysis.exportQuantiles(quantiles, time_step);
+  if (export_stats) analysis.exportStatistics(time_step);
   timer->stop(t_total);
   if (ntasks*numConfigs >= world.size()/task_comm.size()) {
     timer->dump();
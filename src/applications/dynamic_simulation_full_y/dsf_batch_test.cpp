@@ -0,0 +1,272 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dsf_batch_test.cpp
+ *
+ * @brief
+ * Compare trajectories of watched generators from a dynamic simulation
+ * with and without batched integration of classical generators. The
+ * input file should contain a generator status event so that the set of
+ * active generators changes during the simulation. The observations in
+ * the input file are also checked against the values gathered with a
+ * single collective call.
+ */
+// -------------------------------------------------------------
+
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include <cmath>
+#include <vector>
+#include <string>
+#include "gridpack/parser/dictionary.hpp"
+#include "gridpack/math/math.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/applications/modules/dynamic_simulation_full_y/dsf_app_module.hpp"
+
+#define TOLERANCE 1.0e-8
+
+// Observations listed in the input file
+static const int obs_gen_bus[] = {60, 67, 79};
+static const int obs_bus[] = {6, 7, 60, 100};
+static const int obs_freq_bus[] = {60, 79};
+static const int nobs_gen = sizeof(obs_gen_bus)/sizeof(int);
+static const int nobs_bus = sizeof(obs_bus)/sizeof(int);
+static const int nobs_freq = sizeof(obs_freq_bus)/sizeof(int);
+
+/**
+ * Compare a list of observed buses with the expected list
+ * @param name type of observation
+ * @param buses list of observed buses
+ * @param expect expected list of buses
+ * @param nexpect length of expected list
+ * @return number of errors
+ */
+int check_list(const char *name, const std::vector<int> &buses,
+    const int *expect, int nexpect)
+{
+  gridpack::parallel::Communicator world;
+  int i;
+  if (buses.size() != nexpect) {
+    printf("p[%d] number of %s observations: %d expected: %d\n",
+        world.rank(),name,static_cast<int>(buses.size()),nexpect);
+    return 1;
+  }
+  for (i=0; i<nexpect; i++) {
+    if (buses[i] != expect[i]) {
+      printf("p[%d] %s observation %d is bus %d expected: %d\n",
+          world.rank(),name,i,buses[i],expect[i]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Check the observations gathered with a single collective call. The
+ * values must be the same on all processors, the root-only variant must
+ * deliver them to process 0 only, and the vectors returned by
+ * getObservations_withBusFreq must be slices of the same values
+ * @param ds_app dynamic simulation after setObservations has been called
+ * @param nchecked number of values checked
+ * @return number of errors on this processor
+ */
+int check_observations(gridpack::dynamic_simulation::DSFullApp &ds_app,
+    int &nchecked)
+{
+  gridpack::parallel::Communicator world;
+  int nerr = 0;
+  int i;
+  std::vector<int> genBuses, loadBuses, busIDs, freqIDs;
+  std::vector<std::string> genIDs, loadIDs;
+  ds_app.getObservationLists_withBusFreq(genBuses,genIDs,loadBuses,loadIDs,
+      busIDs,freqIDs);
+  nerr += check_list("generator",genBuses,obs_gen_bus,nobs_gen);
+  nerr += check_list("bus",busIDs,obs_bus,nobs_bus);
+  nerr += check_list("bus frequency",freqIDs,obs_freq_bus,nobs_freq);
+  for (i=0; i<genIDs.size(); i++) {
+    if (genIDs[i] != "1") {
+      printf("p[%d] generator observation %d has ID %s expected: 1\n",
+          world.rank(),i,genIDs[i].c_str());
+      nerr++;
+    }
+  }
+  if (loadBuses.size() != 0) {
+    printf("p[%d] unexpected load observations: %d\n",world.rank(),
+        static_cast<int>(loadBuses.size()));
+    nerr++;
+  }
+
+  // All values, delivered to all processors
+  std::vector<double> values;
+  ds_app.getObservationValues(values);
+  int nval = 4*nobs_gen+2*nobs_bus+nobs_freq;
+  if (values.size() != nval) {
+    printf("p[%d] number of observation values: %d expected: %d\n",
+        world.rank(),static_cast<int>(values.size()),nval);
+    nerr++;
+    values.resize(nval,0.0);
+  }
+  // Values must be identical on all processors
+  std::vector<double> sum(values);
+  world.sum(&sum[0],nval);
+  double nproc = static_cast<double>(world.size());
+  for (i=0; i<nval; i++) {
+    if (!(fabs(sum[i]-nproc*values[i]) <= TOLERANCE*nproc)) {
+      printf("p[%d] observation value %d: %f differs between processors\n",
+          world.rank(),i,values[i]);
+      nerr++;
+    }
+    nchecked++;
+  }
+
+  // Values delivered to process 0 only
+  std::vector<double> root;
+  ds_app.getObservationValues(root,true);
+  if (world.rank() == 0) {
+    if (root.size() != nval) {
+      printf("p[%d] number of root observation values: %d expected: %d\n",
+          world.rank(),static_cast<int>(root.size()),nval);
+      nerr++;
+    } else {
+      for (i=0; i<nval; i++) {
+        if (root[i] != values[i]) {
+          printf("p[%d] root observation value %d: %f expected: %f\n",
+              world.rank(),i,root[i],values[i]);
+          nerr++;
+        }
+      }
+    }
+  } else if (root.size() != 0) {
+    printf("p[%d] root observation values on process %d\n",
+        world.rank(),world.rank());
+    nerr++;
+  }
+
+  // Values returned separately must be slices of the packed values
+  std::vector<double> vMag, vAng, rSpd, rAng, genP, genQ, fOnline, busfreq;
+  ds_app.getObservations_withBusFreq(vMag,vAng,rSpd,rAng,genP,genQ,fOnline,
+      busfreq);
+  std::vector<double> slices;
+  slices.insert(slices.end(),rSpd.begin(),rSpd.end());
+  slices.insert(slices.end(),rAng.begin(),rAng.end());
+  slices.insert(slices.end(),genP.begin(),genP.end());
+  slices.insert(slices.end(),genQ.begin(),genQ.end());
+  slices.insert(slices.end(),vMag.begin(),vMag.end());
+  slices.insert(slices.end(),vAng.begin(),vAng.end());
+  slices.insert(slices.end(),fOnline.begin(),fOnline.end());
+  slices.insert(slices.end(),busfreq.begin(),busfreq.end());
+  if (slices != values) {
+    printf("p[%d] separate observations differ from packed values\n",
+        world.rank());
+    nerr++;
+  }
+  for (i=0; i<vMag.size(); i++) {
+    if (!(vMag[i] > 0.5 && vMag[i] < 1.5 && fabs(vAng[i]) <= M_PI)) {
+      printf("p[%d] bus %d observed V: %f Ang: %f\n",world.rank(),
+          obs_bus[i],vMag[i],vAng[i]);
+      nerr++;
+    }
+  }
+  return nerr;
+}
+
+/**
+ * Run dynamic simulation and return time series of watched generators
+ * @param inputfile name of input file
+ * @param batched if true, integrate generators in batches
+ * @param series time series of watched generators on this processor
+ * @param nchecked number of observation values checked
+ * @return number of errors in observations on this processor
+ */
+int run_dynamics(const std::string &inputfile, bool batched,
+    std::vector<std::vector<double> > &series, int &nchecked)
+{
+  gridpack::dynamic_simulation::DSFullApp ds_app;
+  ds_app.solvePowerFlowBeforeDynSimu(inputfile.c_str());
+  ds_app.readGenerators();
+  ds_app.readSequenceData();
+  ds_app.initialize();
+  ds_app.setBatchedModels(batched);
+  ds_app.saveTimeSeries(true);
+  ds_app.setGeneratorWatch();
+  // Set observations twice to check that the first set is replaced
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = gridpack::utility::Configuration::configuration()->getCursor(
+      "Configuration.Dynamic_simulation");
+  ds_app.setObservations(cursor);
+  ds_app.setObservations(cursor);
+  ds_app.setup();
+  ds_app.run();
+  series = ds_app.getGeneratorTimeSeries();
+  return check_observations(ds_app,nchecked);
+}
+
+int main(int argc, char **argv)
+{
+  gridpack::Environment env(argc, argv, NULL, 200000, 200000);
+  int nerr = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    std::string inputfile;
+    if (argc >= 2 && argv[1] != NULL) {
+      inputfile = argv[1];
+    } else {
+      inputfile = "input_145_gentrip.xml";
+    }
+
+    std::vector<std::vector<double> > ref, batch;
+    int nobs = 0;
+    nerr += run_dynamics(inputfile,false,ref,nobs);
+    nerr += run_dynamics(inputfile,true,batch,nobs);
+
+    int i, j;
+    int nchecked = 0;
+    if (ref.size() != batch.size()) {
+      printf("p[%d] number of time series differs: %d batched: %d\n",
+          world.rank(),static_cast<int>(ref.size()),
+          static_cast<int>(batch.size()));
+      nerr++;
+    } else {
+      for (i=0; i<ref.size(); i++) {
+        if (ref[i].size() != batch[i].size()) {
+          printf("p[%d] length of time series %d differs: %d batched: %d\n",
+              world.rank(),i,static_cast<int>(ref[i].size()),
+              static_cast<int>(batch[i].size()));
+          nerr++;
+          continue;
+        }
+        for (j=0; j<ref[i].size(); j++) {
+          if (!(fabs(ref[i][j]-batch[i][j]) <= TOLERANCE)) {
+            printf("p[%d] time series %d step %d: %f batched: %f\n",
+                world.rank(),i,j,ref[i][j],batch[i][j]);
+            nerr++;
+            break;
+          }
+          nchecked++;
+        }
+      }
+    }
+
+    world.sum(&nerr,1);
+    world.sum(&nchecked,1);
+    world.sum(&nobs,1);
+    if (nchecked == 0 || nobs == 0) nerr++;
+    if (world.rank() == 0) {
+      if (nerr == 0) {
+        printf("Batched generator test passed (%d values and %d"
+            " observations checked)\n",nchecked,nobs);
+      } else {
+        printf("Batched generator test failed with %d errors\n",nerr);
+      }
+    }
+  }
+
+  return (nerr == 0 ? 0 : 1);
+}
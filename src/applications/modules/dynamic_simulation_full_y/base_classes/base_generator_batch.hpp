@@ -0,0 +1,87 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   base_generator_batch.hpp
+ *
+ * @brief  Base class for groups of generators of the same model type that
+ * are integrated together. A batch replaces one virtual call per generator
+ * and integration phase with a single call per group that runs over
+ * contiguous arrays of model parameters and states.
+ *
+ *
+ */
+
+#ifndef _base_generator_batch_h_
+#define _base_generator_batch_h_
+
+#include "base_generator_model.hpp"
+
+namespace gridpack {
+namespace dynamic_simulation {
+class BaseGeneratorBatch
+{
+  public:
+    /**
+     * Basic constructor
+     */
+    BaseGeneratorBatch() {}
+
+    /**
+     * Basic destructor
+     */
+    virtual ~BaseGeneratorBatch() {}
+
+    /**
+     * Add a generator to the batch if it is of the type handled by the
+     * batch. Generators that are added are flagged as batched so that their
+     * bus skips them when it integrates its own devices.
+     * @param generator generator model
+     * @param status pointer to status flag of generator on its bus. The
+     * generator is only integrated while the status is non-zero
+     * @return true if generator was added to the batch
+     */
+    virtual bool add(BaseGeneratorModel *generator, const int *status) = 0;
+
+    /**
+     * Remove all generators from batch and return them to the bus
+     */
+    virtual void clear() = 0;
+
+    /**
+     * @return number of generators in batch
+     */
+    virtual int size() const = 0;
+
+    /**
+     * Predict part calculate current injections
+     * @param flag initial step if true
+     */
+    virtual void predictor_currentInjection(bool flag) = 0;
+
+    /**
+     * Corrector part calculate current injections
+     * @param flag initial step if true
+     */
+    virtual void corrector_currentInjection(bool flag) = 0;
+
+    /**
+     * Predict new state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    virtual void predictor(double t_inc, bool flag) = 0;
+
+    /**
+     * Correct state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    virtual void corrector(double t_inc, bool flag) = 0;
+};
+}  // dynamic_simulation
+}  // gridpack
+#endif
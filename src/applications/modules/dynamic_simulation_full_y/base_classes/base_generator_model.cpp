@@ -34,6 +34,7 @@ gridpack::dynamic_simulation::BaseGeneratorModel::BaseGeneratorModel(void) {
   p_hasAeroDynamicModel = false;
   p_hasDriveTrainModel = false;
   bStatus = true;
+  p_batched = false;
   p_generatorObservationPowerSystemBase = true;
   p_wideareafreq = 0.0;
 }
@@ -321,6 +322,21 @@ void gridpack::dynamic_simulation::BaseGeneratorModel::SetGenServiceStatus(
   bStatus = sta;
 }
 
+/**
+ * Mark generator as being integrated by a generator batch
+ * @param flag true if generator is part of a batch
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::setBatched(bool flag) {
+  p_batched = flag;
+}
+
+/**
+ * @return true if generator is integrated by a generator batch
+ */
+bool gridpack::dynamic_simulation::BaseGeneratorModel::getBatched() {
+  return p_batched;
+}
+
 /**
  * return a vector containing any generator values that are being
  * watched
@@ -214,6 +214,18 @@ public:
    */
   void SetGenServiceStatus(bool sta);
 
+  /**
+   * Mark generator as being integrated by a generator batch. Batched
+   * generators are skipped by the predictor and corrector loops of their bus
+   * @param flag true if generator is part of a batch
+   */
+  void setBatched(bool flag);
+
+  /**
+   * @return true if generator is integrated by a generator batch
+   */
+  bool getBatched();
+
   /**
    * return a vector containing any generator values that are being
    * watched
@@ -265,6 +277,7 @@ private:
 
   bool p_watch;
   bool bStatus;
+  bool p_batched;
   std::vector<boost::shared_ptr<BaseRelayModel> >
       vp_relay; // renke add, relay vector
 };
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include "gridpack/utilities/string_utils.hpp"
+#include "gridpack/timer/trace_timer.hpp"
 
 using namespace std;
 
@@ -54,8 +55,13 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(void)
   bapplyLoadChangeP = false;
   bapplyLoadChangeQ = false;
   p_report_dummy_obs = false;
+  p_reportFactorizations = false;
+  for (int i=0; i<4; i++) p_obs_nReport[i] = 0;
   p_biterative_solve_network = false;
   p_iterative_network_debug = false;
+  p_batchedModels = false;
+  p_weightedPartition = false;
+  p_rebalanceTolerance = 0.0;
   p_generator_observationpower_systembase = true;
   ITER_TOL = 1.0e-7;
   MAX_ITR_NO = 8;
@@ -86,8 +92,13 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(gridpack::parallel::Communica
   bapplyLoadChangeP = false;
   bapplyLoadChangeQ = false;
   p_report_dummy_obs = false;
+  p_reportFactorizations = false;
+  for (int i=0; i<4; i++) p_obs_nReport[i] = 0;
   p_biterative_solve_network = false;
   p_iterative_network_debug = false;
+  p_batchedModels = false;
+  p_weightedPartition = false;
+  p_rebalanceTolerance = 0.0;
   ITER_TOL = 1.0e-7;
   MAX_ITR_NO = 8;
   
@@ -206,6 +217,10 @@ void gridpack::dynamic_simulation::DSFullApp::readNetwork(
   //--------------whether iteratively compute network current-----------
   p_biterative_solve_network = cursor->get("iterativeNetworkInterface",false);
   p_iterative_network_debug = cursor->get("iterativeNetworkInterfaceDebugPrint",false);
+  p_reportFactorizations = cursor->get("reportFactorizations",false);
+  p_batchedModels = cursor->get("batchedModels",false);
+  p_weightedPartition = cursor->get("weightedPartition",false);
+  p_rebalanceTolerance = cursor->get("rebalanceTolerance",0.0);
   
   ITER_TOL = cursor->get("iterativeNetworkInterfaceTol", 1.0e-7);
   MAX_ITR_NO = cursor->get("iterativeNetworkInterfaceMaxItrNo", 8);
@@ -280,6 +295,8 @@ void gridpack::dynamic_simulation::DSFullApp::setNetwork(
   //--------------whether iteratively compute network current-----------
   p_biterative_solve_network = cursor->get("iterativeNetworkInterface",false);
   p_iterative_network_debug = cursor->get("iterativeNetworkInterfaceDebugPrint",false);
+  p_reportFactorizations = cursor->get("reportFactorizations",false);
+  p_batchedModels = cursor->get("batchedModels",false);
   p_generator_observationpower_systembase = cursor->get("generatorObservationPowerSystemBase",true);
   
   ITER_TOL = cursor->get("iterativeNetworkInterfaceTol", 1.0e-7);
@@ -364,6 +381,41 @@ void gridpack::dynamic_simulation::DSFullApp::initialize()
   // p_factory->dumpData();
   p_factory->load();
 
+  // Partition network again with costs based on the Y-matrix and the
+  // dynamic models on each bus. Buses and branches move, so the factory has
+  // to be created and loaded again
+  if (p_weightedPartition) {
+    p_factory->setComponents();
+    p_factory->setMode(YBUS);
+    std::vector<int> busWeights, branchWeights;
+    p_factory->partitionWeights(busWeights,branchWeights);
+    p_factory.reset();
+    p_network->partition(busWeights,branchWeights);
+    p_weightedPartition = false;
+    p_factory.reset(new gridpack::dynamic_simulation::DSFullFactory(p_network));
+    p_factory->load();
+  }
+
+  // Rebalance the existing partition with the same costs. Only buses on
+  // processes whose cost exceeds the average by more than the tolerance
+  // move to neighboring processes, so this is much cheaper than a new
+  // partition. The factory is created again for the new local buses.
+  if (p_rebalanceTolerance > 0.0) {
+    p_factory->setComponents();
+    p_factory->setMode(YBUS);
+    std::vector<int> busWeights, branchWeights;
+    p_factory->partitionWeights(busWeights,branchWeights);
+    std::vector<double> weights(busWeights.begin(), busWeights.end());
+    p_factory.reset();
+    int moved = p_network->repartition(weights, p_rebalanceTolerance);
+    p_rebalanceTolerance = 0.0;
+    if (p_comm.rank() == 0) {
+      printf("Rebalanced network by moving %d buses\n",moved);
+    }
+    p_factory.reset(new gridpack::dynamic_simulation::DSFullFactory(p_network));
+    p_factory->load();
+  }
+
   // set network components using factory
   p_factory->setComponents();
   
@@ -559,6 +611,7 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   
   // Initialize vectors for integration 
   p_factory->initDSVect(p_time_step);
+  p_factory->setBatchedModels(p_batchedModels);
   
   p_factory->setGeneratorObPowerBaseFlag(p_generator_observationpower_systembase);
   //exit(0);
@@ -1310,6 +1363,22 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   }
   p_busIO->header(secureBuf);
 
+  // Report how often the network matrices were factored. With a constant
+  // Y-matrix, factorizations should only occur when the fault is applied
+  // or cleared
+  if (p_reportFactorizations) {
+    char factorBuf[256];
+    sprintf(factorBuf,"\nNetwork solver factorizations (symbolic/numeric):"
+        " Y %d/%d fault Y %d/%d post-fault Y %d/%d\n",
+        solver_sptr->symbolicFactorizations(),
+        solver_sptr->numericFactorizations(),
+        solver_fy_sptr->symbolicFactorizations(),
+        solver_fy_sptr->numericFactorizations(),
+        solver_posfy_sptr->symbolicFactorizations(),
+        solver_posfy_sptr->numericFactorizations());
+    p_busIO->header(factorBuf);
+  }
+
 #ifdef MAP_PROFILE
   timer->configTimer(true);
 #endif
@@ -1679,6 +1748,17 @@ void gridpack::dynamic_simulation::DSFullApp::saveTimeSeries(bool flag)
   p_save_time_series = flag;
 }
 
+/**
+ * Integrate generators of supported model types in batches. This
+ * overrides the batchedModels setting in the input file and must be
+ * called before the simulation is set up
+ * @param flag if true, integrate generators in batches
+ */
+void gridpack::dynamic_simulation::DSFullApp::setBatchedModels(bool flag)
+{
+  p_batchedModels = flag;
+}
+
 /**
  * Save time series data for watched generators
  */
@@ -1967,8 +2047,22 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
   gridpack::utility::Configuration::ChildCursors observations;
   p_obs_genBus.clear();
   p_obs_genIDs.clear();
+  p_obs_loadBus.clear();
+  p_obs_loadIDs.clear();
   p_obs_vBus.clear();
   p_obs_vBusfreq.clear();
+  p_obs_GenIdx.clear();
+  p_obs_LoadIdx.clear();
+  p_obs_VIdx.clear();
+  p_obs_VIdxfreq.clear();
+  p_obs_vUsefreq.clear();
+  p_obs_lGenIdx.clear();
+  p_obs_lLoadIdx.clear();
+  p_obs_lVIdx.clear();
+  p_obs_lVIdxfreq.clear();
+  p_obs_gUse.clear();
+  p_obs_lUse.clear();
+  p_obs_vUse.clear();
   gridpack::utility::StringUtils util;
   // Parser observation block
   std::vector<int> foundGen;
@@ -2023,16 +2117,7 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
       }
     }
   }
-  // create global vectors to store values of observations. Check to see if
-  // any observations are on this processor
-  p_obs_vMag.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_vAng.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_vBusfreqVal.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_rSpd.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_rAng.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_genP.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_genQ.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
-  p_obs_fOnline.reset(new gridpack::parallel::GlobalVector<double>(p_comm));
+  // Check to see if any observations are on this processor
   if (p_obs_genBus.size() > 0) {
     int nbus = p_obs_genBus.size();
     p_obs_gActive.resize(nbus);
@@ -2040,8 +2125,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
     p_obs_lGenIDs.clear();
     p_obs_lGenIdx.clear();
     p_obs_gUse.clear();
-    std::vector<double> zeros;
-    std::vector<double> ones;
     int i, j, k, lidx;
     for (i = 0; i<nbus; i++) {
       std::vector<int> localIndices;
@@ -2072,8 +2155,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
         p_obs_lGenBus.push_back(p_obs_genBus[i]);
         p_obs_lGenIDs.push_back(p_obs_genIDs[i]);
         p_obs_gUse.push_back(0);
-        zeros.push_back(0.0);
-        ones.push_back(1.0);
       }
     }
     // Sum foundGen vector over all processors to find out if any observations
@@ -2088,20 +2169,10 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
           p_obs_lGenBus.push_back(p_obs_genBus[i]);
           p_obs_lGenIDs.push_back(p_obs_genIDs[i]);
           p_obs_gUse.push_back(1);
-          zeros.push_back(0.0);
-          ones.push_back(1.0);
         }
       }
     }
-    p_obs_rSpd->addElements(p_obs_lGenIdx, zeros);
-    p_obs_rSpd->upload();
-    p_obs_rAng->addElements(p_obs_lGenIdx, zeros);
-    p_obs_rAng->upload();
-    p_obs_genP->addElements(p_obs_lGenIdx, zeros);
-    p_obs_genP->upload();
-    p_obs_genQ->addElements(p_obs_lGenIdx, zeros);
-    p_obs_genQ->upload();
-    p_comm.sum(&p_obs_gActive[0],p_comm.size());
+    p_comm.sum(&p_obs_gActive[0],p_obs_gActive.size());
   }
   if (p_obs_loadBus.size() > 0) {
     int nbus = p_obs_loadBus.size();
@@ -2110,7 +2181,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
     p_obs_lLoadIDs.clear();
     p_obs_lLoadIdx.clear();
     p_obs_lUse.clear();
-    std::vector<double> ones;
     int i, j, k, lidx;
     for (i = 0; i<nbus; i++) {
       std::vector<int> localIndices;
@@ -2151,7 +2221,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
         p_obs_lLoadBus.push_back(p_obs_loadBus[i]);
         p_obs_lLoadIDs.push_back(p_obs_loadIDs[i]);
         p_obs_lUse.push_back(0);
-        ones.push_back(1.0);
       }
     }
     // Sum foundLoad vector over all processors to find out if any observations
@@ -2166,13 +2235,10 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
           p_obs_lLoadBus.push_back(p_obs_loadBus[i]);
           p_obs_lLoadIDs.push_back(p_obs_loadIDs[i]);
           p_obs_lUse.push_back(1);
-          ones.push_back(1.0);
         }
       }
     }
-    p_obs_fOnline->addElements(p_obs_lLoadIdx, ones);
-    p_obs_fOnline->upload();
-    p_comm.sum(&p_obs_lActive[0],p_comm.size());
+    p_comm.sum(&p_obs_lActive[0],p_obs_lActive.size());
   }
   if (p_obs_vBus.size() > 0) {
     int nbus = p_obs_vBus.size();
@@ -2180,8 +2246,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
     p_obs_lVBus.clear();
     p_obs_lVIdx.clear();
     p_obs_vUse.clear();
-    std::vector<double> zeros;
-    std::vector<double> ones;
     int i, j, lidx;
     for (i = 0; i<nbus; i++) {
       std::vector<int> localIndices;
@@ -2202,8 +2266,6 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
         p_obs_VIdx.push_back(lidx);
         p_obs_lVBus.push_back(p_obs_vBus[i]);
         p_obs_vUse.push_back(0);
-        zeros.push_back(0.0);
-        ones.push_back(1.0);
       }
     }
     // Sum foundBus vector over all processors to find out if any observations
@@ -2217,23 +2279,16 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
           p_obs_VIdx.push_back(-1);
           p_obs_lVBus.push_back(p_obs_vBus[i]);
           p_obs_vUse.push_back(1);
-          zeros.push_back(0.0);
-          ones.push_back(1.0);
         }
       }
     }
-    p_obs_vMag->addElements(p_obs_lVIdx, ones);
-    p_obs_vMag->upload();
-    p_obs_vAng->addElements(p_obs_lVIdx, zeros);
-    p_obs_vAng->upload();
-    p_comm.sum(&p_obs_vActive[0],p_comm.size());
+    p_comm.sum(&p_obs_vActive[0],p_obs_vActive.size());
   }
   if (p_obs_vBusfreq.size() > 0) {  // this is for bus frequency ob
     int nbusfreq = p_obs_vBusfreq.size();
     p_obs_vActivefreq.resize(nbusfreq);
     p_obs_lVBusfreq.clear();
     p_obs_lVIdxfreq.clear();
-    std::vector<double> ones;
     int i, j, lidx;
     for (i = 0; i<nbusfreq; i++) {
       std::vector<int> localIndicesfreq;
@@ -2252,9 +2307,8 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
         foundBusfreq[i] = 1;
         p_obs_lVIdxfreq.push_back(i);
         p_obs_VIdxfreq.push_back(lidx);
-        p_obs_lVBusfreq.push_back(p_obs_vBus[i]);
+        p_obs_lVBusfreq.push_back(p_obs_vBusfreq[i]);
         p_obs_vUsefreq.push_back(0);
-        ones.push_back(1.0);
 
         //need to setup Busfreq computation flag for this specific bus  here!!!!!!!!!!!!!!
         p_network->getBus(lidx)->setBusVolFrequencyFlag(true);
@@ -2270,17 +2324,133 @@ void gridpack::dynamic_simulation::DSFullApp::setObservations(
         if (!foundBusfreq[i]) {
           p_obs_lVIdxfreq.push_back(i);
           p_obs_VIdxfreq.push_back(-1);
-          p_obs_lVBusfreq.push_back(p_obs_vBus[i]);
+          p_obs_lVBusfreq.push_back(p_obs_vBusfreq[i]);
           p_obs_vUsefreq.push_back(1);
-          ones.push_back(1.0);
         }
       }
     }
-    p_obs_vBusfreqVal->addElements(p_obs_lVIdxfreq, ones);
-    p_obs_vBusfreqVal->upload();
-    p_comm.sum(&p_obs_vActivefreq[0],p_comm.size());
+    p_comm.sum(&p_obs_vActivefreq[0],p_obs_vActivefreq.size());
   } //bus frequency ob ends here
-    
+  setupObservationPlan();
+}
+
+/**
+ * Find device slots of local observations and set up the layout of
+ * the gathered observation buffer. Called at the end of
+ * setObservations
+ */
+void gridpack::dynamic_simulation::DSFullApp::setupObservationPlan()
+{
+  int i, j;
+  int ngen = p_obs_genBus.size();
+  int nbus = p_obs_vBus.size();
+  int nload = p_obs_loadBus.size();
+  int nfreq = p_obs_vBusfreq.size();
+  int nproc = p_comm.size();
+  // Find generator and dynamic load slots on host buses
+  int nlgen = p_obs_lGenIdx.size();
+  p_obs_genSlot.assign(nlgen,-1);
+  for (i=0; i<nlgen; i++) {
+    if (p_obs_gUse[i]) continue;
+    std::vector<std::string> tags
+      = p_network->getBus(p_obs_GenIdx[i])->getGenerators();
+    for (j=0; j<tags.size(); j++) {
+      if (tags[j] == p_obs_lGenIDs[i]) {
+        p_obs_genSlot[i] = j;
+        break;
+      }
+    }
+  }
+  int nlload = p_obs_lLoadIdx.size();
+  p_obs_loadSlot.assign(nlload,-1);
+  for (i=0; i<nlload; i++) {
+    if (p_obs_lUse[i]) continue;
+    std::vector<std::string> tags
+      = p_network->getBus(p_obs_LoadIdx[i])->getDynamicLoads();
+    for (j=0; j<tags.size(); j++) {
+      if (tags[j] == p_obs_lLoadIDs[i]) {
+        p_obs_loadSlot[i] = j;
+        break;
+      }
+    }
+  }
+  // Location of local values in the full list of observations. The full
+  // list contains rotor speed, rotor angle, real power and reactive power
+  // of all generators followed by voltage magnitude and angle of all
+  // buses, online fraction of all loads and frequency of all buses
+  int nlbus = p_obs_lVIdx.size();
+  int nlfreq = p_obs_lVIdxfreq.size();
+  int offset;
+  std::vector<int> lpos;
+  for (j=0; j<4; j++) {
+    for (i=0; i<nlgen; i++) lpos.push_back(j*ngen+p_obs_lGenIdx[i]);
+  }
+  offset = 4*ngen;
+  for (j=0; j<2; j++) {
+    for (i=0; i<nlbus; i++) lpos.push_back(offset+j*nbus+p_obs_lVIdx[i]);
+  }
+  offset += 2*nbus;
+  for (i=0; i<nlload; i++) lpos.push_back(offset+p_obs_lLoadIdx[i]);
+  offset += nload;
+  for (i=0; i<nlfreq; i++) lpos.push_back(offset+p_obs_lVIdxfreq[i]);
+  offset += nfreq;
+  p_obs_full.assign(offset,0.0);
+  p_obs_sendBuf.resize(lpos.size());
+
+  // Exchange the layout of all processors once
+  int nlocal = lpos.size();
+  p_obs_counts.resize(nproc);
+  p_obs_displs.resize(nproc);
+  MPI_Comm comm = static_cast<MPI_Comm>(p_comm);
+  MPI_Allgather(&nlocal,1,MPI_INT,&p_obs_counts[0],1,MPI_INT,comm);
+  int ntot = 0;
+  for (i=0; i<nproc; i++) {
+    p_obs_displs[i] = ntot;
+    ntot += p_obs_counts[i];
+  }
+  p_obs_pos.resize(ntot);
+  p_obs_recvBuf.resize(ntot);
+  if (ntot > 0) {
+    if (nlocal == 0) lpos.push_back(0);
+    MPI_Allgatherv(&lpos[0],nlocal,MPI_INT,&p_obs_pos[0],&p_obs_counts[0],
+        &p_obs_displs[0],MPI_INT,comm);
+  }
+
+  // Entries of the full list that are reported
+  p_obs_report.clear();
+  for (j=0; j<4; j++) {
+    for (i=0; i<ngen; i++) {
+      if (p_report_dummy_obs || p_obs_gActive[i]) {
+        p_obs_report.push_back(j*ngen+i);
+      }
+    }
+  }
+  p_obs_nReport[0] = p_obs_report.size()/4;
+  offset = 4*ngen;
+  for (j=0; j<2; j++) {
+    for (i=0; i<nbus; i++) {
+      if (p_report_dummy_obs || p_obs_vActive[i]) {
+        p_obs_report.push_back(offset+j*nbus+i);
+      }
+    }
+  }
+  p_obs_nReport[1] = (p_obs_report.size()-4*p_obs_nReport[0])/2;
+  offset += 2*nbus;
+  p_obs_nReport[2] = 0;
+  for (i=0; i<nload; i++) {
+    if (p_report_dummy_obs || p_obs_lActive[i]) {
+      p_obs_report.push_back(offset+i);
+      p_obs_nReport[2]++;
+    }
+  }
+  offset += nload;
+  p_obs_nReport[3] = 0;
+  for (i=0; i<nfreq; i++) {
+    if (p_report_dummy_obs || p_obs_vActivefreq[i]) {
+      p_obs_report.push_back(offset+i);
+      p_obs_nReport[3]++;
+    }
+  }
 }
 
 /**
@@ -2423,168 +2593,25 @@ void gridpack::dynamic_simulation::DSFullApp::getObservations(
 	std::vector<double> &genP, std::vector<double> &genQ,
     std::vector<double> &fOnline)
 {
-  vMag.clear(); 
-  vAng.clear(); 
-  rSpd.clear(); 
-  rAng.clear(); 
-  genP.clear(); 
-  genQ.clear();
-  fOnline.clear(); 
-  std::vector<double> tvMag;
-  std::vector<double> tvAng;
-  std::vector<double> trSpd;
-  std::vector<double> trAng;
-  std::vector<double> tgenP;
-  std::vector<double> tgenQ;
-  std::vector<double> tfOnline;
-  bool use;
-  if (p_obs_genBus.size()) {
-    int i, j;
-    int nbus =  p_obs_lGenBus.size();
-    for (i=0; i<nbus; i++) {
-      if (!static_cast<bool>(p_obs_gUse[i])) {
-        std::vector<std::string> tags
-          = p_network->getBus(p_obs_GenIdx[i])->getGenerators();
-        for (j=0; j<tags.size(); j++) {
-          if (tags[j] == p_obs_lGenIDs[i]) {
-            double speed, angle, gPtmp, gQtmp;
-            p_network->getBus(p_obs_GenIdx[i])->getWatchedValues(j,&speed,&angle, &gPtmp, &gQtmp);
-            trSpd.push_back(speed);
-            trAng.push_back(angle);
-            tgenP.push_back(gPtmp);
-            tgenQ.push_back(gQtmp);
-            break;
-          }
-        }
-      } else {
-        trSpd.push_back(0.0);
-        trAng.push_back(0.0);
-        tgenP.push_back(0.0);
-        tgenQ.push_back(0.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lGenIdx.size() != trSpd.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_rSpd->resetElements(p_obs_lGenIdx, trSpd);
-    p_obs_rSpd->reload();
-    p_obs_rSpd->getAllData(trSpd);
-    p_obs_rAng->resetElements(p_obs_lGenIdx, trAng);
-    p_obs_rAng->reload();
-    p_obs_rAng->getAllData(trAng);
-	
-	p_obs_genP->resetElements(p_obs_lGenIdx, tgenP);
-    p_obs_genP->reload();
-    p_obs_genP->getAllData(tgenP);
-	p_obs_genQ->resetElements(p_obs_lGenIdx, tgenQ);
-    p_obs_genQ->reload();
-    p_obs_genQ->getAllData(tgenQ);
-	
-    nbus = trSpd.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_gActive[i]);
-      }
-      if (use) {
-        rSpd.push_back(trSpd[i]);
-        rAng.push_back(trAng[i]);
-        genP.push_back(tgenP[i]);
-        genQ.push_back(tgenQ[i]);
-
-      }
-    }
-  }
-  if (p_obs_loadBus.size()) {
-    int i, j;
-    int nbus =  p_obs_lLoadBus.size();
-    for (i=0; i<nbus; i++) {
-      bool found = false;
-      if (!static_cast<bool>(p_obs_lUse[i])) {
-        std::vector<std::string> tags
-          = p_network->getBus(p_obs_LoadIdx[i])->getDynamicLoads();
-        for (j=0; j<tags.size(); j++) {
-          if (tags[j] == p_obs_lLoadIDs[i]) {
-            double frac;
-            frac = p_network->getBus(p_obs_LoadIdx[i])->getOnlineLoadFraction(j);
-            tfOnline.push_back(frac);
-            found = true;
-            break;
-          }
-        }
-      } else {
-        tfOnline.push_back(1.0);
-        found = true;
-      }
-      if (!found) {
-        tfOnline.push_back(1.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lLoadIdx.size() != tfOnline.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_fOnline->resetElements(p_obs_lLoadIdx, tfOnline);
-    p_obs_fOnline->reload();
-    p_obs_fOnline->getAllData(tfOnline);
-    nbus = tfOnline.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_lActive[i]);
-      }
-      if (use) {
-        fOnline.push_back(tfOnline[i]);
-      }
-    }
-  }
-  if (p_obs_vBus.size() > 0) {
-    int i, j;
-    int nbus =  p_obs_lVBus.size();
-    for (i=0; i<nbus; i++) {
-      if (!static_cast<bool>(p_obs_vUse[i])) {
-        gridpack::ComplexType voltage =
-          p_network->getBus(p_obs_VIdx[i])->getComplexVoltage();
-        double rV = real(voltage);
-        double iV = imag(voltage);
-        double V = sqrt(rV*rV+iV*iV);
-        double Ang = acos(rV/V);
-        if (iV < 0) {
-          Ang = -Ang;
-        }
-        tvMag.push_back(V);
-        tvAng.push_back(Ang);
-      } else {
-        tvMag.push_back(1.0);
-        tvAng.push_back(0.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lVIdx.size() != tvMag.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_vMag->resetElements(p_obs_lVIdx, tvMag);
-    p_obs_vMag->reload();
-    p_obs_vMag->getAllData(tvMag);
-    p_obs_vAng->resetElements(p_obs_lVIdx, tvAng);
-    p_obs_vAng->reload();
-    p_obs_vAng->getAllData(tvAng);
-    nbus = tvMag.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_vActive[i]);
-      }
-      if (use) {
-        vMag.push_back(tvMag[i]);
-        vAng.push_back(tvAng[i]);
-      }
-    }
-  }
+  std::vector<double> values;
+  getObservationValues(values);
+  int ngen = p_obs_nReport[0];
+  int nbus = p_obs_nReport[1];
+  int nload = p_obs_nReport[2];
+  std::vector<double>::iterator it = values.begin();
+  rSpd.assign(it, it+ngen);
+  it += ngen;
+  rAng.assign(it, it+ngen);
+  it += ngen;
+  genP.assign(it, it+ngen);
+  it += ngen;
+  genQ.assign(it, it+ngen);
+  it += ngen;
+  vMag.assign(it, it+nbus);
+  it += nbus;
+  vAng.assign(it, it+nbus);
+  it += nbus;
+  fOnline.assign(it, it+nload);
 }
 
 /**
@@ -2604,206 +2631,126 @@ void gridpack::dynamic_simulation::DSFullApp::getObservations_withBusFreq(
 	std::vector<double> &genP, std::vector<double> &genQ,
     std::vector<double> &fOnline, std::vector<double> &busfreq)
 {
-  vMag.clear(); 
-  vAng.clear(); 
-  rSpd.clear(); 
-  rAng.clear(); 
-  genP.clear(); 
-  genQ.clear();
-  fOnline.clear(); 
-  busfreq.clear();
-  std::vector<double> tvMag;
-  std::vector<double> tvAng;
-  std::vector<double> trSpd;
-  std::vector<double> trAng;
-  std::vector<double> tgenP;
-  std::vector<double> tgenQ;
-  std::vector<double> tfOnline;
-  std::vector<double> tbusfreq;
-  bool use;
-  if (p_obs_genBus.size()) {
-    int i, j;
-    int nbus =  p_obs_lGenBus.size();
-    for (i=0; i<nbus; i++) {
-      if (!static_cast<bool>(p_obs_gUse[i])) {
-        std::vector<std::string> tags
-          = p_network->getBus(p_obs_GenIdx[i])->getGenerators();
-        for (j=0; j<tags.size(); j++) {
-          if (tags[j] == p_obs_lGenIDs[i]) {
-            double speed, angle, gPtmp, gQtmp;
-            p_network->getBus(p_obs_GenIdx[i])->getWatchedValues(j,&speed,&angle, &gPtmp, &gQtmp);
-            trSpd.push_back(speed);
-            trAng.push_back(angle);
-            tgenP.push_back(gPtmp);
-            tgenQ.push_back(gQtmp);
-            break;
-          }
-        }
-      } else {
-        trSpd.push_back(0.0);
-        trAng.push_back(0.0);
-        tgenP.push_back(0.0);
-        tgenQ.push_back(0.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lGenIdx.size() != trSpd.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_rSpd->resetElements(p_obs_lGenIdx, trSpd);
-    p_obs_rSpd->reload();
-    p_obs_rSpd->getAllData(trSpd);
-    p_obs_rAng->resetElements(p_obs_lGenIdx, trAng);
-    p_obs_rAng->reload();
-    p_obs_rAng->getAllData(trAng);
-	
-	p_obs_genP->resetElements(p_obs_lGenIdx, tgenP);
-    p_obs_genP->reload();
-    p_obs_genP->getAllData(tgenP);
-	p_obs_genQ->resetElements(p_obs_lGenIdx, tgenQ);
-    p_obs_genQ->reload();
-    p_obs_genQ->getAllData(tgenQ);
-	
-    nbus = trSpd.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_gActive[i]);
-      }
-      if (use) {
-        rSpd.push_back(trSpd[i]);
-        rAng.push_back(trAng[i]);
-		genP.push_back(tgenP[i]);
-		genQ.push_back(tgenQ[i]);
-		
-      }
+  std::vector<double> values;
+  getObservationValues(values);
+  int ngen = p_obs_nReport[0];
+  int nbus = p_obs_nReport[1];
+  int nload = p_obs_nReport[2];
+  int nfreq = p_obs_nReport[3];
+  std::vector<double>::iterator it = values.begin();
+  rSpd.assign(it, it+ngen);
+  it += ngen;
+  rAng.assign(it, it+ngen);
+  it += ngen;
+  genP.assign(it, it+ngen);
+  it += ngen;
+  genQ.assign(it, it+ngen);
+  it += ngen;
+  vMag.assign(it, it+nbus);
+  it += nbus;
+  vAng.assign(it, it+nbus);
+  it += nbus;
+  fOnline.assign(it, it+nload);
+  it += nload;
+  busfreq.assign(it, it+nfreq);
+}
+
+/**
+ * Get current values of all observations in a single vector. Values
+ * are packed on each processor and delivered with one collective
+ * call. The vector contains rotor speed, rotor angle, real power and
+ * reactive power of observed generators, voltage magnitude and angle
+ * of observed buses, online load fraction of observed loads and
+ * frequency of observed buses, in that order
+ * @param values current values of observations
+ * @param rootOnly if true, only process 0 receives the values and
+ * the vector is empty on all other processes
+ */
+void gridpack::dynamic_simulation::DSFullApp::getObservationValues(
+    std::vector<double> &values, bool rootOnly)
+{
+  values.clear();
+  int ntot = p_obs_pos.size();
+  if (ntot == 0) return;
+  int i;
+  int nlgen = p_obs_lGenIdx.size();
+  int nlbus = p_obs_lVIdx.size();
+  int nlload = p_obs_lLoadIdx.size();
+  int nlfreq = p_obs_lVIdxfreq.size();
+  // Pack local values in the order set up in setupObservationPlan
+  double *buf = p_obs_sendBuf.empty() ? NULL : &p_obs_sendBuf[0];
+  for (i=0; i<nlgen; i++) {
+    double speed = 0.0;
+    double angle = 0.0;
+    double genP = 0.0;
+    double genQ = 0.0;
+    if (p_obs_genSlot[i] >= 0) {
+      p_network->getBus(p_obs_GenIdx[i])->getWatchedValues(p_obs_genSlot[i],
+          &speed,&angle,&genP,&genQ);
     }
+    buf[i] = speed;
+    buf[nlgen+i] = angle;
+    buf[2*nlgen+i] = genP;
+    buf[3*nlgen+i] = genQ;
   }
-  if (p_obs_loadBus.size()) {
-    int i, j;
-    int nbus =  p_obs_lLoadBus.size();
-    for (i=0; i<nbus; i++) {
-      bool found = false;
-      if (!static_cast<bool>(p_obs_lUse[i])) {
-        std::vector<std::string> tags
-          = p_network->getBus(p_obs_LoadIdx[i])->getDynamicLoads();
-        for (j=0; j<tags.size(); j++) {
-          if (tags[j] == p_obs_lLoadIDs[i]) {
-            double frac;
-            frac = p_network->getBus(p_obs_LoadIdx[i])->getOnlineLoadFraction(j);
-            tfOnline.push_back(frac);
-            found = true;
-            break;
-          }
-        }
-      } else {
-        tfOnline.push_back(1.0);
-        found = true;
-      }
-      if (!found) {
-        tfOnline.push_back(1.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lLoadIdx.size() != tfOnline.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_fOnline->resetElements(p_obs_lLoadIdx, tfOnline);
-    p_obs_fOnline->reload();
-    p_obs_fOnline->getAllData(tfOnline);
-    nbus = tfOnline.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_lActive[i]);
-      }
-      if (use) {
-        fOnline.push_back(tfOnline[i]);
+  buf += 4*nlgen;
+  for (i=0; i<nlbus; i++) {
+    double V = 1.0;
+    double Ang = 0.0;
+    if (!static_cast<bool>(p_obs_vUse[i])) {
+      gridpack::ComplexType voltage =
+        p_network->getBus(p_obs_VIdx[i])->getComplexVoltage();
+      double rV = real(voltage);
+      double iV = imag(voltage);
+      V = sqrt(rV*rV+iV*iV);
+      Ang = acos(rV/V);
+      if (iV < 0) {
+        Ang = -Ang;
       }
     }
+    buf[i] = V;
+    buf[nlbus+i] = Ang;
   }
-  
-  if (p_obs_vBus.size() > 0) {
-    int i, j;
-    int nbus =  p_obs_lVBus.size();
-    for (i=0; i<nbus; i++) {
-      if (!static_cast<bool>(p_obs_vUse[i])) {
-        gridpack::ComplexType voltage =
-          p_network->getBus(p_obs_VIdx[i])->getComplexVoltage();
-        double rV = real(voltage);
-        double iV = imag(voltage);
-        double V = sqrt(rV*rV+iV*iV);
-        double Ang = acos(rV/V);
-        if (iV < 0) {
-          Ang = -Ang;
-        }
-        tvMag.push_back(V);
-        tvAng.push_back(Ang);
-      } else {
-        tvMag.push_back(1.0);
-        tvAng.push_back(0.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lVIdx.size() != tvMag.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors\n");
-    }
-    p_obs_vMag->resetElements(p_obs_lVIdx, tvMag);
-    p_obs_vMag->reload();
-    p_obs_vMag->getAllData(tvMag);
-    p_obs_vAng->resetElements(p_obs_lVIdx, tvAng);
-    p_obs_vAng->reload();
-    p_obs_vAng->getAllData(tvAng);
-    nbus = tvMag.size();
-    for (i=0; i<nbus; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_vActive[i]);
-      }
-      if (use) {
-        vMag.push_back(tvMag[i]);
-        vAng.push_back(tvAng[i]);
-      }
+  buf += 2*nlbus;
+  for (i=0; i<nlload; i++) {
+    double frac = 1.0;
+    if (p_obs_loadSlot[i] >= 0) {
+      frac = p_network->getBus(p_obs_LoadIdx[i])->getOnlineLoadFraction(
+          p_obs_loadSlot[i]);
     }
+    buf[i] = frac;
   }
-  
-  if (p_obs_vBusfreq.size() > 0) { // bus frequency ob get
-    int i, j;
-    int nbusfreq =  p_obs_lVBusfreq.size();
-	double dbusfreqtmp;
-    for (i=0; i<nbusfreq; i++) {
-      if (!static_cast<bool>(p_obs_vUsefreq[i])) {
-        dbusfreqtmp = p_network->getBus(p_obs_VIdxfreq[i])->getBusVolFrequency();
-        tbusfreq.push_back(dbusfreqtmp);
-      } else {
-        tbusfreq.push_back(0.0);
-      }
-    }
-    // Check to make sure that local vectors still match
-    if (p_obs_lVIdxfreq.size() != tbusfreq.size()) {
-      printf("Mismatch in vector sizes when resetting global vectors for bus frequency observations\n");
-    }
-    p_obs_vBusfreqVal->resetElements(p_obs_lVIdxfreq, tbusfreq);
-    p_obs_vBusfreqVal->reload();
-    p_obs_vBusfreqVal->getAllData(tbusfreq);
-	
-    nbusfreq = tbusfreq.size();
-    for (i=0; i<nbusfreq; i++) {
-      if (p_report_dummy_obs) {
-        use = true;
-      } else {
-        use = static_cast<bool>(p_obs_vActivefreq[i]);
-      }
-      if (use) {
-        busfreq.push_back(tbusfreq[i]);
-      }
+  buf += nlload;
+  for (i=0; i<nlfreq; i++) {
+    double freq = 0.0;
+    if (!static_cast<bool>(p_obs_vUsefreq[i])) {
+      freq = p_network->getBus(p_obs_VIdxfreq[i])->getBusVolFrequency();
     }
+    buf[i] = freq;
+  }
+
+  // Deliver all values with a single collective
+  int me = p_comm.rank();
+  int nlocal = p_obs_sendBuf.size();
+  double dummy = 0.0;
+  double *sbuf = nlocal > 0 ? &p_obs_sendBuf[0] : &dummy;
+  MPI_Comm comm = static_cast<MPI_Comm>(p_comm);
+  if (rootOnly) {
+    MPI_Gatherv(sbuf,nlocal,MPI_DOUBLE,&p_obs_recvBuf[0],&p_obs_counts[0],
+        &p_obs_displs[0],MPI_DOUBLE,0,comm);
+    if (me != 0) return;
+  } else {
+    MPI_Allgatherv(sbuf,nlocal,MPI_DOUBLE,&p_obs_recvBuf[0],&p_obs_counts[0],
+        &p_obs_displs[0],MPI_DOUBLE,comm);
+  }
+  for (i=0; i<ntot; i++) {
+    p_obs_full[p_obs_pos[i]] = p_obs_recvBuf[i];
+  }
+  int nreport = p_obs_report.size();
+  values.resize(nreport);
+  for (i=0; i<nreport; i++) {
+    values[i] = p_obs_full[p_obs_report[i]];
   }
-  
-  
 }
 
 /**
@@ -2904,6 +2851,25 @@ void gridpack::dynamic_simulation::DSFullApp::solvePreInitialize(
 
   t_misc = timer->createCategory("DS Solve: Miscellaneous");
   t_presolve = timer->createCategory("DS App: solvePreInitialize");
+  // Categories used in each call to executeOneSimuStep are created here so
+  // that they are not looked up by name on every time step
+  t_execute_steps = timer->createCategory("DS Solve: execute steps");
+  t_mIf = timer->createCategory("DS Solve: Modified Euler Predictor: Make INorton");
+  t_psolve = timer->createCategory("DS Solve: Modified Euler Predictor: Linear Solver");
+  t_vmap= timer->createCategory("DS Solve: Map Volt to Bus");
+  t_volt= timer->createCategory("DS Solve: Set Volt");
+  t_predictor = timer->createCategory("DS Solve: Modified Euler Predictor");
+  t_cmIf = timer->createCategory("DS Solve: Modified Euler Corrector: Make INorton");
+  t_csolve = timer->createCategory("DS Solve: Modified Euler Corrector: Linear Solver");
+  t_corrector = timer->createCategory("DS Solve: Modified Euler Corrector");
+  t_secure = timer->createCategory("DS Solve: Check Security");
+  gridpack::utility::TraceTimer *trace =
+    gridpack::utility::TraceTimer::instance();
+  tr_psolve = trace->registerRegion("Predictor: Linear Solver");
+  tr_csolve = trace->registerRegion("Corrector: Linear Solver");
+  tr_predictor = trace->registerRegion("Predictor");
+  tr_corrector = trace->registerRegion("Corrector");
+  tr_secure = trace->registerRegion("Check Security");
 #ifdef MAP_PROFILE
   timer->configTimer(false);
 #endif
@@ -3051,6 +3017,7 @@ void gridpack::dynamic_simulation::DSFullApp::solvePreInitialize(
   
   // Initialize vectors for integration 
   p_factory->initDSVect(p_time_step);
+  p_factory->setBatchedModels(p_batchedModels);
   
   p_factory->setGeneratorObPowerBaseFlag(p_generator_observationpower_systembase);
   //exit(0);
@@ -3138,8 +3105,10 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 	
     gridpack::utility::CoarseTimer *timer =
     gridpack::utility::CoarseTimer::instance();
+    gridpack::utility::TraceTimer *trace =
+    gridpack::utility::TraceTimer::instance();
+    GRIDPACK_TRACE_SCOPE("DS Solve: Time Step");
 
-    t_execute_steps = timer->createCategory("DS Solve: execute steps");
 	timer->start(t_execute_steps);
 	
   //for (Simu_Current_Step = 0; Simu_Current_Step < simu_total_steps - 1; Simu_Current_Step++) {
@@ -3258,7 +3227,6 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 #ifdef MAP_PROFILE
   timer->configTimer(true);
 #endif
-    t_mIf = timer->createCategory("DS Solve: Modified Euler Predictor: Make INorton");
     timer->start(t_mIf);
 	p_factory->setMode(make_INorton_full);
     nbusMap_sptr->mapToVector(INorton_full);
@@ -3274,8 +3242,8 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
  
     // ---------- CALL ssnetwork_cal_volt(S_Steps+1, flagF2) 
     // to calculate terminal volt: ----------
-    t_psolve = timer->createCategory("DS Solve: Modified Euler Predictor: Linear Solver");
     timer->start(t_psolve);
+    trace->begin(tr_psolve);
     //boost::shared_ptr<gridpack::math::Vector> volt_full(INorton_full->clone());
     volt_full->zero();
 	
@@ -3355,6 +3323,7 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
       solver_posfy_sptr->solve(*INorton_full, *volt_full);
     }
   } // end of if (p_biterative_solve_network)
+    trace->end(tr_psolve);
     timer->stop(t_psolve);
 
 #ifdef MAP_PROFILE
@@ -3366,7 +3335,6 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
     //	 exit(0);
    //	}
 
-    t_vmap= timer->createCategory("DS Solve: Map Volt to Bus");
     timer->start(t_vmap);
 	
 	//printf("after first volt sovle, before first volt map: \n");
@@ -3382,7 +3350,6 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 	}
     timer->stop(t_vmap);
 
-    t_volt= timer->createCategory("DS Solve: Set Volt");
     timer->start(t_volt);
     p_factory->setVolt(false);
 	p_factory->updateBusFreq(h_sol1);
@@ -3532,14 +3499,15 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
   timer->configTimer(false);
 #endif
 
-    t_predictor = timer->createCategory("DS Solve: Modified Euler Predictor");
     //printf("Test: predictor begins: \n");
     timer->start(t_predictor);
+    trace->begin(tr_predictor);
     if (Simu_Current_Step !=0 && last_S_Steps != S_Steps) {
       p_factory->predictor(h_sol1, false);
     } else { 
       p_factory->predictor(h_sol1, true);
     }
+    trace->end(tr_predictor);
     timer->stop(t_predictor);
 
     
@@ -3551,7 +3519,6 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
     
 
     //INorton_full = nbusMap_sptr->mapToVector();
-    t_cmIf = timer->createCategory("DS Solve: Modified Euler Corrector: Make INorton");
     timer->start(t_cmIf);
     p_factory->setMode(make_INorton_full);
     nbusMap_sptr->mapToVector(INorton_full);
@@ -3562,8 +3529,8 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 
     // ---------- CALL ssnetwork_cal_volt(S_Steps+1, flagF2)
     // to calculate terminal volt: ----------
-    t_csolve = timer->createCategory("DS Solve: Modified Euler Corrector: Linear Solver");
     timer->start(t_csolve);
+    trace->begin(tr_csolve);
     
     volt_full->zero();
 
@@ -3626,6 +3593,7 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
     }
   } //p_biterative_solve_network end here
 
+    trace->end(tr_csolve);
     timer->stop(t_csolve);
 
     //p_busIO->header("\n=== [Corrector] volt_full: ===\n");
@@ -3648,14 +3616,15 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 	p_factory->updateBusFreq(h_sol1);
     timer->stop(t_volt);
 
-    t_corrector = timer->createCategory("DS Solve: Modified Euler Corrector");
     timer->start(t_corrector);
+    trace->begin(tr_corrector);
     //printf("Test: corrector begins: \n");
     if (last_S_Steps != S_Steps) {
       p_factory->corrector(h_sol2, false);
     } else {
       p_factory->corrector(h_sol2, true);
     }
+    trace->end(tr_corrector);
     timer->stop(t_corrector);
 
     //if (Simu_Current_Step == simu_total_steps - 1) 
@@ -3663,8 +3632,8 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 
 
     //printf("----------!renke debug, after solve INorton_full and map back voltage ----------\n");
-    t_secure = timer->createCategory("DS Solve: Check Security");
     timer->start(t_secure);
+    trace->begin(tr_secure);
     if (p_generatorWatch && Simu_Current_Step%p_generatorWatchFrequency == 0) {
       char tbuf[32];
       if (!p_suppress_watch_files) {
@@ -3759,6 +3728,7 @@ void gridpack::dynamic_simulation::DSFullApp::executeOneSimuStep( ){
 
 */    //exit(0);
     last_S_Steps = S_Steps;
+    trace->end(tr_secure);
     timer->stop(t_secure);
     if (p_monitorGenerators) {
       double presentTime = static_cast<double>(Simu_Current_Step)*p_time_step;
@@ -348,6 +348,14 @@ class DSFullApp
      */
     void saveTimeSeries(bool flag);
 
+    /**
+     * Integrate generators of supported model types in batches. This
+     * overrides the batchedModels setting in the input file and must be
+     * called before the simulation is set up
+     * @param flag if true, integrate generators in batches
+     */
+    void setBatchedModels(bool flag);
+
     /**
      * Return global map of timer series values
      * @return map of time series indices (local to global)
@@ -515,6 +523,20 @@ class DSFullApp
 		std::vector<double> &genP, std::vector<double> &genQ,
 		std::vector<double> &fOnline, std::vector<double> &busfreq);
 
+    /**
+     * Get current values of all observations in a single vector. Values
+     * are packed on each processor and delivered with one collective
+     * call. The vector contains rotor speed, rotor angle, real power and
+     * reactive power of observed generators, voltage magnitude and angle
+     * of observed buses, online load fraction of observed loads and
+     * frequency of observed buses, in that order
+     * @param values current values of observations
+     * @param rootOnly if true, only process 0 receives the values and
+     * the vector is empty on all other processes
+     */
+    void getObservationValues(std::vector<double> &values,
+        bool rootOnly = false);
+
     /**
      * Return values for total active and reactive load power on bus
      * @param bus_id original bus index
@@ -816,6 +838,13 @@ class DSFullApp
      */
     void closeLoadWatchFile();
 
+    /**
+     * Find device slots of local observations and set up the layout of
+     * the gathered observation buffer. Called at the end of
+     * setObservations
+     */
+    void setupObservationPlan();
+
     /**
      * Save time series data for watched generators
      */
@@ -857,6 +886,10 @@ class DSFullApp
         int bus_id, std::string gen_id, std::string genParam, T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      // Resolve data collection keys once instead of for every lookup
+      static const gridpack::component::DataKey numKey(GENERATOR_NUMBER);
+      static const gridpack::component::DataKey idKey(GENERATOR_ID);
+      gridpack::component::DataKey paramKey(genParam);
       if (indices.size() > 0) {
         int i;
         bool ret = false;
@@ -864,14 +897,14 @@ class DSFullApp
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           int ngen;
-          if (data->getValue(GENERATOR_NUMBER, &ngen)) {
+          if (data->getValue(numKey, &ngen)) {
             int igen = -1;
             T tval;
             int j;
             std::string gID;
             for (j = 0; j<ngen; j++) {
               // Get index of generator
-              if (data->getValue(GENERATOR_ID,&gID,j)) {
+              if (data->getValue(idKey,&gID,j)) {
                 if (gID == gen_id) {
                   igen = j;
                   break;
@@ -879,7 +912,7 @@ class DSFullApp
               }
             }
             if (igen >= 0) {
-              if (data->setValue(genParam.c_str(),value,igen)) {
+              if (data->setValue(paramKey,value,igen)) {
                 ret = true;
               }
             }
@@ -905,6 +938,9 @@ class DSFullApp
           std::string loadParam, T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      static const gridpack::component::DataKey numKey(LOAD_NUMBER);
+      static const gridpack::component::DataKey idKey(LOAD_ID);
+      gridpack::component::DataKey paramKey(loadParam);
       if (indices.size() > 0) {
         int i;
         bool ret = false;
@@ -912,13 +948,13 @@ class DSFullApp
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           int nload;
-          if (data->getValue(LOAD_NUMBER, &nload)) {
+          if (data->getValue(numKey, &nload)) {
             int iload = -1;
             T tval;
             int j;
             std::string lID;
             for (j = 0; j<nload; j++) {
-              if (data->getValue(LOAD_ID,&lID,j)) {
+              if (data->getValue(idKey,&lID,j)) {
                 if (lID == load_id) {
                   iload = j;
                   break;
@@ -926,7 +962,7 @@ class DSFullApp
               }
             }
             if (iload >= 0) {
-              if (data->setValue(loadParam.c_str(),value,iload)) {
+              if (data->setValue(paramKey,value,iload)) {
                 ret = true;
               }
             }
@@ -951,6 +987,7 @@ class DSFullApp
         T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      gridpack::component::DataKey paramKey(busParam);
       if (indices.size() > 0) {
         int i;
         bool ret = false;
@@ -958,7 +995,7 @@ class DSFullApp
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           T tval;
-          if (data->setValue(busParam.c_str(),value)) {
+          if (data->setValue(paramKey,value)) {
             ret = true;
           }
         }
@@ -985,6 +1022,19 @@ class DSFullApp
 	
 	// whether print out debug information for iteratively solve the network interface 
 	bool p_iterative_network_debug;
+
+	// whether to report the number of network matrix factorizations
+	bool p_reportFactorizations;
+
+	// whether generators of supported model types are integrated in batches
+	bool p_batchedModels;
+
+	// partition network again in initialize() using estimated costs
+	bool p_weightedPartition;
+
+	// if positive, rebalance the partition in initialize() using estimated
+	// costs when the largest cost exceeds this multiple of the average
+	double p_rebalanceTolerance;
 	
 	//for the generator observations, output the generator power based on system base or generator base
 	bool p_generator_observationpower_systembase;
@@ -1127,14 +1177,22 @@ class DSFullApp
    std::vector<int> p_obs_vActivefreq;
    std::vector<int> p_obs_vUsefreq;
 
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_vMag;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_vAng;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_vBusfreqVal;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_rSpd;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_rAng;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_genP;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_genQ;
-   boost::shared_ptr<gridpack::parallel::GlobalVector<double> > p_obs_fOnline;
+   // Observation plan. Device slots of local generator and load
+   // observations are found once, local values are packed into a single
+   // buffer and p_obs_pos holds the location of each gathered value in
+   // p_obs_full. p_obs_report lists the entries of p_obs_full that are
+   // reported and p_obs_nReport the number of reported generators, buses,
+   // loads and bus frequencies
+   std::vector<int> p_obs_genSlot;
+   std::vector<int> p_obs_loadSlot;
+   std::vector<int> p_obs_counts;
+   std::vector<int> p_obs_displs;
+   std::vector<int> p_obs_pos;
+   std::vector<int> p_obs_report;
+   int p_obs_nReport[4];
+   std::vector<double> p_obs_sendBuf;
+   std::vector<double> p_obs_recvBuf;
+   std::vector<double> p_obs_full;
    
    // below are all variables originally defined the solve function, now define them as class private members
    boost::shared_ptr < gridpack::mapper::FullMatrixMap<DSFullNetwork> > ybusMap_sptr;  
@@ -1195,6 +1253,13 @@ class DSFullApp
    int t_corrector;
    int t_secure;
    int t_cmIf;
+
+   // handles for hierarchical timing of the time step
+   int tr_psolve;
+   int tr_csolve;
+   int tr_predictor;
+   int tr_corrector;
+   int tr_secure;
    
 };
 
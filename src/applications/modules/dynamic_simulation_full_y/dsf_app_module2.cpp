@@ -187,6 +187,7 @@ void gridpack::dynamic_simulation::DSFullApp::setup()
 
   // Initialize vectors for integration 
   p_factory->initDSVect(p_time_step);
+  p_factory->setBatchedModels(p_batchedModels);
   
   p_factory->setGeneratorObPowerBaseFlag(p_generator_observationpower_systembase);
 
@@ -664,6 +664,7 @@ void gridpack::dynamic_simulation::DSFullBus::predictor_currentInjection(bool fl
   int i;
   for (i = 0; i < p_ngen; i++) {
     if(!p_gstatus[i] || !p_generators.size()) continue;
+    if(p_generators[i]->getBatched()) continue;
     p_generators[i]->predictor_currentInjection(flag);
   }
   
@@ -689,6 +690,7 @@ void gridpack::dynamic_simulation::DSFullBus::predictor(double t_inc, bool flag)
   int i;
   for (i = 0; i < p_ngen; i++) {
     if(!p_gstatus[i] || !p_generators.size()) continue;
+    if(p_generators[i]->getBatched()) continue;
     p_generators[i]->predictor(t_inc,flag);
   }
   
@@ -708,6 +710,7 @@ void gridpack::dynamic_simulation::DSFullBus::corrector_currentInjection(bool fl
   int i;
   for (i = 0; i < p_ngen; i++) {
     if(!p_gstatus[i] || !p_generators.size()) continue;
+    if(p_generators[i]->getBatched()) continue;
     p_generators[i]->corrector_currentInjection(flag);
   }
   
@@ -732,6 +735,7 @@ void gridpack::dynamic_simulation::DSFullBus::corrector(double t_inc, bool flag)
   int i;
   for (i = 0; i < p_ngen; i++) {
     if(!p_gstatus[i] || !p_generators.size()) continue;
+    if(p_generators[i]->getBatched()) continue;
     p_generators[i]->corrector(t_inc,flag);
   }
   
@@ -741,6 +745,39 @@ void gridpack::dynamic_simulation::DSFullBus::corrector(double t_inc, bool flag)
   }
 }
 
+/**
+ * Hand generators on this bus to the first batch that accepts them
+ * @param batches list of generator batches
+ */
+void gridpack::dynamic_simulation::DSFullBus::batchGenerators(
+    std::vector<boost::shared_ptr<BaseGeneratorBatch> > &batches)
+{
+  int i, j;
+  for (i = 0; i < p_ngen && i < p_generators.size(); i++) {
+    for (j = 0; j < batches.size(); j++) {
+      if (batches[j]->add(p_generators[i].get(), &p_gstatus[i])) break;
+    }
+  }
+}
+
+/**
+ * Get the number of dynamic models on this bus
+ * @return number of dynamic models
+ */
+int gridpack::dynamic_simulation::DSFullBus::getModelCount()
+{
+  int i;
+  int count = p_ndyn_load;
+  for (i = 0; i < p_ngen && i < p_generators.size(); i++) {
+    if (!p_gstatus[i]) continue;
+    count++;
+    if (p_generators[i]->getExciter()) count++;
+    if (p_generators[i]->getGovernor()) count++;
+    if (p_generators[i]->getPss()) count++;
+  }
+  return count;
+}
+
 void gridpack::dynamic_simulation::DSFullBus::setWideAreaFreqforPSS(double freq){
 	
   int i;
@@ -18,6 +18,7 @@
 #include "generator_factory.hpp"
 #include "relay_factory.hpp"
 #include "load_factory.hpp"
+#include "base_generator_batch.hpp"
 
 namespace gridpack {
 namespace dynamic_simulation {
@@ -208,6 +209,22 @@ class DSFullBus
      * @param flag initial step if true
      */
     void corrector(double t_inc, bool flag);
+
+    /**
+     * Hand generators on this bus to the first batch that accepts them.
+     * Batched generators are integrated by the batch instead of the bus
+     * @param batches list of generator batches
+     */
+    void batchGenerators(
+        std::vector<boost::shared_ptr<BaseGeneratorBatch> > &batches);
+
+    /**
+     * Get the number of dynamic models on this bus. This includes active
+     * generators and their exciters, governors and stabilizers and all
+     * dynamic loads
+     * @return number of dynamic models
+     */
+    int getModelCount();
 	
 	/**
      * Update dynamic load internal relays action
@@ -7,6 +7,8 @@
 #include <vector>
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "dsf_factory.hpp"
+#include "classical_batch.hpp"
+#include "genrou_batch.hpp"
 
 namespace gridpack {
 namespace dynamic_simulation {
@@ -49,6 +51,7 @@ DSFullFactory::DSFullFactory(DSFullFactory::NetworkPtr network)
  */
 gridpack::dynamic_simulation::DSFullFactory::~DSFullFactory()
 {
+  setBatchedModels(false);
   delete [] p_buses;
   delete [] p_branches;
 #ifdef USE_FNCS
@@ -195,6 +198,9 @@ void gridpack::dynamic_simulation::DSFullFactory::predictor_currentInjection(boo
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->predictor_currentInjection(flag);
   }
+  for (i=0; i<p_genBatches.size(); i++) {
+    p_genBatches[i]->predictor_currentInjection(flag);
+  }
 }
 
 /**
@@ -208,6 +214,9 @@ void gridpack::dynamic_simulation::DSFullFactory::predictor(double t_inc, bool f
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->predictor(t_inc,flag);
   }
+  for (i=0; i<p_genBatches.size(); i++) {
+    p_genBatches[i]->predictor(t_inc,flag);
+  }
 }
 
 /**
@@ -221,6 +230,9 @@ void gridpack::dynamic_simulation::DSFullFactory::corrector_currentInjection(boo
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->corrector_currentInjection(flag);
   }
+  for (i=0; i<p_genBatches.size(); i++) {
+    p_genBatches[i]->corrector_currentInjection(flag);
+  }
 }
 
 /**
@@ -234,6 +246,50 @@ void gridpack::dynamic_simulation::DSFullFactory::corrector(double t_inc, bool f
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->corrector(t_inc,flag);
   }
+  for (i=0; i<p_genBatches.size(); i++) {
+    p_genBatches[i]->corrector(t_inc,flag);
+  }
+}
+
+/**
+ * Integrate generators of supported model types in batches
+ * @param flag if true, create generator batches, otherwise remove them
+ */
+void gridpack::dynamic_simulation::DSFullFactory::setBatchedModels(bool flag)
+{
+  int i;
+  for (i=0; i<p_genBatches.size(); i++) {
+    p_genBatches[i]->clear();
+  }
+  p_genBatches.clear();
+  if (!flag) return;
+
+  p_genBatches.push_back(boost::shared_ptr<BaseGeneratorBatch>(
+        new ClassicalGeneratorBatch));
+  p_genBatches.push_back(boost::shared_ptr<BaseGeneratorBatch>(
+        new GenrouGeneratorBatch));
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->batchGenerators(p_genBatches);
+  }
+}
+
+/**
+ * Estimate the cost of each bus and branch for partitioning the network
+ * @param busWeights cost of each local bus
+ * @param branchWeights cost of cutting each local branch
+ */
+void gridpack::dynamic_simulation::DSFullFactory::partitionWeights(
+    std::vector<int> &busWeights, std::vector<int> &branchWeights)
+{
+  // Relative cost of integrating one dynamic model compared to one
+  // matrix entry
+  const int modelCost = 4;
+  gridpack::factory::BaseFactory<DSFullNetwork>::partitionWeights(busWeights,
+      branchWeights);
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    busWeights[i] += modelCost*p_buses[i]->getModelCount();
+  }
 }
 
 /**
@@ -96,6 +96,29 @@ class DSFullFactory
      * Update vectors in each integration time step (Corrector)
      */
     void corrector(double t_inc, bool flag);
+
+    /**
+     * Integrate generators of supported model types in batches instead of
+     * one generator at a time. Classical (GENCLS) generators and round
+     * rotor (GENROU) generators without controls or with EXDC1 exciters
+     * and TGOV1 governors are batched; all other models are integrated by
+     * their bus
+     * @param flag if true, create generator batches, otherwise remove them
+     */
+    void setBatchedModels(bool flag);
+
+    /**
+     * Estimate the cost of each bus and branch for partitioning the
+     * network. In addition to the matrix blocks counted by the base
+     * factory, each dynamic model (generator, exciter, governor,
+     * stabilizer and dynamic load) on a bus is counted as several matrix
+     * entries, since most of the time in each step is spent integrating
+     * the models
+     * @param busWeights cost of each local bus
+     * @param branchWeights cost of cutting each local branch
+     */
+    void partitionWeights(std::vector<int> &busWeights,
+        std::vector<int> &branchWeights);
 	
 	/**
      * Update dynamic load internal relays action
@@ -244,6 +267,8 @@ class DSFullFactory
     int p_numBranch;
 
     DSFullBranch **p_branches;
+
+    std::vector<boost::shared_ptr<BaseGeneratorBatch> > p_genBatches;
 };
 
 } // dynamic_simulation
@@ -173,6 +173,7 @@ class ClassicalGenerator : public BaseGeneratorModel
     double IrNorton, IiNorton;
 
     friend class boost::serialization::access;
+    friend class ClassicalGeneratorBatch;
 
     template<class Archive>
       void serialize(Archive & ar, const unsigned int version)
@@ -0,0 +1,347 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -----------------------------------------------------------
+/**
+ * @file   classical_batch.cpp
+ *
+ * @brief
+ *
+ *
+ */
+
+#include <vector>
+#include <cmath>
+
+#include "classical_batch.hpp"
+
+/**
+ *  Basic constructor
+ */
+gridpack::dynamic_simulation::ClassicalGeneratorBatch::ClassicalGeneratorBatch(void)
+{
+  p_nactive = 0;
+  p_gathered = false;
+  double sysFreq = 60.0;
+  p_basrad = 2.0*4.0*atan(1.0)*sysFreq;
+}
+
+/**
+ *  Basic destructor
+ */
+gridpack::dynamic_simulation::ClassicalGeneratorBatch::~ClassicalGeneratorBatch(void)
+{
+  clear();
+}
+
+/**
+ * Add a generator to the batch if it is a classical generator
+ * @param generator generator model
+ * @param status pointer to status flag of generator on its bus
+ * @return true if generator was added to the batch
+ */
+bool gridpack::dynamic_simulation::ClassicalGeneratorBatch::add(
+    BaseGeneratorModel *generator, const int *status)
+{
+  ClassicalGenerator *gen = dynamic_cast<ClassicalGenerator*>(generator);
+  if (gen == NULL) return false;
+  gen->setBatched(true);
+  p_generators.push_back(gen);
+  p_status.push_back(status);
+  return true;
+}
+
+/**
+ * Remove all generators from batch and return them to the bus
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::clear()
+{
+  int i;
+  for (i=0; i<p_generators.size(); i++) {
+    p_generators[i]->setBatched(false);
+  }
+  p_generators.clear();
+  p_status.clear();
+  p_active.clear();
+  p_nactive = 0;
+  p_gathered = false;
+}
+
+/**
+ * @return number of generators in batch
+ */
+int gridpack::dynamic_simulation::ClassicalGeneratorBatch::size() const
+{
+  return p_generators.size();
+}
+
+/**
+ * Check the status of all generators in the batch. If the set of
+ * active generators has changed since the last phase, states of the
+ * previously active generators are copied back to the generator objects
+ * and the batch arrays are filled again from the new set
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::updateActive()
+{
+  bool changed = !p_gathered;
+  int i, n;
+  n = 0;
+  for (i=0; i<p_generators.size() && !changed; i++) {
+    if (*p_status[i]) {
+      if (n >= p_nactive || p_active[n] != p_generators[i]) changed = true;
+      n++;
+    }
+  }
+  if (n != p_nactive) changed = true;
+  if (!changed) return;
+  if (p_gathered) scatterStates();
+  gather();
+  p_gathered = true;
+}
+
+/**
+ * Find active generators and copy their parameters and states into
+ * the batch arrays
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::gather()
+{
+  int i, n;
+  p_active.resize(p_generators.size());
+  n = 0;
+  for (i=0; i<p_generators.size(); i++) {
+    if (*p_status[i]) {
+      p_active[n] = p_generators[i];
+      n++;
+    }
+  }
+  p_nactive = n;
+  if (p_dtr.size() < n) {
+    p_dtr.resize(n);
+    p_scale.resize(n);
+    p_2h.resize(n);
+    p_d0.resize(n);
+    p_pmech.resize(n);
+    p_eqprime_r.resize(n);
+    p_eqprime_i.resize(n);
+    p_volt_r.resize(n);
+    p_volt_i.resize(n);
+    p_ang_s0.resize(n);
+    p_spd_s0.resize(n);
+    p_ang_s1.resize(n);
+    p_spd_s1.resize(n);
+    p_dang_s0.resize(n);
+    p_dspd_s0.resize(n);
+    p_dang_s1.resize(n);
+    p_dspd_s1.resize(n);
+    p_eprime_r_s0.resize(n);
+    p_eprime_i_s0.resize(n);
+    p_eprime_r_s1.resize(n);
+    p_eprime_i_s1.resize(n);
+    p_inorton_r.resize(n);
+    p_inorton_i.resize(n);
+    p_pelect.resize(n);
+    p_genP.resize(n);
+    p_genQ.resize(n);
+  }
+  for (i=0; i<n; i++) {
+    const ClassicalGenerator *gen = p_active[i];
+    p_dtr[i] = gen->p_dtr;
+    p_scale[i] = gen->p_mva/gen->p_sbase;
+    p_2h[i] = 2.0*gen->p_h;
+    p_d0[i] = gen->p_d0;
+    p_pmech[i] = real(gen->p_pmech);
+    p_eqprime_r[i] = real(gen->p_eqprime);
+    p_eqprime_i[i] = imag(gen->p_eqprime);
+    p_ang_s0[i] = real(gen->p_mac_ang_s0);
+    p_spd_s0[i] = real(gen->p_mac_spd_s0);
+    p_ang_s1[i] = real(gen->p_mac_ang_s1);
+    p_spd_s1[i] = real(gen->p_mac_spd_s1);
+    p_dang_s0[i] = real(gen->p_dmac_ang_s0);
+    p_dspd_s0[i] = real(gen->p_dmac_spd_s0);
+    p_dang_s1[i] = real(gen->p_dmac_ang_s1);
+    p_dspd_s1[i] = real(gen->p_dmac_spd_s1);
+    p_eprime_r_s0[i] = real(gen->p_eprime_s0);
+    p_eprime_i_s0[i] = imag(gen->p_eprime_s0);
+    p_eprime_r_s1[i] = real(gen->p_eprime_s1);
+    p_eprime_i_s1[i] = imag(gen->p_eprime_s1);
+    p_pelect[i] = real(gen->p_pelect);
+    p_genP[i] = gen->genP;
+    p_genQ[i] = gen->genQ;
+  }
+}
+
+/**
+ * Copy terminal voltages of active generators into the batch arrays
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::gatherVoltage()
+{
+  int i;
+  for (i=0; i<p_nactive; i++) {
+    p_volt_r[i] = real(p_active[i]->p_volt);
+    p_volt_i[i] = imag(p_active[i]->p_volt);
+  }
+}
+
+/**
+ * Copy states at the end of the last step to the start of the current
+ * step
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::shiftStates()
+{
+  int i;
+  const int n = p_nactive;
+  for (i=0; i<n; i++) {
+    p_ang_s0[i] = p_ang_s1[i];
+    p_spd_s0[i] = p_spd_s1[i];
+    p_eprime_r_s0[i] = p_eprime_r_s1[i];
+    p_eprime_i_s0[i] = p_eprime_i_s1[i];
+  }
+}
+
+/**
+ * Copy Norton currents of active generators back to generator objects
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::scatterINorton()
+{
+  int i;
+  for (i=0; i<p_nactive; i++) {
+    p_active[i]->p_INorton = gridpack::ComplexType(p_inorton_r[i],
+        p_inorton_i[i]);
+  }
+}
+
+/**
+ * Copy states of active generators back to generator objects
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::scatterStates()
+{
+  int i;
+  for (i=0; i<p_nactive; i++) {
+    ClassicalGenerator *gen = p_active[i];
+    gen->p_mac_ang_s0 = p_ang_s0[i];
+    gen->p_mac_spd_s0 = p_spd_s0[i];
+    gen->p_mac_ang_s1 = p_ang_s1[i];
+    gen->p_mac_spd_s1 = p_spd_s1[i];
+    gen->p_dmac_ang_s0 = p_dang_s0[i];
+    gen->p_dmac_spd_s0 = p_dspd_s0[i];
+    gen->p_dmac_ang_s1 = p_dang_s1[i];
+    gen->p_dmac_spd_s1 = p_dspd_s1[i];
+    gen->p_eprime_s0 = gridpack::ComplexType(p_eprime_r_s0[i],
+        p_eprime_i_s0[i]);
+    gen->p_eprime_s1 = gridpack::ComplexType(p_eprime_r_s1[i],
+        p_eprime_i_s1[i]);
+    gen->p_pelect = p_pelect[i];
+    gen->genP = p_genP[i];
+    gen->genQ = p_genQ[i];
+  }
+}
+
+/**
+ * Predict part calculate current injections
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::predictor_currentInjection(bool flag)
+{
+  updateActive();
+  if (!flag) shiftStates();
+  int i;
+  const int n = p_nactive;
+  // INorton = eprime/(j*dtr)*mva/sbase
+  for (i=0; i<n; i++) {
+    p_inorton_r[i] = p_eprime_i_s0[i]/p_dtr[i]*p_scale[i];
+    p_inorton_i[i] = -p_eprime_r_s0[i]/p_dtr[i]*p_scale[i];
+  }
+  scatterINorton();
+}
+
+/**
+ * Predict new state variables for time step
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::predictor(
+    double t_inc, bool flag)
+{
+  updateActive();
+  if (!flag) shiftStates();
+  gatherVoltage();
+  int i;
+  const int n = p_nactive;
+  const double basrad = p_basrad;
+  for (i=0; i<n; i++) {
+    // terminal curr: curr = conj((eprime - volt) / (j*GEN_dtr))
+    double curr_r = (p_eprime_i_s0[i] - p_volt_i[i])/p_dtr[i];
+    double curr_i = (p_eprime_r_s0[i] - p_volt_r[i])/p_dtr[i];
+    p_pelect[i] = p_eprime_r_s0[i]*curr_r - p_eprime_i_s0[i]*curr_i;
+    p_genP[i] = p_volt_r[i]*curr_r - p_volt_i[i]*curr_i;
+    p_genQ[i] = p_volt_r[i]*curr_i + p_volt_i[i]*curr_r;
+    p_dang_s0[i] = (p_spd_s0[i] - 1.0) * basrad;
+    p_dspd_s0[i] = ((p_pmech[i] - p_d0[i] * (p_spd_s0[i] - 1.0))
+        / p_spd_s0[i] - p_pelect[i]) / p_2h[i];
+    p_ang_s1[i] = p_ang_s0[i] + p_dang_s0[i] * t_inc;
+    p_spd_s1[i] = p_spd_s0[i] + p_dspd_s0[i] * t_inc;
+  }
+  for (i=0; i<n; i++) {
+    double c = cos(p_ang_s1[i]);
+    double s = sin(p_ang_s1[i]);
+    p_eprime_r_s1[i] = c*p_eqprime_r[i] - s*p_eqprime_i[i];
+    p_eprime_i_s1[i] = s*p_eqprime_r[i] + c*p_eqprime_i[i];
+  }
+}
+
+/**
+ * Correct part calculate current injections
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::corrector_currentInjection(bool flag)
+{
+  updateActive();
+  int i;
+  const int n = p_nactive;
+  for (i=0; i<n; i++) {
+    p_inorton_r[i] = p_eprime_i_s1[i]/p_dtr[i]*p_scale[i];
+    p_inorton_i[i] = -p_eprime_r_s1[i]/p_dtr[i]*p_scale[i];
+  }
+  scatterINorton();
+}
+
+/**
+ * Correct state variables for time step
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::ClassicalGeneratorBatch::corrector(
+    double t_inc, bool flag)
+{
+  updateActive();
+  gatherVoltage();
+  int i;
+  const int n = p_nactive;
+  const double basrad = p_basrad;
+  for (i=0; i<n; i++) {
+    // terminal curr: curr = conj((eprime - volt) / (j*GEN_dtr))
+    double curr_r = (p_eprime_i_s1[i] - p_volt_i[i])/p_dtr[i];
+    double curr_i = (p_eprime_r_s1[i] - p_volt_r[i])/p_dtr[i];
+    p_pelect[i] = p_eprime_r_s1[i]*curr_r - p_eprime_i_s1[i]*curr_i;
+    p_genP[i] = p_volt_r[i]*curr_r - p_volt_i[i]*curr_i;
+    p_genQ[i] = p_volt_r[i]*curr_i + p_volt_i[i]*curr_r;
+    p_dang_s1[i] = (p_spd_s1[i] - 1.0) * basrad;
+    p_dspd_s1[i] = ((p_pmech[i] - p_d0[i] * (p_spd_s1[i] - 1.0))
+        / p_spd_s1[i] - p_pelect[i]) / p_2h[i];
+    p_ang_s1[i] = p_ang_s0[i] + (p_dang_s0[i] + p_dang_s1[i]) / 2.0 * t_inc;
+    p_spd_s1[i] = p_spd_s0[i] + (p_dspd_s0[i] + p_dspd_s1[i]) / 2.0 * t_inc;
+  }
+  for (i=0; i<n; i++) {
+    double c = cos(p_ang_s1[i]);
+    double s = sin(p_ang_s1[i]);
+    p_eprime_r_s1[i] = c*p_eqprime_r[i] - s*p_eqprime_i[i];
+    p_eprime_i_s1[i] = s*p_eqprime_r[i] + c*p_eqprime_i[i];
+    p_inorton_r[i] = 0.0;
+    p_inorton_i[i] = 0.0;
+  }
+  // States are only needed by the generator objects at the end of the step
+  scatterStates();
+  scatterINorton();
+}
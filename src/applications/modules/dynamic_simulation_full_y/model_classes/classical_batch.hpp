@@ -0,0 +1,153 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   classical_batch.hpp
+ *
+ * @brief  Batched integration of classical (GENCLS) generators. Parameters
+ * and states of all active generators in the batch are copied into
+ * separate arrays and the modified Euler updates are evaluated in tight
+ * loops over these arrays. The arrays stay resident between phases and
+ * time steps. Norton currents are copied back to the ClassicalGenerator
+ * objects after each current injection phase and the states after each
+ * corrector, so output and events see the usual values at the end of
+ * every time step.
+ *
+ *
+ */
+
+#ifndef _classical_batch_h_
+#define _classical_batch_h_
+
+#include <vector>
+#include "base_generator_batch.hpp"
+#include "classical.hpp"
+
+namespace gridpack {
+namespace dynamic_simulation {
+class ClassicalGeneratorBatch : public BaseGeneratorBatch
+{
+  public:
+    /**
+     * Basic constructor
+     */
+    ClassicalGeneratorBatch();
+
+    /**
+     * Basic destructor
+     */
+    virtual ~ClassicalGeneratorBatch();
+
+    /**
+     * Add a generator to the batch if it is a classical generator
+     * @param generator generator model
+     * @param status pointer to status flag of generator on its bus
+     * @return true if generator was added to the batch
+     */
+    bool add(BaseGeneratorModel *generator, const int *status);
+
+    /**
+     * Remove all generators from batch and return them to the bus
+     */
+    void clear();
+
+    /**
+     * @return number of generators in batch
+     */
+    int size() const;
+
+    /**
+     * Predict part calculate current injections
+     * @param flag initial step if true
+     */
+    void predictor_currentInjection(bool flag);
+
+    /**
+     * Corrector part calculate current injections
+     * @param flag initial step if true
+     */
+    void corrector_currentInjection(bool flag);
+
+    /**
+     * Predict new state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void predictor(double t_inc, bool flag);
+
+    /**
+     * Correct state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void corrector(double t_inc, bool flag);
+
+  private:
+
+    /**
+     * Check the status of all generators in the batch. If the set of
+     * active generators has changed since the last phase, states of the
+     * previously active generators are copied back to the generator objects
+     * and the batch arrays are filled again from the new set
+     */
+    void updateActive();
+
+    /**
+     * Find active generators and copy their parameters and states into
+     * the batch arrays
+     */
+    void gather();
+
+    /**
+     * Copy terminal voltages of active generators into the batch arrays
+     */
+    void gatherVoltage();
+
+    /**
+     * Copy states at the end of the last step to the start of the current
+     * step
+     */
+    void shiftStates();
+
+    /**
+     * Copy Norton currents of active generators back to generator objects
+     */
+    void scatterINorton();
+
+    /**
+     * Copy states of active generators back to generator objects
+     */
+    void scatterStates();
+
+    // all generators in batch and their status flags
+    std::vector<ClassicalGenerator*> p_generators;
+    std::vector<const int*> p_status;
+
+    // generators that are active in the current step
+    std::vector<ClassicalGenerator*> p_active;
+    int p_nactive;
+    // batch arrays have been filled from generator objects
+    bool p_gathered;
+    double p_basrad;
+
+    // parameters
+    std::vector<double> p_dtr, p_scale, p_2h, p_d0, p_pmech;
+    std::vector<double> p_eqprime_r, p_eqprime_i;
+
+    // terminal voltage
+    std::vector<double> p_volt_r, p_volt_i;
+
+    // states
+    std::vector<double> p_ang_s0, p_spd_s0, p_ang_s1, p_spd_s1;
+    std::vector<double> p_dang_s0, p_dspd_s0, p_dang_s1, p_dspd_s1;
+    std::vector<double> p_eprime_r_s0, p_eprime_i_s0;
+    std::vector<double> p_eprime_r_s1, p_eprime_i_s1;
+    std::vector<double> p_inorton_r, p_inorton_i;
+    std::vector<double> p_pelect, p_genP, p_genQ;
+};
+}  // dynamic_simulation
+}  // gridpack
+#endif
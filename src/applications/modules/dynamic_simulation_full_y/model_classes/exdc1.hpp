@@ -172,6 +172,8 @@ class Exdc1Model : public BaseExciterModel
 
   void computeModel(double t_inc,IntegrationStage int_flag);
 
+  friend class GenrouGeneratorBatch;
+
 
 };
 }  // dynamic_simulation
@@ -206,6 +206,7 @@ class GenrouGenerator : public BaseGeneratorModel
     int p_bus_id;
 
     friend class boost::serialization::access;
+    friend class GenrouGeneratorBatch;
 
     template<class Archive>
       void serialize(Archive & ar, const unsigned int version)
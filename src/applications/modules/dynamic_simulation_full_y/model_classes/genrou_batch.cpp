@@ -0,0 +1,628 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -----------------------------------------------------------
+/**
+ * @file   genrou_batch.cpp
+ *
+ * @brief
+ *
+ *
+ */
+
+#include <vector>
+#include <cmath>
+
+#include "genrou_batch.hpp"
+
+/**
+ *  Basic constructor
+ */
+gridpack::dynamic_simulation::GenrouGeneratorBatch::GenrouGeneratorBatch(void)
+{
+  p_nactive = 0;
+  p_gathered = false;
+}
+
+/**
+ *  Basic destructor
+ */
+gridpack::dynamic_simulation::GenrouGeneratorBatch::~GenrouGeneratorBatch(void)
+{
+  clear();
+}
+
+/**
+ * Add a generator to the batch if it is a GENROU generator whose
+ * exciter is EXDC1 or absent and whose governor is TGOV1 or absent
+ * @param generator generator model
+ * @param status pointer to status flag of generator on its bus
+ * @return true if generator was added to the batch
+ */
+bool gridpack::dynamic_simulation::GenrouGeneratorBatch::add(
+    BaseGeneratorModel *generator, const int *status)
+{
+  GenrouGenerator *gen = dynamic_cast<GenrouGenerator*>(generator);
+  if (gen == NULL) return false;
+  Exdc1Model *exc = NULL;
+  if (gen->p_hasExciter) {
+    exc = dynamic_cast<Exdc1Model*>(gen->getExciter().get());
+    if (exc == NULL) return false;
+  }
+  Tgov1Model *gov = NULL;
+  if (gen->p_hasGovernor) {
+    gov = dynamic_cast<Tgov1Model*>(gen->getGovernor().get());
+    if (gov == NULL) return false;
+  }
+  gen->setBatched(true);
+  p_generators.push_back(gen);
+  p_exciters.push_back(exc);
+  p_governors.push_back(gov);
+  p_status.push_back(status);
+  return true;
+}
+
+/**
+ * Remove all generators from batch and return them to the bus
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::clear()
+{
+  int i;
+  for (i=0; i<p_generators.size(); i++) {
+    p_generators[i]->setBatched(false);
+  }
+  p_generators.clear();
+  p_exciters.clear();
+  p_governors.clear();
+  p_status.clear();
+  p_active.clear();
+  p_exc_idx.clear();
+  p_gov_idx.clear();
+  p_exc.clear();
+  p_gov.clear();
+  p_stopped.clear();
+  p_nactive = 0;
+  p_gathered = false;
+}
+
+/**
+ * @return number of generators in batch
+ */
+int gridpack::dynamic_simulation::GenrouGeneratorBatch::size() const
+{
+  return p_generators.size();
+}
+
+/**
+ * Sort generators with a non-zero status into running generators that
+ * are integrated from the batch arrays and tripped or out of service
+ * generators that are integrated through their own objects. If the set
+ * of running generators has changed since the last phase, states of
+ * the previous set are copied back to the generator objects and the
+ * batch arrays are filled again from the new set
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::updateActive()
+{
+  bool changed = !p_gathered;
+  int i, n;
+  n = 0;
+  p_stopped.clear();
+  for (i=0; i<p_generators.size(); i++) {
+    if (!*p_status[i]) continue;
+    GenrouGenerator *gen = p_generators[i];
+    if (gen->getGenStatus() && !gen->p_tripped) {
+      if (n >= p_nactive || p_active[n] != gen) changed = true;
+      n++;
+    } else {
+      p_stopped.push_back(gen);
+    }
+  }
+  if (n != p_nactive) changed = true;
+  if (!changed) return;
+  if (p_gathered) scatterStates();
+  p_active.resize(p_generators.size());
+  p_exc_idx.clear();
+  p_gov_idx.clear();
+  p_exc.clear();
+  p_gov.clear();
+  n = 0;
+  for (i=0; i<p_generators.size(); i++) {
+    if (!*p_status[i]) continue;
+    GenrouGenerator *gen = p_generators[i];
+    if (!gen->getGenStatus() || gen->p_tripped) continue;
+    p_active[n] = gen;
+    if (p_exciters[i] != NULL) {
+      p_exc_idx.push_back(n);
+      p_exc.push_back(p_exciters[i]);
+    }
+    if (p_governors[i] != NULL) {
+      p_gov_idx.push_back(n);
+      p_gov.push_back(p_governors[i]);
+    }
+    n++;
+  }
+  p_nactive = n;
+  gatherParameters();
+  gatherStates();
+  p_gathered = true;
+}
+
+/**
+ * Copy parameters of running generators and their controls into the
+ * batch arrays
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::gatherParameters()
+{
+  int i;
+  const int n = p_nactive;
+  if (p_G.size() < n) {
+    p_G.resize(n);
+    p_B.resize(n);
+    p_scale.resize(n);
+    p_2h.resize(n);
+    p_D.resize(n);
+    p_Xd.resize(n);
+    p_Xq.resize(n);
+    p_Xdp.resize(n);
+    p_Xqp.resize(n);
+    p_Xdpp.resize(n);
+    p_Xqpp.resize(n);
+    p_Xl.resize(n);
+    p_Tdop.resize(n);
+    p_Tdopp.resize(n);
+    p_Tqop.resize(n);
+    p_Tqopp.resize(n);
+    p_satA.resize(n);
+    p_satB.resize(n);
+    p_Efdinit.resize(n);
+    p_Pmechinit.resize(n);
+    p_vmag.resize(n);
+    p_vr.resize(n);
+    p_vi.resize(n);
+  }
+  for (i=0; i<n; i++) {
+    const GenrouGenerator *gen = p_active[i];
+    double ra = gen->Ra;
+    double xdpp = gen->Xdpp;
+    // machine base Norton admittance
+    p_B[i] = -xdpp / (ra * ra + xdpp * xdpp);
+    p_G[i] = ra / (ra * ra + xdpp * xdpp);
+    p_scale[i] = gen->MBase/gen->p_sbase;
+    p_2h[i] = 2.0*gen->H;
+    p_D[i] = gen->D;
+    p_Xd[i] = gen->Xd;
+    p_Xq[i] = gen->Xq;
+    p_Xdp[i] = gen->Xdp;
+    p_Xqp[i] = gen->Xqp;
+    p_Xdpp[i] = gen->Xdpp;
+    p_Xqpp[i] = gen->Xqpp;
+    p_Xl[i] = gen->Xl;
+    p_Tdop[i] = gen->Tdop;
+    p_Tdopp[i] = gen->Tdopp;
+    p_Tqop[i] = gen->Tqop;
+    p_Tqopp[i] = gen->Tqopp;
+    // Saturation S = B*(x - A)^2 for x > A. A zero B switches it off
+    if (gen->enableSat) {
+      double S10 = gen->S10;
+      double S12 = gen->S12;
+      double a_ = S12 / S10 - 1.0;
+      double b_ = -2 * S12 / S10 + 2.4;
+      double c_ = S12 / S10 - 1.44;
+      p_satA[i] = (-b_ - sqrt(b_ * b_ - 4 * a_ * c_)) / (2 * a_);
+      p_satB[i] = S10 / ((1.0 - p_satA[i]) * (1.0 - p_satA[i]));
+    } else {
+      p_satA[i] = 0.0;
+      p_satB[i] = 0.0;
+    }
+    p_Efdinit[i] = gen->Efdinit;
+    p_Pmechinit[i] = gen->Pmechinit;
+  }
+}
+
+/**
+ * Copy states of running generators into the batch arrays
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::gatherStates()
+{
+  int i;
+  const int n = p_nactive;
+  if (p_x1d.size() < n) {
+    p_x1d.resize(n);
+    p_x2w.resize(n);
+    p_x3Eqp.resize(n);
+    p_x4Psidp.resize(n);
+    p_x5Psiqp.resize(n);
+    p_x6Edp.resize(n);
+    p_x1d_1.resize(n);
+    p_x2w_1.resize(n);
+    p_x3Eqp_1.resize(n);
+    p_x4Psidp_1.resize(n);
+    p_x5Psiqp_1.resize(n);
+    p_x6Edp_1.resize(n);
+    p_dx1d.resize(n);
+    p_dx2w.resize(n);
+    p_dx3Eqp.resize(n);
+    p_dx4Psidp.resize(n);
+    p_dx5Psiqp.resize(n);
+    p_dx6Edp.resize(n);
+    p_dx1d_1.resize(n);
+    p_dx2w_1.resize(n);
+    p_dx3Eqp_1.resize(n);
+    p_dx4Psidp_1.resize(n);
+    p_dx5Psiqp_1.resize(n);
+    p_dx6Edp_1.resize(n);
+    p_Id.resize(n);
+    p_Iq.resize(n);
+    p_Efd.resize(n);
+    p_LadIfd.resize(n);
+    p_Pmech.resize(n);
+    p_inorton_r.resize(n);
+    p_inorton_i.resize(n);
+    p_genP.resize(n);
+    p_genQ.resize(n);
+  }
+  for (i=0; i<n; i++) {
+    const GenrouGenerator *gen = p_active[i];
+    p_x1d[i] = gen->x1d;
+    p_x2w[i] = gen->x2w;
+    p_x3Eqp[i] = gen->x3Eqp;
+    p_x4Psidp[i] = gen->x4Psidp;
+    p_x5Psiqp[i] = gen->x5Psiqp;
+    p_x6Edp[i] = gen->x6Edp;
+    p_x1d_1[i] = gen->x1d_1;
+    p_x2w_1[i] = gen->x2w_1;
+    p_x3Eqp_1[i] = gen->x3Eqp_1;
+    p_x4Psidp_1[i] = gen->x4Psidp_1;
+    p_x5Psiqp_1[i] = gen->x5Psiqp_1;
+    p_x6Edp_1[i] = gen->x6Edp_1;
+    p_dx1d[i] = gen->dx1d;
+    p_dx2w[i] = gen->dx2w;
+    p_dx3Eqp[i] = gen->dx3Eqp;
+    p_dx4Psidp[i] = gen->dx4Psidp;
+    p_dx5Psiqp[i] = gen->dx5Psiqp;
+    p_dx6Edp[i] = gen->dx6Edp;
+    p_dx1d_1[i] = gen->dx1d_1;
+    p_dx2w_1[i] = gen->dx2w_1;
+    p_dx3Eqp_1[i] = gen->dx3Eqp_1;
+    p_dx4Psidp_1[i] = gen->dx4Psidp_1;
+    p_dx5Psiqp_1[i] = gen->dx5Psiqp_1;
+    p_dx6Edp_1[i] = gen->dx6Edp_1;
+    p_Id[i] = gen->Id;
+    p_Iq[i] = gen->Iq;
+    p_Efd[i] = gen->Efd;
+    p_LadIfd[i] = gen->LadIfd;
+    p_Pmech[i] = gen->Pmech;
+    p_genP[i] = gen->genP;
+    p_genQ[i] = gen->genQ;
+  }
+}
+
+/**
+ * Copy terminal voltages of running generators into the batch arrays
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::gatherVoltage()
+{
+  int i;
+  for (i=0; i<p_nactive; i++) {
+    const GenrouGenerator *gen = p_active[i];
+    p_vmag[i] = gen->presentMag;
+    p_vr[i] = gen->presentMag * cos(gen->presentAng);
+    p_vi[i] = gen->presentMag * sin(gen->presentAng);
+  }
+}
+
+/**
+ * Pass terminal voltage and speed deviation to the exciters and
+ * governors and copy field voltage and mechanical power into the batch
+ * arrays
+ * @param w speed deviation used as governor input
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::exchangeControls(
+    const std::vector<double> &w)
+{
+  int i;
+  const int n = p_nactive;
+  for (i=0; i<n; i++) {
+    p_Efd[i] = p_Efdinit[i];
+    p_Pmech[i] = p_Pmechinit[i];
+  }
+  // EXDC1 only uses the terminal voltage as input
+  const int nexc = p_exc.size();
+  for (i=0; i<nexc; i++) {
+    int k = p_exc_idx[i];
+    p_exc[i]->Ec = p_vmag[k];
+    p_Efd[k] = p_exc[i]->Efd;
+  }
+  const int ngov = p_gov.size();
+  for (i=0; i<ngov; i++) {
+    int k = p_gov_idx[i];
+    p_gov[i]->delta_w = w[k];
+    p_Pmech[k] = p_gov[i]->Pmech;
+  }
+}
+
+/**
+ * Advance the exciters and governors of running generators
+ * @param t_inc time step increment
+ * @param stage predictor or corrector stage
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::integrateControls(
+    double t_inc, IntegrationStage stage)
+{
+  int i;
+  const int nexc = p_exc.size();
+  for (i=0; i<nexc; i++) {
+    p_exc[i]->computeModel(t_inc,stage);
+  }
+  const int ngov = p_gov.size();
+  for (i=0; i<ngov; i++) {
+    p_gov[i]->computeModel(t_inc,stage);
+  }
+}
+
+/**
+ * Evaluate the Norton current injections of the running generators
+ * from the given states and copy them back to the generator objects
+ * @param x1d rotor angle
+ * @param x3Eqp, x4Psidp, x5Psiqp, x6Edp flux states
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::currentInjection(
+    const std::vector<double> &x1d, const std::vector<double> &x3Eqp,
+    const std::vector<double> &x4Psidp, const std::vector<double> &x5Psiqp,
+    const std::vector<double> &x6Edp)
+{
+  int i;
+  const int n = p_nactive;
+  for (i=0; i<n; i++) {
+    double Psiqpp = - x6Edp[i] * (p_Xqpp[i] - p_Xl[i]) / (p_Xqp[i] - p_Xl[i])
+      - x5Psiqp[i] * (p_Xqp[i] - p_Xqpp[i]) / (p_Xqp[i] - p_Xl[i]);
+    double Psidpp = + x3Eqp[i] * (p_Xdpp[i] - p_Xl[i]) / (p_Xdp[i] - p_Xl[i])
+      + x4Psidp[i] * (p_Xdp[i] - p_Xdpp[i]) / (p_Xdp[i] - p_Xl[i]);
+    double Vd = - Psiqpp;
+    double Vq = + Psidpp;
+    double Idnorton = Vd * p_G[i] - Vq * p_B[i];
+    double Iqnorton = Vd * p_B[i] + Vq * p_G[i];
+    double s = sin(x1d[i]);
+    double c = cos(x1d[i]);
+    p_inorton_r[i] = (+ Idnorton * s + Iqnorton * c) * p_scale[i];
+    p_inorton_i[i] = (- Idnorton * c + Iqnorton * s) * p_scale[i];
+  }
+  for (i=0; i<n; i++) {
+    GenrouGenerator *gen = p_active[i];
+    gen->IrNorton = p_inorton_r[i];
+    gen->IiNorton = p_inorton_i[i];
+    gen->p_INorton = gridpack::ComplexType(p_inorton_r[i], p_inorton_i[i]);
+  }
+}
+
+/**
+ * Copy states of running generators back to generator objects
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::scatterStates()
+{
+  int i;
+  for (i=0; i<p_nactive; i++) {
+    GenrouGenerator *gen = p_active[i];
+    gen->x1d = p_x1d[i];
+    gen->x2w = p_x2w[i];
+    gen->x3Eqp = p_x3Eqp[i];
+    gen->x4Psidp = p_x4Psidp[i];
+    gen->x5Psiqp = p_x5Psiqp[i];
+    gen->x6Edp = p_x6Edp[i];
+    gen->x1d_1 = p_x1d_1[i];
+    gen->x2w_1 = p_x2w_1[i];
+    gen->x3Eqp_1 = p_x3Eqp_1[i];
+    gen->x4Psidp_1 = p_x4Psidp_1[i];
+    gen->x5Psiqp_1 = p_x5Psiqp_1[i];
+    gen->x6Edp_1 = p_x6Edp_1[i];
+    gen->dx1d = p_dx1d[i];
+    gen->dx2w = p_dx2w[i];
+    gen->dx3Eqp = p_dx3Eqp[i];
+    gen->dx4Psidp = p_dx4Psidp[i];
+    gen->dx5Psiqp = p_dx5Psiqp[i];
+    gen->dx6Edp = p_dx6Edp[i];
+    gen->dx1d_1 = p_dx1d_1[i];
+    gen->dx2w_1 = p_dx2w_1[i];
+    gen->dx3Eqp_1 = p_dx3Eqp_1[i];
+    gen->dx4Psidp_1 = p_dx4Psidp_1[i];
+    gen->dx5Psiqp_1 = p_dx5Psiqp_1[i];
+    gen->dx6Edp_1 = p_dx6Edp_1[i];
+    gen->Id = p_Id[i];
+    gen->Iq = p_Iq[i];
+    gen->Efd = p_Efd[i];
+    gen->LadIfd = p_LadIfd[i];
+    gen->Pmech = p_Pmech[i];
+    gen->genP = p_genP[i];
+    gen->genQ = p_genQ[i];
+    gen->B = p_B[i];
+    gen->G = p_G[i];
+    gen->Vterm = gen->presentMag;
+    gen->Theta = gen->presentAng;
+  }
+}
+
+/**
+ * Predict part calculate current injections
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::predictor_currentInjection(bool flag)
+{
+  updateActive();
+  int i;
+  for (i=0; i<p_stopped.size(); i++) {
+    p_stopped[i]->predictor_currentInjection(flag);
+  }
+  gatherVoltage();
+  const int n = p_nactive;
+  // terminal power from the currents of the last corrector
+  for (i=0; i<n; i++) {
+    double Ir = + p_Id[i] * sin(p_x1d[i]) + p_Iq[i] * cos(p_x1d[i]);
+    double Ii = - p_Id[i] * cos(p_x1d[i]) + p_Iq[i] * sin(p_x1d[i]);
+    p_genP[i] = p_vr[i]*Ir + p_vi[i]*Ii;
+    p_genQ[i] = p_vi[i]*Ir - p_vr[i]*Ii;
+  }
+  currentInjection(p_x1d,p_x3Eqp,p_x4Psidp,p_x5Psiqp,p_x6Edp);
+}
+
+/**
+ * Predict new state variables for time step
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::predictor(
+    double t_inc, bool flag)
+{
+  updateActive();
+  int i;
+  for (i=0; i<p_stopped.size(); i++) {
+    p_stopped[i]->predictor(t_inc,flag);
+  }
+  gatherVoltage();
+  exchangeControls(p_x2w);
+  const int n = p_nactive;
+  const double pi = 4.0*atan(1.0);
+  for (i=0; i<n; i++) {
+    double Xl = p_Xl[i];
+    double Xdp = p_Xdp[i];
+    double Xqp = p_Xqp[i];
+    double Xdpp = p_Xdpp[i];
+    double Xqpp = p_Xqpp[i];
+    double Psiqpp = - p_x6Edp[i] * (Xqpp - Xl) / (Xqp - Xl)
+      - p_x5Psiqp[i] * (Xqp - Xqpp) / (Xqp - Xl);
+    double Psidpp = + p_x3Eqp[i] * (Xdpp - Xl) / (Xdp - Xl)
+      + p_x4Psidp[i] * (Xdp - Xdpp) / (Xdp - Xl);
+    double Vd = - Psiqpp;
+    double Vq = + Psidpp;
+    double s = sin(p_x1d[i]);
+    double c = cos(p_x1d[i]);
+    double Vdterm = p_vr[i] * s - p_vi[i] * c;
+    double Vqterm = p_vr[i] * c + p_vi[i] * s;
+
+    //DQ Axis currents
+    double Id = (Vd - Vdterm) * p_G[i] - (Vq - Vqterm) * p_B[i];
+    double Iq = (Vd - Vdterm) * p_B[i] + (Vq - Vqterm) * p_G[i];
+    p_Id[i] = Id;
+    p_Iq[i] = Iq;
+
+    double Telec = Psidpp * Iq - Psiqpp * Id;
+    double TempD = (Xdp - Xdpp) / ((Xdp - Xl) * (Xdp - Xl))
+      * (-p_x4Psidp[i] - (Xdp - Xl) * Id + p_x3Eqp[i]);
+    double sat = p_x3Eqp[i] - p_satA[i];
+    if (sat < 0.0) sat = 0.0;
+    sat = p_satB[i] * sat * sat;
+    p_LadIfd[i] = p_x3Eqp[i] * (1 + sat) + (p_Xd[i] - Xdp) * (Id + TempD);
+
+    p_dx1d[i] = p_x2w[i] * 2 * pi * 60;
+    p_dx2w[i] = 1 / p_2h[i] * ((p_Pmech[i] - p_D[i] * p_x2w[i])
+        / (1 + p_x2w[i]) - Telec);
+    p_dx3Eqp[i] = (p_Efd[i] - p_LadIfd[i]) / p_Tdop[i];
+    p_dx4Psidp[i] = (-p_x4Psidp[i] - (Xdp - Xl) * Id + p_x3Eqp[i])
+      / p_Tdopp[i];
+    p_dx5Psiqp[i] = (-p_x5Psiqp[i] + (Xqp - Xl) * Iq + p_x6Edp[i])
+      / p_Tqopp[i];
+    double TempQ = (Xqp - Xqpp) / ((Xqp - Xl) * (Xqp - Xl))
+      * (-p_x5Psiqp[i] + (Xqp - Xl) * Iq + p_x6Edp[i]);
+    p_dx6Edp[i] = (-p_x6Edp[i] + (p_Xq[i] - Xqp) * (Iq - TempQ)) / p_Tqop[i];
+  }
+  for (i=0; i<n; i++) {
+    p_x1d_1[i] = p_x1d[i] + p_dx1d[i] * t_inc;
+    p_x2w_1[i] = p_x2w[i] + p_dx2w[i] * t_inc;
+    p_x3Eqp_1[i] = p_x3Eqp[i] + p_dx3Eqp[i] * t_inc;
+    p_x4Psidp_1[i] = p_x4Psidp[i] + p_dx4Psidp[i] * t_inc;
+    p_x5Psiqp_1[i] = p_x5Psiqp[i] + p_dx5Psiqp[i] * t_inc;
+    p_x6Edp_1[i] = p_x6Edp[i] + p_dx6Edp[i] * t_inc;
+  }
+  integrateControls(t_inc,PREDICTOR);
+}
+
+/**
+ * Correct part calculate current injections
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::corrector_currentInjection(bool flag)
+{
+  updateActive();
+  int i;
+  for (i=0; i<p_stopped.size(); i++) {
+    p_stopped[i]->corrector_currentInjection(flag);
+  }
+  currentInjection(p_x1d_1,p_x3Eqp_1,p_x4Psidp_1,p_x5Psiqp_1,p_x6Edp_1);
+}
+
+/**
+ * Correct state variables for time step
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::GenrouGeneratorBatch::corrector(
+    double t_inc, bool flag)
+{
+  updateActive();
+  int i;
+  for (i=0; i<p_stopped.size(); i++) {
+    p_stopped[i]->corrector(t_inc,flag);
+  }
+  gatherVoltage();
+  exchangeControls(p_x2w_1);
+  const int n = p_nactive;
+  const double pi = 4.0*atan(1.0);
+  for (i=0; i<n; i++) {
+    double Xl = p_Xl[i];
+    double Xdp = p_Xdp[i];
+    double Xqp = p_Xqp[i];
+    double Xdpp = p_Xdpp[i];
+    double Xqpp = p_Xqpp[i];
+    double Psiqpp = - p_x6Edp_1[i] * (Xqpp - Xl) / (Xqp - Xl)
+      - p_x5Psiqp_1[i] * (Xqp - Xqpp) / (Xqp - Xl);
+    double Psidpp = + p_x3Eqp_1[i] * (Xdpp - Xl) / (Xdp - Xl)
+      + p_x4Psidp_1[i] * (Xdp - Xdpp) / (Xdp - Xl);
+    double Vd = - Psiqpp;
+    double Vq = + Psidpp;
+    double s = sin(p_x1d_1[i]);
+    double c = cos(p_x1d_1[i]);
+    double Vdterm = p_vr[i] * s - p_vi[i] * c;
+    double Vqterm = p_vr[i] * c + p_vi[i] * s;
+
+    //DQ Axis
+    double Id = (Vd - Vdterm) * p_G[i] - (Vq - Vqterm) * p_B[i];
+    double Iq = (Vd - Vdterm) * p_B[i] + (Vq - Vqterm) * p_G[i];
+    p_Id[i] = Id;
+    p_Iq[i] = Iq;
+
+    double Telec = Psidpp * Iq - Psiqpp * Id;
+    double TempD = (Xdp - Xdpp) / ((Xdp - Xl) * (Xdp - Xl))
+      * (-p_x4Psidp_1[i] - (Xdp - Xl) * Id + p_x3Eqp_1[i]);
+    double sat = p_x3Eqp_1[i] - p_satA[i];
+    if (sat < 0.0) sat = 0.0;
+    sat = p_satB[i] * sat * sat;
+    p_LadIfd[i] = p_x3Eqp_1[i] * (1 + sat) + (p_Xd[i] - Xdp) * (Id + TempD);
+
+    p_dx1d_1[i] = p_x2w_1[i] * 2 * pi * 60;
+    p_dx2w_1[i] = 1 / p_2h[i] * ((p_Pmech[i] - p_D[i] * p_x2w_1[i])
+        / (1 + p_x2w_1[i]) - Telec);
+    p_dx3Eqp_1[i] = (p_Efd[i] - p_LadIfd[i]) / p_Tdop[i];
+    p_dx4Psidp_1[i] = (-p_x4Psidp_1[i] - (Xdp - Xl) * Id + p_x3Eqp_1[i])
+      / p_Tdopp[i];
+    p_dx5Psiqp_1[i] = (-p_x5Psiqp_1[i] + (Xqp - Xl) * Iq + p_x6Edp_1[i])
+      / p_Tqopp[i];
+    double TempQ = (Xqp - Xqpp) / ((Xqp - Xl) * (Xqp - Xl))
+      * (-p_x5Psiqp_1[i] + (Xqp - Xl) * Iq + p_x6Edp_1[i]);
+    p_dx6Edp_1[i] = (-p_x6Edp_1[i] + (p_Xq[i] - Xqp) * (Iq - TempQ))
+      / p_Tqop[i];
+  }
+  for (i=0; i<n; i++) {
+    p_x1d[i] = p_x1d[i] + (p_dx1d[i] + p_dx1d_1[i]) / 2.0 * t_inc;
+    p_x2w[i] = p_x2w[i] + (p_dx2w[i] + p_dx2w_1[i]) / 2.0 * t_inc;
+    p_x3Eqp[i] = p_x3Eqp[i] + (p_dx3Eqp[i] + p_dx3Eqp_1[i]) / 2.0 * t_inc;
+    p_x4Psidp[i] = p_x4Psidp[i]
+      + (p_dx4Psidp[i] + p_dx4Psidp_1[i]) / 2.0 * t_inc;
+    p_x5Psiqp[i] = p_x5Psiqp[i]
+      + (p_dx5Psiqp[i] + p_dx5Psiqp_1[i]) / 2.0 * t_inc;
+    p_x6Edp[i] = p_x6Edp[i] + (p_dx6Edp[i] + p_dx6Edp_1[i]) / 2.0 * t_inc;
+  }
+  integrateControls(t_inc,CORRECTOR);
+  // States are only needed by the generator objects at the end of the step
+  scatterStates();
+}
@@ -0,0 +1,193 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   genrou_batch.hpp
+ *
+ * @brief  Batched integration of round rotor (GENROU) generators together
+ * with their EXDC1 exciters and TGOV1 governors. Parameters and states of
+ * the machines are copied into separate arrays and the machine equations
+ * are evaluated in tight loops over these arrays. The exciter and governor
+ * inputs (terminal voltage, speed deviation) and outputs (field voltage,
+ * mechanical power) are exchanged with the machine arrays in the same
+ * loops and all controls of the batch are advanced one after the other
+ * without going through the generator. Generators with other control
+ * models are left to their bus. Generators that are tripped or out of
+ * service are integrated through their own object so that the batch
+ * only contains running machines.
+ *
+ *
+ */
+
+#ifndef _genrou_batch_h_
+#define _genrou_batch_h_
+
+#include <vector>
+#include "base_generator_batch.hpp"
+#include "genrou.hpp"
+#include "exdc1.hpp"
+#include "tgov1.hpp"
+
+namespace gridpack {
+namespace dynamic_simulation {
+class GenrouGeneratorBatch : public BaseGeneratorBatch
+{
+  public:
+    /**
+     * Basic constructor
+     */
+    GenrouGeneratorBatch();
+
+    /**
+     * Basic destructor
+     */
+    virtual ~GenrouGeneratorBatch();
+
+    /**
+     * Add a generator to the batch if it is a GENROU generator whose
+     * exciter is EXDC1 or absent and whose governor is TGOV1 or absent
+     * @param generator generator model
+     * @param status pointer to status flag of generator on its bus
+     * @return true if generator was added to the batch
+     */
+    bool add(BaseGeneratorModel *generator, const int *status);
+
+    /**
+     * Remove all generators from batch and return them to the bus
+     */
+    void clear();
+
+    /**
+     * @return number of generators in batch
+     */
+    int size() const;
+
+    /**
+     * Predict part calculate current injections
+     * @param flag initial step if true
+     */
+    void predictor_currentInjection(bool flag);
+
+    /**
+     * Corrector part calculate current injections
+     * @param flag initial step if true
+     */
+    void corrector_currentInjection(bool flag);
+
+    /**
+     * Predict new state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void predictor(double t_inc, bool flag);
+
+    /**
+     * Correct state variables for time step
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void corrector(double t_inc, bool flag);
+
+  private:
+
+    /**
+     * Sort generators with a non-zero status into running generators that
+     * are integrated from the batch arrays and tripped or out of service
+     * generators that are integrated through their own objects. If the set
+     * of running generators has changed since the last phase, states of
+     * the previous set are copied back to the generator objects and the
+     * batch arrays are filled again from the new set
+     */
+    void updateActive();
+
+    /**
+     * Copy parameters of running generators and their controls into the
+     * batch arrays
+     */
+    void gatherParameters();
+
+    /**
+     * Copy states of running generators into the batch arrays
+     */
+    void gatherStates();
+
+    /**
+     * Copy terminal voltages of running generators into the batch arrays
+     */
+    void gatherVoltage();
+
+    /**
+     * Pass terminal voltage and speed deviation to the exciters and
+     * governors and copy field voltage and mechanical power into the batch
+     * arrays
+     * @param w speed deviation used as governor input
+     */
+    void exchangeControls(const std::vector<double> &w);
+
+    /**
+     * Advance the exciters and governors of running generators
+     * @param t_inc time step increment
+     * @param stage predictor or corrector stage
+     */
+    void integrateControls(double t_inc, IntegrationStage stage);
+
+    /**
+     * Evaluate the Norton current injections of the running generators
+     * from the given states and copy them back to the generator objects
+     * @param x1d rotor angle
+     * @param x3Eqp, x4Psidp, x5Psiqp, x6Edp flux states
+     */
+    void currentInjection(const std::vector<double> &x1d,
+        const std::vector<double> &x3Eqp, const std::vector<double> &x4Psidp,
+        const std::vector<double> &x5Psiqp, const std::vector<double> &x6Edp);
+
+    /**
+     * Copy states of running generators back to generator objects
+     */
+    void scatterStates();
+
+    // all generators in batch and their status flags
+    std::vector<GenrouGenerator*> p_generators;
+    std::vector<Exdc1Model*> p_exciters;
+    std::vector<Tgov1Model*> p_governors;
+    std::vector<const int*> p_status;
+
+    // running generators in the current step and their controls. The
+    // control lists only contain generators that have the control
+    std::vector<GenrouGenerator*> p_active;
+    std::vector<int> p_exc_idx, p_gov_idx;
+    std::vector<Exdc1Model*> p_exc;
+    std::vector<Tgov1Model*> p_gov;
+    int p_nactive;
+    // tripped or out of service generators in the current step
+    std::vector<GenrouGenerator*> p_stopped;
+    // batch arrays have been filled from generator objects
+    bool p_gathered;
+
+    // parameters
+    std::vector<double> p_G, p_B, p_scale, p_2h, p_D;
+    std::vector<double> p_Xd, p_Xq, p_Xdp, p_Xqp, p_Xdpp, p_Xqpp, p_Xl;
+    std::vector<double> p_Tdop, p_Tdopp, p_Tqop, p_Tqopp;
+    std::vector<double> p_satA, p_satB;
+    std::vector<double> p_Efdinit, p_Pmechinit;
+
+    // terminal voltage
+    std::vector<double> p_vmag, p_vr, p_vi;
+
+    // states
+    std::vector<double> p_x1d, p_x2w, p_x3Eqp, p_x4Psidp, p_x5Psiqp, p_x6Edp;
+    std::vector<double> p_x1d_1, p_x2w_1, p_x3Eqp_1, p_x4Psidp_1;
+    std::vector<double> p_x5Psiqp_1, p_x6Edp_1;
+    std::vector<double> p_dx1d, p_dx2w, p_dx3Eqp, p_dx4Psidp;
+    std::vector<double> p_dx5Psiqp, p_dx6Edp;
+    std::vector<double> p_dx1d_1, p_dx2w_1, p_dx3Eqp_1, p_dx4Psidp_1;
+    std::vector<double> p_dx5Psiqp_1, p_dx6Edp_1;
+    std::vector<double> p_Id, p_Iq, p_Efd, p_LadIfd, p_Pmech;
+    std::vector<double> p_inorton_r, p_inorton_i, p_genP, p_genQ;
+};
+}  // dynamic_simulation
+}  // gridpack
+#endif
@@ -125,6 +125,8 @@ class Tgov1Model : public BaseGovernorModel
   
   void computeModel(double t_inc, IntegrationStage int_flag);
 
+  friend class GenrouGeneratorBatch;
+
 };
 }  // dynamic_simulation
 }  // gridpack
@@ -394,51 +394,16 @@ void gridpack::hadrec::HADRECAppModule::updateData()
 
 /**
  * return observations after each simulation time step
+ * @param rootOnly if true, observations are only returned on process 0
  */
 
-std::vector<double> gridpack::hadrec::HADRECAppModule::getObservations(){
-	
-	std::vector<double> rSpd, rAng, genP, genQ, vMag, vAng, fOnline; 
-	//ds_app_sptr->getObservations(vMag, vAng, rSpd, rAng, genP, genQ, fOnline);
-	
-	std::vector<double> busfreq;
-	ds_app_sptr->getObservations_withBusFreq(vMag, vAng, rSpd, rAng, genP, genQ, fOnline, busfreq);
+std::vector<double> gridpack::hadrec::HADRECAppModule::getObservations(
+    bool rootOnly){
 	
+	// values are ordered as rotor speed, rotor angle, generator P and Q,
+	// bus voltage magnitude and angle, online load fraction and bus frequency
 	std::vector<double> obs_vals;
-	obs_vals.clear();
-	
-	int i;
-	for (i=0; i<rSpd.size(); i++){
-		obs_vals.push_back(rSpd[i]);
-	}
-	
-	for (i=0; i<rAng.size(); i++){
-		obs_vals.push_back(rAng[i]);
-	}
-	
-	for (i=0; i<genP.size(); i++){
-		obs_vals.push_back(genP[i]);
-	}
-	
-	for (i=0; i<genQ.size(); i++){
-		obs_vals.push_back(genQ[i]);
-	}
-
-	for (i=0; i<vMag.size(); i++){
-		obs_vals.push_back(vMag[i]);
-	}
-
-	for (i=0; i<vAng.size(); i++){
-		obs_vals.push_back(vAng[i]);
-	}	
-
-	for (i=0; i<fOnline.size(); i++){
-		obs_vals.push_back(fOnline[i]);
-	}	
-	
-	for (i=0; i<busfreq.size(); i++){
-		obs_vals.push_back(busfreq[i]);
-	}
+	ds_app_sptr->getObservationValues(obs_vals, rootOnly);
 	
 	return obs_vals;
 	
@@ -591,6 +556,19 @@ void gridpack::hadrec::HADRECAppModule::applyAction(gridpack::hadrec::HADRECActi
 
 }
 
+/**
+ * apply a list of actions in order
+ * @param control_actions actions to apply
+ */
+void gridpack::hadrec::HADRECAppModule::applyActions(
+    const std::vector<gridpack::hadrec::HADRECAction> &control_actions){
+	
+	int i;
+	for (i=0; i<control_actions.size(); i++){
+		applyAction(control_actions[i]);
+	}
+}
+
 /**
  * set the wide area control signals of the PSS of a certain generator
  * input bus_number: generator bus number
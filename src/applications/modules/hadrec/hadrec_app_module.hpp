@@ -123,6 +123,12 @@ class HADRECAppModule
 	* apply actions
 	*/
 	void applyAction(gridpack::hadrec::HADRECAction control_action);
+
+	/**
+	* apply a list of actions in order
+	* @param control_actions actions to apply
+	*/
+	void applyActions(const std::vector<gridpack::hadrec::HADRECAction> &control_actions);
 	
 	/**
 	 * set the wide area control signals of the PSS of a certain generator
@@ -172,8 +178,9 @@ class HADRECAppModule
 	
 	/**
 	* return observations after each simulation time step
+	* @param rootOnly if true, observations are only returned on process 0
 	*/
-	std::vector<double> getObservations();
+	std::vector<double> getObservations(bool rootOnly = false);
 	
 	/**
 	* return observations list
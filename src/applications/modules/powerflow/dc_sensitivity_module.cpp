@@ -0,0 +1,595 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dc_sensitivity_module.cpp
+ *
+ * @brief
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include <algorithm>
+#include "dc_sensitivity_module.hpp"
+#include "gridpack/mapper/full_map.hpp"
+#include "gridpack/mapper/bus_vector_map.hpp"
+#include "gridpack/math/math.hpp"
+#include "gridpack/parallel/task_manager.hpp"
+#include "gridpack/timer/coarse_timer.hpp"
+
+#define USE_REAL_VALUES
+
+namespace gridpack {
+namespace powerflow {
+
+/**
+ * Mappers, DC B matrix, vectors and linear solver. The factorization of
+ * B is reused for all solves
+ */
+struct DCSolver {
+  boost::shared_ptr<gridpack::mapper::FullMatrixMap<PFNetwork> > mMap;
+  boost::shared_ptr<gridpack::mapper::BusVectorMap<PFNetwork> > vMap;
+  boost::shared_ptr<gridpack::math::RealMatrix> B;
+  boost::shared_ptr<gridpack::math::RealVector> rhs;
+  boost::shared_ptr<gridpack::math::RealVector> theta;
+  boost::shared_ptr<gridpack::math::RealLinearSolver> solver;
+};
+
+/**
+ * Comparison of screening results by decreasing severity
+ */
+struct SeverityOrder {
+  const std::vector<ScreeningResult> &p_results;
+  SeverityOrder(const std::vector<ScreeningResult> &results)
+    : p_results(results) {}
+  bool operator()(int a, int b) const
+  {
+    if (p_results[a].estimated != p_results[b].estimated) {
+      return !p_results[a].estimated;
+    }
+    return p_results[a].maxLoading > p_results[b].maxLoading;
+  }
+};
+
+} // powerflow
+} // gridpack
+
+/**
+ * Basic constructor
+ * @param network powerflow network. The network must have been
+ * initialized by a PFAppModule
+ * @param cursor pointer to block in input file containing the linear
+ * solver parameters used for the DC B matrix
+ */
+gridpack::powerflow::DCSensitivityModule::DCSensitivityModule(
+    boost::shared_ptr<PFNetwork> network,
+    gridpack::utility::Configuration::CursorPtr cursor)
+{
+  p_network = network;
+  p_cursor = cursor;
+  p_factory.reset(new PFFactoryModule(network));
+  p_threshold = 1.0e-3;
+  p_rateB = false;
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::powerflow::DCSensitivityModule::~DCSensitivityModule()
+{
+}
+
+/**
+ * Smallest absolute value of PTDF and LODF factors that are returned by
+ * getPTDF and getLODF
+ * @param threshold cutoff for sensitivity factors
+ */
+void gridpack::powerflow::DCSensitivityModule::setThreshold(double threshold)
+{
+  p_threshold = threshold;
+}
+
+/**
+ * Use rating B instead of rating A for estimated overloads
+ * @param flag if true, use rating B
+ */
+void gridpack::powerflow::DCSensitivityModule::useRateB(bool flag)
+{
+  p_rateB = flag;
+}
+
+/**
+ * Build and factor the DC B matrix for the current topology and store
+ * the base case flows. This is collective on the network communicator
+ * and must be called again if the topology of the base case changes
+ */
+void gridpack::powerflow::DCSensitivityModule::setup(void)
+{
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_setup = timer->createCategory("DC Sensitivity: Setup");
+  timer->start(t_setup);
+
+  // Find all in-service transmission elements on locally held branches
+  p_elements.clear();
+  int nbranch = p_network->numBranches();
+  int i, j;
+  for (i=0; i<nbranch; i++) {
+    if (!p_network->getActiveBranch(i)) continue;
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          p_network->getBranch(i).get());
+    gridpack::powerflow::PFBus *bus1 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(branch->getBus1().get());
+    gridpack::powerflow::PFBus *bus2 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(branch->getBus2().get());
+    if (bus1->isIsolated() || bus2->isIsolated()) continue;
+    std::vector<std::string> tags = branch->getLineTags();
+    for (j=0; j<tags.size(); j++) {
+      double b = branch->getDCSusceptance(tags[j]);
+      if (b == 0.0) continue;
+      DCElement elem;
+      elem.branch = i;
+      elem.from = branch->getBus1OriginalIndex();
+      elem.to = branch->getBus2OriginalIndex();
+      elem.tag = tags[j];
+      elem.b = b;
+      elem.p = 0.0;
+      elem.q = 0.0;
+      elem.rating = 0.0;
+      p_elements.push_back(elem);
+    }
+  }
+  setBaseFlows();
+
+  // Build and factor B
+  p_solver.reset(new DCSolver);
+  p_factory->setMode(DCSensitivity);
+  p_solver->mMap.reset(
+      new gridpack::mapper::FullMatrixMap<PFNetwork>(p_network));
+  p_solver->B = p_solver->mMap->mapToRealMatrix();
+  p_solver->vMap.reset(
+      new gridpack::mapper::BusVectorMap<PFNetwork>(p_network));
+  p_solver->rhs = p_solver->vMap->mapToRealVector();
+  p_solver->theta.reset(p_solver->rhs->clone());
+  p_solver->solver.reset(
+      new gridpack::math::RealLinearSolver(*(p_solver->B)));
+  p_solver->solver->configure(p_cursor);
+  p_solver->solver->reuseMode(gridpack::math::ReuseFactorization);
+  timer->stop(t_setup);
+}
+
+/**
+ * Store the real and reactive flows of the current powerflow solution
+ * as the base case flows for screening. Call this after a new base
+ * case has been solved on the same topology
+ */
+void gridpack::powerflow::DCSensitivityModule::setBaseFlows(void)
+{
+  int nelem = p_elements.size();
+  int i;
+  for (i=0; i<nelem; i++) {
+    DCElement &elem = p_elements[i];
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          p_network->getBranch(elem.branch).get());
+    gridpack::ComplexType s = branch->getComplexPower(elem.tag);
+    elem.p = real(s);
+    elem.q = imag(s);
+    double rate = 0.0;
+    if (p_rateB) rate = branch->getBranchRatingB(elem.tag);
+    if (rate <= 0.0) rate = branch->getBranchRatingA(elem.tag);
+    if (branch->getIgnore(elem.tag)) rate = 0.0;
+    elem.rating = rate;
+  }
+}
+
+/**
+ * Find a transmission element held on this process
+ * @param from original index of "from" bus
+ * @param to original index of "to" bus
+ * @param tag identifier of element
+ * @return index of element or -1 if element is not held on this process
+ */
+int gridpack::powerflow::DCSensitivityModule::findElement(int from, int to,
+    const std::string &tag)
+{
+  std::vector<int> lids = p_network->getLocalBranchIndices(from,to);
+  int nelem = p_elements.size();
+  int i, j;
+  for (j=0; j<lids.size(); j++) {
+    if (!p_network->getActiveBranch(lids[j])) continue;
+    for (i=0; i<nelem; i++) {
+      if (p_elements[i].branch == lids[j] && p_elements[i].tag == tag) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * Find the "from" and "to" buses of a transmission element as they are
+ * stored in the network. The element may be specified with its buses
+ * in either order. This is collective on the network communicator
+ * @param from original index of one bus of element
+ * @param to original index of other bus of element
+ * @param tag identifier of element
+ * @param idx index of element or -1 if element is not held on this
+ * process
+ * @param ends original indices of "from" and "to" bus of element
+ * @return false if element was not found on any process
+ */
+bool gridpack::powerflow::DCSensitivityModule::elementEnds(int from, int to,
+    const std::string &tag, int &idx, int *ends)
+{
+  int data[3];
+  data[0] = 0;
+  data[1] = 0;
+  data[2] = 0;
+  idx = findElement(from, to, tag);
+  if (idx >= 0) {
+    data[0] = p_elements[idx].from;
+    data[1] = p_elements[idx].to;
+    data[2] = 1;
+  }
+  p_network->communicator().sum(data,3);
+  if (data[2] == 0) return false;
+  ends[0] = data[0]/data[2];
+  ends[1] = data[1]/data[2];
+  return true;
+}
+
+/**
+ * Solve the DC equations for the injections at a set of buses and
+ * store the change in flow of all local elements. This is collective
+ * @param buses original indices of buses with injections
+ * @param values injections at buses
+ * @param dflow change in flow for each local element
+ */
+void gridpack::powerflow::DCSensitivityModule::solveFlows(
+    const std::vector<int> &buses, const std::vector<double> &values,
+    std::vector<double> &dflow)
+{
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_solve = timer->createCategory("DC Sensitivity: Solve");
+  if (!p_solver) {
+    char buf[128];
+    sprintf(buf,"p[%d] DCSensitivityModule: setup has not been called\n",
+        p_network->communicator().rank());
+    throw gridpack::Exception(buf);
+  }
+  timer->start(t_solve);
+  int nbus = buses.size();
+  int i, j;
+  gridpack::powerflow::PFBus *bus;
+  for (i=0; i<nbus; i++) {
+    std::vector<int> lids = p_network->getLocalBusIndices(buses[i]);
+    for (j=0; j<lids.size(); j++) {
+      bus = dynamic_cast<gridpack::powerflow::PFBus*>(
+          p_network->getBus(lids[j]).get());
+      bus->setDCInjection(values[i]);
+    }
+  }
+  p_factory->setMode(DCSensitivity);
+  p_solver->vMap->mapToRealVector(p_solver->rhs);
+  p_solver->solver->solve(*(p_solver->rhs), *(p_solver->theta));
+  p_solver->vMap->mapToBus(p_solver->theta);
+  p_network->updateBuses();
+  // Clear injections for the next solve
+  for (i=0; i<nbus; i++) {
+    std::vector<int> lids = p_network->getLocalBusIndices(buses[i]);
+    for (j=0; j<lids.size(); j++) {
+      bus = dynamic_cast<gridpack::powerflow::PFBus*>(
+          p_network->getBus(lids[j]).get());
+      bus->setDCInjection(0.0);
+    }
+  }
+
+  int nelem = p_elements.size();
+  dflow.resize(nelem);
+  for (i=0; i<nelem; i++) {
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          p_network->getBranch(p_elements[i].branch).get());
+    dflow[i] = p_elements[i].b*branch->getDCAngleDifference();
+  }
+  timer->stop(t_solve);
+}
+
+/**
+ * Evaluate power transfer distribution factors of all monitored
+ * elements for an injection at a bus that is withdrawn at the
+ * reference bus. This is collective on the network communicator
+ * @param bus original index of bus with injection
+ * @param factors PTDF factors of locally held elements. Only factors
+ * with absolute value above the threshold are included
+ */
+void gridpack::powerflow::DCSensitivityModule::getPTDF(int bus,
+    std::vector<SensitivityFactor> &factors)
+{
+  factors.clear();
+  std::vector<int> buses(1,bus);
+  std::vector<double> values(1,1.0);
+  std::vector<double> dflow;
+  solveFlows(buses, values, dflow);
+  int nelem = p_elements.size();
+  int i;
+  for (i=0; i<nelem; i++) {
+    if (p_elements[i].rating <= 0.0) continue;
+    if (fabs(dflow[i]) < p_threshold) continue;
+    SensitivityFactor factor;
+    factor.from = p_elements[i].from;
+    factor.to = p_elements[i].to;
+    factor.tag = p_elements[i].tag;
+    factor.value = dflow[i];
+    factors.push_back(factor);
+  }
+}
+
+/**
+ * Evaluate line outage distribution factors of all monitored elements
+ * for the outage of a single transmission element. This is collective
+ * on the network communicator
+ * @param from original index of "from" bus of element
+ * @param to original index of "to" bus of element
+ * @param tag identifier of element
+ * @param factors LODF factors of locally held elements. Only factors
+ * with absolute value above the threshold are included
+ * @return false if element was not found or if the outage splits the
+ * network into islands
+ */
+bool gridpack::powerflow::DCSensitivityModule::getLODF(int from, int to,
+    const std::string &tag, std::vector<SensitivityFactor> &factors)
+{
+  factors.clear();
+  // The transfer is applied in the direction of the element as stored in
+  // the network so that it matches the sign of the element's flow
+  int idx;
+  int ends[2];
+  if (!elementEnds(from, to, tag, idx, ends)) return false;
+  std::vector<int> buses(2);
+  std::vector<double> values(2);
+  buses[0] = ends[0];
+  buses[1] = ends[1];
+  values[0] = 1.0;
+  values[1] = -1.0;
+  std::vector<double> dflow;
+  solveFlows(buses, values, dflow);
+  // Sensitivity of outaged element to a transfer between its own ends
+  double self = 0.0;
+  if (idx >= 0) self = dflow[idx];
+  p_network->communicator().sum(&self,1);
+  double denom = 1.0 - self;
+  if (fabs(denom) < 1.0e-6) return false;
+  int nelem = p_elements.size();
+  int i;
+  for (i=0; i<nelem; i++) {
+    if (i == idx || p_elements[i].rating <= 0.0) continue;
+    double lodf = dflow[i]/denom;
+    if (fabs(lodf) < p_threshold) continue;
+    SensitivityFactor factor;
+    factor.from = p_elements[i].from;
+    factor.to = p_elements[i].to;
+    factor.tag = p_elements[i].tag;
+    factor.value = lodf;
+    factors.push_back(factor);
+  }
+  return true;
+}
+
+/**
+ * Estimate post-contingency flows of all monitored elements. This is
+ * collective on the network communicator
+ * @param event contingency
+ * @return result of screening. The index field is not set
+ */
+gridpack::powerflow::ScreeningResult
+  gridpack::powerflow::DCSensitivityModule::screen(const Contingency &event)
+{
+  ScreeningResult result;
+  result.index = -1;
+  result.maxLoading = 0.0;
+  result.overloads = 0;
+  result.estimated = false;
+  const gridpack::parallel::Communicator &comm = p_network->communicator();
+  int nelem = p_elements.size();
+  std::vector<double> flow(nelem);
+  std::vector<bool> outaged(nelem,false);
+  int i, j, k;
+  for (i=0; i<nelem; i++) flow[i] = p_elements[i].p;
+
+  if (event.p_type == Generator) {
+    // Lost generation is picked up by the reference bus
+    int ngen = event.p_busid.size();
+    std::vector<int> buses(ngen);
+    std::vector<double> values(ngen);
+    int found = 0;
+    for (i=0; i<ngen; i++) {
+      buses[i] = event.p_busid[i];
+      values[i] = 0.0;
+      std::vector<int> lids = p_network->getLocalBusIndices(buses[i]);
+      for (j=0; j<lids.size(); j++) {
+        if (!p_network->getActiveBus(lids[j])) continue;
+        gridpack::powerflow::PFBus *bus =
+          dynamic_cast<gridpack::powerflow::PFBus*>(
+              p_network->getBus(lids[j]).get());
+        values[i] = -bus->getGeneratorRealPower(event.p_genid[i]);
+        found++;
+      }
+    }
+    comm.sum(&values[0],ngen);
+    comm.sum(&found,1);
+    if (found < ngen) return result;
+    std::vector<double> dflow;
+    solveFlows(buses, values, dflow);
+    for (i=0; i<nelem; i++) flow[i] += dflow[i];
+  } else if (event.p_type == Branch) {
+    // Outages of m elements are modeled as transfers between the ends of
+    // each element. The transfers w satisfy (I - H) w = f, where H(l,m) is
+    // the sensitivity of outaged element l to the transfer across element m
+    // and f are the base case flows on the outaged elements
+    int nout = event.p_from.size();
+    if (nout == 0) return result;
+    std::vector<int> buses(2);
+    std::vector<double> values(2);
+    values[0] = 1.0;
+    values[1] = -1.0;
+    std::vector<int> idx(nout);
+    std::vector<int> ends(2*nout);
+    std::vector<double> a(nelem*nout);
+    std::vector<double> H(nout*nout,0.0);
+    std::vector<double> w(nout,0.0);
+    // Transfers are applied in the direction of the elements as stored in
+    // the network, which may differ from the order of the buses in the
+    // contingency
+    for (k=0; k<nout; k++) {
+      if (!elementEnds(event.p_from[k], event.p_to[k], event.p_ckt[k],
+            idx[k], &ends[2*k])) return result;
+      if (idx[k] >= 0) {
+        w[k] = p_elements[idx[k]].p;
+        outaged[idx[k]] = true;
+      }
+    }
+    comm.sum(&w[0],nout);
+    std::vector<double> dflow;
+    for (k=0; k<nout; k++) {
+      buses[0] = ends[2*k];
+      buses[1] = ends[2*k+1];
+      solveFlows(buses, values, dflow);
+      for (i=0; i<nelem; i++) a[i*nout+k] = dflow[i];
+      for (j=0; j<nout; j++) {
+        if (idx[j] >= 0) H[j*nout+k] = dflow[idx[j]];
+      }
+    }
+    comm.sum(&H[0],nout*nout);
+    // Solve (I - H) w = f with partial pivoting. A singular matrix means
+    // that the outage splits the network
+    for (j=0; j<nout; j++) {
+      for (k=0; k<nout; k++) {
+        H[j*nout+k] = (j == k ? 1.0 : 0.0) - H[j*nout+k];
+      }
+    }
+    for (k=0; k<nout; k++) {
+      int piv = k;
+      for (j=k+1; j<nout; j++) {
+        if (fabs(H[j*nout+k]) > fabs(H[piv*nout+k])) piv = j;
+      }
+      if (fabs(H[piv*nout+k]) < 1.0e-6) return result;
+      if (piv != k) {
+        for (i=0; i<nout; i++) std::swap(H[k*nout+i],H[piv*nout+i]);
+        std::swap(w[k],w[piv]);
+      }
+      for (j=k+1; j<nout; j++) {
+        double fac = H[j*nout+k]/H[k*nout+k];
+        for (i=k; i<nout; i++) H[j*nout+i] -= fac*H[k*nout+i];
+        w[j] -= fac*w[k];
+      }
+    }
+    for (k=nout-1; k>=0; k--) {
+      for (i=k+1; i<nout; i++) w[k] -= H[k*nout+i]*w[i];
+      w[k] /= H[k*nout+k];
+    }
+    for (i=0; i<nelem; i++) {
+      for (k=0; k<nout; k++) flow[i] += a[i*nout+k]*w[k];
+    }
+  } else {
+    return result;
+  }
+
+  // Estimate loading using base case reactive flows
+  for (i=0; i<nelem; i++) {
+    if (outaged[i] || p_elements[i].rating <= 0.0) continue;
+    double s = sqrt(flow[i]*flow[i]+p_elements[i].q*p_elements[i].q);
+    double loading = s/p_elements[i].rating;
+    if (loading > result.maxLoading) result.maxLoading = loading;
+    if (loading > 1.0) result.overloads++;
+  }
+  comm.max(&result.maxLoading,1);
+  comm.sum(&result.overloads,1);
+  result.estimated = true;
+  return result;
+}
+
+/**
+ * Screen a list of contingencies. Contingencies are divided between
+ * all copies of the network on the world communicator, each of which
+ * must have a DCSensitivityModule. This is collective on the world
+ * communicator and all processes get results for all contingencies
+ * @param events list of contingencies
+ * @param world communicator containing all copies of the network
+ * @return results for all contingencies in the order of events
+ */
+std::vector<gridpack::powerflow::ScreeningResult>
+  gridpack::powerflow::DCSensitivityModule::screen(
+      const std::vector<Contingency> &events,
+      gridpack::parallel::Communicator &world)
+{
+  int nevents = events.size();
+  std::vector<double> loading(nevents,0.0);
+  std::vector<int> overloads(nevents,0);
+  std::vector<int> estimated(nevents,0);
+  gridpack::parallel::Communicator comm = p_network->communicator();
+  gridpack::parallel::TaskManager taskmgr(world);
+  taskmgr.set(nevents);
+  int task_id;
+  while (taskmgr.nextTask(comm, &task_id)) {
+    ScreeningResult result = screen(events[task_id]);
+    // Only one process in each copy of the network contributes results
+    if (comm.rank() == 0) {
+      loading[task_id] = result.maxLoading;
+      overloads[task_id] = result.overloads;
+      estimated[task_id] = result.estimated ? 1 : 0;
+    }
+  }
+  if (nevents > 0) {
+    world.sum(&loading[0],nevents);
+    world.sum(&overloads[0],nevents);
+    world.sum(&estimated[0],nevents);
+  }
+  std::vector<ScreeningResult> results(nevents);
+  int i;
+  for (i=0; i<nevents; i++) {
+    results[i].index = i;
+    results[i].maxLoading = loading[i];
+    results[i].overloads = overloads[i];
+    results[i].estimated = (estimated[i] != 0);
+  }
+  return results;
+}
+
+/**
+ * Order contingencies by decreasing severity and drop the contingencies
+ * that are estimated to be below a loading limit. Contingencies that
+ * could not be estimated are always kept and come first
+ * @param results screening results
+ * @param cutoff contingencies with an estimated maximum loading below
+ * this value are dropped
+ * @param skipped indices of contingencies that were dropped
+ * @return indices of the remaining contingencies in order of decreasing
+ * severity
+ */
+std::vector<int> gridpack::powerflow::DCSensitivityModule::rank(
+    const std::vector<ScreeningResult> &results, double cutoff,
+    std::vector<int> &skipped)
+{
+  std::vector<int> order;
+  skipped.clear();
+  int nresults = results.size();
+  int i;
+  for (i=0; i<nresults; i++) {
+    if (results[i].estimated && results[i].maxLoading < cutoff) {
+      skipped.push_back(i);
+    } else {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), SeverityOrder(results));
+  return order;
+}
@@ -0,0 +1,219 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dc_sensitivity_module.hpp
+ *
+ * @brief
+ * DC sensitivities (PTDF and LODF factors) for a powerflow network and
+ * screening of contingencies based on these sensitivities. All factors are
+ * evaluated from solves of the DC B matrix, which is factored once for the
+ * base case topology. Contingencies that are estimated to be benign can be
+ * left out of the AC contingency calculations and the remaining
+ * contingencies can be run in order of their estimated severity.
+ */
+// -------------------------------------------------------------
+
+#ifndef _dc_sensitivity_module_h_
+#define _dc_sensitivity_module_h_
+
+#include <vector>
+#include <string>
+#include "boost/smart_ptr/shared_ptr.hpp"
+#include "gridpack/configuration/configuration.hpp"
+#include "gridpack/parallel/communicator.hpp"
+#include "pf_factory_module.hpp"
+#include "pf_app_module.hpp"
+
+namespace gridpack {
+namespace powerflow {
+
+// Single sensitivity factor of a monitored transmission element
+struct SensitivityFactor {
+  int from;          // original index of "from" bus
+  int to;            // original index of "to" bus
+  std::string tag;   // identifier of transmission element
+  double value;      // PTDF or LODF value
+};
+
+// Result of screening a single contingency
+struct ScreeningResult {
+  int index;         // index of contingency in list of contingencies
+  double maxLoading; // largest estimated post-contingency flow over rating
+  int overloads;     // number of elements with estimated loading above 1
+  bool estimated;    // false if contingency could not be estimated, e.g.
+                     // because it splits the network into islands
+};
+
+// Linear solver and vectors for DC solves (defined in
+// dc_sensitivity_module.cpp)
+struct DCSolver;
+
+class DCSensitivityModule
+{
+  public:
+
+    /**
+     * Basic constructor
+     * @param network powerflow network. The network must have been
+     * initialized by a PFAppModule
+     * @param cursor pointer to block in input file containing the linear
+     * solver parameters used for the DC B matrix
+     */
+    DCSensitivityModule(boost::shared_ptr<PFNetwork> network,
+        gridpack::utility::Configuration::CursorPtr cursor);
+
+    /**
+     * Basic destructor
+     */
+    ~DCSensitivityModule();
+
+    /**
+     * Smallest absolute value of PTDF and LODF factors that are returned by
+     * getPTDF and getLODF
+     * @param threshold cutoff for sensitivity factors
+     */
+    void setThreshold(double threshold);
+
+    /**
+     * Use rating B instead of rating A for estimated overloads
+     * @param flag if true, use rating B
+     */
+    void useRateB(bool flag);
+
+    /**
+     * Build and factor the DC B matrix for the current topology and store
+     * the base case flows. This is collective on the network communicator
+     * and must be called again if the topology of the base case changes
+     */
+    void setup(void);
+
+    /**
+     * Store the real and reactive flows of the current powerflow solution
+     * as the base case flows for screening. Call this after a new base
+     * case has been solved on the same topology
+     */
+    void setBaseFlows(void);
+
+    /**
+     * Evaluate power transfer distribution factors of all monitored
+     * elements for an injection at a bus that is withdrawn at the
+     * reference bus. This is collective on the network communicator
+     * @param bus original index of bus with injection
+     * @param factors PTDF factors of locally held elements. Only factors
+     * with absolute value above the threshold are included
+     */
+    void getPTDF(int bus, std::vector<SensitivityFactor> &factors);
+
+    /**
+     * Evaluate line outage distribution factors of all monitored elements
+     * for the outage of a single transmission element. This is collective
+     * on the network communicator
+     * @param from original index of "from" bus of element
+     * @param to original index of "to" bus of element
+     * @param tag identifier of element
+     * @param factors LODF factors of locally held elements. Only factors
+     * with absolute value above the threshold are included
+     * @return false if element was not found or if the outage splits the
+     * network into islands
+     */
+    bool getLODF(int from, int to, const std::string &tag,
+        std::vector<SensitivityFactor> &factors);
+
+    /**
+     * Estimate post-contingency flows of all monitored elements. This is
+     * collective on the network communicator
+     * @param event contingency
+     * @return result of screening. The index field is not set
+     */
+    ScreeningResult screen(const Contingency &event);
+
+    /**
+     * Screen a list of contingencies. Contingencies are divided between
+     * all copies of the network on the world communicator, each of which
+     * must have a DCSensitivityModule. This is collective on the world
+     * communicator and all processes get results for all contingencies
+     * @param events list of contingencies
+     * @param world communicator containing all copies of the network
+     * @return results for all contingencies in the order of events
+     */
+    std::vector<ScreeningResult> screen(const std::vector<Contingency> &events,
+        gridpack::parallel::Communicator &world);
+
+    /**
+     * Order contingencies by decreasing severity and drop the contingencies
+     * that are estimated to be below a loading limit. Contingencies that
+     * could not be estimated are always kept and come first
+     * @param results screening results
+     * @param cutoff contingencies with an estimated maximum loading below
+     * this value are dropped
+     * @param skipped indices of contingencies that were dropped
+     * @return indices of the remaining contingencies in order of decreasing
+     * severity
+     */
+    static std::vector<int> rank(const std::vector<ScreeningResult> &results,
+        double cutoff, std::vector<int> &skipped);
+
+  private:
+
+    // Transmission element held on this process
+    struct DCElement {
+      int branch;      // local index of branch
+      int from;        // original index of "from" bus
+      int to;          // original index of "to" bus
+      std::string tag; // identifier of element
+      double b;        // DC susceptance
+      double p, q;     // base case flow (MW, MVAR)
+      double rating;   // rating (MVA), zero if element is not monitored
+    };
+
+    /**
+     * Find a transmission element held on this process
+     * @param from original index of "from" bus
+     * @param to original index of "to" bus
+     * @param tag identifier of element
+     * @return index of element or -1 if element is not held on this process
+     */
+    int findElement(int from, int to, const std::string &tag);
+
+    /**
+     * Find the "from" and "to" buses of a transmission element as they are
+     * stored in the network. The element may be specified with its buses
+     * in either order. This is collective on the network communicator
+     * @param from original index of one bus of element
+     * @param to original index of other bus of element
+     * @param tag identifier of element
+     * @param idx index of element or -1 if element is not held on this
+     * process
+     * @param ends original indices of "from" and "to" bus of element
+     * @return false if element was not found on any process
+     */
+    bool elementEnds(int from, int to, const std::string &tag, int &idx,
+        int *ends);
+
+    /**
+     * Solve the DC equations for the injections at a set of buses and
+     * store the change in flow of all local elements. This is collective
+     * @param buses original indices of buses with injections
+     * @param values injections at buses
+     * @param dflow change in flow for each local element
+     */
+    void solveFlows(const std::vector<int> &buses,
+        const std::vector<double> &values, std::vector<double> &dflow);
+
+    boost::shared_ptr<PFNetwork> p_network;
+    boost::shared_ptr<PFFactoryModule> p_factory;
+    gridpack::utility::Configuration::CursorPtr p_cursor;
+    boost::shared_ptr<DCSolver> p_solver;
+    std::vector<DCElement> p_elements;
+    double p_threshold;
+    bool p_rateB;
+};
+
+} // powerflow
+} // gridpack
+
+#endif
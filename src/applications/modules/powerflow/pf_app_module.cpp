@@ -31,15 +31,110 @@
 #include "gridpack/math/math.hpp"
 #include "pf_helper.hpp"
 #include "gridpack/utilities/string_utils.hpp"
+#include <sys/stat.h>
 
 #define USE_REAL_VALUES
 
+namespace gridpack {
+namespace powerflow {
+
+/**
+ * Matrix, vectors and linear solver for one half step of the fast decoupled
+ * powerflow. The matrix only depends on the network topology, so the
+ * factorization from the first solve is kept for all later solves
+ */
+struct FastDecoupledStep {
+  int nrows;
+  boost::shared_ptr<gridpack::mapper::FullMatrixMap<PFNetwork> > mMap;
+  boost::shared_ptr<gridpack::mapper::BusVectorMap<PFNetwork> > vMap;
+  boost::shared_ptr<gridpack::math::RealMatrix> B;
+  boost::shared_ptr<gridpack::math::RealVector> mismatch;
+  boost::shared_ptr<gridpack::math::RealVector> dx;
+  boost::shared_ptr<gridpack::math::RealLinearSolver> solver;
+};
+
+/**
+ * Mappers, Jacobian, vectors and linear solver of the Newton-Raphson
+ * powerflow. The block sizes of all buses and branches are stored so
+ * that a change in the structure of the Jacobian can be detected
+ */
+struct NewtonRaphsonStep {
+  std::vector<int> pattern;
+  boost::shared_ptr<gridpack::mapper::FullMatrixMap<PFNetwork> > jMap;
+  boost::shared_ptr<gridpack::mapper::BusVectorMap<PFNetwork> > vMap;
+#ifdef USE_REAL_VALUES
+  boost::shared_ptr<gridpack::math::RealMatrix> J;
+  boost::shared_ptr<gridpack::math::RealVector> PQ;
+  boost::shared_ptr<gridpack::math::RealVector> X;
+  boost::shared_ptr<gridpack::math::RealLinearSolver> solver;
+#else
+  boost::shared_ptr<gridpack::math::Matrix> J;
+  boost::shared_ptr<gridpack::math::Vector> PQ;
+  boost::shared_ptr<gridpack::math::Vector> X;
+  boost::shared_ptr<gridpack::math::LinearSolver> solver;
+#endif
+};
+
+/**
+ * Add a block of bytes to a 64 bit FNV-1a hash
+ * @param hash current value of hash
+ * @param data pointer to bytes
+ * @param len number of bytes
+ * @return updated hash
+ */
+static unsigned long long snapshotHash(unsigned long long hash,
+    const void *data, size_t len)
+{
+  const unsigned char *ptr = static_cast<const unsigned char*>(data);
+  size_t i;
+  for (i=0; i<len; i++) {
+    hash ^= static_cast<unsigned long long>(ptr[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/**
+ * Key identifying a network file and the options used to parse it. The key
+ * changes if the name, size or modification time (including nanoseconds)
+ * of the file or any of the parse options change
+ * @param filename name of network file
+ * @param filetype format of network file
+ * @param phaseShiftSign sign convention for phase shifters
+ * @param key key for network snapshot
+ * @return false if file could not be found
+ */
+static bool snapshotKey(const std::string &filename, int filetype,
+    double phaseShiftSign, long long *key)
+{
+  struct stat st;
+  if (stat(filename.c_str(),&st) != 0) return false;
+  unsigned long long hash = 14695981039346656037ULL;
+  long long size = static_cast<long long>(st.st_size);
+  long long sec = static_cast<long long>(st.st_mtim.tv_sec);
+  long long nsec = static_cast<long long>(st.st_mtim.tv_nsec);
+  hash = snapshotHash(hash,filename.c_str(),filename.size());
+  hash = snapshotHash(hash,&size,sizeof(size));
+  hash = snapshotHash(hash,&sec,sizeof(sec));
+  hash = snapshotHash(hash,&nsec,sizeof(nsec));
+  hash = snapshotHash(hash,&filetype,sizeof(filetype));
+  hash = snapshotHash(hash,&phaseShiftSign,sizeof(phaseShiftSign));
+  *key = static_cast<long long>(hash);
+  return true;
+}
+
+} // powerflow
+} // gridpack
+
 /**
  * Basic constructor
  */
 gridpack::powerflow::PFAppModule::PFAppModule(void)
 {
   p_no_print = false;
+  p_fastDecoupled = false;
+  p_fd_max_iteration = 100;
+  p_weightedPartition = false;
 }
 
 /**
@@ -134,100 +229,145 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   p_tolerance = cursor->get("tolerance",1.0e-6);
   p_qlim = cursor->get("qlim",0);
   p_max_iteration = cursor->get("maxIteration",50);
+  p_fastDecoupled = cursor->get("fastDecoupled",false);
+  p_fd_max_iteration = cursor->get("fastDecoupledMaxIteration",
+      2*p_max_iteration);
+  p_weightedPartition = cursor->get("weightedPartition",false);
   ComplexType tol;
   // Phase shift sign
   double phaseShiftSign = cursor->get("phaseShiftSign",1.0);
 
+  // A binary snapshot of the partitioned network can be used instead of
+  // parsing and partitioning the network. The snapshot is written the first
+  // time the network is read and it is ignored if the network file or the
+  // parse options have changed since then. The key is evaluated on process
+  // 0, which reads the network file, and if the file cannot be found the
+  // snapshot is not used.
+  std::string snapshot = cursor->get("networkSnapshot","");
+  long long stamp = 0;
+  bool from_snapshot = false;
+  if (snapshot.size() > 0) {
+    long key[2];
+    key[0] = 0;
+    key[1] = 0;
+    if (p_comm.rank() == 0) {
+      long long lkey;
+      if (snapshotKey(filename,static_cast<int>(filetype),phaseShiftSign,
+            &lkey)) {
+        key[0] = 1;
+        key[1] = static_cast<long>(lkey);
+      }
+    }
+    p_comm.sum(key,2);
+    if (key[0] == 0) {
+      if (p_comm.rank() == 0) {
+        printf("Unable to find %s, network snapshot not used\n",
+            filename.c_str());
+      }
+      snapshot.clear();
+    } else {
+      stamp = static_cast<long long>(key[1]);
+      int t_snap = timer->createCategory("Powerflow: Load Network Snapshot");
+      timer->start(t_snap);
+      from_snapshot = network->loadSnapshot(snapshot, stamp);
+      timer->stop(t_snap);
+    }
+  }
+
   int t_pti = timer->createCategory("Powerflow: Network Parser");
   timer->start(t_pti);
-  if (filetype == PTI23) {
-    gridpack::parser::PTI23_parser<PFNetwork> parser(network);
+  if (!from_snapshot) {
+    if (filetype == PTI23) {
+      gridpack::parser::PTI23_parser<PFNetwork> parser(network);
 #ifdef USE_GOSS
-    char sbuf[256], sbuf2[256];
-    sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
-    sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
-    p_goss_client.publish(networkFile,sbuf,sbuf2);
-    std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
-    parser.parse(fileVec);
+      char sbuf[256], sbuf2[256];
+      sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
+      sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
+      p_goss_client.publish(networkFile,sbuf,sbuf2);
+      std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
+      parser.parse(fileVec);
 #else
-    try {
-      parser.parse(filename.c_str());
-    } catch (const gridpack::Exception e) {
-      std::string w(e.what());
-      if (!p_no_print) {
-        char ebuf[512];
-        sprintf(ebuf,"p[%d] unable to open network file: %s with error: %s\n",
-            filename.c_str(),w.c_str());
-        if (p_comm.rank() == 0) {
-          printf("%s",ebuf);
+      try {
+        parser.parse(filename.c_str());
+      } catch (const gridpack::Exception e) {
+        std::string w(e.what());
+        if (!p_no_print) {
+          char ebuf[512];
+          sprintf(ebuf,"p[%d] unable to open network file: %s with error: %s\n",
+              filename.c_str(),w.c_str());
+          if (p_comm.rank() == 0) {
+            printf("%s",ebuf);
+          }
         }
+        timer->stop(t_total);
       }
-      timer->stop(t_total);
-    }
 #endif
-    if (phaseShiftSign == -1.0) {
-      parser.changePhaseShiftSign();
-    }
-  } else if (filetype == PTI33) {
-    gridpack::parser::PTI33_parser<PFNetwork> parser(network);
+      if (phaseShiftSign == -1.0) {
+        parser.changePhaseShiftSign();
+      }
+    } else if (filetype == PTI33) {
+      gridpack::parser::PTI33_parser<PFNetwork> parser(network);
+      // Optionally read the file on all processors
+      parser.setParallelRead(cursor->get("parallelParse",false));
 #ifdef USE_GOSS
-    char sbuf[256], sbuf2[256];
-    sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
-    sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
-    p_goss_client.publish(networkFile,sbuf,sbuf2);
-    std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
-    parser.parse(fileVec);
+      char sbuf[256], sbuf2[256];
+      sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
+      sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
+      p_goss_client.publish(networkFile,sbuf,sbuf2);
+      std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
+      parser.parse(fileVec);
 #else
-    parser.parse(filename.c_str());
+      parser.parse(filename.c_str());
 #endif
-    if (phaseShiftSign == -1.0) {
-      parser.changePhaseShiftSign();
-    }
-  } else if (filetype == PTI34) {
-    gridpack::parser::PTI34_parser<PFNetwork> parser(network);
+      if (phaseShiftSign == -1.0) {
+        parser.changePhaseShiftSign();
+      }
+    } else if (filetype == PTI34) {
+      gridpack::parser::PTI34_parser<PFNetwork> parser(network);
 #ifdef USE_GOSS
-    char sbuf[256], sbuf2[256];
-    sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
-    sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
-    p_goss_client.publish(networkFile,sbuf,sbuf2);
-    std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
-    parser.parse(fileVec);
+      char sbuf[256], sbuf2[256];
+      sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
+      sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
+      p_goss_client.publish(networkFile,sbuf,sbuf2);
+      std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
+      parser.parse(fileVec);
 #else
-    parser.parse(filename.c_str());
+      parser.parse(filename.c_str());
 #endif
-    if (phaseShiftSign == -1.0) {
-      parser.changePhaseShiftSign();
-    }
-  } else if (filetype == PTI35) {
-    gridpack::parser::PTI35_parser<PFNetwork> parser(network);
+      if (phaseShiftSign == -1.0) {
+        parser.changePhaseShiftSign();
+      }
+    } else if (filetype == PTI35) {
+      gridpack::parser::PTI35_parser<PFNetwork> parser(network);
 #ifdef USE_GOSS
-    char sbuf[256], sbuf2[256];
-    sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
-    sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
-    p_goss_client.publish(networkFile,sbuf,sbuf2);
-    std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
-    parser.parse(fileVec);
+      char sbuf[256], sbuf2[256];
+      sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
+      sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
+      p_goss_client.publish(networkFile,sbuf,sbuf2);
+      std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
+      parser.parse(fileVec);
 #else
-    parser.parse(filename.c_str());
+      parser.parse(filename.c_str());
 #endif
-    if (phaseShiftSign == -1.0) {
-      parser.changePhaseShiftSign();
-    }
-  } else if (filetype == MAT_POWER) {
-    gridpack::parser::MAT_parser<PFNetwork> parser(network);
+      if (phaseShiftSign == -1.0) {
+        parser.changePhaseShiftSign();
+      }
+    } else if (filetype == MAT_POWER) {
+      gridpack::parser::MAT_parser<PFNetwork> parser(network);
 #ifdef USE_GOSS
-    char sbuf[256], sbuf2[256];
-    sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
-    sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
-    p_goss_client.publish(networkFile,sbuf,sbuf2);
-    std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
-    parser.parse(fileVec);
+      char sbuf[256], sbuf2[256];
+      sprintf(sbuf,"{ \"simulation_id\": \"%s\"}",simID.c_str());
+      sprintf(sbuf2,"reply.%s.%s\n",filename.c_str(),p_simID.c_str());
+      p_goss_client.publish(networkFile,sbuf,sbuf2);
+      std::vector<std::string> fileVec = p_goss_client.subscribeFileAsVector(std::string(sbuf2));
+      parser.parse(fileVec);
 #else
-    parser.parse(filename.c_str());
+      parser.parse(filename.c_str());
 #endif
-  } else if (filetype == GOSS) {
-    gridpack::parser::GOSS_parser<PFNetwork> parser(network);
-    parser.parse(filename.c_str());
+    } else if (filetype == GOSS) {
+      gridpack::parser::GOSS_parser<PFNetwork> parser(network);
+      parser.parse(filename.c_str());
+    }
   }
   timer->stop(t_pti);
 
@@ -248,7 +388,10 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   // partition network
   int t_part = timer->createCategory("Powerflow: Partition");
   timer->start(t_part);
-  network->partition();
+  if (!from_snapshot) {
+    network->partition();
+    if (snapshot.size() > 0) network->saveSnapshot(snapshot, stamp);
+  }
   timer->stop(t_part);
   timer->stop(t_total);
 }
@@ -272,11 +415,33 @@ void gridpack::powerflow::PFAppModule::initialize()
   // p_factory->dumpData();
   timer->stop(t_load);
 
+  // Partition network again with costs based on the Jacobian. Buses and
+  // branches move, so the factory has to be created and loaded again
+  if (p_weightedPartition) {
+    int t_part = timer->createCategory("Powerflow: Partition");
+    timer->start(t_part);
+    p_factory->setComponents();
+    p_factory->setMode(Jacobian);
+    std::vector<int> busWeights, branchWeights;
+    p_factory->partitionWeights(busWeights,branchWeights);
+    p_factory.reset();
+    p_network->partition(busWeights,branchWeights);
+    p_weightedPartition = false;
+    timer->stop(t_part);
+    p_factory.reset(new gridpack::powerflow::PFFactoryModule(p_network));
+    timer->start(t_load);
+    p_factory->load();
+    timer->stop(t_load);
+  }
+
   // set network components using factory
   int t_setc = timer->createCategory("Powerflow: Factory Set Components");
   timer->start(t_setc);
   p_factory->setComponents();
   timer->stop(t_setc);
+  p_fdP.reset();
+  p_fdQ.reset();
+  p_nr.reset();
 
   // Set up bus data exchange buffers. Need to decide what data needs to be
   // exchanged
@@ -304,6 +469,9 @@ void gridpack::powerflow::PFAppModule::reload()
   timer->start(t_load);
   p_factory->load();
   timer->stop(t_load);
+  p_fdP.reset();
+  p_fdQ.reset();
+  p_nr.reset();
 }
 
 /**
@@ -313,6 +481,13 @@ void gridpack::powerflow::PFAppModule::reload()
  */
 bool gridpack::powerflow::PFAppModule::solve()
 {
+  if (p_fastDecoupled) {
+    if (fd_solve()) return true;
+    if (!p_no_print) {
+      p_busIO->header("\nFast decoupled iterations did not converge,"
+          " switching to Newton-Raphson\n");
+    }
+  }
   bool ret = true;
   gridpack::utility::CoarseTimer *timer =
     gridpack::utility::CoarseTimer::instance();
@@ -364,19 +539,34 @@ bool gridpack::powerflow::PFAppModule::solve()
     timer->stop(t_fact);
     //  p_busIO->header("\nIteration 0\n");
 
+    // Mappers and linear solver are kept from the previous solve, e.g. of
+    // another contingency, unless the structure of the Jacobian changed
+    bool rebuilt = nrSetup();
+    gridpack::mapper::BusVectorMap<PFNetwork> &vMap = *(p_nr->vMap);
+    gridpack::mapper::FullMatrixMap<PFNetwork> &jMap = *(p_nr->jMap);
+#ifdef USE_REAL_VALUES
+    gridpack::math::RealLinearSolver &solver = *(p_nr->solver);
+#else
+    gridpack::math::LinearSolver &solver = *(p_nr->solver);
+#endif
+
     // Set PQ
-    timer->start(t_cmap);
-    p_factory->setMode(RHS); 
-    gridpack::mapper::BusVectorMap<PFNetwork> vMap(p_network);
-    timer->stop(t_cmap);
     int t_vmap = timer->createCategory("Powerflow: Map to Vector");
     timer->start(t_vmap);
 
 #ifdef USE_REAL_VALUES
-    boost::shared_ptr<gridpack::math::RealVector> PQ = vMap.mapToRealVector();
+    boost::shared_ptr<gridpack::math::RealVector> PQ = p_nr->PQ;
 #else
-    boost::shared_ptr<gridpack::math::Vector> PQ = vMap.mapToVector();
+    boost::shared_ptr<gridpack::math::Vector> PQ = p_nr->PQ;
 #endif
+    if (!rebuilt) {
+      p_factory->setMode(RHS);
+#ifdef USE_REAL_VALUES
+      vMap.mapToRealVector(PQ);
+#else
+      vMap.mapToVector(PQ);
+#endif
+    }
     timer->stop(t_vmap);
     gridpack::ComplexType  tol_org = PQ->normInfinity();
     if (!p_no_print) {
@@ -384,40 +574,30 @@ bool gridpack::powerflow::PFAppModule::solve()
       p_busIO->header(ioBuf);
     }
     //  PQ->print();
-    timer->start(t_cmap);
-    p_factory->setMode(Jacobian);
-    gridpack::mapper::FullMatrixMap<PFNetwork> jMap(p_network);
-    timer->stop(t_cmap);
     timer->start(t_mmap);
 
 #ifdef USE_REAL_VALUES
-    boost::shared_ptr<gridpack::math::RealMatrix> J = jMap.mapToRealMatrix();
+    boost::shared_ptr<gridpack::math::RealMatrix> J = p_nr->J;
 #else
-    boost::shared_ptr<gridpack::math::Matrix> J = jMap.mapToMatrix();
+    boost::shared_ptr<gridpack::math::Matrix> J = p_nr->J;
 #endif
-    timer->stop(t_mmap);
-    //  p_busIO->header("\nJacobian values\n");
-    //  J->print();
-
-    // Create X vector by cloning PQ
+    if (!rebuilt) {
+      p_factory->setMode(Jacobian);
 #ifdef USE_REAL_VALUES
-    boost::shared_ptr<gridpack::math::RealVector> X(PQ->clone());
+      jMap.refillRealMatrix(J);
 #else
-    boost::shared_ptr<gridpack::math::Vector> X(PQ->clone());
+      jMap.refillMatrix(J);
 #endif
+    }
+    timer->stop(t_mmap);
+    //  p_busIO->header("\nJacobian values\n");
+    //  J->print();
 
-    gridpack::utility::Configuration::CursorPtr cursor;
-    cursor = p_config->getCursor("Configuration.Powerflow");
-    // Create linear solver
-    int t_csolv = timer->createCategory("Powerflow: Create Linear Solver");
-    timer->start(t_csolv);
 #ifdef USE_REAL_VALUES
-    gridpack::math::RealLinearSolver solver(*J);
+    boost::shared_ptr<gridpack::math::RealVector> X = p_nr->X;
 #else
-    gridpack::math::LinearSolver solver(*J);
+    boost::shared_ptr<gridpack::math::Vector> X = p_nr->X;
 #endif
-    solver.configure(cursor);
-    timer->stop(t_csolv);
 
     // First iteration
     X->zero(); //might not need to do this
@@ -483,10 +663,12 @@ bool gridpack::powerflow::PFAppModule::solve()
       timer->stop(t_vmap);
       timer->start(t_mmap);
       p_factory->setMode(Jacobian);
+      // Structure of Jacobian does not change between iterations, so only
+      // refill the values using the pattern cached in jMap
 #ifdef USE_REAL_VALUES
-      jMap.mapToRealMatrix(J);
+      jMap.refillRealMatrix(J);
 #else
-      jMap.mapToMatrix(J);
+      jMap.refillMatrix(J);
 #endif
       timer->stop(t_mmap);
 
@@ -531,6 +713,11 @@ bool gridpack::powerflow::PFAppModule::solve()
     }
 
     if (iter >= p_max_iteration) ret = false;
+    if (!p_no_print) {
+      sprintf(ioBuf,"\nLinear solver factorizations: symbolic %d numeric %d\n",
+          solver.symbolicFactorizations(),solver.numericFactorizations());
+      p_busIO->header(ioBuf);
+    }
     if (p_qlim == 0) {
       repeat = false;
     } else {
@@ -622,6 +809,314 @@ bool gridpack::powerflow::PFAppModule::nl_solve()
 }
 
 
+/**
+ * Execute the iterative solve portion of the application using the fast
+ * decoupled (XB) method
+ * @return false if the iterations did not converge
+ */
+bool gridpack::powerflow::PFAppModule::fd_solve()
+{
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_total = timer->createCategory("Powerflow: Total Application");
+  timer->start(t_total);
+  int t_fact = timer->createCategory("Powerflow: Factory Operations");
+  int t_setup = timer->createCategory("Powerflow: Fast Decoupled Setup");
+  int t_iter = timer->createCategory("Powerflow: Fast Decoupled Iterations");
+  p_factory->clearViolations();
+
+  // Save starting point so that it can be restored if the iterations fail
+  int nbus = p_network->numBuses();
+  std::vector<double> v0(nbus), a0(nbus);
+  int i;
+  for (i=0; i<nbus; i++) {
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>(p_network->getBus(i).get());
+    v0[i] = bus->getVoltage();
+    a0[i] = bus->getPhase();
+  }
+  if (p_qlim != 0) p_factory->saveQlimState();
+
+  bool ret = false;
+  bool repeat = true;
+  while (repeat) {
+    timer->start(t_fact);
+    p_factory->setYBus();
+    p_factory->setSBus();
+    timer->stop(t_fact);
+
+    timer->start(t_setup);
+    if (!p_fdP) fdSetup(true);
+    if (!p_fdQ) fdSetup(false);
+    timer->stop(t_setup);
+
+    timer->start(t_iter);
+    ret = fdIterate();
+    timer->stop(t_iter);
+    if (!ret) break;
+
+    repeat = false;
+    if (p_qlim != 0 && !p_factory->checkQlimViolations()) {
+      // Some PV buses have been converted to PQ buses, which changes the
+      // rows of B''
+      if (!p_no_print) {
+        p_busIO->header("There are Qlim violations in fast decoupled solve\n");
+      }
+      p_fdQ.reset();
+      repeat = true;
+    }
+  }
+
+  if (!ret) {
+    for (i=0; i<nbus; i++) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>(p_network->getBus(i).get());
+      bus->setVoltage(v0[i], a0[i]);
+    }
+    p_network->updateBuses();
+    // Undo any PV to PQ conversions so that the Newton-Raphson solve starts
+    // from the same bus types as the fast decoupled solve
+    if (p_qlim != 0) {
+      p_factory->restoreQlimState();
+      p_fdQ.reset();
+    }
+  }
+  timer->stop(t_total);
+  return ret;
+}
+
+/**
+ * Try the fast decoupled method first when calling solve()
+ * @param flag use fast decoupled method if true
+ */
+void gridpack::powerflow::PFAppModule::useFastDecoupled(bool flag)
+{
+  p_fastDecoupled = flag;
+}
+
+/**
+ * Build and factor the B' matrix (realPower is true) or the B'' matrix
+ * of the fast decoupled method for the current network topology
+ * @param realPower build matrix for P-theta (true) or Q-V half steps
+ */
+void gridpack::powerflow::PFAppModule::fdSetup(bool realPower)
+{
+  boost::shared_ptr<FastDecoupledStep> step(new FastDecoupledStep);
+  if (realPower) {
+    p_fdP = step;
+    p_factory->setMode(FastDecoupledP);
+  } else {
+    p_fdQ = step;
+    p_factory->setMode(FastDecoupledQ);
+  }
+
+  // B'' has no rows if all buses are PV buses, in which case there are no
+  // Q-V half steps
+  int i, isize;
+  int nbus = p_network->numBuses();
+  step->nrows = 0;
+  for (i=0; i<nbus; i++) {
+    if (p_network->getActiveBus(i) &&
+        p_network->getBus(i)->vectorSize(&isize)) {
+      step->nrows++;
+    }
+  }
+  p_comm.sum(&step->nrows,1);
+  if (step->nrows == 0) return;
+
+  step->mMap.reset(new gridpack::mapper::FullMatrixMap<PFNetwork>(p_network));
+  step->B = step->mMap->mapToRealMatrix();
+  step->vMap.reset(new gridpack::mapper::BusVectorMap<PFNetwork>(p_network));
+  step->mismatch = step->vMap->mapToRealVector();
+  step->dx.reset(step->mismatch->clone());
+
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = p_config->getCursor("Configuration.Powerflow");
+  step->solver.reset(new gridpack::math::RealLinearSolver(*(step->B)));
+  step->solver->configure(cursor);
+  step->solver->reuseMode(gridpack::math::ReuseFactorization);
+}
+
+/**
+ * Build the mappers, Jacobian, vectors and linear solver of the
+ * Newton-Raphson method. The ones from the previous solve are kept if
+ * the block structure of the Jacobian has not changed, e.g. if a
+ * contingency only switched lines out of service
+ * @return true if new mappers and solver were built
+ */
+bool gridpack::powerflow::PFAppModule::nrSetup(void)
+{
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_cmap = timer->createCategory("Powerflow: Create Mappers");
+  int t_csolv = timer->createCategory("Powerflow: Create Linear Solver");
+  timer->start(t_cmap);
+  // Outaged lines leave their branch blocks in the Jacobian, but isolated
+  // buses and PV buses that are converted to PQ buses change the block sizes
+  std::vector<int> pattern;
+  int i, isize, jsize;
+  int nbus = p_network->numBuses();
+  int nbranch = p_network->numBranches();
+  p_factory->setMode(RHS);
+  for (i=0; i<nbus; i++) {
+    if (!p_network->getBus(i)->vectorSize(&isize)) isize = 0;
+    pattern.push_back(isize);
+  }
+  p_factory->setMode(Jacobian);
+  for (i=0; i<nbus; i++) {
+    if (!p_network->getBus(i)->matrixDiagSize(&isize,&jsize)) {
+      isize = 0;
+      jsize = 0;
+    }
+    pattern.push_back(isize);
+    pattern.push_back(jsize);
+  }
+  for (i=0; i<nbranch; i++) {
+    if (!p_network->getBranch(i)->matrixForwardSize(&isize,&jsize)) {
+      isize = 0;
+      jsize = 0;
+    }
+    pattern.push_back(isize);
+    pattern.push_back(jsize);
+    if (!p_network->getBranch(i)->matrixReverseSize(&isize,&jsize)) {
+      isize = 0;
+      jsize = 0;
+    }
+    pattern.push_back(isize);
+    pattern.push_back(jsize);
+  }
+  int changed = 0;
+  if (!p_nr || p_nr->pattern != pattern) changed = 1;
+  p_comm.sum(&changed,1);
+  if (changed == 0) {
+    timer->stop(t_cmap);
+    return false;
+  }
+
+  p_nr.reset(new NewtonRaphsonStep);
+  p_nr->pattern = pattern;
+  p_factory->setMode(RHS);
+  p_nr->vMap.reset(new gridpack::mapper::BusVectorMap<PFNetwork>(p_network));
+#ifdef USE_REAL_VALUES
+  p_nr->PQ = p_nr->vMap->mapToRealVector();
+#else
+  p_nr->PQ = p_nr->vMap->mapToVector();
+#endif
+  p_nr->X.reset(p_nr->PQ->clone());
+  p_factory->setMode(Jacobian);
+  p_nr->jMap.reset(new gridpack::mapper::FullMatrixMap<PFNetwork>(p_network));
+#ifdef USE_REAL_VALUES
+  p_nr->J = p_nr->jMap->mapToRealMatrix();
+#else
+  p_nr->J = p_nr->jMap->mapToMatrix();
+#endif
+  timer->stop(t_cmap);
+
+  timer->start(t_csolv);
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = p_config->getCursor("Configuration.Powerflow");
+#ifdef USE_REAL_VALUES
+  p_nr->solver.reset(new gridpack::math::RealLinearSolver(*(p_nr->J)));
+#else
+  p_nr->solver.reset(new gridpack::math::LinearSolver(*(p_nr->J)));
+#endif
+  p_nr->solver->configure(cursor);
+  // The Jacobian is refilled with the same nonzero pattern in each
+  // iteration and for each contingency, so the symbolic factorization can
+  // be reused unless some other reuse mode has been requested in the input
+  if (p_nr->solver->reuseMode() == gridpack::math::ReuseNone) {
+    p_nr->solver->reuseMode(gridpack::math::SameNonzeroPattern);
+  }
+  timer->stop(t_csolv);
+  return true;
+}
+
+/**
+ * Alternate P-theta and Q-V half steps of the fast decoupled method until
+ * both mismatches are converged. A half step is only taken if its mismatch
+ * is not converged and the iterations stop when both mismatches are
+ * converged for the same voltages
+ * @return false if iterations did not converge
+ */
+bool gridpack::powerflow::PFAppModule::fdIterate(void)
+{
+  int t_bmap = gridpack::utility::CoarseTimer::instance()->createCategory(
+      "Powerflow: Map to Bus");
+  char ioBuf[128];
+  bool pDone = (p_fdP->nrows == 0);
+  bool qDone = (p_fdQ->nrows == 0);
+  if (pDone && qDone) return true;
+  double tolP = 0.0, tolQ = 0.0;
+  // initial mismatch of the P and Q half steps
+  double tol_org[2] = {-1.0, -1.0};
+  int iter = 0;
+  FastDecoupledStep *steps[2] = {p_fdP.get(), p_fdQ.get()};
+  int modes[2] = {FastDecoupledP, FastDecoupledQ};
+  while (iter < p_fd_max_iteration) {
+    int k;
+    for (k=0; k<2; k++) {
+      FastDecoupledStep *step = steps[k];
+      if (step->nrows == 0) continue;
+      p_factory->setMode(modes[k]);
+      step->vMap->mapToRealVector(step->mismatch);
+      double tol = step->mismatch->normInfinity();
+      if (k == 0) {
+        tolP = tol;
+      } else {
+        tolQ = tol;
+      }
+      if (tol_org[k] < 0.0) tol_org[k] = tol;
+      if (!(tol == tol) || tol > 100.0*tol_org[k]) {
+        if (!p_no_print) {
+          p_busIO->header("\nFast decoupled iterations diverge\n");
+        }
+        return false;
+      }
+      if (tol <= p_tolerance) {
+        if (k == 0) {
+          pDone = true;
+        } else {
+          qDone = true;
+        }
+        if (pDone && qDone) {
+          if (!p_no_print) {
+            sprintf(ioBuf,"\nFast decoupled converged in %d iterations\n",
+                iter);
+            p_busIO->header(ioBuf);
+          }
+          return true;
+        }
+        continue;
+      }
+      try {
+        step->solver->solve(*(step->mismatch), *(step->dx));
+      } catch (const gridpack::Exception e) {
+        if (!p_no_print) {
+          sprintf(ioBuf,"p[%d] hit exception in fast decoupled solve\n",
+              p_network->communicator().rank());
+          p_busIO->header(ioBuf);
+        }
+        return false;
+      }
+      step->vMap->mapToBus(step->dx);
+      p_network->updateBuses();
+      // The other mismatch has to be checked again after an update
+      if (k == 0) {
+        qDone = (p_fdQ->nrows == 0);
+      } else {
+        pDone = (p_fdP->nrows == 0);
+      }
+    }
+    iter++;
+    if (!p_no_print) {
+      sprintf(ioBuf,"\nFast decoupled iteration %d P Tol: %12.6e"
+          " Q Tol: %12.6e\n",iter,tolP,tolQ);
+      p_busIO->header(ioBuf);
+    }
+  }
+  return false;
+}
+
 /**
  * Write out results of powerflow calculation to standard output or a file
  */
@@ -915,6 +1410,9 @@ bool gridpack::powerflow::PFAppModule::setContingency(
     p_contingency_name.clear();
   }
   p_factory->checkLoneBus();
+  // Fast decoupled matrices must be rebuilt for the new topology
+  p_fdP.reset();
+  p_fdQ.reset();
   return ret;
 }
 
@@ -927,6 +1425,8 @@ bool gridpack::powerflow::PFAppModule::unSetContingency(
     gridpack::powerflow::Contingency &event)
 {
   p_factory->clearLoneBus();
+  p_fdP.reset();
+  p_fdQ.reset();
   bool ret = true;
   if (event.p_type == Generator) {
     int ngen = event.p_busid.size();
@@ -1068,6 +1568,24 @@ void gridpack::powerflow::PFAppModule::resetVoltages()
   p_factory->resetVoltages();
 }
 
+/**
+ * Save current voltages. These can be used as a warm start for
+ * subsequent calculations, e.g. contingencies that start from the
+ * solution of the base case
+ */
+void gridpack::powerflow::PFAppModule::saveVoltages()
+{
+  p_factory->saveVoltages();
+}
+
+/**
+ * Restore voltages to values stored by saveVoltages
+ */
+void gridpack::powerflow::PFAppModule::restoreVoltages()
+{
+  p_factory->restoreVoltages();
+}
+
 /**
  * Scale generator real power. If zone less than 1 then scale all
  * generators in the area.
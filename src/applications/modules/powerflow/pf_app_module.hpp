@@ -71,6 +71,14 @@ struct Contingency
   std::vector<bool> p_saveGenStatus;
 };
 
+// Matrix, vectors and linear solver for one half step of the fast
+// decoupled powerflow (defined in pf_app_module.cpp)
+struct FastDecoupledStep;
+
+// Mappers, Jacobian, vectors and linear solver of the Newton-Raphson
+// powerflow (defined in pf_app_module.cpp)
+struct NewtonRaphsonStep;
+
 // Calling program for powerflow application
 
 class PFAppModule
@@ -124,6 +132,25 @@ class PFAppModule
      */
     bool nl_solve();
 
+    /**
+     * Execute the iterative solve portion of the application using the fast
+     * decoupled (XB) method. The B' and B'' matrices are built and factored
+     * on the first call and reused by later calls until the network
+     * topology changes, so each iteration only requires triangular solves
+     * @return false if the iterations did not converge. The voltages are
+     * restored to their values at the start of the call in this case
+     */
+    bool fd_solve();
+
+    /**
+     * Try the fast decoupled method first when calling solve(). The full
+     * Newton-Raphson iterations are only used if it does not converge.
+     * This can also be set with the fastDecoupled parameter in the input
+     * file
+     * @param flag use fast decoupled method if true
+     */
+    void useFastDecoupled(bool flag);
+
     /**
      * Write out results of powerflow calculation to standard output
      * Separate calls for writing only data from buses or branches
@@ -277,6 +304,18 @@ class PFAppModule
      */
     void resetVoltages();
 
+    /**
+     * Save current voltages. These can be used as a warm start for
+     * subsequent calculations, e.g. contingencies that start from the
+     * solution of the base case
+     */
+    void saveVoltages();
+
+    /**
+     * Restore voltages to values stored by saveVoltages
+     */
+    void restoreVoltages();
+
     /**
      * Scale generator real power. If zone less than 1 then scale all
      * generators in the area.
@@ -474,6 +513,29 @@ class PFAppModule
 
   private:
 
+    /**
+     * Build and factor the B' matrix (realPower is true) or the B'' matrix
+     * of the fast decoupled method for the current network topology
+     * @param realPower build matrix for P-theta (true) or Q-V half steps
+     */
+    void fdSetup(bool realPower);
+
+    /**
+     * Build the mappers, Jacobian, vectors and linear solver of the
+     * Newton-Raphson method. The ones from the previous solve are kept if
+     * the block structure of the Jacobian has not changed, e.g. if a
+     * contingency only switched lines out of service
+     * @return true if new mappers and solver were built
+     */
+    bool nrSetup(void);
+
+    /**
+     * Alternate P-theta and Q-V half steps of the fast decoupled method
+     * until both mismatches are converged
+     * @return false if iterations did not converge
+     */
+    bool fdIterate(void);
+
     /**
      * Template function for modifying generator parameters in data collection
      * for specified bus
@@ -489,6 +551,10 @@ class PFAppModule
         int bus_id, std::string gen_id, std::string genParam, T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      // Resolve data collection keys once instead of for every lookup
+      static const gridpack::component::DataKey numKey(GENERATOR_NUMBER);
+      static const gridpack::component::DataKey idKey(GENERATOR_ID);
+      gridpack::component::DataKey paramKey(genParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -501,14 +567,14 @@ class PFAppModule
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           int ngen;
-          if (data->getValue(GENERATOR_NUMBER, &ngen)) {
+          if (data->getValue(numKey, &ngen)) {
             int igen = -1;
             T tval;
             int j;
             std::string gID;
             for (j = 0; j<ngen; j++) {
               // Get index of generator
-              if (data->getValue(GENERATOR_ID,&gID,j)) {
+              if (data->getValue(idKey,&gID,j)) {
                 if (gID == clean_id) {
                   igen = j;
                   break;
@@ -516,7 +582,7 @@ class PFAppModule
               }
             }
             if (igen >= 0) {
-              if (data->setValue(genParam.c_str(),value,igen)) {
+              if (data->setValue(paramKey,value,igen)) {
                 ret = true;
               }
             }
@@ -542,6 +608,9 @@ class PFAppModule
           std::string loadParam, T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      static const gridpack::component::DataKey numKey(LOAD_NUMBER);
+      static const gridpack::component::DataKey idKey(LOAD_ID);
+      gridpack::component::DataKey paramKey(loadParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -554,13 +623,13 @@ class PFAppModule
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           int nload;
-          if (data->getValue(LOAD_NUMBER, &nload)) {
+          if (data->getValue(numKey, &nload)) {
             int iload = -1;
             T tval;
             int j;
             std::string lID;
             for (j = 0; j<nload; j++) {
-              if (data->getValue(LOAD_ID,&lID,j)) {
+              if (data->getValue(idKey,&lID,j)) {
                 if (lID == clean_id) {
                   iload = j;
                   break;
@@ -568,7 +637,7 @@ class PFAppModule
               }
             }
             if (iload >= 0) {
-              if (data->setValue(loadParam.c_str(),value,iload)) {
+              if (data->setValue(paramKey,value,iload)) {
                 ret = true;
               }
             }
@@ -593,6 +662,7 @@ class PFAppModule
         T value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      gridpack::component::DataKey paramKey(busParam);
       if (indices.size() > 0) {
         int i;
         bool ret = false;
@@ -600,7 +670,7 @@ class PFAppModule
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBusData(indices[i]);
           T tval;
-          if (data->setValue(busParam.c_str(),value)) {
+          if (data->setValue(paramKey,value)) {
             ret = true;
           }
         }
@@ -624,6 +694,9 @@ class PFAppModule
         std::string branchParam, T value)
     {
       std::vector<int> indices = p_network->getLocalBranchIndices(bus1, bus2);
+      static const gridpack::component::DataKey numKey(BRANCH_NUM_ELEMENTS);
+      static const gridpack::component::DataKey idKey(BRANCH_CKT);
+      gridpack::component::DataKey paramKey(branchParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -636,13 +709,13 @@ class PFAppModule
           boost::shared_ptr<gridpack::component::DataCollection> data =
             p_network->getBranchData(indices[i]);
           int nbranch;
-          if (data->getValue(BRANCH_NUM_ELEMENTS, &nbranch)) {
+          if (data->getValue(numKey, &nbranch)) {
             int ibr = -1;
             T tval;
             int j;
             std::string brID;
             for (j=0; j<nbranch; j++) {
-              if (data->getValue(BRANCH_CKT,&brID,j)) {
+              if (data->getValue(idKey,&brID,j)) {
                 if (clean_id == brID) {
                   ibr = j;
                   break;
@@ -650,7 +723,7 @@ class PFAppModule
               }
             }
             if (ibr >= 0) {
-              if (data->setValue(branchParam.c_str(),value,ibr)) {
+              if (data->setValue(paramKey,value,ibr)) {
                 ret = true;
               }
             }
@@ -676,6 +749,9 @@ class PFAppModule
         int bus_id, std::string gen_id, std::string genParam, T *value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      static const gridpack::component::DataKey numKey(GENERATOR_NUMBER);
+      static const gridpack::component::DataKey idKey(GENERATOR_ID);
+      gridpack::component::DataKey paramKey(genParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -689,14 +765,14 @@ class PFAppModule
             boost::shared_ptr<gridpack::component::DataCollection> data =
               p_network->getBusData(indices[i]);
             int ngen;
-            if (data->getValue(GENERATOR_NUMBER, &ngen)) {
+            if (data->getValue(numKey, &ngen)) {
               int igen = -1;
               T tval;
               int j;
               std::string gID;
               for (j = 0; j<ngen; j++) {
                 // Get index of generator
-                if (data->getValue(GENERATOR_ID,&gID,j)) {
+                if (data->getValue(idKey,&gID,j)) {
                   if (gID == clean_id) {
                     igen = j;
                     break;
@@ -704,7 +780,7 @@ class PFAppModule
                 }
               }
               if (igen >= 0) {
-                if (data->getValue(genParam.c_str(),value,igen)) {
+                if (data->getValue(paramKey,value,igen)) {
                   ret = true;
                 }
               }
@@ -731,6 +807,9 @@ class PFAppModule
           std::string loadParam, T *value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      static const gridpack::component::DataKey numKey(LOAD_NUMBER);
+      static const gridpack::component::DataKey idKey(LOAD_ID);
+      gridpack::component::DataKey paramKey(loadParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -744,13 +823,13 @@ class PFAppModule
             boost::shared_ptr<gridpack::component::DataCollection> data =
               p_network->getBusData(indices[i]);
             int nload;
-            if (data->getValue(LOAD_NUMBER, &nload)) {
+            if (data->getValue(numKey, &nload)) {
               int iload = -1;
               T tval;
               int j;
               std::string lID;
               for (j = 0; j<nload; j++) {
-                if (data->getValue(LOAD_ID,&lID,j)) {
+                if (data->getValue(idKey,&lID,j)) {
                   if (lID == clean_id) {
                     iload = j;
                     break;
@@ -758,7 +837,7 @@ class PFAppModule
                 }
               }
               if (iload >= 0) {
-                if (data->getValue(loadParam.c_str(),value,iload)) {
+                if (data->getValue(paramKey,value,iload)) {
                   ret = true;
                 }
               }
@@ -784,6 +863,7 @@ class PFAppModule
         T *value)
     {
       std::vector<int> indices = p_network->getLocalBusIndices(bus_id);
+      gridpack::component::DataKey paramKey(busParam);
       if (indices.size() > 0) {
         int i;
         bool ret = false;
@@ -792,7 +872,7 @@ class PFAppModule
             boost::shared_ptr<gridpack::component::DataCollection> data =
               p_network->getBusData(indices[i]);
             T tval;
-            if (data->getValue(busParam.c_str(),value)) {
+            if (data->getValue(paramKey,value)) {
               ret = true;
             }
           }
@@ -817,6 +897,9 @@ class PFAppModule
         std::string branchParam, T *value)
     {
       std::vector<int> indices = p_network->getLocalBranchIndices(bus1, bus2);
+      static const gridpack::component::DataKey numKey(BRANCH_NUM_ELEMENTS);
+      static const gridpack::component::DataKey idKey(BRANCH_CKT);
+      gridpack::component::DataKey paramKey(branchParam);
 	  
 	  gridpack::utility::StringUtils util;
 	  std::string clean_id;
@@ -830,13 +913,13 @@ class PFAppModule
             boost::shared_ptr<gridpack::component::DataCollection> data =
               p_network->getBranchData(indices[i]);
             int nbranch;
-            if (data->getValue(BRANCH_NUM_ELEMENTS, &nbranch)) {
+            if (data->getValue(numKey, &nbranch)) {
               int ibr = -1;
               T tval;
               int j;
               std::string brID;
               for (j=0; j<nbranch; j++) {
-                if (data->getValue(BRANCH_CKT,&brID,j)) {
+                if (data->getValue(idKey,&brID,j)) {
                   if (clean_id == brID) {
                     ibr = j;
                     break;
@@ -844,7 +927,7 @@ class PFAppModule
                 }
               }
               if (ibr >= 0) {
-                if (data->getValue(branchParam.c_str(),value,ibr)) {
+                if (data->getValue(paramKey,value,ibr)) {
                   ret = true;
                 }
               }
@@ -874,6 +957,24 @@ class PFAppModule
     // qlim enforce flag
     int p_qlim;
 
+    // use fast decoupled method in solve()
+    bool p_fastDecoupled;
+
+    // maximum number of fast decoupled iterations
+    int p_fd_max_iteration;
+
+    // partition network again in initialize() using estimated costs
+    bool p_weightedPartition;
+
+    // fast decoupled half steps for current topology. These are discarded
+    // when the topology changes
+    boost::shared_ptr<FastDecoupledStep> p_fdP;
+    boost::shared_ptr<FastDecoupledStep> p_fdQ;
+
+    // Newton-Raphson mappers and solver. These are kept between solves as
+    // long as the block structure of the Jacobian does not change
+    boost::shared_ptr<NewtonRaphsonStep> p_nr;
+
     // pointer to bus IO module
     boost::shared_ptr<gridpack::serial_io::SerialBusIO<PFNetwork> > p_busIO;
 
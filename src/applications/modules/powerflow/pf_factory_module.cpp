@@ -682,6 +682,50 @@ void gridpack::powerflow::PFFactoryModule::clearQlimViolations()
   }
 }
 
+/**
+ * Save the state of all buses that is modified by checkQlimViolations
+ */
+void gridpack::powerflow::PFFactoryModule::saveQlimState()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    if (p_network->getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (p_network->getBus(i).get());
+      bus->saveQlimState();
+    }
+  }
+}
+
+/**
+ * Undo all changes made by checkQlimViolations since the last call to
+ * saveQlimState
+ */
+void gridpack::powerflow::PFFactoryModule::restoreQlimState()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    if (p_network->getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (p_network->getBus(i).get());
+      bus->restoreQlimState();
+    }
+  }
+  p_network->updateBuses();
+  for (i=0; i<numBus; i++) {
+    if (!p_network->getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (p_network->getBus(i).get());
+      bus->pushIsPV();
+    }
+  }
+}
+
 /**
  * Reinitialize voltages
  */
@@ -699,6 +743,41 @@ void gridpack::powerflow::PFFactoryModule::resetVoltages()
   }
 }
 
+/**
+ * Save current voltages so that they can be used as starting point for
+ * subsequent calculations
+ */
+void gridpack::powerflow::PFFactoryModule::saveVoltages()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    if (p_network->getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (p_network->getBus(i).get());
+      bus->saveVoltage();
+    }
+  }
+}
+
+/**
+ * Restore voltages to values stored by saveVoltages
+ */
+void gridpack::powerflow::PFFactoryModule::restoreVoltages()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    if (p_network->getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>
+        (p_network->getBus(i).get());
+      bus->restoreVoltage();
+    }
+  }
+}
+
 /**
  * Scale generator real power. If zone less than 1 then scale all
  * generators in the area.
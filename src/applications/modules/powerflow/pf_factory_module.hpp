@@ -125,6 +125,17 @@ class PFFactoryModule
      */
     void clearQlimViolations();
 
+    /**
+     * Save the state of all buses that is modified by checkQlimViolations
+     */
+    void saveQlimState();
+
+    /**
+     * Undo all changes made by checkQlimViolations since the last call to
+     * saveQlimState
+     */
+    void restoreQlimState();
+
     /**
      * Set "ignore" parameter on all buses with violations so that subsequent
      * checks are not counted as violations
@@ -167,6 +178,17 @@ class PFFactoryModule
      */
     void resetVoltages();
 
+    /**
+     * Save current voltages so that they can be used as starting point for
+     * subsequent calculations
+     */
+    void saveVoltages();
+
+    /**
+     * Restore voltages to values stored by saveVoltages
+     */
+    void restoreVoltages();
+
     /**
      * Scale generator real power. If zone less than 1 then scale all
      * generators in the area
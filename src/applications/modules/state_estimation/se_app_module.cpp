@@ -36,6 +36,7 @@
  */
 gridpack::state_estimation::SEAppModule::SEAppModule(void)
 {
+  p_weightedPartition = false;
 }
 
 /**
@@ -146,6 +147,7 @@ void gridpack::state_estimation::SEAppModule::readNetwork(
   // Convergence and iteration parameters
   p_tolerance = secursor->get("tolerance",1.0e-3);
   p_max_iteration = secursor->get("maxIteration",20);
+  p_weightedPartition = secursor->get("weightedPartition",false);
 
   // load input file
   //gridpack::parser::PTI23_parser<SENetwork> parser(p_network);
@@ -278,6 +280,20 @@ void gridpack::state_estimation::SEAppModule::initialize(void)
   p_factory.reset(new gridpack::state_estimation::SEFactoryModule(p_network));
   p_factory->load();
 
+  // Partition network again with costs based on the Y-matrix. Buses and
+  // branches move, so the factory has to be created and loaded again
+  if (p_weightedPartition) {
+    p_factory->setComponents();
+    p_factory->setMode(YBus);
+    std::vector<int> busWeights, branchWeights;
+    p_factory->partitionWeights(busWeights,branchWeights);
+    p_factory.reset();
+    p_network->partition(busWeights,branchWeights);
+    p_weightedPartition = false;
+    p_factory.reset(new gridpack::state_estimation::SEFactoryModule(p_network));
+    p_factory->load();
+  }
+
   // set network components using factory
   p_factory->setComponents();
 
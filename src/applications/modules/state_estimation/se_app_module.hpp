@@ -124,6 +124,9 @@ class SEAppModule
 
     // convergence tolerance
     double p_tolerance;
+
+    // partition network again in initialize() using estimated costs
+    bool p_weightedPartition;
 };
 
 } // state estimation
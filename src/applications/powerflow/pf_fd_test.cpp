@@ -0,0 +1,116 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   pf_fd_test.cpp
+ *
+ * @brief
+ * Compare bus voltages from the fast decoupled power flow solver with
+ * voltages from the Newton-Raphson solver.
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+
+#define TOLERANCE 1.0e-4
+
+typedef gridpack::powerflow::PFNetwork PFNetwork;
+
+/**
+ * Get voltage magnitudes and angles of all active buses
+ * @param network powerflow network
+ * @param v voltage magnitudes
+ * @param a voltage angles
+ */
+void getVoltages(boost::shared_ptr<PFNetwork> network,
+    std::vector<double> &v, std::vector<double> &a)
+{
+  int nbus = network->numBuses();
+  int i;
+  v.assign(nbus,0.0);
+  a.assign(nbus,0.0);
+  for (i=0; i<nbus; i++) {
+    if (!network->getActiveBus(i)) continue;
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>(network->getBus(i).get());
+    v[i] = bus->getVoltage();
+    a[i] = bus->getPhase();
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int nerr = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    // read configuration file
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      char inputfile[256];
+      sprintf(inputfile,"%s",argv[1]);
+      config->open(inputfile,world);
+    } else {
+      config->open("input_14.xml",world);
+    }
+
+    boost::shared_ptr<PFNetwork> network(new PFNetwork(world));
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(network,config);
+    pf_app.initialize();
+
+    // Reference solution from Newton-Raphson solver
+    pf_app.useFastDecoupled(false);
+    pf_app.solve();
+    std::vector<double> v_nr, a_nr;
+    getVoltages(network,v_nr,a_nr);
+
+    // Solve again from the initial voltages using only the fast decoupled
+    // solver
+    pf_app.resetVoltages();
+    if (!pf_app.fd_solve()) {
+      if (world.rank() == 0) {
+        printf("Fast decoupled solver did not converge\n");
+        nerr++;
+      }
+    }
+    std::vector<double> v_fd, a_fd;
+    getVoltages(network,v_fd,a_fd);
+
+    int i;
+    int nchecked = 0;
+    for (i=0; i<network->numBuses(); i++) {
+      if (!network->getActiveBus(i)) continue;
+      if (fabs(v_fd[i]-v_nr[i]) > TOLERANCE
+          || fabs(a_fd[i]-a_nr[i]) > TOLERANCE) {
+        printf("p[%d] bus %d: fast decoupled V: %f Ang: %f"
+            " Newton-Raphson V: %f Ang: %f\n",world.rank(),
+            network->getOriginalBusIndex(i),v_fd[i],a_fd[i],v_nr[i],a_nr[i]);
+        nerr++;
+      }
+      nchecked++;
+    }
+
+    world.sum(&nerr,1);
+    world.sum(&nchecked,1);
+    if (nchecked == 0) nerr++;
+    if (world.rank() == 0) {
+      if (nerr == 0) {
+        printf("Fast decoupled test passed (%d buses checked)\n",nchecked);
+      } else {
+        printf("Fast decoupled test failed with %d errors\n",nerr);
+      }
+    }
+  }
+
+  return (nerr == 0 ? 0 : 1);
+}
@@ -839,6 +839,40 @@ void gridpack::rtpr::RTPRDriver::execute(int argc, char** argv, gridpack::Enviro
     printf("Using Branch Rating B parameter for checking line overloads\n");
   }
 
+  // Skip contingencies whose estimated line loading from DC sensitivities
+  // is below screeningLoading and run the rest in order of decreasing
+  // estimated loading
+  p_dcScreening = cursor->get("dcScreening",false);
+  p_screeningLoading = cursor->get("screeningLoading",0.9);
+
+  // Choose between the fixed step scan and the bracketed search for the
+  // rating. The bracketed search can evaluate several ratings at the same
+  // time on different groups of task communicators
+  std::string search = "scan";
+  cursor->get("ratingSearch",&search);
+  util.toLower(search);
+  p_bisection = (search == "bisection");
+  p_ratingStep = cursor->get("ratingStep",0.05);
+  p_ratingTolerance = cursor->get("ratingTolerance",0.01);
+  p_numLevels = 1;
+  if (p_bisection) p_numLevels = cursor->get("concurrentRatings",1);
+  if (p_numLevels < 1) p_numLevels = 1;
+  if (p_numLevels > p_world.size()/grp_size) {
+    p_numLevels = p_world.size()/grp_size;
+    if (p_numLevels < 1) p_numLevels = 1;
+  }
+  // All groups must contain the same number of task communicators
+  while (p_numLevels > 1 && (p_world.size()%p_numLevels != 0 ||
+        (p_world.size()/p_numLevels)%grp_size != 0)) {
+    p_numLevels--;
+  }
+  p_warmStart = cursor->get("warmStart",p_bisection);
+  p_savedVoltages = false;
+  if (p_bisection && p_world.rank() == 0) {
+    printf("Bracketed rating search with %d concurrent ratings\n",
+        p_numLevels);
+  }
+
   // TODO: Set these values from input deck
   double start;
   if (!cursor->get("contingencyDSStart",&start)) {
@@ -858,8 +892,18 @@ void gridpack::rtpr::RTPRDriver::execute(int argc, char** argv, gridpack::Enviro
     printf("Time step for dynamic simulation contingencies:  %f\n",tstep);
   }
 
-  // Create task communicators from world communicator
-  p_task_comm = p_world.divide(grp_size);
+  // Create task communicators from world communicator. If ratings are
+  // evaluated concurrently, the world communicator is first divided into
+  // one group for each rating
+  if (p_numLevels > 1) {
+    int level_size = p_world.size()/p_numLevels;
+    p_level_comm = p_world.divide(level_size);
+    p_levelIndex = p_world.rank()/level_size;
+  } else {
+    p_level_comm = p_world;
+    p_levelIndex = 0;
+  }
+  p_task_comm = p_level_comm.divide(grp_size);
   // Create powerflow applications on each task communicator
   p_pf_network.reset(new gridpack::powerflow::PFNetwork(p_task_comm));
   // Read in the network from an external file and partition it over the
@@ -1016,74 +1060,79 @@ void gridpack::rtpr::RTPRDriver::execute(int argc, char** argv, gridpack::Enviro
     }
   }
 
-  p_rating = 1.0;
-  bool checkTie = runContingencies();
-  if (checkTie) {
-    // Tie lines are secure for all contingencies. Increase loads and generation
-    while (checkTie) {
-      p_rating += 0.05;
-      if (!adjustRating(p_rating,0)) {
-        if (p_world.rank() == 0) {
-          printf("Rating capacity exceeded: %f\n",p_rating);
+  bool checkTie;
+  if (p_bisection) {
+    searchRating();
+  } else {
+    p_rating = 1.0;
+    checkTie = runContingencies();
+    if (checkTie) {
+      // Tie lines are secure for all contingencies. Increase loads and generation
+      while (checkTie) {
+        p_rating += 0.05;
+        if (!adjustRating(p_rating,0)) {
+          if (p_world.rank() == 0) {
+            printf("Rating capacity exceeded: %f\n",p_rating);
+          }
+          p_rating -= 0.05;
+          p_pf_app.resetPower();
+          break;
         }
-        p_rating -= 0.05;
+        checkTie = runContingencies();
+        if (!checkTie) p_rating -= 0.05;
         p_pf_app.resetPower();
-        break;
       }
-      checkTie = runContingencies();
-      if (!checkTie) p_rating -= 0.05;
-      p_pf_app.resetPower();
-    }
-    // Refine estimate of rating
-    checkTie = true;
-    while (checkTie) {
-      p_rating += 0.01;
-      if (!adjustRating(p_rating,0)) {
-        p_rating -= 0.01;
-        if (p_world.rank() == 0) {
-          printf("Real power generation for power flow"
-              " is capacity-limited for Rating: %f\n",
-              p_rating);
+      // Refine estimate of rating
+      checkTie = true;
+      while (checkTie) {
+        p_rating += 0.01;
+        if (!adjustRating(p_rating,0)) {
+          p_rating -= 0.01;
+          if (p_world.rank() == 0) {
+            printf("Real power generation for power flow"
+                " is capacity-limited for Rating: %f\n",
+                p_rating);
+          }
+          p_pf_app.resetPower();
+          break;
         }
+        checkTie = runContingencies();
+        if (!checkTie) p_rating -= 0.01;
         p_pf_app.resetPower();
-        break;
       }
-      checkTie = runContingencies();
-      if (!checkTie) p_rating -= 0.01;
-      p_pf_app.resetPower();
-    }
-  } else {
-    // Tie lines are insecure for some contingencies. Decrease loads and generation
-    while (!checkTie && p_rating >= 0.0) {
-      p_rating -= 0.05;
-      if (!adjustRating(p_rating,0)) {
-        if (p_world.rank() == 0) {
-          printf("Rating capacity exceeded: %f\n",p_rating);
+    } else {
+      // Tie lines are insecure for some contingencies. Decrease loads and generation
+      while (!checkTie && p_rating >= 0.0) {
+        p_rating -= 0.05;
+        if (!adjustRating(p_rating,0)) {
+          if (p_world.rank() == 0) {
+            printf("Rating capacity exceeded: %f\n",p_rating);
+          }
+          p_rating += 0.05;
+          p_pf_app.resetPower();
+          break;
         }
-        p_rating += 0.05;
+        checkTie = runContingencies();
+        if (checkTie) p_rating += 0.05;
         p_pf_app.resetPower();
-        break;
       }
-      checkTie = runContingencies();
-      if (checkTie) p_rating += 0.05;
-      p_pf_app.resetPower();
-    }
-    // Refine estimate of rating
-    checkTie = false;
-    while (!checkTie && p_rating >= 0.0) {
-      p_rating -= 0.01;
-      if (!adjustRating(p_rating,0)) {
-        p_rating += 0.01;
-        if (p_world.rank() == 0) {
-          printf("Real power generation for power flow"
-              " is capacity-limited for Rating: %f\n",
-              p_rating);
+      // Refine estimate of rating
+      checkTie = false;
+      while (!checkTie && p_rating >= 0.0) {
+        p_rating -= 0.01;
+        if (!adjustRating(p_rating,0)) {
+          p_rating += 0.01;
+          if (p_world.rank() == 0) {
+            printf("Real power generation for power flow"
+                " is capacity-limited for Rating: %f\n",
+                p_rating);
+          }
+          p_pf_app.resetPower();
+          break;
         }
+        checkTie = runContingencies();
         p_pf_app.resetPower();
-        break;
       }
-      checkTie = runContingencies();
-      p_pf_app.resetPower();
     }
   }
   if (p_world.rank() == 0) {
@@ -1183,14 +1232,14 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   std::vector<bool> violations;
   std::vector<bool> contingency_success;
   // Keep track of which calculations completed successfully
-  gridpack::parallel::GlobalVector<bool> ca_success(p_world);
+  gridpack::parallel::GlobalVector<bool> ca_success(p_level_comm);
   // Keep track of violation status for completed calculations
   // 1: no violations
   // 2: voltage violation
   // 3: line overload violation
   // 4: both voltage violation and line overload violation
   std::vector<int> contingency_violation;
-  gridpack::parallel::GlobalVector<int> ca_violation(p_world);
+  gridpack::parallel::GlobalVector<int> ca_violation(p_level_comm);
 
   //  Set minimum and maximum voltage limits on all buses
   p_pf_app.setVoltageLimits(p_Vmin, p_Vmax);
@@ -1202,12 +1251,18 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   if (p_print_calcs) p_pf_app.open(sbuf);
   sprintf(sbuf,"\nRunning base case on %d processes\n",p_task_comm.size());
   if (p_print_calcs) p_pf_app.writeHeader(sbuf);
+  // Start from the base case solution of the previous rating
+  if (p_warmStart && p_savedVoltages) p_pf_app.restoreVoltages();
   chkSolve = p_pf_app.solve();
   // Check for Qlimit violations
   if (p_check_Qlim && !p_pf_app.checkQlimViolations()) {
     chkSolve = p_pf_app.solve();
   }
   if (!chkSolve) printf("Failed solution on base case\n");
+  if (p_warmStart && chkSolve) {
+    p_pf_app.saveVoltages();
+    p_savedVoltages = true;
+  }
   // Some buses may violate the voltage limits in the base problem. Flag these
   // buses to ignore voltage violations on them.
   p_pf_app.ignoreVoltageViolations();
@@ -1225,14 +1280,43 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   if (p_print_calcs) p_pf_app.write();
   if (p_print_calcs) p_pf_app.close();
 
-  // Set up task manager on the world communicator. The number of tasks is
-  // equal to the number of contingencies
-  gridpack::parallel::TaskManager taskmgr(p_world);
+  // Set up task manager on the communicator of all task communicators
+  // evaluating this rating. The number of tasks is equal to the number of
+  // contingencies
+  gridpack::parallel::TaskManager taskmgr(p_level_comm);
   int ntasks = p_events.size();
   if (ntasks == 0) {
     return chkSolve;
   }
-  taskmgr.set(ntasks);
+  // Find contingencies that are evaluated with the AC powerflow. Task i
+  // evaluates contingency task_order[i]. The DC matrix only depends on the
+  // topology of the base case, so it is factored once and reused for all
+  // ratings
+  std::vector<int> task_order;
+  if (p_dcScreening) {
+    if (!p_dcSens) {
+      p_dcSens.reset(new gridpack::powerflow::DCSensitivityModule(
+            p_pf_network, gridpack::utility::Configuration::configuration()
+            ->getCursor("Configuration.Powerflow")));
+      p_dcSens->useRateB(p_useRateB);
+      p_dcSens->setup();
+    } else {
+      p_dcSens->setBaseFlows();
+    }
+    std::vector<gridpack::powerflow::ScreeningResult> results
+      = p_dcSens->screen(p_events, p_level_comm);
+    std::vector<int> skipped;
+    task_order = gridpack::powerflow::DCSensitivityModule::rank(results,
+        p_screeningLoading, skipped);
+    if (p_level_comm.rank() == 0) {
+      printf("DC screening: %d of %d contingencies evaluated with AC"
+          " powerflow\n",static_cast<int>(task_order.size()),ntasks);
+    }
+  } else {
+    int icnt;
+    for (icnt=0; icnt<ntasks; icnt++) task_order.push_back(icnt);
+  }
+  taskmgr.set(task_order.size());
 #ifdef USE_STATBLOCK
   gridpack::utility::StringUtils util;
   std::vector<std::string> v_vals = p_pf_app.writeBranchString("flow_str");
@@ -1266,8 +1350,8 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
       }
     }
   }
-  gridpack::analysis::StatBlock pflow_stats(p_world,nsize,ntasks+1);
-  if (p_world.rank() == 0) {
+  gridpack::analysis::StatBlock pflow_stats(p_level_comm,nsize,ntasks+1);
+  if (p_level_comm.rank() == 0) {
     pflow_stats.addRowLabels(id1, id2, tags);
     pflow_stats.addColumnValues(0,pflow,mask);
     pflow_stats.addRowMinValue(pmin);
@@ -1279,10 +1363,11 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   if (p_check_Qlim) p_pf_app.clearQlimViolations();
 
   // Evaluate contingencies using the task manager
-  int task_id;
-  // nextTask returns the same task_id on all processors in task_comm. When the
+  int itask, task_id;
+  // nextTask returns the same task on all processors in task_comm. When the
   // calculation runs out of task, nextTask will return false.
-  while (taskmgr.nextTask(p_task_comm, &task_id)) {
+  while (taskmgr.nextTask(p_task_comm, &itask)) {
+    task_id = task_order[itask];
 #ifdef RTPR_DEBUG
     int nsize = violationDesc.size();
     if (task_id == 0 && nsize>0) {
@@ -1331,8 +1416,13 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
       }
     }
     if (p_print_calcs) p_pf_app.writeHeader(sbuf);
-    // Reset all voltages back to their original values
-    p_pf_app.resetVoltages();
+    // Reset all voltages back to their original values or to the base case
+    // solution
+    if (p_warmStart && p_savedVoltages) {
+      p_pf_app.restoreVoltages();
+    } else {
+      p_pf_app.resetVoltages();
+    }
     // Set contingency
     p_pf_app.setContingency(p_events[task_id]);
     // Solve power flow equations for this system
@@ -1481,7 +1571,7 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   ca_success.upload();
   ca_violation.upload();
   // Write out stats on successful calculations
-  if (p_world.rank() == 0) {
+  if (p_level_comm.rank() == 0) {
     char sbuf[128];
     contingency_idx.clear();
     contingency_success.clear();
@@ -1525,8 +1615,8 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   } else {
     ok = 0;
   }
-  p_world.sum(&ok,1);
-  if (ok == p_world.size()) {
+  p_level_comm.sum(&ok,1);
+  if (ok == p_level_comm.size()) {
     ret = true;
   } else {
     ret = false;
@@ -1534,6 +1624,141 @@ bool gridpack::rtpr::RTPRDriver::runContingencies()
   return ret;
 }
 
+/**
+ * Find the power flow rating with a bracketed search. The rating is
+ * increased (or decreased) with growing steps until the tie lines
+ * change from secure to insecure and the bracket is then narrowed
+ * until it is smaller than the rating tolerance. If more than one
+ * rating level is evaluated concurrently, each bracket is divided
+ * into equal parts instead of being bisected. The result is stored in
+ * p_rating
+ */
+void gridpack::rtpr::RTPRDriver::searchRating()
+{
+  int nlev = p_numLevels;
+  std::vector<double> ratings(nlev);
+  std::vector<bool> secure, feasible;
+  double step = p_ratingStep;
+  double lo = 1.0, hi = 1.0;
+  bool haveLo = false;
+  bool haveHi = false;
+  int k;
+
+  // The first round evaluates the current rating and, if several ratings
+  // are evaluated concurrently, the ratings above it
+  for (k=0; k<nlev; k++) ratings[k] = 1.0+static_cast<double>(k)*step;
+  evaluateRatings(ratings, secure, feasible);
+  if (secure[0]) {
+    // Tie lines are secure. Increase the rating with growing steps until
+    // the tie lines become insecure or generator capacity is exceeded
+    while (!haveHi) {
+      for (k=0; k<nlev; k++) {
+        if (feasible[k] && secure[k]) {
+          lo = ratings[k];
+          haveLo = true;
+        } else {
+          hi = ratings[k];
+          haveHi = true;
+          break;
+        }
+      }
+      if (haveHi) break;
+      step *= 2.0;
+      for (k=0; k<nlev; k++) ratings[k] = lo+static_cast<double>(k+1)*step;
+      evaluateRatings(ratings, secure, feasible);
+    }
+  } else {
+    // Tie lines are insecure. Decrease the rating with growing steps
+    // until the tie lines become secure
+    haveHi = true;
+    bool limited = false;
+    while (!haveLo && !limited) {
+      for (k=0; k<nlev; k++) ratings[k] = hi-static_cast<double>(k+1)*step;
+      evaluateRatings(ratings, secure, feasible);
+      for (k=0; k<nlev; k++) {
+        if (!feasible[k]) {
+          limited = true;
+          break;
+        } else if (secure[k]) {
+          lo = ratings[k];
+          haveLo = true;
+          break;
+        } else {
+          hi = ratings[k];
+        }
+      }
+      step *= 2.0;
+    }
+  }
+
+  // Narrow the bracket. Levels that cannot be reached because of generator
+  // capacity count as insecure
+  while (haveLo && haveHi && hi-lo > p_ratingTolerance) {
+    double dr = (hi-lo)/static_cast<double>(nlev+1);
+    for (k=0; k<nlev; k++) ratings[k] = lo+static_cast<double>(k+1)*dr;
+    evaluateRatings(ratings, secure, feasible);
+    for (k=0; k<nlev; k++) {
+      if (feasible[k] && secure[k]) {
+        lo = ratings[k];
+      } else {
+        hi = ratings[k];
+        break;
+      }
+    }
+  }
+
+  if (haveLo) {
+    p_rating = lo;
+  } else {
+    p_rating = hi;
+    if (p_world.rank() == 0) {
+      printf("No secure rating found above Rating: %f\n",p_rating);
+    }
+  }
+}
+
+/**
+ * Evaluate the full set of contingencies for a list of ratings. Each
+ * group of task communicators evaluates one rating
+ * @param ratings list of ratings, one for each group
+ * @param secure true if tie lines are secure for all contingencies
+ * @param feasible false if rating could not be reached because of
+ * generator capacity limits
+ */
+void gridpack::rtpr::RTPRDriver::evaluateRatings(
+    const std::vector<double> &ratings, std::vector<bool> &secure,
+    std::vector<bool> &feasible)
+{
+  int nlev = ratings.size();
+  std::vector<int> flags(2*nlev,0);
+  p_rating = ratings[p_levelIndex];
+  if (p_rating >= 0.0 && adjustRating(p_rating,0)) {
+    bool ok = runContingencies();
+    if (p_level_comm.rank() == 0) {
+      flags[p_levelIndex] = ok ? 1 : 0;
+      flags[nlev+p_levelIndex] = 1;
+    }
+  }
+  p_pf_app.resetPower();
+  p_world.sum(&flags[0],2*nlev);
+  secure.resize(nlev);
+  feasible.resize(nlev);
+  int k;
+  for (k=0; k<nlev; k++) {
+    secure[k] = (flags[k] != 0);
+    feasible[k] = (flags[nlev+k] != 0);
+    if (p_world.rank() == 0) {
+      if (!feasible[k]) {
+        printf("Rating search: %f capacity exceeded\n",ratings[k]);
+      } else if (secure[k]) {
+        printf("Rating search: %f secure\n",ratings[k]);
+      } else {
+        printf("Rating search: %f insecure\n",ratings[k]);
+      }
+    }
+  }
+}
+
 /**
  * Transfer data from power flow to dynamic simulation
  * @param pf_network power flow network
@@ -20,6 +20,7 @@
 
 #include "gridpack/include/gridpack.hpp"
 #include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/applications/modules/powerflow/dc_sensitivity_module.hpp"
 
 namespace gridpack {
 namespace rtpr {
@@ -157,6 +158,28 @@ class RTPRDriver
      */
     bool runContingencies();
 
+    /**
+     * Find the power flow rating with a bracketed search. The rating is
+     * increased (or decreased) with growing steps until the tie lines
+     * change from secure to insecure and the bracket is then narrowed
+     * until it is smaller than the rating tolerance. If more than one
+     * rating level is evaluated concurrently, each bracket is divided
+     * into equal parts instead of being bisected. The result is stored in
+     * p_rating
+     */
+    void searchRating();
+
+    /**
+     * Evaluate the full set of contingencies for a list of ratings. Each
+     * group of task communicators evaluates one rating
+     * @param ratings list of ratings, one for each group
+     * @param secure true if tie lines are secure for all contingencies
+     * @param feasible false if rating could not be reached because of
+     * generator capacity limits
+     */
+    void evaluateRatings(const std::vector<double> &ratings,
+        std::vector<bool> &secure, std::vector<bool> &feasible);
+
     /**
      * Run dynamic simulations over full set of contingencies
      * @return true if no violations found on complete set of contingencies
@@ -207,10 +230,32 @@ class RTPRDriver
     gridpack::parallel::Communicator p_world;
     gridpack::parallel::Communicator p_task_comm;
 
+    // Communicator for all task communicators that evaluate the same
+    // rating. This is the same as p_world unless several ratings are
+    // evaluated concurrently
+    gridpack::parallel::Communicator p_level_comm;
+    int p_numLevels;
+    int p_levelIndex;
+
+    // Parameters of rating search
+    bool p_bisection;
+    double p_ratingStep;
+    double p_ratingTolerance;
+
+    // Start power flow calculations from the base case solution of the
+    // previous rating
+    bool p_warmStart;
+    bool p_savedVoltages;
+
     int p_numTies;
 
     bool p_useRateB;
 
+    // Screen contingencies with DC sensitivities before AC calculations
+    bool p_dcScreening;
+    double p_screeningLoading;
+    boost::shared_ptr<gridpack::powerflow::DCSensitivityModule> p_dcSens;
+
     std::vector<int> p_watch_busIDs;
     std::vector<std::string> p_watch_genIDs;
 
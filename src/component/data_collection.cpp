@@ -6,6 +6,352 @@
 #include "gridpack/component/data_collection.hpp"
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+#include <deque>
+#include "gridpack/parallel/threads.hpp"
+
+namespace {
+
+/**
+ * Read-only copy of the name table. Threads look names up in the current
+ * copy without locking. A copy is never modified after it is published
+ */
+struct KeyTable {
+  boost::unordered_map<std::string, int> ids;
+  std::vector<const std::string*> names;
+};
+
+/**
+ * Process-wide table of interned data element names. Names are kept in a
+ * deque so that references to them stay valid when new names are added.
+ * Copies of the table that threads may still be reading are retired and
+ * deleted the next time a name is looked up outside a threaded loop
+ */
+struct KeyRegistry {
+  boost::unordered_map<std::string, int> ids;
+  std::deque<std::string> names;
+  const KeyTable *table;
+  std::vector<const KeyTable*> retired;
+  KeyRegistry(void) : table(NULL) {}
+  ~KeyRegistry(void)
+  {
+    freeRetired();
+    delete table;
+  }
+  void freeRetired(void)
+  {
+    size_t i;
+    for (i=0; i<retired.size(); i++) delete retired[i];
+    retired.clear();
+  }
+};
+
+KeyRegistry& registry(void)
+{
+  static KeyRegistry reg;
+  return reg;
+}
+
+int findKey(const std::string &name)
+{
+  KeyRegistry &reg = registry();
+  boost::unordered_map<std::string, int>::iterator it = reg.ids.find(name);
+  if (it != reg.ids.end()) return it->second;
+  int id = reg.names.size();
+  reg.names.push_back(name);
+  reg.ids.insert(std::pair<std::string, int>(name, id));
+  return id;
+}
+
+/**
+ * Return the current read-only table. This may be NULL or may not contain
+ * the most recently added names
+ */
+const KeyTable* currentTable(void)
+{
+  const KeyTable *table;
+  GRIDPACK_OMP_PRAGMA(omp atomic read seq_cst)
+  table = registry().table;
+  return table;
+}
+
+/**
+ * Replace the read-only table with a copy of the full registry if it is
+ * missing names. Must be called while holding the registry lock
+ */
+void publishTable(void)
+{
+  KeyRegistry &reg = registry();
+  if (reg.table && reg.table->names.size() == reg.names.size()) return;
+  KeyTable *table = new KeyTable;
+  table->ids = reg.ids;
+  size_t i;
+  table->names.resize(reg.names.size());
+  for (i=0; i<reg.names.size(); i++) table->names[i] = &reg.names[i];
+  if (reg.table) reg.retired.push_back(reg.table);
+  GRIDPACK_OMP_PRAGMA(omp atomic write seq_cst)
+  reg.table = table;
+}
+
+/**
+ * Look up the ID of a name, adding it to the registry if it is new.
+ * Components may be loaded on several threads. Inside threaded loops
+ * names are looked up in the read-only table without locking and the
+ * registry is only locked if a name is not in the table
+ */
+int internKey(const std::string &name)
+{
+  if (!gridpack::parallel::Threads::inParallel()) {
+    registry().freeRetired();
+    return findKey(name);
+  }
+  const KeyTable *table = currentTable();
+  if (table) {
+    boost::unordered_map<std::string, int>::const_iterator it
+      = table->ids.find(name);
+    if (it != table->ids.end()) return it->second;
+  }
+  int id;
+  GRIDPACK_OMP_PRAGMA(omp critical(gridpack_data_keys))
+  {
+    id = findKey(name);
+    publishTable();
+  }
+  return id;
+}
+
+/**
+ * Add value to store if it does not already exist
+ */
+template <typename S, typename T>
+void storeAdd(S &store, unsigned long long key, const T &value)
+{
+  store.add(key, value);
+}
+
+/**
+ * Modify existing value in store
+ */
+template <typename S, typename T>
+bool storeSet(S &store, unsigned long long key, const T &value)
+{
+  typename S::value_type *ptr = store.find(key);
+  if (ptr == NULL) return false;
+  *ptr = value;
+  return true;
+}
+
+/**
+ * Retrieve value from store
+ */
+template <typename S, typename T>
+bool storeGet(S &store, unsigned long long key, T *value)
+{
+  typename S::value_type *ptr = store.find(key);
+  if (ptr == NULL) return false;
+  *value = *ptr;
+  return true;
+}
+
+/**
+ * Append plain data to a binary buffer
+ */
+template <typename T>
+void packValues(std::vector<char> &buf, const T *values, int n)
+{
+  if (n <= 0) return;
+  size_t size = buf.size();
+  buf.resize(size + n*sizeof(T));
+  memcpy(&buf[size], values, n*sizeof(T));
+}
+
+/**
+ * Copy plain data out of a binary buffer and advance pointer
+ */
+template <typename T>
+void unpackValues(const char *&ptr, T *values, int n)
+{
+  if (n <= 0) return;
+  memcpy(values, ptr, n*sizeof(T));
+  ptr += n*sizeof(T);
+}
+
+/**
+ * Write store as its size, its keys and then its values
+ */
+template <typename S>
+void packStore(std::vector<char> &buf, const S &store)
+{
+  int n = store.size();
+  packValues(buf, &n, 1);
+  if (n == 0) return;
+  packValues(buf, &store.p_keys[0], n);
+  packValues(buf, &store.p_values[0], n);
+}
+
+void packStrings(std::vector<char> &buf,
+    const std::vector<unsigned long long> &keys,
+    const std::vector<std::string> &values)
+{
+  int i, len;
+  int n = keys.size();
+  packValues(buf, &n, 1);
+  if (n == 0) return;
+  packValues(buf, &keys[0], n);
+  for (i=0; i<n; i++) {
+    len = values[i].size();
+    packValues(buf, &len, 1);
+    packValues(buf, values[i].c_str(), len);
+  }
+}
+
+/**
+ * Replace interned IDs in keys using map and restore sort order of store
+ */
+template <typename T>
+void remapKeys(std::vector<unsigned long long> &keys, std::vector<T> &values,
+    const std::vector<int> &idMap)
+{
+  int i;
+  int n = keys.size();
+  const unsigned long long mask = (1ULL << 33) - 1;
+  bool sorted = true;
+  for (i=0; i<n; i++) {
+    keys[i] = (static_cast<unsigned long long>(idMap[keys[i] >> 33]) << 33)
+      | (keys[i] & mask);
+    if (i > 0 && keys[i] < keys[i-1]) sorted = false;
+  }
+  if (sorted) return;
+  std::vector<std::pair<unsigned long long, int> > order(n);
+  for (i=0; i<n; i++) {
+    order[i] = std::pair<unsigned long long, int>(keys[i], i);
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<T> tmp(values);
+  for (i=0; i<n; i++) {
+    keys[i] = order[i].first;
+    values[i] = tmp[order[i].second];
+  }
+}
+
+template <typename S>
+void unpackStore(const char *&ptr, S &store, const std::vector<int> &idMap)
+{
+  int n;
+  unpackValues(ptr, &n, 1);
+  store.p_keys.resize(n);
+  store.p_values.resize(n);
+  if (n == 0) return;
+  unpackValues(ptr, &store.p_keys[0], n);
+  unpackValues(ptr, &store.p_values[0], n);
+  remapKeys(store.p_keys, store.p_values, idMap);
+}
+
+void unpackStrings(const char *&ptr, std::vector<unsigned long long> &keys,
+    std::vector<std::string> &values, const std::vector<int> &idMap)
+{
+  int i, len;
+  int n;
+  unpackValues(ptr, &n, 1);
+  keys.resize(n);
+  values.resize(n);
+  if (n == 0) return;
+  unpackValues(ptr, &keys[0], n);
+  for (i=0; i<n; i++) {
+    unpackValues(ptr, &len, 1);
+    values[i].assign(ptr, len);
+    ptr += len;
+  }
+  remapKeys(keys, values, idMap);
+}
+
+/**
+ * Print one value of a store. Bools are stored as char
+ */
+template <typename T>
+void dumpValue(const T &value)
+{
+  std::cout << value;
+}
+
+void dumpValue(const char &value)
+{
+  std::cout << static_cast<bool>(value);
+}
+
+/**
+ * Print elements of a store sorted by their "name" or "name:idx" tags
+ */
+template <typename S>
+void dumpStore(const char *type, const S &store,
+    std::string (*keyTag)(unsigned long long))
+{
+  int i;
+  int n = store.size();
+  std::vector<std::pair<std::string, int> > order(n);
+  for (i=0; i<n; i++) {
+    order[i].first = (*keyTag)(store.p_keys[i]);
+    order[i].second = i;
+  }
+  std::sort(order.begin(), order.end());
+  for (i=0; i<n; i++) {
+    std::cout << "  (" << type << ") key: " << order[i].first << " value: ";
+    dumpValue(store.p_values[order[i].second]);
+    std::cout << std::endl;
+  }
+}
+
+}
+
+/**
+ * Resolve name to key
+ * @param name name of data element (a dictionary variable)
+ */
+gridpack::component::DataKey::DataKey(const char *name)
+{
+  p_id = internKey(std::string(name));
+}
+
+gridpack::component::DataKey::DataKey(const std::string &name)
+{
+  p_id = internKey(name);
+}
+
+/**
+ * Return name corresponding to an integer ID
+ * @param id integer ID of key
+ * @return name of data element
+ */
+const std::string& gridpack::component::DataKey::name(int id)
+{
+  if (!gridpack::parallel::Threads::inParallel()) return registry().names[id];
+  const KeyTable *table = currentTable();
+  if (table && id < static_cast<int>(table->names.size())) {
+    return *table->names[id];
+  }
+  const std::string *str;
+  GRIDPACK_OMP_PRAGMA(omp critical(gridpack_data_keys))
+  {
+    publishTable();
+    str = &registry().names[id];
+  }
+  return *str;
+}
+
+/**
+ * Return number of names that have been interned on this process
+ * @return number of interned names
+ */
+int gridpack::component::DataKey::numKeys(void)
+{
+  int nkeys;
+  GRIDPACK_OMP_PRAGMA(omp critical(gridpack_data_keys))
+  nkeys = registry().names.size();
+  return nkeys;
+}
 
 /**
  * Simple constructor
@@ -38,6 +384,35 @@ gridpack::component::DataCollection & gridpack::component::DataCollection::opera
   return *this;
 }
 
+/**
+ * Reconstruct the "name" or "name:idx" tag for a composite key
+ */
+std::string gridpack::component::DataCollection::keyTag(unsigned long long key)
+{
+  std::string str = DataKey::name(static_cast<int>(key >> 33));
+  if (key & (1ULL << 32)) {
+    char buf[16];
+    sprintf(buf,":%d",static_cast<int>(key & 0xffffffffULL));
+    str.append(buf);
+  }
+  return str;
+}
+
+/**
+ * Split a "name" or "name:idx" tag into an interned name and index
+ */
+unsigned long long gridpack::component::DataCollection::tagKey(
+    const std::string &tag)
+{
+  size_t pos = tag.rfind(':');
+  if (pos != std::string::npos && pos+1 < tag.size()) {
+    return compositeKey(DataKey(tag.substr(0,pos)),
+        atoi(tag.c_str()+pos+1));
+  }
+  return compositeKey(DataKey(tag), -1);
+}
+
+
 /**
  *  Add variables to DataCollection object
  *  @param name name given to data element
@@ -45,45 +420,37 @@ gridpack::component::DataCollection & gridpack::component::DataCollection::opera
  */
 void gridpack::component::DataCollection::addValue(const char *name, const int value)
 {
-  std::string str = name;
-  p_ints.insert(std::pair<std::string, int>(str,value));
+  storeAdd(p_ints, compositeKey(DataKey(name),-1), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const long value)
 {
-  std::string str = name;
-  p_longs.insert(std::pair<std::string, long>(str,value));
+  storeAdd(p_longs, compositeKey(DataKey(name),-1), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const bool value)
 {
-  std::string str = name;
-  p_bools.insert(std::pair<std::string, bool>(str,value));
+  storeAdd(p_bools, compositeKey(DataKey(name),-1), static_cast<char>(value));
 }
 
-void gridpack::component::DataCollection::addValue(const char *name, const char *value)
+void gridpack::component::DataCollection::addValue(const char *name, const char * value)
 {
-  std::string str = name;
-  std::string val = value;
-  p_strings.insert(std::pair<std::string, std::string>(str,val));
+  storeAdd(p_strings, compositeKey(DataKey(name),-1), std::string(value));
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const float value)
 {
-  std::string str = name;
-  p_floats.insert(std::pair<std::string, float>(str,value));
+  storeAdd(p_floats, compositeKey(DataKey(name),-1), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const double value)
 {
-  std::string str = name;
-  p_doubles.insert(std::pair<std::string, double>(str,value));
+  storeAdd(p_doubles, compositeKey(DataKey(name),-1), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const gridpack::ComplexType value)
 {
-  std::string str = name;
-  p_complexType.insert(std::pair<std::string, gridpack::ComplexType>(str,value));
+  storeAdd(p_complexType, compositeKey(DataKey(name),-1), value);
 }
 
 /**
@@ -97,79 +464,43 @@ void gridpack::component::DataCollection::addValue(const char *name, const gridp
 void gridpack::component::DataCollection::addValue(const char *name, const int value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_ints.insert(std::pair<std::string, int>(str,value));
+  storeAdd(p_ints, compositeKey(DataKey(name),idx), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const long value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_longs.insert(std::pair<std::string, long>(str,value));
+  storeAdd(p_longs, compositeKey(DataKey(name),idx), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const bool value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_bools.insert(std::pair<std::string, bool>(str,value));
+  storeAdd(p_bools, compositeKey(DataKey(name),idx), static_cast<char>(value));
 }
 
-void gridpack::component::DataCollection::addValue(const char *name, const char *value,
+void gridpack::component::DataCollection::addValue(const char *name, const char * value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  std::string val = value;
-  p_strings.insert(std::pair<std::string, std::string>(str,val));
+  storeAdd(p_strings, compositeKey(DataKey(name),idx), std::string(value));
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const float value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_floats.insert(std::pair<std::string, float>(str,value));
+  storeAdd(p_floats, compositeKey(DataKey(name),idx), value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const double value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_doubles.insert(std::pair<std::string, double>(str,value));
+  storeAdd(p_doubles, compositeKey(DataKey(name),idx), value);
 }
 
-void gridpack::component::DataCollection::addValue(const char *name,
-    const gridpack::ComplexType value, const int idx)
+void gridpack::component::DataCollection::addValue(const char *name, const gridpack::ComplexType value,
+    const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_complexType.insert(std::pair<std::string, gridpack::ComplexType>(str,value));
+  storeAdd(p_complexType, compositeKey(DataKey(name),idx), value);
 }
 
 /**
@@ -182,122 +513,37 @@ void gridpack::component::DataCollection::addValue(const char *name,
  */
 bool gridpack::component::DataCollection::setValue(const char *name, const int value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_ints, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const long value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_longs, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const bool value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_bools, compositeKey(DataKey(name),-1), static_cast<char>(value));
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name, const char *value)
-{
-  std::string str = name;
-  std::string val = value;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    it->second = val;
-    return true;
-  } else {
-    return false;
-  }
+bool gridpack::component::DataCollection::setValue(const char *name, const char * value)
+{
+  return storeSet(p_strings, compositeKey(DataKey(name),-1), std::string(value));
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const float value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_floats, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const double value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_doubles, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const gridpack::ComplexType value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_complexType, compositeKey(DataKey(name),-1), value);
 }
 
 /**
@@ -313,156 +559,43 @@ bool gridpack::component::DataCollection::setValue(const char *name, const gridp
 bool gridpack::component::DataCollection::setValue(const char *name, const int value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_ints, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const long value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_longs, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const bool value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_bools, compositeKey(DataKey(name),idx), static_cast<char>(value));
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name, const char *value,
+bool gridpack::component::DataCollection::setValue(const char *name, const char * value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  std::string val = value;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    it->second = val;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_strings, compositeKey(DataKey(name),idx), std::string(value));
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const float value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_floats, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const double value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_doubles, compositeKey(DataKey(name),idx), value);
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name,
-    const gridpack::ComplexType value, const int idx)
+bool gridpack::component::DataCollection::setValue(const char *name, const gridpack::ComplexType value,
+    const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return storeSet(p_complexType, compositeKey(DataKey(name),idx), value);
 }
 
 /**
@@ -475,121 +608,40 @@ bool gridpack::component::DataCollection::setValue(const char *name,
  */
 bool gridpack::component::DataCollection::getValue(const char *name, int *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_ints, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, long *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_longs, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, bool *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  char cval;
+  if (!storeGet(p_bools, compositeKey(DataKey(name),-1), &cval)) return false;
+  *value = static_cast<bool>(cval);
+  return true;
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, std::string *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_strings, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, float *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_floats, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, double *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_doubles, compositeKey(DataKey(name),-1), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, gridpack::ComplexType *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_complexType, compositeKey(DataKey(name),-1), value);
 }
 
 /**
@@ -605,155 +657,195 @@ bool gridpack::component::DataCollection::getValue(const char *name, gridpack::C
 bool gridpack::component::DataCollection::getValue(const char *name, int *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_ints, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, long *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_longs, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, bool *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-  it = p_bools.find(str);
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  if (it != p_bools.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  char cval;
+  if (!storeGet(p_bools, compositeKey(DataKey(name),idx), &cval)) return false;
+  *value = static_cast<bool>(cval);
+  return true;
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, std::string *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_strings, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, float *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_floats, compositeKey(DataKey(name),idx), value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, double *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_doubles, compositeKey(DataKey(name),idx), value);
+}
+
+bool gridpack::component::DataCollection::getValue(const char *name, gridpack::ComplexType *value,
+    const int idx)
+{
+  return storeGet(p_complexType, compositeKey(DataKey(name),idx), value);
+}
+
+/**
+ *  Add data element using an interned key
+ *  @param key interned name of data element
+ *  @param value value of data element
+ *  @param idx index of value
+ */
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const int value, const int idx)
+{
+  storeAdd(p_ints, compositeKey(key,idx), value);
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const long value, const int idx)
+{
+  storeAdd(p_longs, compositeKey(key,idx), value);
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const bool value, const int idx)
+{
+  storeAdd(p_bools, compositeKey(key,idx), static_cast<char>(value));
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const char * value, const int idx)
+{
+  storeAdd(p_strings, compositeKey(key,idx), std::string(value));
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const float value, const int idx)
+{
+  storeAdd(p_floats, compositeKey(key,idx), value);
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const double value, const int idx)
+{
+  storeAdd(p_doubles, compositeKey(key,idx), value);
+}
+
+void gridpack::component::DataCollection::addValue(const DataKey &key,
+    const gridpack::ComplexType value, const int idx)
+{
+  storeAdd(p_complexType, compositeKey(key,idx), value);
+}
+
+/**
+ *  Modify data element using an interned key
+ *  @param key interned name of data element
+ *  @param value new value of data element
+ *  @param idx index of value
+ *  @return false if no element of the correct name and type exists
+ */
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const int value, const int idx)
+{
+  return storeSet(p_ints, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const long value, const int idx)
+{
+  return storeSet(p_longs, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const bool value, const int idx)
+{
+  return storeSet(p_bools, compositeKey(key,idx), static_cast<char>(value));
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const char * value, const int idx)
+{
+  return storeSet(p_strings, compositeKey(key,idx), std::string(value));
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const float value, const int idx)
+{
+  return storeSet(p_floats, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const double value, const int idx)
+{
+  return storeSet(p_doubles, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::setValue(const DataKey &key,
+    const gridpack::ComplexType value, const int idx)
+{
+  return storeSet(p_complexType, compositeKey(key,idx), value);
+}
+
+/**
+ *  Retrieve data element using an interned key
+ *  @param key interned name of data element
+ *  @param value current value of data element
+ *  @param idx index of value
+ *  @return false if no element of the correct name and type exists
+ */
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    int *value, const int idx)
+{
+  return storeGet(p_ints, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    long *value, const int idx)
+{
+  return storeGet(p_longs, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    bool *value, const int idx)
+{
+  char cval;
+  if (!storeGet(p_bools, compositeKey(key,idx), &cval)) return false;
+  *value = static_cast<bool>(cval);
+  return true;
+}
+
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    std::string *value, const int idx)
+{
+  return storeGet(p_strings, compositeKey(key,idx), value);
 }
 
-bool gridpack::component::DataCollection::getValue(const char *name,
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    float *value, const int idx)
+{
+  return storeGet(p_floats, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
+    double *value, const int idx)
+{
+  return storeGet(p_doubles, compositeKey(key,idx), value);
+}
+
+bool gridpack::component::DataCollection::getValue(const DataKey &key,
     gridpack::ComplexType *value, const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return storeGet(p_complexType, compositeKey(key,idx), value);
 }
 
 /**
@@ -761,96 +853,44 @@ bool gridpack::component::DataCollection::getValue(const char *name,
  */
 void gridpack::component::DataCollection::dump(void)
 {
-  // print out integers
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator int_it;
-#else
-  boost::unordered_map<std::string, int>::iterator int_it;
-#endif
-  int_it = p_ints.begin();
-  int i = 0;
-  while (int_it != p_ints.end()) {
-    std::string key = int_it->first;
-    int ival = int_it->second;
-    std::cout << "  (INTEGER) key: "<<key<<" value: "<<ival<<std::endl;
-    int_it++;
-  }
-  // print out longs
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator long_it;
-#else
-  boost::unordered_map<std::string, long>::iterator long_it;
-#endif
-  long_it = p_longs.begin();
-  while (long_it != p_longs.end()) {
-    std::string key = long_it->first;
-    long lval = long_it->second;
-    std::cout << "  (LONG) key: "<<key<<" value: "<<lval<<std::endl;
-    long_it++;
-  }
-  // print out bools
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator bool_it;
-#else
-  boost::unordered_map<std::string, bool>::iterator bool_it;
-#endif
-  bool_it = p_bools.begin();
-  while (bool_it != p_bools.end()) {
-    std::string key = bool_it->first;
-    bool bval = bool_it->second;
-    std::cout << "  (BOOL) key: "<<key<<" value: "<<bval<<std::endl;
-    bool_it++;
-  }
-  // print out strings
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator str_it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator str_it;
-#endif
-  str_it = p_strings.begin();
-  while (str_it != p_strings.end()) {
-    std::string key = str_it->first;
-    std::string sval = str_it->second;
-    std::cout << "  (STRING) key: "<<key<<" value: "<<sval<<std::endl;
-    str_it++;
-  }
-  // print out floats
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator flt_it;
-#else
-  boost::unordered_map<std::string, float>::iterator flt_it;
-#endif
-  flt_it = p_floats.begin();
-  while (flt_it != p_floats.end()) {
-    std::string key = flt_it->first;
-    float fval = flt_it->second;
-    std::cout << "  (FLOAT) key: "<<key<<" value: "<<fval<<std::endl;
-    flt_it++;
-  }
-  // print out doubles
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator dbl_it;
-#else
-  boost::unordered_map<std::string, double>::iterator dbl_it;
-#endif
-  dbl_it = p_doubles.begin();
-  while (dbl_it != p_doubles.end()) {
-    std::string key = dbl_it->first;
-    double dval = dbl_it->second;
-    std::cout << "  (DOUBLE) key: "<<key<<" value: "<<dval<<std::endl;
-    dbl_it++;
-  }
-  // print out complex
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator cmplx_it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator cmplx_it;
-#endif
-  cmplx_it = p_complexType.begin();
-  while (cmplx_it != p_complexType.end()) {
-    std::string key = cmplx_it->first;
-    ComplexType cval = cmplx_it->second;
-    std::cout << "  (COMPLEX) key: "<<key<<" value: "<<cval<<std::endl;
-    cmplx_it++;
-  }
+  dumpStore("INTEGER", p_ints, &keyTag);
+  dumpStore("LONG", p_longs, &keyTag);
+  dumpStore("BOOL", p_bools, &keyTag);
+  dumpStore("STRING", p_strings, &keyTag);
+  dumpStore("FLOAT", p_floats, &keyTag);
+  dumpStore("DOUBLE", p_doubles, &keyTag);
+  dumpStore("COMPLEX", p_complexType, &keyTag);
+}
+
+/**
+ * Append a flat binary image of the data collection to a buffer
+ * @param buf buffer that image is appended to
+ */
+void gridpack::component::DataCollection::pack(std::vector<char> &buf) const
+{
+  packStore(buf, p_ints);
+  packStore(buf, p_longs);
+  packStore(buf, p_bools);
+  packStrings(buf, p_strings.p_keys, p_strings.p_values);
+  packStore(buf, p_floats);
+  packStore(buf, p_doubles);
+  packStore(buf, p_complexType);
+}
+
+/**
+ * Replace contents of data collection with a binary image created by pack
+ * @param ptr pointer to start of image. On return, it points to the first
+ *        byte after the image
+ * @param idMap map from interned IDs used in the image to IDs on this process
+ */
+void gridpack::component::DataCollection::unpack(const char *&ptr,
+    const std::vector<int> &idMap)
+{
+  unpackStore(ptr, p_ints, idMap);
+  unpackStore(ptr, p_longs, idMap);
+  unpackStore(ptr, p_bools, idMap);
+  unpackStrings(ptr, p_strings.p_keys, p_strings.p_values, idMap);
+  unpackStore(ptr, p_floats, idMap);
+  unpackStore(ptr, p_doubles, idMap);
+  unpackStore(ptr, p_complexType, idMap);
 }
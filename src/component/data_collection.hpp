@@ -6,15 +6,13 @@
 #ifndef _data_collection_h
 #define _data_collection_h
 
-#define OLD_MAP
-
-#ifndef OLD_MAP
-#include <boost/unordered_map.hpp>
-#endif
 #include <map>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/string.hpp>
+#include <boost/serialization/split_member.hpp>
 
 #include "gridpack/utilities/complex.hpp"
 
@@ -25,6 +23,47 @@
 namespace gridpack{
 namespace component{
 
+/**
+ * Interned name of a data element. The name is resolved to an integer ID the
+ * first time it is seen and the ID can then be used for repeated lookups in
+ * any DataCollection without string formatting or comparison. IDs are only
+ * valid on the process that created them.
+ */
+class DataKey {
+public:
+  /**
+   * Resolve name to key
+   * @param name name of data element (a dictionary variable)
+   */
+  explicit DataKey(const char *name);
+  explicit DataKey(const std::string &name);
+
+  /**
+   * Return integer ID of key
+   */
+  int id(void) const
+  {
+    return p_id;
+  }
+
+  /**
+   * Return name corresponding to an integer ID
+   * @param id integer ID of key
+   * @return name of data element
+   */
+  static const std::string& name(int id);
+
+  /**
+   * Return number of names that have been interned on this process. Valid
+   * IDs run from 0 to numKeys()-1
+   * @return number of interned names
+   */
+  static int numKeys(void);
+
+private:
+  int p_id;
+};
+
 class DataCollection {
 public:
   /**
@@ -139,44 +178,203 @@ public:
   bool getValue(const char *name, double *value, const int idx);
   bool getValue(const char *name, gridpack::ComplexType *value, const int idx);
 
+  /**
+   *  Add, modify and retrieve data elements using an interned key. These
+   *  behave the same as the corresponding functions that take a name, but
+   *  avoid resolving the name on every call. An index of -1 refers to the
+   *  element without an index, so elements added with the name-based
+   *  functions using an index of -1 are also stored without an index.
+   *  @param key interned name of data element
+   *  @param value value of data element
+   *  @param idx index of value
+   */
+  void addValue(const DataKey &key, const int value, const int idx = -1);
+  void addValue(const DataKey &key, const long value, const int idx = -1);
+  void addValue(const DataKey &key, const bool value, const int idx = -1);
+  void addValue(const DataKey &key, const char *value, const int idx = -1);
+  void addValue(const DataKey &key, const float value, const int idx = -1);
+  void addValue(const DataKey &key, const double value, const int idx = -1);
+  void addValue(const DataKey &key, const gridpack::ComplexType value,
+      const int idx = -1);
+
+  bool setValue(const DataKey &key, const int value, const int idx = -1);
+  bool setValue(const DataKey &key, const long value, const int idx = -1);
+  bool setValue(const DataKey &key, const bool value, const int idx = -1);
+  bool setValue(const DataKey &key, const char *value, const int idx = -1);
+  bool setValue(const DataKey &key, const float value, const int idx = -1);
+  bool setValue(const DataKey &key, const double value, const int idx = -1);
+  bool setValue(const DataKey &key, const gridpack::ComplexType value,
+      const int idx = -1);
+
+  bool getValue(const DataKey &key, int *value, const int idx = -1);
+  bool getValue(const DataKey &key, long *value, const int idx = -1);
+  bool getValue(const DataKey &key, bool *value, const int idx = -1);
+  bool getValue(const DataKey &key, std::string *value, const int idx = -1);
+  bool getValue(const DataKey &key, float *value, const int idx = -1);
+  bool getValue(const DataKey &key, double *value, const int idx = -1);
+  bool getValue(const DataKey &key, gridpack::ComplexType *value,
+      const int idx = -1);
+
   /**
    * Dump contents of data collection to standard out
    */
   void dump(void);
+
+  /**
+   * Append a flat binary image of the data collection to a buffer. Keys are
+   * written using the interned IDs of the calling process, so the names
+   * corresponding to IDs 0 to DataKey::numKeys()-1 need to be stored
+   * alongside the image for it to be read back on another process
+   * @param buf buffer that image is appended to
+   */
+  void pack(std::vector<char> &buf) const;
+
+  /**
+   * Replace contents of data collection with a binary image created by
+   * pack. The image does not need to be aligned.
+   * @param ptr pointer to start of image. On return, it points to the first
+   *        byte after the image
+   * @param idMap map from interned IDs used in the image to IDs on this
+   *        process
+   */
+  void unpack(const char *&ptr, const std::vector<int> &idMap);
 private:
-#ifdef OLD_MAP
-  std::map<std::string, int> p_ints; 
-  std::map<std::string, long> p_longs; 
-  std::map<std::string, bool> p_bools; 
-  std::map<std::string, std::string> p_strings; 
-  std::map<std::string, float> p_floats; 
-  std::map<std::string, double> p_doubles; 
-  std::map<std::string, gridpack::ComplexType> p_complexType; 
-#else
-  boost::unordered_map<std::string, int> p_ints; 
-  boost::unordered_map<std::string, long> p_longs; 
-  boost::unordered_map<std::string, bool> p_bools; 
-  boost::unordered_map<std::string, std::string> p_strings; 
-  boost::unordered_map<std::string, float> p_floats; 
-  boost::unordered_map<std::string, double> p_doubles; 
-  boost::unordered_map<std::string, gridpack::ComplexType> p_complexType; 
-#endif
+  /**
+   * Contiguous storage for all elements of a single type. Elements are kept
+   * sorted by a composite key formed from the interned name and the index so
+   * that lookups are a binary search over a flat array.
+   */
+  template <typename T>
+  class DataStore {
+  public:
+    typedef T value_type;
+
+    /**
+     * Add value if key does not already exist
+     */
+    void add(unsigned long long key, const T &value)
+    {
+      std::vector<unsigned long long>::iterator it =
+        std::lower_bound(p_keys.begin(), p_keys.end(), key);
+      if (it != p_keys.end() && *it == key) return;
+      int pos = it - p_keys.begin();
+      p_keys.insert(it, key);
+      p_values.insert(p_values.begin()+pos, value);
+    }
+
+    /**
+     * Return pointer to value for key or NULL if key does not exist
+     */
+    T* find(unsigned long long key)
+    {
+      std::vector<unsigned long long>::iterator it =
+        std::lower_bound(p_keys.begin(), p_keys.end(), key);
+      if (it != p_keys.end() && *it == key) {
+        return &p_values[it - p_keys.begin()];
+      }
+      return NULL;
+    }
+
+    int size(void) const
+    {
+      return p_keys.size();
+    }
+
+    std::vector<unsigned long long> p_keys;
+    std::vector<T> p_values;
+  };
+
+  /**
+   * Construct composite key from interned name and index
+   * @param key interned name
+   * @param idx index of element (-1 if element has no index)
+   */
+  static unsigned long long compositeKey(const DataKey &key, const int idx)
+  {
+    unsigned long long ret = static_cast<unsigned long long>(key.id()) << 33;
+    if (idx != -1) {
+      ret |= (1ULL << 32) | static_cast<unsigned int>(idx);
+    }
+    return ret;
+  }
+
+  /**
+   * Reconstruct the "name" or "name:idx" tag for a composite key
+   */
+  static std::string keyTag(unsigned long long key);
+
+  /**
+   * Split a "name" or "name:idx" tag into an interned name and index
+   */
+  static unsigned long long tagKey(const std::string &tag);
+
+  DataStore<int> p_ints;
+  DataStore<long> p_longs;
+  DataStore<char> p_bools;  // stored as char so elements are addressable
+  DataStore<std::string> p_strings;
+  DataStore<float> p_floats;
+  DataStore<double> p_doubles;
+  DataStore<gridpack::ComplexType> p_complexType;
 
 private:
   friend class boost::serialization::access;
 
-  /// Serialization method
-  template<class Archive> void serialize(Archive &ar, const unsigned int)
+  /**
+   * Serialize one store. Interned IDs are only valid on a single process, so
+   * keys are written as "name:idx" tags and interned again when read back.
+   */
+  template<class Archive, typename T>
+  void saveStore(Archive &ar, const DataStore<T> &store) const
+  {
+    int n = store.size();
+    ar & n;
+    for (int i=0; i<n; i++) {
+      std::string tag = keyTag(store.p_keys[i]);
+      T value = store.p_values[i];
+      ar & tag & value;
+    }
+  }
+
+  template<class Archive, typename T>
+  void loadStore(Archive &ar, DataStore<T> &store)
   {
-    ar & p_ints
-      & p_longs
-      & p_bools
-      & p_strings
-      & p_floats
-      & p_doubles
-      & p_complexType;
+    int n;
+    ar & n;
+    store.p_keys.clear();
+    store.p_values.clear();
+    for (int i=0; i<n; i++) {
+      std::string tag;
+      T value;
+      ar & tag & value;
+      store.add(tagKey(tag), value);
+    }
   }
 
+  /// Serialization methods
+  template<class Archive> void save(Archive &ar, const unsigned int) const
+  {
+    saveStore(ar, p_ints);
+    saveStore(ar, p_longs);
+    saveStore(ar, p_bools);
+    saveStore(ar, p_strings);
+    saveStore(ar, p_floats);
+    saveStore(ar, p_doubles);
+    saveStore(ar, p_complexType);
+  }
+
+  template<class Archive> void load(Archive &ar, const unsigned int)
+  {
+    loadStore(ar, p_ints);
+    loadStore(ar, p_longs);
+    loadStore(ar, p_bools);
+    loadStore(ar, p_strings);
+    loadStore(ar, p_floats);
+    loadStore(ar, p_doubles);
+    loadStore(ar, p_complexType);
+  }
+
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
 };
 
 
@@ -38,6 +38,7 @@ typedef boost::archive::binary_oarchive outarchive;
 #include "gridpack/utilities/exception.hpp"
 #include "gridpack/parallel/parallel.hpp"
 #include "gridpack/environment/environment.hpp"
+#include "gridpack/parallel/threads.hpp"
 #include "data_collection.hpp"
 #include "base_component.hpp"
 
@@ -299,6 +300,104 @@ BOOST_AUTO_TEST_CASE( DataCollection_mpi )
   check_data_collection(key, *dcin, *dcout);
 }
 
+BOOST_AUTO_TEST_CASE( DataCollection_keys )
+{
+  gridpack::component::DataCollection dc;
+  gridpack::component::DataKey vkey("BUS_PF_VMAG");
+  gridpack::component::DataKey gkey("GENERATOR_PG");
+  gridpack::component::DataKey mkey("NOT_IN_COLLECTION");
+  double dval;
+  int ival;
+  bool bval;
+  std::string sval;
+
+  // keys resolve to the same ID every time
+  BOOST_CHECK_EQUAL(vkey.id(), gridpack::component::DataKey("BUS_PF_VMAG").id());
+  BOOST_CHECK(vkey.id() != gkey.id());
+  BOOST_CHECK_EQUAL(gridpack::component::DataKey::name(vkey.id()),
+      std::string("BUS_PF_VMAG"));
+
+  // values added by name are found by key and vice versa
+  dc.addValue("BUS_PF_VMAG", 1.02);
+  BOOST_REQUIRE(dc.getValue(vkey, &dval));
+  BOOST_CHECK_CLOSE(dval, 1.02, delta);
+  dc.addValue(gkey, 50.0, 1);
+  BOOST_REQUIRE(dc.getValue("GENERATOR_PG", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 50.0, delta);
+
+  // indexed and unindexed values are distinct
+  BOOST_CHECK(!dc.getValue(gkey, &dval));
+  BOOST_CHECK(!dc.getValue(vkey, &dval, 0));
+
+  // overwrite existing values
+  BOOST_CHECK(dc.setValue(vkey, 0.98));
+  BOOST_REQUIRE(dc.getValue("BUS_PF_VMAG", &dval));
+  BOOST_CHECK_CLOSE(dval, 0.98, delta);
+  BOOST_CHECK(dc.setValue("GENERATOR_PG", 75.0, 1));
+  BOOST_REQUIRE(dc.getValue(gkey, &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 75.0, delta);
+
+  // same name with different types are separate elements
+  BOOST_CHECK(!dc.getValue(vkey, &ival));
+  dc.addValue(vkey, 3);
+  BOOST_REQUIRE(dc.getValue(vkey, &ival));
+  BOOST_CHECK_EQUAL(ival, 3);
+  BOOST_REQUIRE(dc.getValue(vkey, &dval));
+  BOOST_CHECK_CLOSE(dval, 0.98, delta);
+
+  dc.addValue(vkey, false);
+  BOOST_CHECK(dc.setValue("BUS_PF_VMAG", true));
+  BOOST_REQUIRE(dc.getValue(vkey, &bval));
+  BOOST_CHECK(bval);
+
+  dc.addValue(vkey, "one");
+  BOOST_CHECK(dc.setValue(vkey, "two"));
+  BOOST_REQUIRE(dc.getValue("BUS_PF_VMAG", &sval));
+  BOOST_CHECK_EQUAL(sval, std::string("two"));
+
+  // missing keys leave the value untouched
+  dval = -1.0;
+  BOOST_CHECK(!dc.getValue(mkey, &dval));
+  BOOST_CHECK(!dc.getValue("NOT_IN_COLLECTION", &dval, 2));
+  BOOST_CHECK_EQUAL(dval, -1.0);
+  BOOST_CHECK(!dc.setValue(mkey, 1.0));
+  BOOST_CHECK(!dc.setValue("GENERATOR_PG", 1.0, 2));
+  BOOST_CHECK(!dc.getValue(mkey, &dval));
+}
+
+BOOST_AUTO_TEST_CASE( DataCollection_threaded_keys )
+{
+  // Half of the names exist before the loop and half are added by the
+  // threads. All threads must agree on the ID of every name
+  const int nnames = 64;
+  const int nlookups = 20000;
+  int i;
+  std::vector<int> ids(nnames, -1);
+  for (i=0; i<nnames/2; i++) {
+    ids[i] = gridpack::component::DataKey(
+        "THREADED_KEY_" + boost::lexical_cast<std::string>(i)).id();
+  }
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::Threads::set(4);
+  int nerr = 0;
+  GRIDPACK_PARALLEL_FOR_SUM(gridpack::parallel::Threads::get(), nerr)
+  for (i=0; i<nlookups; i++) {
+    int j = i%nnames;
+    std::string name = "THREADED_KEY_" + boost::lexical_cast<std::string>(j);
+    gridpack::component::DataKey key(name);
+    if (gridpack::component::DataKey::name(key.id()) != name) nerr++;
+    if (j < nnames/2 && key.id() != ids[j]) nerr++;
+  }
+  gridpack::parallel::Threads::set(nthr);
+  BOOST_CHECK_EQUAL(nerr, 0);
+  for (i=0; i<nnames; i++) {
+    std::string name = "THREADED_KEY_" + boost::lexical_cast<std::string>(i);
+    gridpack::component::DataKey key(name);
+    BOOST_CHECK_EQUAL(gridpack::component::DataKey::name(key.id()), name);
+    if (i < nnames/2) BOOST_CHECK_EQUAL(key.id(), ids[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE ( Component_bin )
 {
   static int the_id(1);
@@ -23,9 +23,13 @@
 #include "gridpack/timer/coarse_timer.hpp"
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/component/base_component.hpp"
+#include "gridpack/parallel/threads.hpp"
 
 // Base factory class that contains functions that are generic to all
-// applications.
+// applications. The loops over components in setComponents, load and
+// setMode run on the number of threads set with
+// gridpack::parallel::Threads::set, so the component functions called in
+// them may only modify the component they are called on.
 
 namespace gridpack{
 namespace factory{
@@ -79,41 +83,55 @@ class BaseFactory {
       timer->configTimer(p_profile);
       int t_setc = timer->createCategory("Factory:setComponents");
       timer->start(t_setc);
-      int i, j;
-      int idx1, idx2;
+      int i;
+      int nthr = gridpack::parallel::Threads::get();
+      gridpack::parallel::ThreadErrors errors;
 
       // Set pointers for buses at either end of each branch
       int numActiveBranch = 0;
+      GRIDPACK_PARALLEL_FOR_SUM(nthr, numActiveBranch)
       for (i=0; i<p_numBranches; i++) {
-        int branch_idx, bus1_idx, bus2_idx;
-        p_network->getBranchEndpoints(i, &idx1, &idx2);
-        p_network->getBranch(i)->setBus1(p_network->getBus(idx1));
-        p_network->getBranch(i)->setBus2(p_network->getBus(idx2));
-        branch_idx = p_network->getGlobalBranchIndex(i); 
-        bus1_idx = p_network->getGlobalBusIndex(idx1); 
-        bus2_idx = p_network->getGlobalBusIndex(idx2); 
-        p_network->getBranch(i)->setMatVecIndices(bus1_idx, bus2_idx); 
-        if (p_network->getActiveBranch(i)) numActiveBranch++;
+        try {
+          int branch_idx, bus1_idx, bus2_idx, idx1, idx2;
+          p_network->getBranchEndpoints(i, &idx1, &idx2);
+          p_network->getBranch(i)->setBus1(p_network->getBus(idx1));
+          p_network->getBranch(i)->setBus2(p_network->getBus(idx2));
+          branch_idx = p_network->getGlobalBranchIndex(i); 
+          bus1_idx = p_network->getGlobalBusIndex(idx1); 
+          bus2_idx = p_network->getGlobalBusIndex(idx2); 
+          p_network->getBranch(i)->setMatVecIndices(bus1_idx, bus2_idx); 
+          if (p_network->getActiveBranch(i)) numActiveBranch++;
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
 
       // Set pointers for branches and buses connected to each bus
       int numActiveBus = 0;
+      GRIDPACK_PARALLEL_FOR_SUM(nthr, numActiveBus)
       for (i=0; i<p_numBuses; i++) {
-        p_network->getBus(i)->clearBuses();
-        std::vector<int> nghbrBus = p_network->getConnectedBuses(i);
-        for (j=0; j<nghbrBus.size(); j++) {
-          p_network->getBus(i)->addBus(p_network->getBus(nghbrBus[j]));
-        }
-        p_network->getBus(i)->clearBranches();
-        std::vector<int> nghbrBranch = p_network->getConnectedBranches(i);
-        for (j=0; j<nghbrBranch.size(); j++) {
-          p_network->getBus(i)->addBranch(p_network->getBranch(nghbrBranch[j]));
+        try {
+          int j;
+          p_network->getBus(i)->clearBuses();
+          std::vector<int> nghbrBus = p_network->getConnectedBuses(i);
+          for (j=0; j<nghbrBus.size(); j++) {
+            p_network->getBus(i)->addBus(p_network->getBus(nghbrBus[j]));
+          }
+          p_network->getBus(i)->clearBranches();
+          std::vector<int> nghbrBranch = p_network->getConnectedBranches(i);
+          for (j=0; j<nghbrBranch.size(); j++) {
+            p_network->getBus(i)->addBranch(p_network->getBranch(nghbrBranch[j]));
+          }
+          int bus_idx;
+          bus_idx = p_network->getGlobalBusIndex(i); 
+          p_network->getBus(i)->setMatVecIndex(bus_idx);
+          if (p_network->getActiveBus(i)) numActiveBus++;
+        } catch (...) {
+          errors.save(std::current_exception());
         }
-        int bus_idx;
-        bus_idx = p_network->getGlobalBusIndex(i); 
-        p_network->getBus(i)->setMatVecIndex(bus_idx);
-        if (p_network->getActiveBus(i)) numActiveBus++;
       }
+      errors.check();
       
       // Set reference bus
       int idx = p_network->getReferenceBus();
@@ -122,28 +140,40 @@ class BaseFactory {
       }
 
       // Set bus and branch indices
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBuses; i++) {
-        p_network->getBus(i)->setOriginalIndex(p_network->getOriginalBusIndex(i));
-        p_network->getBus(i)->setGlobalIndex(p_network->getGlobalBusIndex(i));
+        try {
+          p_network->getBus(i)->setOriginalIndex(p_network->getOriginalBusIndex(i));
+          p_network->getBus(i)->setGlobalIndex(p_network->getGlobalBusIndex(i));
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBranches; i++) {
-        gridpack::component::BaseBusComponent *bus1 =
-          dynamic_cast<gridpack::component::BaseBusComponent*>
-          (p_network->getBranch(i)->getBus1().get());
-        gridpack::component::BaseBusComponent *bus2 =
-          dynamic_cast<gridpack::component::BaseBusComponent*>
-          (p_network->getBranch(i)->getBus2().get());
-        p_network->getBranch(i)->setGlobalIndex(
-            p_network->getGlobalBranchIndex(i));
-        p_network->getBranch(i)->setBus1OriginalIndex(
-            bus1->getOriginalIndex());
-        p_network->getBranch(i)->setBus2OriginalIndex(
-            bus2->getOriginalIndex());
-        p_network->getBranch(i)->setBus1GlobalIndex(
-            bus1->getGlobalIndex());
-        p_network->getBranch(i)->setBus2GlobalIndex(
-            bus2->getGlobalIndex());
+        try {
+          gridpack::component::BaseBusComponent *bus1 =
+            dynamic_cast<gridpack::component::BaseBusComponent*>
+            (p_network->getBranch(i)->getBus1().get());
+          gridpack::component::BaseBusComponent *bus2 =
+            dynamic_cast<gridpack::component::BaseBusComponent*>
+            (p_network->getBranch(i)->getBus2().get());
+          p_network->getBranch(i)->setGlobalIndex(
+              p_network->getGlobalBranchIndex(i));
+          p_network->getBranch(i)->setBus1OriginalIndex(
+              bus1->getOriginalIndex());
+          p_network->getBranch(i)->setBus2OriginalIndex(
+              bus2->getOriginalIndex());
+          p_network->getBranch(i)->setBus1GlobalIndex(
+              bus1->getGlobalIndex());
+          p_network->getBranch(i)->setBus2GlobalIndex(
+              bus2->getGlobalIndex());
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
 
       // Come up with a set of global indices for each component so that the buses
       // and branches are consecutively numbered on each component and the indices
@@ -228,11 +258,18 @@ class BaseFactory {
       GA_Destroy(g_bus);
 
       // Finish by assigning MatVecIndices for the branches
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBranches; i++) {
-        p_network->getBranch(i)->getBus1()->getMatVecIndex(&idx1);
-        p_network->getBranch(i)->getBus2()->getMatVecIndex(&idx2);
-        p_network->getBranch(i)->setMatVecIndices(idx1,idx2);
+        try {
+          int idx1, idx2;
+          p_network->getBranch(i)->getBus1()->getMatVecIndex(&idx1);
+          p_network->getBranch(i)->getBus2()->getMatVecIndex(&idx2);
+          p_network->getBranch(i)->setMatVecIndices(idx1,idx2);
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
       
       // Set internal maps
       p_network->setMap();
@@ -258,13 +295,23 @@ class BaseFactory {
       timer->stop(t_nbus);
       int i;
       int rank = p_network->communicator().rank();
+      int nthr = gridpack::parallel::Threads::get();
+      gridpack::parallel::ThreadErrors errors;
 
       // Invoke load method on all bus objects
       int t_load1 = timer->createCategory("Factory:load:bus");
       timer->start(t_load1);
+      GRIDPACK_PARALLEL_FOR(nthr)
+      for (i=0; i<p_numBuses; i++) {
+        try {
+          p_network->getBus(i)->setRank(rank);
+          p_network->getBus(i)->load(p_network->getBusData(i));
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
+      }
+      errors.check();
       for (i=0; i<p_numBuses; i++) {
-        p_network->getBus(i)->setRank(rank);
-        p_network->getBus(i)->load(p_network->getBusData(i));
         if (p_network->getBus(i)->getReferenceBus())
           p_network->setReferenceBus(i);
       }
@@ -273,10 +320,16 @@ class BaseFactory {
       // Invoke load method on all branch objects
       int t_load2 = timer->createCategory("Factory:load:branch");
       timer->start(t_load2);
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBranches; i++) {
-        p_network->getBranch(i)->setRank(rank);
-        p_network->getBranch(i)->load(p_network->getBranchData(i));
+        try {
+          p_network->getBranch(i)->setRank(rank);
+          p_network->getBranch(i)->load(p_network->getBranchData(i));
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
       timer->stop(t_load2);
       timer->stop(t_load);
       timer->configTimer(true);
@@ -368,12 +421,26 @@ class BaseFactory {
     virtual void setMode(int mode)
     {
       int i;
+      int nthr = gridpack::parallel::Threads::get();
+      gridpack::parallel::ThreadErrors errors;
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBuses; i++) {
-        p_buses[i]->setMode(mode);
+        try {
+          p_buses[i]->setMode(mode);
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBranches; i++) {
-        p_branches[i]->setMode(mode);
+        try {
+          p_branches[i]->setMode(mode);
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
     }
 
     /**
@@ -383,9 +450,17 @@ class BaseFactory {
     virtual void setBusMode(int mode)
     {
       int i;
+      int nthr = gridpack::parallel::Threads::get();
+      gridpack::parallel::ThreadErrors errors;
+      GRIDPACK_PARALLEL_FOR(nthr)
       for (i=0; i<p_numBuses; i++) {
-        p_buses[i]->setMode(mode);
+        try {
+          p_buses[i]->setMode(mode);
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
       }
+      errors.check();
     }
 
     /**
@@ -395,8 +470,51 @@ class BaseFactory {
     virtual void setBranchMode(int mode)
     {
       int i;
+      int nthr = gridpack::parallel::Threads::get();
+      gridpack::parallel::ThreadErrors errors;
+      GRIDPACK_PARALLEL_FOR(nthr)
+      for (i=0; i<p_numBranches; i++) {
+        try {
+          p_branches[i]->setMode(mode);
+        } catch (...) {
+          errors.save(std::current_exception());
+        }
+      }
+      errors.check();
+    }
+
+    /**
+     * Estimate the cost of each bus and branch for partitioning the network
+     * with BaseNetwork::partition(busWeights, branchWeights). The cost of a
+     * bus is based on the size of its diagonal block in the matrix for the
+     * current mode and the cost of a branch on the size of its off-diagonal
+     * blocks, so the network must be loaded and the mode set before calling
+     * this function. Factories for applications whose work is dominated by
+     * something other than the matrix can override this function. The
+     * factory cannot be used after the network has been partitioned again
+     * @param busWeights cost of each local bus
+     * @param branchWeights cost of cutting each local branch
+     */
+    virtual void partitionWeights(std::vector<int> &busWeights,
+        std::vector<int> &branchWeights)
+    {
+      int i, isize, jsize;
+      busWeights.resize(p_numBuses);
+      for (i=0; i<p_numBuses; i++) {
+        busWeights[i] = 1;
+        if (p_buses[i]->matrixDiagSize(&isize,&jsize)) {
+          busWeights[i] += isize*jsize;
+        }
+      }
+      branchWeights.resize(p_numBranches);
       for (i=0; i<p_numBranches; i++) {
-        p_branches[i]->setMode(mode);
+        branchWeights[i] = 1;
+        if (p_branches[i]->matrixForwardSize(&isize,&jsize)) {
+          branchWeights[i] += isize*jsize;
+        }
+        if (p_branches[i]->matrixReverseSize(&isize,&jsize)) {
+          branchWeights[i] += isize*jsize;
+        }
       }
     }
 
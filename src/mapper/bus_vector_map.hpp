@@ -24,6 +24,7 @@
 #include <gridpack/component/base_component.hpp>
 #include <gridpack/network/base_network.hpp>
 #include <gridpack/math/vector.hpp>
+#include <gridpack/parallel/threads.hpp>
 
 //#define DBG_CHECK
 
@@ -225,16 +226,23 @@ void mapToBus(const gridpack::math::Vector &vector)
   if (p_timer) p_timer->start(t_get);
   vector.getElements(p_numValues, p_Indices, values);
   if (p_timer) p_timer->stop(t_get);
-  ComplexType *vptr = values;
   if (p_timer) t_unpack = p_timer->createCategory("mapToBus: set Data");
   if (p_timer) p_timer->start(t_unpack);
+  std::vector<int> start;
+  valueOffsets(start);
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::ThreadErrors errors;
+  GRIDPACK_PARALLEL_FOR(nthr)
   for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->setValues(vptr);
-    isize = p_ISize[i];
-    vptr += isize;
+    try {
+      p_contributingBuses[i]->setValues(values+start[i]);
+    } catch (...) {
+      errors.save(std::current_exception());
+    }
   }
   if (p_timer) p_timer->stop(t_unpack);
   delete [] values;
+  errors.check();
 }
 
 /**
@@ -252,16 +260,23 @@ void mapToBus(const gridpack::math::RealVector &vector)
   if (p_timer) p_timer->start(t_get);
   vector.getElements(p_numValues, p_Indices, values);
   if (p_timer) p_timer->stop(t_get);
-  RealType *vptr = values;
   if (p_timer) t_unpack = p_timer->createCategory("mapToBus: set Data");
   if (p_timer) p_timer->start(t_unpack);
+  std::vector<int> start;
+  valueOffsets(start);
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::ThreadErrors errors;
+  GRIDPACK_PARALLEL_FOR(nthr)
   for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->setValues(vptr);
-    isize = p_ISize[i];
-    vptr += isize;
+    try {
+      p_contributingBuses[i]->setValues(values+start[i]);
+    } catch (...) {
+      errors.save(std::current_exception());
+    }
   }
   if (p_timer) p_timer->stop(t_unpack);
   delete [] values;
+  errors.check();
 }
 
 /**
@@ -311,11 +326,11 @@ void loadBusData(gridpack::math::Vector &vector, bool flag)
   if (p_timer) t_pack = p_timer->createCategory("loadBusData: Fill Buffer");
   if (p_timer) p_timer->start(t_pack);
   ComplexType *vbuf = new ComplexType[p_numValues];
-  ComplexType *vptr = vbuf;
   int *ibuf = new int[p_numValues];
+  std::vector<int> start;
+  valueOffsets(start);
   icnt = 0;
   for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->vectorValues(vptr);
     isize = p_ISize[i];
     idx = p_Offsets[i];
     for (j=0; j<isize; j++) {
@@ -323,8 +338,20 @@ void loadBusData(gridpack::math::Vector &vector, bool flag)
       idx++;
       icnt++;
     }
-    vptr += isize;
   }
+  // Each bus writes to its own section of the buffer so the values can be
+  // evaluated on several threads
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::ThreadErrors errors;
+  GRIDPACK_PARALLEL_FOR(nthr)
+  for (i=0; i<p_busContribution; i++) {
+    try {
+      p_contributingBuses[i]->vectorValues(vbuf+start[i]);
+    } catch (...) {
+      errors.save(std::current_exception());
+    }
+  }
+  errors.check();
   if (p_timer) p_timer->stop(t_pack);
   if (p_timer) t_add = p_timer->createCategory("loadBusData: Add Elements");
   if (p_timer) p_timer->start(t_add);
@@ -353,11 +380,11 @@ void loadRealBusData(gridpack::math::RealVector &vector, bool flag)
   if (p_timer) t_pack = p_timer->createCategory("loadBusData: Fill Buffer");
   if (p_timer) p_timer->start(t_pack);
   RealType *vbuf = new RealType[p_numValues];
-  RealType *vptr = vbuf;
   int *ibuf = new int[p_numValues];
+  std::vector<int> start;
+  valueOffsets(start);
   icnt = 0;
   for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->vectorValues(vptr);
     isize = p_ISize[i];
     idx = p_Offsets[i];
     for (j=0; j<isize; j++) {
@@ -365,8 +392,20 @@ void loadRealBusData(gridpack::math::RealVector &vector, bool flag)
       idx++;
       icnt++;
     }
-    vptr += isize;
   }
+  // Each bus writes to its own section of the buffer so the values can be
+  // evaluated on several threads
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::ThreadErrors errors;
+  GRIDPACK_PARALLEL_FOR(nthr)
+  for (i=0; i<p_busContribution; i++) {
+    try {
+      p_contributingBuses[i]->vectorValues(vbuf+start[i]);
+    } catch (...) {
+      errors.save(std::current_exception());
+    }
+  }
+  errors.check();
   if (p_timer) p_timer->stop(t_pack);
   if (p_timer) t_add = p_timer->createCategory("loadBusData: Add Elements");
   if (p_timer) p_timer->start(t_add);
@@ -397,6 +436,22 @@ void loadRealBusData(boost::shared_ptr<gridpack::math::RealVector> &vector, bool
   loadRealBusData(*vector, flag);
 }
 
+/**
+ * Find the location of the values of each contributing bus in the list of
+ * all local values
+ * @param start offset of values for each contributing bus
+ */
+void valueOffsets(std::vector<int> &start)
+{
+  int i;
+  start.resize(p_busContribution);
+  int offset = 0;
+  for (i=0; i<p_busContribution; i++) {
+    start[i] = offset;
+    offset += p_ISize[i];
+  }
+}
+
 /**
  * Calculate how many buses contribute to vector
  */
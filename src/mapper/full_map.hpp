@@ -19,6 +19,8 @@
 
 //#define NZ_PER_ROW
 
+#include <vector>
+#include <algorithm>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <ga.h>
 #include "gridpack/parallel/parallel.hpp"
@@ -27,6 +29,7 @@
 #include <gridpack/network/base_network.hpp>
 #include <gridpack/math/matrix.hpp>
 #include <gridpack/utilities/exception.hpp>
+#include <gridpack/parallel/threads.hpp>
 
 #define DBG_CHECK
 
@@ -55,6 +58,8 @@ FullMatrixMap(boost::shared_ptr<_network> network)
   int                     iSize    = 0;
   int                     jSize    = 0;
 
+  p_patternSet = false;
+  p_nnz = 0;
   p_timer = NULL;
   //p_timer = gridpack::utility::CoarseTimer::instance();
 
@@ -344,6 +349,96 @@ void incrementMatrix(boost::shared_ptr<gridpack::math::Matrix> &matrix)
   incrementMatrix(*matrix);
 }
 
+/**
+ * Reset values of an existing matrix using the frozen sparsity pattern of the
+ * mapper. The first call records the location of every matrix block
+ * contributed by buses and branches. Subsequent calls only evaluate the
+ * component values and write them into a cached value array that is handed
+ * to the matrix in a single call. The nonzero structure of the network must
+ * not change between calls; use resetPattern() if it does.
+ * @param matrix existing matrix (should be generated from same mapper)
+ */
+void refillMatrix(gridpack::math::Matrix &matrix)
+{
+  int t_set, t_bus;
+  if (!p_patternSet) buildPattern();
+  GA_Pgroup_sync(p_GAgrp);
+  if (p_timer) t_bus = p_timer->createCategory("Mapper: Load Pattern Values");
+  if (p_timer) p_timer->start(t_bus);
+  loadPatternValues(p_patValues);
+  if (p_nnz > 0) {
+    matrix.setElements(p_nnz, &p_patRows[0], &p_patCols[0], &p_patValues[0]);
+  }
+  if (p_timer) p_timer->stop(t_bus);
+  if (p_timer) t_set = p_timer->createCategory("Mapper: Set Matrix");
+  if (p_timer) p_timer->start(t_set);
+  GA_Pgroup_sync(p_GAgrp);
+  matrix.ready();
+  if (p_timer) p_timer->stop(t_set);
+}
+
+/**
+ * Reset values of an existing real matrix using the frozen sparsity pattern
+ * of the mapper
+ * @param matrix existing matrix (should be generated from same mapper)
+ */
+void refillRealMatrix(gridpack::math::RealMatrix &matrix)
+{
+  int t_set, t_bus;
+  if (!p_patternSet) buildPattern();
+  GA_Pgroup_sync(p_GAgrp);
+  if (p_timer) t_bus = p_timer->createCategory("Mapper: Load Pattern Values");
+  if (p_timer) p_timer->start(t_bus);
+  loadPatternValues(p_patRealValues);
+  if (p_nnz > 0) {
+    matrix.setElements(p_nnz, &p_patRows[0], &p_patCols[0],
+        &p_patRealValues[0]);
+  }
+  if (p_timer) p_timer->stop(t_bus);
+  if (p_timer) t_set = p_timer->createCategory("Mapper: Set Matrix");
+  if (p_timer) p_timer->start(t_set);
+  GA_Pgroup_sync(p_GAgrp);
+  matrix.ready();
+  if (p_timer) p_timer->stop(t_set);
+}
+
+/**
+ * Reset values of an existing matrix using the frozen sparsity pattern
+ * @param matrix existing matrix (should be generated from same mapper)
+ */
+void refillMatrix(boost::shared_ptr<gridpack::math::Matrix> &matrix)
+{
+  refillMatrix(*matrix);
+}
+
+/**
+ * Reset values of an existing real matrix using the frozen sparsity pattern
+ * @param matrix existing matrix (should be generated from same mapper)
+ */
+void refillRealMatrix(boost::shared_ptr<gridpack::math::RealMatrix> &matrix)
+{
+  refillRealMatrix(*matrix);
+}
+
+/**
+ * Discard the cached sparsity pattern. The pattern is rebuilt on the next
+ * call to refillMatrix or refillRealMatrix. This only needs to be called if
+ * the values returned by matrixDiagSize, matrixForwardSize or
+ * matrixReverseSize have changed since the pattern was built, but the block
+ * offsets in the mapper are still valid
+ */
+void resetPattern(void)
+{
+  p_patternSet = false;
+  p_slots.clear();
+  p_slotMap.clear();
+  p_patRows.clear();
+  p_patCols.clear();
+  p_patValues.clear();
+  p_patRealValues.clear();
+  p_nnz = 0;
+}
+
 /**
  * Check to see if matrix looks well formed. This method runs through all
  * branches and verifies that the dimensions of the branch contributions match
@@ -408,6 +503,19 @@ bool check(void)
 }
 
 private:
+
+    // matrix block contributed by a single bus or branch
+enum {BUS_DIAG, BRANCH_FORWARD, BRANCH_REVERSE};
+struct PatternSlot {
+  int type;    // bus diagonal, forward branch or reverse branch block
+  int index;   // local index of bus or branch
+  int isize;   // block size along i axis
+  int jsize;   // block size along j axis
+  int ioff;    // row offset of block in matrix
+  int joff;    // column offset of block in matrix
+  int offset;  // location of first block element in list of all elements
+};
+
 /**
  * Return the number of active buses on this process
  * @return number of active buses
@@ -930,34 +1038,30 @@ void setBusOffsets(void)
  */
 void loadBusData(gridpack::math::Matrix &matrix, bool flag)
 {
-  int i,idx,jdx,isize,jsize,icnt;
+  if (gridpack::parallel::Threads::get() > 1) {
+    std::vector<PatternSlot> slots;
+    collectBusBlocks(slots);
+    loadSlots<gridpack::math::Matrix, ComplexType>(matrix, slots, flag);
+    return;
+  }
+  int i,isize,jsize;
   boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
   // Add matrix elements
   ComplexType *values = new ComplexType[p_maxIBlock*p_maxJBlock];
-  int j,k;
+  std::vector<ComplexType> block(p_maxIBlock*p_maxJBlock);
   int jcnt = 0;
   for (i=0; i<p_nBuses; i++) {
     if (p_network->getActiveBus(i)) {
       bus = p_network->getBus(i);
       if (bus->matrixDiagSize(&isize,&jsize)) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          loadBlock(matrix, p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -975,34 +1079,30 @@ void loadBusData(gridpack::math::Matrix &matrix, bool flag)
  */
 void loadRealBusData(gridpack::math::RealMatrix &matrix, bool flag)
 {
-  int i,idx,jdx,isize,jsize,icnt;
+  if (gridpack::parallel::Threads::get() > 1) {
+    std::vector<PatternSlot> slots;
+    collectBusBlocks(slots);
+    loadSlots<gridpack::math::RealMatrix, RealType>(matrix, slots, flag);
+    return;
+  }
+  int i,isize,jsize;
   boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
   // Add matrix elements
   RealType *values = new RealType[p_maxIBlock*p_maxJBlock];
-  int j,k;
+  std::vector<RealType> block(p_maxIBlock*p_maxJBlock);
   int jcnt = 0;
   for (i=0; i<p_nBuses; i++) {
     if (p_network->getActiveBus(i)) {
       bus = p_network->getBus(i);
       if (bus->matrixDiagSize(&isize,&jsize)) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          loadBlock(matrix, p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -1113,14 +1213,21 @@ void setBranchOffsets(void)
  */
 void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
 {
-  int i,idx,jdx,isize,jsize,icnt;
+  int i,idx,jdx,isize,jsize;
   // Add matrix elements
   int t_add(0);
   if (p_timer) t_add = p_timer->createCategory("loadBranchData: Add Matrix Elements");
   if (p_timer) p_timer->start(t_add);
+  if (gridpack::parallel::Threads::get() > 1) {
+    std::vector<PatternSlot> slots;
+    collectBranchBlocks(slots);
+    loadSlots<gridpack::math::Matrix, ComplexType>(matrix, slots, flag);
+    if (p_timer) p_timer->stop(t_add);
+    return;
+  }
   boost::shared_ptr<gridpack::component::BaseBranchComponent> branch;
   ComplexType *values = new ComplexType[p_maxIBlock*p_maxJBlock];
-  int j,k;
+  std::vector<ComplexType> block(p_maxIBlock*p_maxJBlock);
   int jcnt = 0;
   for (i=0; i<p_nBranches; i++) {
     branch = p_network->getBranch(i);
@@ -1128,23 +1235,13 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
       branch->getMatVecIndices(&idx, &jdx);
       if (idx >= p_minRowIndex && idx <= p_maxRowIndex) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          loadBlock(matrix, p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -1153,25 +1250,15 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
       branch->getMatVecIndices(&idx, &jdx);
       if (jdx >= p_minRowIndex && jdx <= p_maxRowIndex) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          // Offsets for reverse blocks are already swapped, so the block
+          // is loaded the same way as a forward block
+          loadBlock(matrix, p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -1190,14 +1277,21 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
  */
 void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
 {
-  int i,idx,jdx,isize,jsize,icnt;
+  int i,idx,jdx,isize,jsize;
   // Add matrix elements
   int t_add(0);
   if (p_timer) t_add = p_timer->createCategory("loadBranchData: Add Matrix Elements");
   if (p_timer) p_timer->start(t_add);
+  if (gridpack::parallel::Threads::get() > 1) {
+    std::vector<PatternSlot> slots;
+    collectBranchBlocks(slots);
+    loadSlots<gridpack::math::RealMatrix, RealType>(matrix, slots, flag);
+    if (p_timer) p_timer->stop(t_add);
+    return;
+  }
   boost::shared_ptr<gridpack::component::BaseBranchComponent> branch;
   RealType *values = new RealType[p_maxIBlock*p_maxJBlock];
-  int j,k;
+  std::vector<RealType> block(p_maxIBlock*p_maxJBlock);
   int jcnt = 0;
   for (i=0; i<p_nBranches; i++) {
     branch = p_network->getBranch(i);
@@ -1205,23 +1299,13 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
       branch->getMatVecIndices(&idx, &jdx);
       if (idx >= p_minRowIndex && idx <= p_maxRowIndex) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          loadBlock(matrix, p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -1230,25 +1314,15 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
       branch->getMatVecIndices(&idx, &jdx);
       if (jdx >= p_minRowIndex && jdx <= p_maxRowIndex) {
 #ifdef DBG_CHECK
+        int k;
         int ijsize = isize*jsize;
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
-          }
+          // Offsets for reverse blocks are already swapped, so the block
+          // is loaded the same way as a forward block
+          loadBlock(matrix, p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+              isize, jsize, values, block, flag);
         }
         jcnt++;
       }
@@ -1314,6 +1388,280 @@ void contributions(void)
   }
 }
 
+/**
+ * Add or set a dense block of matrix elements with a single call to the
+ * matrix
+ * @param matrix matrix to which the block is added
+ * @param ioff row offset of block in matrix
+ * @param joff column offset of block in matrix
+ * @param isize size of block along i axis
+ * @param jsize size of block along j axis
+ * @param values block values in the order written by the component
+ * (column by column)
+ * @param block work array of size isize*jsize
+ * @param flag add values if true, otherwise overwrite them
+ */
+template <typename _matrix_type, typename _data_type>
+void loadBlock(_matrix_type &matrix, int ioff, int joff, int isize,
+    int jsize, const _data_type *values, std::vector<_data_type> &block,
+    bool flag)
+{
+  int j, k;
+  p_blockRows.resize(isize);
+  p_blockCols.resize(jsize);
+  for (j=0; j<isize; j++) p_blockRows[j] = ioff+j;
+  for (k=0; k<jsize; k++) p_blockCols[k] = joff+k;
+  // matrix blocks are stored row by row
+  for (k=0; k<jsize; k++) {
+    for (j=0; j<isize; j++) {
+      block[j*jsize+k] = values[k*isize+j];
+    }
+  }
+  if (flag) {
+    matrix.addElementBlock(isize, &p_blockRows[0], jsize, &p_blockCols[0],
+        &block[0]);
+  } else {
+    matrix.setElementBlock(isize, &p_blockRows[0], jsize, &p_blockCols[0],
+        &block[0]);
+  }
+}
+
+/**
+ * Build the frozen sparsity pattern used by refillMatrix. Every bus and
+ * branch block that contributes to the matrix is recorded in a slot table
+ * together with the location of its elements in a compressed row-ordered
+ * list of unique nonzeros. Rows and columns of the pattern are stored in
+ * coordinate form so that the values can be passed to the matrix in a single
+ * setElements call.
+ */
+void buildPattern(void)
+{
+  int i,j,k;
+  resetPattern();
+  collectBusBlocks(p_slots);
+  collectBranchBlocks(p_slots);
+  // Row and column of every block element, in the order that the component
+  // writes them into its values array
+  int nslots = p_slots.size();
+  int nelem = 0;
+  if (nslots > 0) {
+    nelem = p_slots[nslots-1].offset
+      + p_slots[nslots-1].isize*p_slots[nslots-1].jsize;
+  }
+  std::vector<int> rows(nelem), cols(nelem);
+  for (i=0; i<nslots; i++) {
+    const PatternSlot &slot = p_slots[i];
+    int *srow = &rows[slot.offset];
+    int *scol = &cols[slot.offset];
+    for (k=0; k<slot.jsize; k++) {
+      for (j=0; j<slot.isize; j++) {
+        srow[k*slot.isize+j] = slot.ioff+j;
+        scol[k*slot.isize+j] = slot.joff+k;
+      }
+    }
+  }
+
+  // Sort elements by row and then column and remove duplicates. The slot map
+  // records the position of each block element in the unique list.
+  std::vector<std::pair<std::pair<int,int>, int> > order(nelem);
+  for (k=0; k<nelem; k++) {
+    order[k] = std::make_pair(std::make_pair(rows[k],cols[k]),k);
+  }
+  std::sort(order.begin(), order.end());
+  p_slotMap.resize(nelem);
+  p_nnz = 0;
+  for (k=0; k<nelem; k++) {
+    if (k == 0 || order[k].first != order[k-1].first) {
+      p_patRows.push_back(order[k].first.first);
+      p_patCols.push_back(order[k].first.second);
+      p_nnz++;
+    }
+    p_slotMap[order[k].second] = p_nnz-1;
+  }
+  p_patternSet = true;
+}
+
+/**
+ * List the diagonal blocks that buses contribute to the matrix, in the order
+ * in which they are loaded by loadBusData
+ * @param slots list that the blocks are appended to
+ */
+void collectBusBlocks(std::vector<PatternSlot> &slots)
+{
+  int i,isize,jsize;
+  int jcnt = 0;
+  for (i=0; i<p_nBuses; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (p_network->getBus(i)->matrixDiagSize(&isize,&jsize)) {
+        addSlot(slots, BUS_DIAG, i, isize, jsize, p_i_busOffsets[jcnt],
+            p_j_busOffsets[jcnt]);
+        jcnt++;
+      }
+    }
+  }
+}
+
+/**
+ * List the off-diagonal blocks that branches contribute to the matrix, in
+ * the order in which they are loaded by loadBranchData
+ * @param slots list that the blocks are appended to
+ */
+void collectBranchBlocks(std::vector<PatternSlot> &slots)
+{
+  int i,idx,jdx,isize,jsize;
+  int jcnt = 0;
+  boost::shared_ptr<gridpack::component::BaseBranchComponent> branch;
+  for (i=0; i<p_nBranches; i++) {
+    branch = p_network->getBranch(i);
+    if (branch->matrixForwardSize(&isize,&jsize)) {
+      branch->getMatVecIndices(&idx, &jdx);
+      if (idx >= p_minRowIndex && idx <= p_maxRowIndex) {
+        addSlot(slots, BRANCH_FORWARD, i, isize, jsize,
+            p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt]);
+        jcnt++;
+      }
+    }
+    if (branch->matrixReverseSize(&isize,&jsize)) {
+      branch->getMatVecIndices(&idx, &jdx);
+      if (jdx >= p_minRowIndex && jdx <= p_maxRowIndex) {
+        // Offsets for reverse blocks are already swapped so element (j,k) of
+        // the block lands on the same row and column as a forward block
+        addSlot(slots, BRANCH_REVERSE, i, isize, jsize,
+            p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt]);
+        jcnt++;
+      }
+    }
+  }
+}
+
+/**
+ * Add a single matrix block to a list of blocks. The elements of the blocks
+ * in the list are numbered consecutively
+ * @param slots list of blocks
+ * @param type type of component contributing block
+ * @param index local index of bus or branch
+ * @param isize size of block along i axis
+ * @param jsize size of block along j axis
+ * @param ioff row offset of block in matrix
+ * @param joff column offset of block in matrix
+ */
+void addSlot(std::vector<PatternSlot> &slots, int type, int index,
+    int isize, int jsize, int ioff, int joff)
+{
+  PatternSlot slot;
+  slot.type = type;
+  slot.index = index;
+  slot.isize = isize;
+  slot.jsize = jsize;
+  slot.ioff = ioff;
+  slot.joff = joff;
+  slot.offset = 0;
+  if (!slots.empty()) {
+    const PatternSlot &last = slots.back();
+    slot.offset = last.offset + last.isize*last.jsize;
+  }
+  slots.push_back(slot);
+}
+
+/**
+ * Evaluate the values of a list of blocks. Each block is written to its own
+ * section of the values array so components can be evaluated on several
+ * threads. Blocks whose components do not return values are left at zero
+ * @param slots list of blocks
+ * @param values values of all blocks, in the order written by the
+ * components
+ * @param ok true for blocks whose components returned values
+ */
+template <typename _data_type>
+void evaluateSlots(const std::vector<PatternSlot> &slots,
+    std::vector<_data_type> &values, std::vector<char> &ok)
+{
+  int i;
+  int nslots = slots.size();
+  int nelem = 0;
+  if (nslots > 0) {
+    nelem = slots[nslots-1].offset
+      + slots[nslots-1].isize*slots[nslots-1].jsize;
+  }
+  values.assign(nelem, static_cast<_data_type>(0.0));
+  ok.assign(nslots, 0);
+  int nthr = gridpack::parallel::Threads::get();
+  gridpack::parallel::ThreadErrors errors;
+  GRIDPACK_PARALLEL_FOR(nthr)
+  for (i=0; i<nslots; i++) {
+    const PatternSlot &slot = slots[i];
+    _data_type *block = &values[slot.offset];
+    try {
+      if (slot.type == BUS_DIAG) {
+        ok[i] = p_network->getBus(slot.index)->matrixDiagValues(block);
+      } else if (slot.type == BRANCH_FORWARD) {
+        ok[i] = p_network->getBranch(slot.index)->matrixForwardValues(block);
+      } else {
+        ok[i] = p_network->getBranch(slot.index)->matrixReverseValues(block);
+      }
+    } catch (...) {
+      errors.save(std::current_exception());
+    }
+  }
+  errors.check();
+}
+
+/**
+ * Evaluate a list of blocks on threads and then add them to the matrix one
+ * at a time, in order, from a single thread
+ * @param matrix matrix to which contributions are added
+ * @param slots list of blocks
+ * @param flag add values if true, otherwise overwrite them
+ */
+template <typename _matrix_type, typename _data_type>
+void loadSlots(_matrix_type &matrix, const std::vector<PatternSlot> &slots,
+    bool flag)
+{
+  int i;
+  std::vector<_data_type> values;
+  std::vector<char> ok;
+  evaluateSlots(slots, values, ok);
+  std::vector<_data_type> block(p_maxIBlock*p_maxJBlock);
+  int nslots = slots.size();
+  for (i=0; i<nslots; i++) {
+    if (ok[i]) {
+      const PatternSlot &slot = slots[i];
+      loadBlock(matrix, slot.ioff, slot.joff, slot.isize, slot.jsize,
+          &values[slot.offset], block, flag);
+    }
+  }
+}
+
+/**
+ * Evaluate values of all blocks in the pattern and write them into the
+ * cached value array. Elements of blocks whose components do not return
+ * values are left at zero, which matches the result of zeroing the matrix
+ * and reloading it. Several blocks can contribute to the same element, so
+ * the blocks are evaluated into a separate buffer and copied into the
+ * cached array afterwards.
+ * @param values cached value array for the pattern
+ */
+template <typename _data_type>
+void loadPatternValues(std::vector<_data_type> &values)
+{
+  int i, k, ijsize;
+  int nslots = p_slots.size();
+  values.resize(p_nnz);
+  std::fill(values.begin(), values.end(), static_cast<_data_type>(0.0));
+  std::vector<_data_type> blocks;
+  std::vector<char> ok;
+  evaluateSlots(p_slots, blocks, ok);
+  for (i=0; i<nslots; i++) {
+    if (ok[i]) {
+      const PatternSlot &slot = p_slots[i];
+      ijsize = slot.isize*slot.jsize;
+      const int *map = &p_slotMap[slot.offset];
+      const _data_type *block = &blocks[slot.offset];
+      for (k=0; k<ijsize; k++) values[map[k]] = block[k];
+    }
+  }
+}
+
     // GA information
 int                         p_me;
 int                         p_nNodes;
@@ -1354,6 +1702,20 @@ int                         p_GAgrp;
     // pointer to timer
 gridpack::utility::CoarseTimer *p_timer;
 
+    // frozen sparsity pattern
+bool                        p_patternSet;
+int                         p_nnz;
+std::vector<PatternSlot>    p_slots;
+std::vector<int>            p_slotMap;
+std::vector<int>            p_patRows;
+std::vector<int>            p_patCols;
+std::vector<ComplexType>    p_patValues;
+std::vector<RealType>       p_patRealValues;
+
+    // row and column indices of block passed to matrix
+std::vector<int>            p_blockRows;
+std::vector<int>            p_blockCols;
+
 };
 
 } /* namespace mapper */
@@ -578,6 +578,25 @@ void setIndices(void)
   GA_Destroy(g_branch_offsets);
 }
 
+/**
+ * Add or set all columns of one row of the matrix with a single call
+ * @param matrix matrix to which contributions are added
+ * @param row index of row
+ * @param values values of all columns in row
+ * @param cols column indices 0 to p_nColumns-1
+ * @param flag flag to distinguish new matrix (true) from old (false)
+ */
+void loadRow(gridpack::math::Matrix &matrix, int row,
+    const ComplexType *values, std::vector<int> &cols, bool flag)
+{
+  if (p_nColumns <= 0) return;
+  if (flag) {
+    matrix.addElementBlock(1, &row, p_nColumns, &cols[0], values);
+  } else {
+    matrix.setElementBlock(1, &row, p_nColumns, &cols[0], values);
+  }
+}
+
 /**
  * Add contributions from buses to matrix
  * @param matrix matrix to which contributions are added
@@ -591,20 +610,14 @@ void loadBusData(gridpack::math::Matrix &matrix, bool flag)
     values.push_back(new ComplexType[p_nColumns]);
   }
   int *idx = new int[p_maxValues];
+  std::vector<int> cols(p_nColumns);
+  for (k=0; k<p_nColumns; k++) cols[k] = k;
   for (i=0; i<p_nBuses; i++) {
     if (p_network->getActiveBus(i)) {
       p_network->getBus(i)->slabSize(&ivals,&jvals);
       p_network->getBus(i)->slabGetValues(values, idx);
       for (j=0; j<ivals; j++) {
-        if (flag) {
-          for (k=0; k<p_nColumns; k++) {
-            matrix.addElement(idx[j],k,(values[j])[k]);
-          }
-        } else {
-          for (k=0; k<p_nColumns; k++) {
-            matrix.setElement(idx[j],k,(values[j])[k]);
-          }
-        }
+        loadRow(matrix, idx[j], values[j], cols, flag);
       }
     }
   }
@@ -627,21 +640,15 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
     values.push_back(new ComplexType[p_nColumns]);
   }
   int *idx = new int[p_maxValues];
+  std::vector<int> cols(p_nColumns);
+  for (k=0; k<p_nColumns; k++) cols[k] = k;
   for (i=0; i<p_nBranches; i++) {
     if (p_network->getActiveBranch(i)) {
       p_network->getBranch(i)->slabSize(&ivals,&jvals);
       p_network->getBranch(i)->slabGetValues(values,idx);
       for (j=0; j<ivals; j++) {
         if (idx[j] >= p_minIndex && idx[j] <= p_maxIndex) {
-          if (flag) {
-            for (k=0; k<p_nColumns; k++) {
-              matrix.addElement(idx[j],k,(values[j])[k]);
-            }
-          } else {
-            for (k=0; k<p_nColumns; k++) {
-              matrix.setElement(idx[j],k,(values[j])[k]);
-            }
-          }
+          loadRow(matrix, idx[j], values[j], cols, flag);
         }
       }
     }
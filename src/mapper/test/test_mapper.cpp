@@ -16,6 +16,7 @@
 #include "gridpack/mapper/bus_vector_map.hpp"
 #include "gridpack/mapper/gen_vector_map.hpp"
 #include "gridpack/mapper/gen_slab_map.hpp"
+#include "gridpack/parallel/threads.hpp"
 
 #define XDIM 100
 #define YDIM 100
@@ -699,6 +700,9 @@ void run (const int &me, const int &nprocs)
   gridpack::mapper::FullMatrixMap<TestNetwork> mMap(network); 
   boost::shared_ptr<gridpack::math::Matrix> M = mMap.mapToMatrix();
   mMap.mapToMatrix(M);
+  // Reset values using the frozen sparsity pattern. Matrix should be unchanged
+  mMap.refillMatrix(M);
+  mMap.refillMatrix(M);
   // Check to see if matrix has correct values
   int one = 1;
   int chk = 0;
@@ -766,6 +770,23 @@ void run (const int &me, const int &nprocs)
     }
   }
 
+  // Matrix built with threaded component loops should be identical to the
+  // serial one
+  gridpack::parallel::Threads::set(4);
+  boost::shared_ptr<gridpack::math::Matrix> tM = mMap.mapToMatrix();
+  mMap.refillMatrix(tM);
+  tM->scale(-1.0);
+  tM->add(*M);
+  double tdiff = tM->norm2();
+  gridpack::parallel::Threads::set(1);
+  if (me == 0) {
+    if (tdiff == 0.0) {
+      printf("\nThreaded matrix is ok\n");
+    } else {
+      printf("\nError found in threaded matrix: %e\n",tdiff);
+    }
+  }
+
   if (me == 0) {
     printf("\nTesting BusVectorMap\n");
   }
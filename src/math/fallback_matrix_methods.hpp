@@ -21,6 +21,8 @@
 #ifndef _fall_back_matrix_methods_hpp_
 #define _fall_back_matrix_methods_hpp_
 
+#include <vector>
+#include <algorithm>
 #include "gridpack/parallel/communicator.hpp"
 #include "matrix_interface.hpp"
 #include "complex_operators.hpp"
@@ -41,8 +43,13 @@ addDiagonal(BaseMatrixInterface<T, I>& A, const T& x)
 {
   I lo, hi;
   A.localRowRange(lo, hi);
-  for (I i = lo; i < hi; ++i) {
-    A.addElement(i, i, x);
+  if (hi > lo) {
+    std::vector<I> idx(hi - lo);
+    std::vector<T> vals(hi - lo, x);
+    for (I i = lo; i < hi; ++i) {
+      idx[i - lo] = i;
+    }
+    A.addElements(hi - lo, &idx[0], &idx[0], &vals[0]);
   }
   A.ready();
 }
@@ -58,11 +65,17 @@ norm2(const parallel::Communicator& comm, const BaseMatrixInterface<T, I>& A)
   A.localRowRange(lo, hi);
   struct l2_norm<T> accum;
 
-  T v;
-  for (I i = lo; i < hi; ++i) {
+  // get one row at a time
+  std::vector<I> rows(ncols), cols(ncols);
+  std::vector<T> v(ncols);
+  for (I j = 0; j < ncols; ++j) {
+    cols[j] = j;
+  }
+  for (I i = lo; i < hi && ncols > 0; ++i) {
+    std::fill(rows.begin(), rows.end(), i);
+    A.getElements(ncols, &rows[0], &cols[0], &v[0]);
     for (I j = 0; j < ncols; ++j) {
-      A.getElement(i, j, v);
-      accum(v);
+      accum(v[j]);
     }
   }
   double lresult(accum.result());
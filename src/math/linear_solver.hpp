@@ -136,6 +136,18 @@ protected:
     p_solver->tolerance(tol);
   }
 
+  /// Get the relative solution tolerance (specialized)
+  double p_relativeTolerance(void) const
+  {
+    return p_solver->relativeTolerance();
+  }
+
+  /// Set the relative solution tolerance (specialized)
+  void p_relativeTolerance(const double& tol)
+  {
+    p_solver->relativeTolerance(tol);
+  }
+
   /// Get the maximum iterations (specialized)
   /** 
    * 
@@ -160,6 +172,36 @@ protected:
     p_solver->maximumIterations(n);
   }
 
+  /// Get the factorization reuse mode (specialized)
+  LinearSolverReuse p_reuseMode(void) const
+  {
+    return p_solver->reuseMode();
+  }
+
+  /// Set the factorization reuse mode (specialized)
+  void p_reuseMode(const LinearSolverReuse& mode, const int& interval)
+  {
+    p_solver->reuseMode(mode, interval);
+  }
+
+  /// Force a new numeric factorization on the next solve (specialized)
+  void p_refactor(void)
+  {
+    p_solver->refactor();
+  }
+
+  /// Get the number of symbolic factorizations (specialized)
+  int p_symbolicFactorizations(void) const
+  {
+    return p_solver->symbolicFactorizations();
+  }
+
+  /// Get the number of numeric factorizations (specialized)
+  int p_numericFactorizations(void) const
+  {
+    return p_solver->numericFactorizations();
+  }
+
   /// Solve w/ the specified RHS, put result in specified vector
   /** 
    * @e Collective.
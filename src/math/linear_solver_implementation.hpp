@@ -59,12 +59,19 @@ public:
       utility::Uncopyable(),
       p_matrix(A),
       p_solutionTolerance(1.0e-06),
-      p_relativeTolerance(p_solutionTolerance),
+      p_relTolerance(p_solutionTolerance),
       p_maxIterations(100),
       p_doSerial(false),
       p_constSerialMatrix(),
       p_guessZero(false),
-      p_serialSolution()
+      p_serialSolution(),
+      p_reuse(ReuseNone),
+      p_reuseInterval(0),
+      p_forceRefactor(false),
+      p_tolerancesChanged(false),
+      p_symbolicCount(0),
+      p_numericCount(0),
+      p_reuseCount(0)
   {
   }
 
@@ -94,7 +101,7 @@ protected:
    * norm is @em reduced by the specified amount.
    * 
    */
-  double p_relativeTolerance;
+  double p_relTolerance;
 
   /// The maximum number of iterations to perform
   int p_maxIterations;
@@ -138,12 +145,105 @@ protected:
   /// A buffer to use for value transfer
   mutable std::vector<TheType> p_valueBuffer;
 
+  /// How much of a previous factorization can be reused
+  LinearSolverReuse p_reuse;
+
+  /// Number of solves a factorization is reused for (::ReuseFactorization)
+  int p_reuseInterval;
+
+  /// Force a numeric factorization on the next solve
+  mutable bool p_forceRefactor;
+
+  /// Tolerances were changed after the solver was built
+  mutable bool p_tolerancesChanged;
+
+  /// Number of symbolic factorizations done
+  mutable int p_symbolicCount;
+
+  /// Number of numeric factorizations done
+  mutable int p_numericCount;
+
+  /// Number of solves since the last numeric factorization
+  mutable int p_reuseCount;
+
+  /// Decide whether a new factorization is needed and update counters
+  /**
+   * Called by implementations before each solve with information
+   * about the coefficient matrix.
+   * 
+   * @param patternChanged true if the nonzero pattern of the coefficient
+   * matrix changed since the last factorization (or if there was no
+   * factorization)
+   * @param valuesChanged true if the values of the coefficient matrix
+   * changed since the last factorization
+   * 
+   * @return true if the matrix needs to be factored
+   */
+  bool p_needFactorization(const bool& patternChanged,
+                           const bool& valuesChanged) const
+  {
+    bool result(false);
+    if (patternChanged) {
+      p_symbolicCount++;
+      result = true;
+    } else if (p_forceRefactor) {
+      result = true;
+    } else if (valuesChanged) {
+      switch (p_reuse) {
+      case ReuseFactorization:
+        result = (p_reuseInterval > 0 && p_reuseCount >= p_reuseInterval);
+        break;
+      default:
+        result = true;
+        break;
+      }
+    }
+    if (result) {
+      p_numericCount++;
+      p_reuseCount = 0;
+    }
+    p_reuseCount++;
+    p_forceRefactor = false;
+    return result;
+  }
+
+  /// Get the factorization reuse mode (specialized)
+  LinearSolverReuse p_reuseMode(void) const
+  {
+    return p_reuse;
+  }
+
+  /// Set the factorization reuse mode (specialized)
+  void p_reuseMode(const LinearSolverReuse& mode, const int& interval)
+  {
+    p_reuse = mode;
+    p_reuseInterval = interval;
+  }
+
+  /// Force a new numeric factorization on the next solve (specialized)
+  void p_refactor(void)
+  {
+    p_forceRefactor = true;
+  }
+
+  /// Get the number of symbolic factorizations (specialized)
+  int p_symbolicFactorizations(void) const
+  {
+    return p_symbolicCount;
+  }
+
+  /// Get the number of numeric factorizations (specialized)
+  int p_numericFactorizations(void) const
+  {
+    return p_numericCount;
+  }
+
   /// Specialized way to configure from property tree
   void p_configure(utility::Configuration::CursorPtr props)
   {
     if (props) {
       p_solutionTolerance = props->get("SolutionTolerance", p_solutionTolerance);
-      p_relativeTolerance = props->get("RelativeTolerance", p_relativeTolerance);
+      p_relTolerance = props->get("RelativeTolerance", p_relTolerance);
       p_maxIterations = props->get("MaxIterations", p_maxIterations);
 
       p_doSerial = props->get("ForceSerial", p_doSerial);
@@ -153,6 +253,16 @@ protected:
       p_doSerial = (p_doSerial && (this->processor_size() > 1));
 
       p_guessZero = props->get("InitialGuessZero", p_guessZero);
+
+      std::string reuse(props->get("ReuseMode", std::string("")));
+      if (reuse == "None") {
+        p_reuse = ReuseNone;
+      } else if (reuse == "SameNonzeroPattern") {
+        p_reuse = SameNonzeroPattern;
+      } else if (reuse == "Factorization") {
+        p_reuse = ReuseFactorization;
+      }
+      p_reuseInterval = props->get("ReuseInterval", p_reuseInterval);
     }
   }
 
@@ -166,6 +276,20 @@ protected:
   void p_tolerance(const double& tol)
   {
     p_solutionTolerance = tol;
+    p_tolerancesChanged = true;
+  }
+
+  /// Get the relative solution tolerance (specialized)
+  double p_relativeTolerance(void) const
+  {
+    return p_relTolerance;
+  }
+
+  /// Set the relative solution tolerance (specialized)
+  void p_relativeTolerance(const double& tol)
+  {
+    p_relTolerance = tol;
+    p_tolerancesChanged = true;
   }
 
   /// Get the maximum iterations (specialized)
@@ -178,6 +302,7 @@ protected:
   void p_maximumIterations(const int& n)
   {
     p_maxIterations = n;
+    p_tolerancesChanged = true;
   }
 
   /// Solve the specified system w/ RHS and estimate (implementation)  
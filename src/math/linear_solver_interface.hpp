@@ -28,6 +28,26 @@ namespace gridpack {
 namespace math {
 
 
+// -------------------------------------------------------------
+//  enum LinearSolverReuse
+// -------------------------------------------------------------
+/// How much of a previous factorization a LinearSolver may reuse
+/**
+ * - ReuseNone: refactor numerically whenever the coefficient matrix
+ *   values change and symbolically whenever its nonzero pattern changes
+ * - SameNonzeroPattern: the nonzero pattern of the coefficient matrix
+ *   is fixed, so ordering and fill from the first symbolic factorization
+ *   are kept and only numeric factorizations are done
+ * - ReuseFactorization: keep the current factorization (or
+ *   preconditioner) for a number of solves, even if the matrix values
+ *   change, e.g. for a Y-matrix that is constant during a simulation
+ */
+enum LinearSolverReuse {
+  ReuseNone,
+  SameNonzeroPattern,
+  ReuseFactorization
+};
+
 // -------------------------------------------------------------
 //  class BaseLinearSolverInterface
 // -------------------------------------------------------------
@@ -71,6 +91,31 @@ public:
     this->p_tolerance(tol);
   }
 
+  /// Get the relative solution tolerance
+  /** 
+   * 
+   * 
+   * 
+   * @return current relative solution tolerance
+   */
+  double relativeTolerance(void) const
+  {
+    return this->p_relativeTolerance();
+  }
+
+  /// Set the relative solution tolerance
+  /** 
+   * This can be changed between solves, e.g. to use an inexact
+   * solution in the early iterations of a nonlinear solver. It has no
+   * effect on direct solvers.
+   * 
+   * @param tol new relative solution tolerance
+   */
+  void relativeTolerance(const double& tol)
+  {
+    this->p_relativeTolerance(tol);
+  }
+
   /// Get the maximum iterations
   /** 
    * 
@@ -95,6 +140,63 @@ public:
     this->p_maximumIterations(n);
   }
 
+  /// Get how much of a previous factorization is reused
+  /** 
+   * 
+   * 
+   * 
+   * @return current reuse mode
+   */
+  LinearSolverReuse reuseMode(void) const
+  {
+    return this->p_reuseMode();
+  }
+
+  /// Set how much of a previous factorization can be reused
+  /** 
+   * @e Collective.
+   * 
+   * @param mode reuse mode
+   * @param interval for ::ReuseFactorization, number of solves
+   * after which the factorization is recomputed; if 0 or less, the
+   * factorization is only recomputed if the nonzero pattern changes
+   * or refactor() is called
+   */
+  void reuseMode(const LinearSolverReuse& mode, const int& interval = 0)
+  {
+    this->p_reuseMode(mode, interval);
+  }
+
+  /// Force a new numeric factorization on the next solve
+  void refactor(void)
+  {
+    this->p_refactor();
+  }
+
+  /// Get the number of symbolic factorizations done so far
+  /** 
+   * For iterative solvers, this counts preconditioner setups with a
+   * new nonzero pattern.
+   * 
+   * @return number of symbolic factorizations
+   */
+  int symbolicFactorizations(void) const
+  {
+    return this->p_symbolicFactorizations();
+  }
+
+  /// Get the number of numeric factorizations done so far
+  /** 
+   * For iterative solvers, this counts preconditioner setups.  This
+   * includes the numeric part of symbolic factorizations.
+   * 
+   * @return number of numeric factorizations
+   */
+  int numericFactorizations(void) const
+  {
+    return this->p_numericFactorizations();
+  }
+
   /// Solve w/ the specified RHS, put result in specified vector
   /** 
    * @e Collective.
@@ -165,12 +267,33 @@ protected:
   /// Set the solver tolerance (specialized)
   virtual void p_tolerance(const double& tol) = 0;
 
+  /// Get the relative solution tolerance (specialized)
+  virtual double p_relativeTolerance(void) const = 0;
+
+  /// Set the relative solution tolerance (specialized)
+  virtual void p_relativeTolerance(const double& tol) = 0;
+
   /// Get the maximum iterations (specialized)
   virtual int p_maximumIterations(void) const = 0;
 
   /// Set the maximum solution iterations
   virtual void p_maximumIterations(const int& n) = 0;
 
+  /// Get the factorization reuse mode (specialized)
+  virtual LinearSolverReuse p_reuseMode(void) const = 0;
+
+  /// Set the factorization reuse mode (specialized)
+  virtual void p_reuseMode(const LinearSolverReuse& mode, const int& interval) = 0;
+
+  /// Force a new numeric factorization on the next solve (specialized)
+  virtual void p_refactor(void) = 0;
+
+  /// Get the number of symbolic factorizations (specialized)
+  virtual int p_symbolicFactorizations(void) const = 0;
+
+  /// Get the number of numeric factorizations (specialized)
+  virtual int p_numericFactorizations(void) const = 0;
+
   /// Solve w/ the specified RHS, put result in specified vector
   /** 
    * Can be called repeatedly with different @c b and @c x vectors
@@ -328,6 +328,22 @@ protected:
     p_matrix_impl->addElements(n, i, j, x); 
   }
 
+  /// Set a dense block of elements
+  void p_setElementBlock(const IdxType& nrow, const IdxType *rows,
+                         const IdxType& ncol, const IdxType *cols,
+                         const TheType *x)
+  {
+    p_matrix_impl->setElementBlock(nrow, rows, ncol, cols, x);
+  }
+
+  /// Add to a dense block of elements
+  void p_addElementBlock(const IdxType& nrow, const IdxType *rows,
+                         const IdxType& ncol, const IdxType *cols,
+                         const TheType *x)
+  {
+    p_matrix_impl->addElementBlock(nrow, rows, ncol, cols, x);
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   { 
@@ -25,6 +25,7 @@
 #ifndef _matrix_interface_hpp_
 #define _matrix_interface_hpp_
 
+#include <vector>
 #include "gridpack/math/implementation_visitable.hpp"
 
 namespace gridpack {
@@ -171,6 +172,47 @@ public:
     this->p_addElements(n, i, j, x);
   }
 
+  /// Set a dense block of elements
+  /** 
+   * @e Local.
+   *
+   * This overwrites the values at every combination of the specified
+   * rows and columns. The whole block is passed to the underlying
+   * library at once, which is much cheaper than setting the elements
+   * one at a time. ready() must be called after all setElementBlock()
+   * calls and before using the matrix.
+   * 
+   * @param nrow number of rows in block
+   * @param rows array of @c nrow global, 0-based row indexes
+   * @param ncol number of columns in block
+   * @param cols array of @c ncol global, 0-based column indexes
+   * @param x array of @c nrow*ncol values, stored by row
+   */
+  void setElementBlock(const IdxType& nrow, const IdxType *rows,
+                       const IdxType& ncol, const IdxType *cols,
+                       const TheType *x)
+  {
+    this->p_setElementBlock(nrow, rows, ncol, cols, x);
+  }
+
+  /// Add to a dense block of elements
+  /** 
+   * @e Local.
+   * 
+   * @param nrow number of rows in block
+   * @param rows array of @c nrow global, 0-based row indexes
+   * @param ncol number of columns in block
+   * @param cols array of @c ncol global, 0-based column indexes
+   * @param x array of @c nrow*ncol values, stored by row, to add to
+   * existing matrix elements
+   */
+  void addElementBlock(const IdxType& nrow, const IdxType *rows,
+                       const IdxType& ncol, const IdxType *cols,
+                       const TheType *x)
+  {
+    this->p_addElementBlock(nrow, rows, ncol, cols, x);
+  }
+
   /// Get an individual element
   /** 
    * @c Local.
@@ -409,6 +451,43 @@ protected:
   virtual void p_addElements(const IdxType& n, const IdxType *i, const IdxType *j, 
                              const TheType *x) = 0;
 
+  /// Set a dense block of elements (specialized)
+  virtual void p_setElementBlock(const IdxType& nrow, const IdxType *rows,
+                                 const IdxType& ncol, const IdxType *cols,
+                                 const TheType *x)
+  {
+    std::vector<IdxType> i, j;
+    p_blockIndexes(nrow, rows, ncol, cols, i, j);
+    if (!i.empty()) p_setElements(i.size(), &i[0], &j[0], x);
+  }
+
+  /// Add to a dense block of elements (specialized)
+  virtual void p_addElementBlock(const IdxType& nrow, const IdxType *rows,
+                                 const IdxType& ncol, const IdxType *cols,
+                                 const TheType *x)
+  {
+    std::vector<IdxType> i, j;
+    p_blockIndexes(nrow, rows, ncol, cols, i, j);
+    if (!i.empty()) p_addElements(i.size(), &i[0], &j[0], x);
+  }
+
+  /// Expand a dense block into coordinate (row, column) arrays
+  static void p_blockIndexes(const IdxType& nrow, const IdxType *rows,
+                             const IdxType& ncol, const IdxType *cols,
+                             std::vector<IdxType>& i, std::vector<IdxType>& j)
+  {
+    i.clear();
+    j.clear();
+    i.reserve(nrow*ncol);
+    j.reserve(nrow*ncol);
+    for (IdxType r = 0; r < nrow; ++r) {
+      for (IdxType c = 0; c < ncol; ++c) {
+        i.push_back(rows[r]);
+        j.push_back(cols[c]);
+      }
+    }
+  }
+
   /// Get an individual element (specialized)
   virtual void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const = 0;
 
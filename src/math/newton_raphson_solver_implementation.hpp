@@ -21,6 +21,8 @@
 #define _newton_raphson_solver_implementation_hpp_
 
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
 #include "nonlinear_solver_functions.hpp"
 #include "nonlinear_solver_implementation.hpp"
@@ -60,6 +62,23 @@ namespace math {
  * The interative process is ended when the L<sup>2</sup> \ref
  * Vector::norm2() "norm" of \f$ \Delta \mathbf{x}^{k} \f$ is less
  * then some specified small tolerance.
+ *
+ * Several inexact Newton strategies can be selected in the
+ * configuration:
+ *
+ *  - JacobianLag: the Jacobian (and its factorization) is only
+ *    recomputed every JacobianLag iterations (chord or Shamanskii
+ *    method). A lagged Jacobian is recomputed early if an iteration
+ *    reduces the function norm by less than JacobianLagRatio.
+ *  - LineSearch: if "Backtracking", the step is halved until the
+ *    function norm is sufficiently reduced (Armijo condition with
+ *    parameter LineSearchAlpha), at most LineSearchMaxSteps times.
+ *  - ForcingTerm: if "EisenstatWalker", the relative tolerance of the
+ *    linear solver is set each iteration from the reduction of the
+ *    function norm (choice 2 of Eisenstat and Walker, with
+ *    ForcingTermGamma, ForcingTermAlpha, ForcingTermInitial and
+ *    ForcingTermMaximum). This only affects iterative linear solvers.
+ *  - Verbose: if false, the norms are not printed each iteration.
  */
 template <typename T, typename I>
 class NewtonRaphsonSolverImplementation 
@@ -90,7 +109,12 @@ public:
                                     JacobianBuilder form_jacobian,
                                     FunctionBuilder form_function)
     : NonlinearSolverImplementation<T, I>(comm, local_size, form_jacobian, form_function),
-      p_linear_solver()
+      p_linear_solver(),
+      p_jacobianLag(1), p_lagRatio(0.5),
+      p_lineSearch(false), p_lineSearchAlpha(1.0e-04), p_lineSearchMaxSteps(8),
+      p_forcingEW(false), p_forcingInitial(0.5), p_forcingMax(0.9),
+      p_forcingGamma(0.9), p_forcingAlpha(0.5*(1.0 + std::sqrt(5.0))),
+      p_verbose(true)
   {
     this->configurationKey("NewtonRaphsonSolver");
   }
@@ -101,7 +125,12 @@ public:
                                     JacobianBuilder form_jacobian,
                                     FunctionBuilder form_function)
     : NonlinearSolverImplementation<T, I>(J, form_jacobian, form_function),
-      p_linear_solver()
+      p_linear_solver(),
+      p_jacobianLag(1), p_lagRatio(0.5),
+      p_lineSearch(false), p_lineSearchAlpha(1.0e-04), p_lineSearchMaxSteps(8),
+      p_forcingEW(false), p_forcingInitial(0.5), p_forcingMax(0.9),
+      p_forcingGamma(0.9), p_forcingAlpha(0.5*(1.0 + std::sqrt(5.0))),
+      p_verbose(true)
   {
     this->configurationKey("NewtonRaphsonSolver");
   }
@@ -132,35 +161,155 @@ protected:
   /// The linear solver
   boost::scoped_ptr< LinearSolverT<T, I> > p_linear_solver;
 
+  /// Number of iterations a Jacobian is used before it is recomputed
+  int p_jacobianLag;
+
+  /// Recompute a lagged Jacobian if the function norm is reduced by less than this
+  double p_lagRatio;
+
+  /// Use a backtracking line search
+  bool p_lineSearch;
+
+  /// Sufficient decrease parameter of the line search
+  double p_lineSearchAlpha;
+
+  /// Maximum number of step reductions in the line search
+  int p_lineSearchMaxSteps;
+
+  /// Use Eisenstat-Walker forcing terms as linear solver tolerance
+  bool p_forcingEW;
+
+  /// Forcing term used in the first iteration
+  double p_forcingInitial;
+
+  /// Largest allowed forcing term
+  double p_forcingMax;
+
+  /// Eisenstat-Walker gamma parameter
+  double p_forcingGamma;
+
+  /// Eisenstat-Walker alpha parameter
+  double p_forcingAlpha;
+
+  /// Print norms each iteration
+  bool p_verbose;
+
+  /// Specialized way to configure from property tree
+  void p_configure(utility::Configuration::CursorPtr props)
+  {
+    NonlinearSolverImplementation<T, I>::p_configure(props);
+    if (props) {
+      p_jacobianLag = props->get("JacobianLag", p_jacobianLag);
+      if (p_jacobianLag < 1) p_jacobianLag = 1;
+      p_lagRatio = props->get("JacobianLagRatio", p_lagRatio);
+
+      std::string search(props->get("LineSearch", std::string("")));
+      if (search == "None") {
+        p_lineSearch = false;
+      } else if (search == "Backtracking") {
+        p_lineSearch = true;
+      }
+      p_lineSearchAlpha = props->get("LineSearchAlpha", p_lineSearchAlpha);
+      p_lineSearchMaxSteps = props->get("LineSearchMaxSteps", p_lineSearchMaxSteps);
+
+      std::string forcing(props->get("ForcingTerm", std::string("")));
+      if (forcing == "Constant") {
+        p_forcingEW = false;
+      } else if (forcing == "EisenstatWalker") {
+        p_forcingEW = true;
+      }
+      p_forcingInitial = props->get("ForcingTermInitial", p_forcingInitial);
+      p_forcingMax = props->get("ForcingTermMaximum", p_forcingMax);
+      p_forcingGamma = props->get("ForcingTermGamma", p_forcingGamma);
+      p_forcingAlpha = props->get("ForcingTermAlpha", p_forcingAlpha);
+
+      p_verbose = props->get("Verbose", p_verbose);
+    }
+  }
+
   /// Solve w/ using the specified initial guess (specialized)
   void p_solve(VectorType& x)
   {
     NonlinearSolverImplementation<T, I>::p_solve(x);
     double stol(1.0e+30);
     double ftol(1.0e+30);
+    double ftol_old(0.0);
+    double eta(p_forcingInitial);
+    double lambda(1.0);
     int iter(0);
+    int age(0);
+    bool haveF(false);
 
     boost::scoped_ptr<VectorType> deltaX(this->p_X->clone());
+    boost::scoped_ptr<VectorType> Xtrial, Ftrial;
+    if (p_lineSearch) {
+      Xtrial.reset(this->p_X->clone());
+      Ftrial.reset(this->p_F->clone());
+    }
     while (stol > this->p_solutionTolerance && iter < this->p_maxIterations) {
-      this->p_function(*(this->p_X), *(this->p_F));
-      this->p_F->scale(-1.0);
-      this->p_jacobian(*(this->p_X), *(this->p_J));
+      // the line search already evaluated the function at the new estimate
+      if (!haveF) {
+        this->p_function(*(this->p_X), *(this->p_F));
+      }
+      ftol = this->p_F->norm2();
+
+      // recompute the Jacobian if it has been used for p_jacobianLag
+      // iterations or if the last iteration did not make enough progress
+      if (iter == 0 || age >= p_jacobianLag || ftol > p_lagRatio*ftol_old) {
+        this->p_jacobian(*(this->p_X), *(this->p_J));
+        age = 0;
+      }
       if (!p_linear_solver) {
         p_linear_solver.reset(new LinearSolverT<T, I>(*(this->p_J)));
         p_linear_solver->configure(this->p_configCursor);
       } 
+
+      if (p_forcingEW) {
+        if (iter > 0) {
+          double eta_new(p_forcingGamma*std::pow(ftol/ftol_old, p_forcingAlpha));
+          double eta_safe(p_forcingGamma*std::pow(eta, p_forcingAlpha));
+          if (eta_safe > 0.1) eta_new = std::max(eta_new, eta_safe);
+          eta = std::min(eta_new, p_forcingMax);
+        }
+        p_linear_solver->relativeTolerance(eta);
+      }
+
+      this->p_F->scale(-1.0);
       deltaX->zero();
       p_linear_solver->solve(*(this->p_F), *deltaX);
-      stol = deltaX->norm2();
-      ftol = this->p_F->norm2();
-      this->p_X->add(*deltaX);
+
+      lambda = 1.0;
+      if (p_lineSearch) {
+        int nstep(0);
+        double ftrial;
+        while (true) {
+          Xtrial->equate(*(this->p_X));
+          Xtrial->add(*deltaX, lambda);
+          this->p_function(*Xtrial, *Ftrial);
+          ftrial = Ftrial->norm2();
+          if (ftrial <= (1.0 - p_lineSearchAlpha*lambda)*ftol ||
+              nstep >= p_lineSearchMaxSteps) break;
+          lambda *= 0.5;
+          nstep += 1;
+        }
+        this->p_X->equate(*Xtrial);
+        this->p_F->equate(*Ftrial);
+        haveF = true;
+      } else {
+        this->p_X->add(*deltaX);
+      }
+      stol = lambda*deltaX->norm2();
+      ftol_old = ftol;
+      age += 1;
       iter += 1;
-      if (this->processor_rank() == 0) {
+      if (p_verbose && this->processor_rank() == 0) {
         std::cout << "Newton-Raphson "
                   << "iteration " << iter << ": "
                   << "solution residual norm = " << stol << ", "
-                  << "function norm = " << ftol
-                  << std::endl;
+                  << "function norm = " << ftol;
+        if (p_lineSearch) std::cout << ", step = " << lambda;
+        if (p_forcingEW) std::cout << ", forcing term = " << eta;
+        std::cout << std::endl;
       }
     }
   }
@@ -28,6 +28,7 @@
 #include "linear_matrix_solver_implementation.hpp"
 #include "petsc_configurable.hpp"
 #include "petsc_matrix_implementation.hpp"
+#include "petsc_misc.hpp"
 #include "petsc_matrix_extractor.hpp"
 #include "petsc_exception.hpp"
 
@@ -60,7 +61,8 @@ public:
       p_solverPackage(MATSOLVERPETSC),
 #endif    
       p_factorType(MAT_FACTOR_LU),
-      p_fill(5), p_pivot(false)
+      p_fill(5), p_pivot(false),
+      p_rhsBlockSize(0)
   {
     // FIXME: maybe enforce the following: A is square, A uses sparse storage
   }
@@ -120,6 +122,15 @@ protected:
   /// Flag to enable pivoting
   bool p_pivot;
 
+  /// Number of right hand side columns solved together (0 = all)
+  int p_rhsBlockSize;
+
+  /// Solve a panel of right hand sides with the factored matrix
+  static PetscErrorCode p_panelSolve(void *ctx, Mat B, Mat X)
+  {
+    return MatMatSolve(static_cast<Mat>(ctx), B, X);
+  }
+
   /// Do what is necessary to build this instance
   void p_build(const std::string& option_prefix)
   {
@@ -187,6 +198,7 @@ protected:
       }
       p_fill = props->get("Fill", p_fill);
       p_pivot = props->get("Pivot", p_pivot);
+      p_rhsBlockSize = props->get("RHSBlockSize", p_rhsBlockSize);
     }
 
     // FIXME: I cannot make this test work. Not sure why. It would be
@@ -251,15 +263,21 @@ protected:
     PetscErrorCode ierr(0);
     Mat X;
 
-    // FIXME: enforce B is dense, or copy and convert
-    const Mat *Bmat(PETScMatrix(B));
+    // The right hand side needs to be dense, so make a dense copy if
+    // necessary
+    boost::scoped_ptr<MatrixType> Bdense;
+    if (B.storageType() != Dense) {
+      Bdense.reset(storageType(B, Dense));
+    }
+    const Mat *Bmat(PETScMatrix(Bdense ? *Bdense : B));
 
     try {
       if (!p_factored) {
         p_factor();
       }
       ierr = MatDuplicate(*Bmat, MAT_DO_NOT_COPY_VALUES, &X); CHKERRXX(ierr);
-      ierr = MatMatSolve(p_Fmat, *Bmat, X); CHKERRXX(ierr);
+      ierr = denseBlockSolve(*Bmat, X, p_rhsBlockSize,
+                             &p_panelSolve, p_Fmat); CHKERRXX(ierr);
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
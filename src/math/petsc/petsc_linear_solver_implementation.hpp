@@ -28,6 +28,8 @@
 #include "petsc_configurable.hpp"
 #include "petsc/petsc_matrix_extractor.hpp"
 #include "petsc/petsc_vector_extractor.hpp"
+#include "petsc/petsc_matrix_implementation.hpp"
+#include "petsc/petsc_misc.hpp"
 
 namespace gridpack {
 namespace math {
@@ -50,7 +52,11 @@ public:
   PETScLinearSolverImplementation(MatrixType& A)
     : LinearSolverImplementation<T, I>(A),
       PETScConfigurable(this->communicator()),
-      p_matrixSet(false)
+      p_matrixSet(false),
+      p_lastMat(NULL),
+      p_lastState(0),
+      p_lastNonzeroState(0),
+      p_rhsBlockSize(0)
   {
     p_no_print = gridpack::NoPrint::instance()->status();
   }
@@ -79,6 +85,18 @@ protected:
   /// For constant matrices, has the coefficient matrix been set
   mutable bool p_matrixSet;
 
+  /// The coefficient matrix used for the last factorization
+  mutable Mat p_lastMat;
+
+  /// State of the coefficient matrix at the last factorization
+  mutable PetscObjectState p_lastState;
+
+  /// Nonzero state of the coefficient matrix at the last factorization
+  mutable PetscObjectState p_lastNonzeroState;
+
+  /// Number of right hand side columns solved together (0 = all)
+  int p_rhsBlockSize;
+
   // Turn off printing
   bool p_no_print;
 
@@ -100,19 +118,20 @@ protected:
       ierr = KSPSetOptionsPrefix(p_KSP, option_prefix.c_str()); CHKERRXX(ierr);
 
       ierr = KSPSetTolerances(p_KSP, 
-                              LinearSolverImplementation<T, I>::p_relativeTolerance, 
+                              LinearSolverImplementation<T, I>::p_relTolerance, 
                               LinearSolverImplementation<T, I>::p_solutionTolerance, 
                               PETSC_DEFAULT,
                               LinearSolverImplementation<T, I>::p_maxIterations); CHKERRXX(ierr);
 
       ierr = KSPSetFromOptions(p_KSP);CHKERRXX(ierr);
+      this->p_tolerancesChanged = false;
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
   }  
 
-  /// Solve w/ the specified RHS and estimate (result in x)
-  void p_solveImpl(MatrixType& A, const VectorType& b, VectorType& x) const
+  /// Set the coefficient matrix and decide if it needs to be factored
+  void p_setOperators(MatrixType& A) const
   {
     PetscErrorCode ierr(0);
     try {
@@ -125,15 +144,149 @@ protected:
         p_matrixSet = true;
       }
 
-      this->p_resolveImpl(b, x);
-          
+      // Find out if the matrix changed since it was last factored and
+      // tell PETSc whether the current preconditioner can be kept
+      PetscObjectState state, nzstate;
+      ierr = PetscObjectStateGet((PetscObject)(*Amat), &state); CHKERRXX(ierr);
+      ierr = MatGetNonzeroState(*Amat, &nzstate); CHKERRXX(ierr);
+      bool patternChanged(p_lastMat != *Amat || nzstate != p_lastNonzeroState ||
+                          this->p_numericCount == 0);
+      bool valuesChanged(state != p_lastState);
+      bool factor(this->p_needFactorization(patternChanged, valuesChanged));
+      if (factor && !patternChanged && !valuesChanged) {
+        // refactor() was called: PETSc skips the preconditioner setup if
+        // the matrix state is unchanged, so mark the matrix as modified
+        ierr = PetscObjectStateIncrease((PetscObject)(*Amat)); CHKERRXX(ierr);
+        ierr = PetscObjectStateGet((PetscObject)(*Amat), &state); CHKERRXX(ierr);
+      }
+      if (patternChanged && this->p_reuse == SameNonzeroPattern) {
+        PC pc;
+        ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+        ierr = PCFactorSetReuseOrdering(pc, PETSC_TRUE); CHKERRXX(ierr);
+        ierr = PCFactorSetReuseFill(pc, PETSC_TRUE); CHKERRXX(ierr);
+      }
+      ierr = KSPSetReusePreconditioner(p_KSP, (factor ? PETSC_FALSE : PETSC_TRUE));
+      CHKERRXX(ierr);
+      if (factor) {
+        p_lastMat = *Amat;
+        p_lastState = state;
+        p_lastNonzeroState = nzstate;
+      }
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
-    } catch (const Exception& e) {
-      throw e;
     }
   }
 
+  /// Hand tolerances to the KSP if they changed since the solver was built
+  void p_applyTolerances(void) const
+  {
+    PetscErrorCode ierr(0);
+    if (this->p_tolerancesChanged) {
+      ierr = KSPSetTolerances(p_KSP, 
+                              LinearSolverImplementation<T, I>::p_relTolerance, 
+                              LinearSolverImplementation<T, I>::p_solutionTolerance, 
+                              PETSC_DEFAULT,
+                              LinearSolverImplementation<T, I>::p_maxIterations); CHKERRXX(ierr);
+      this->p_tolerancesChanged = false;
+    }
+  }
+
+  /// Solve w/ the specified RHS and estimate (result in x)
+  void p_solveImpl(MatrixType& A, const VectorType& b, VectorType& x) const
+  {
+    this->p_setOperators(A);
+    this->p_resolveImpl(b, x);
+  }
+
+  /// KSP and convergence information of a multiple RHS solve
+  struct PanelContext {
+    KSP ksp;
+    KSPConvergedReason reason;
+    PetscInt its;
+  };
+
+  /// Solve a panel of right hand sides with the KSP
+  /**
+   * The first diverged panel is recorded in the context so that the
+   * caller can report it after the solve.
+   */
+  static PetscErrorCode p_panelSolve(void *ctx, Mat B, Mat X)
+  {
+    PetscErrorCode ierr(0);
+    PanelContext *pctx(static_cast<PanelContext *>(ctx));
+    KSPConvergedReason reason;
+    ierr = KSPMatSolve(pctx->ksp, B, X); CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(pctx->ksp, &reason); CHKERRQ(ierr);
+    if (reason < 0 && pctx->reason >= 0) {
+      pctx->reason = reason;
+      ierr = KSPGetIterationNumber(pctx->ksp, &(pctx->its)); CHKERRQ(ierr);
+    }
+    return ierr;
+  }
+
+  /// Solve multiple systems w/ each column of the Matrix a single RHS (specialized)
+  /**
+   * All columns of @c B are solved together, in panels of
+   * ::p_rhsBlockSize columns, using the same operator and
+   * preconditioner. Serial solves in a parallel environment fall back
+   * to solving one column at a time.
+   */
+  MatrixType *p_solve(const MatrixType& B) const
+  {
+    if (this->p_doSerial) {
+      return LinearSolverImplementation<T, I>::p_solve(B);
+    }
+
+    PetscErrorCode ierr(0);
+    Mat X;
+
+    // The right hand side needs to be dense, so make a dense copy if
+    // necessary
+    boost::scoped_ptr<MatrixType> Bdense;
+    if (B.storageType() != Dense) {
+      Bdense.reset(storageType(B, Dense));
+    }
+    const Mat *Bmat(PETScMatrix(Bdense ? *Bdense : B));
+
+    this->p_setOperators(this->p_matrix);
+    PanelContext pctx;
+    pctx.ksp = p_KSP;
+    pctx.reason = KSP_CONVERGED_ITERATING;
+    pctx.its = 0;
+    try {
+      p_applyTolerances();
+      ierr = MatDuplicate(*Bmat, MAT_DO_NOT_COPY_VALUES, &X); CHKERRXX(ierr);
+      ierr = denseBlockSolve(*Bmat, X, p_rhsBlockSize,
+                             &p_panelSolve, &pctx); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+
+    if (pctx.reason < 0) {
+      try {
+        ierr = MatDestroy(&X); CHKERRXX(ierr);
+      } catch (const PETSC_EXCEPTION_TYPE& e) {
+        throw PETScException(ierr, e);
+      }
+      std::string msg = 
+        boost::str(boost::format("%d: PETSc KSP diverged after %d iterations"
+                                 " in multiple RHS solve, reason: %d") % 
+                   this->processor_rank() % pctx.its % pctx.reason);
+      throw Exception(msg);
+    }
+
+    PETScMatrixImplementation<T, I> *ximpl = 
+      new PETScMatrixImplementation<T, I>(X, true);
+    MatrixT<T, I> *result = new MatrixT<T, I>(ximpl);
+
+    try {
+      ierr = MatDestroy(&X); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return result;
+  }
+
   /// Solve again w/ the specified RHS, put result in specified vector (specialized)
   void p_resolveImpl(const VectorType& b, VectorType& x) const
   {
@@ -143,6 +296,7 @@ protected:
       const Vec *bvec(PETScVector(b));
       Vec *xvec(PETScVector(x));
 
+      p_applyTolerances();
       ierr = KSPSolve(p_KSP, *bvec, *xvec); CHKERRXX(ierr);
       int its;
       KSPConvergedReason reason;
@@ -176,6 +330,9 @@ protected:
   void p_configure(utility::Configuration::CursorPtr props)
   {
     LinearSolverImplementation<T, I>::p_configure(props);
+    if (props) {
+      p_rhsBlockSize = props->get("RHSBlockSize", p_rhsBlockSize);
+    }
     this->build(props);
   }
 
@@ -21,6 +21,8 @@
 #define _petsc_matrix_implementation_h_
 
 #include <petscmat.h>
+#include <vector>
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
 #include <boost/format.hpp>
 #include "petsc_exception.hpp"
@@ -362,13 +364,66 @@ protected:
     p_setElement(i, j, x, INSERT_VALUES);
   }
 
+  /// Set or add to several elements
+  /**
+   * All values are converted in one pass. Runs of consecutive elements
+   * in the same row are passed to PETSc with a single MatSetValues()
+   * call, so coordinate arrays ordered by row need one call per row
+   * instead of one per element.
+   */
+  void p_setElements(const IdxType& n, const IdxType *i, const IdxType *j,
+                     const TheType *x, InsertMode mode)
+  {
+    if (n <= 0) return;
+    PetscErrorCode ierr(0);
+    try {
+      Mat *mat = p_mwrap->getMatrix();
+      MatrixValueTransferToLibrary<TheType, PetscScalar> 
+        trans(n, const_cast<TheType *>(x));
+      trans.go();
+      const PetscScalar *px(trans.to());
+      const int es(elementSize);
+      PetscInt iidx[elementSize];
+      std::vector<PetscInt> jidx;
+      std::vector<PetscScalar> vals;
+      IdxType k(0);
+      while (k < n) {
+        IdxType kend(k+1);
+        while (kend < n && i[kend] == i[k]) ++kend;
+        PetscInt m(kend - k);
+        for (int ii = 0; ii < es; ++ii) {
+          iidx[ii] = i[k]*es + ii;
+        }
+        jidx.resize(m*es);
+        if (es == 1) {
+          std::copy(j + k, j + kend, jidx.begin());
+          ierr = MatSetValues(*mat, 1, &iidx[0], m, &jidx[0], px + k, mode);
+          CHKERRXX(ierr);
+        } else {
+          // each element is an es x es block; arrange them as es rows
+          vals.resize(es*m*es);
+          for (PetscInt l = 0; l < m; ++l) {
+            for (int jj = 0; jj < es; ++jj) {
+              jidx[l*es + jj] = j[k + l]*es + jj;
+              for (int ii = 0; ii < es; ++ii) {
+                vals[ii*m*es + l*es + jj] = px[(k + l)*es*es + ii*es + jj];
+              }
+            }
+          }
+          ierr = MatSetValues(*mat, es, &iidx[0], m*es, &jidx[0], &vals[0], mode);
+          CHKERRXX(ierr);
+        }
+        k = kend;
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
   /// Set an several element
   void p_setElements(const IdxType& n, const IdxType *i, const IdxType *j, const TheType *x)
   {
-    // FIXME: There's probably a better way
-    for (IdxType k = 0; k < n; k++) {
-      this->p_setElement(i[k], j[k], x[k]);
-    }
+    p_setElements(n, i, j, x, INSERT_VALUES);
   }
 
   /// Add to  an individual element
@@ -380,12 +435,74 @@ protected:
   /// Add to  an several element
   void p_addElements(const IdxType& n, const IdxType *i, const IdxType *j, const TheType *x)
   {
-    // FIXME: There's probably a better way
-    for (IdxType k = 0; k < n; k++) {
-      this->p_addElement(i[k], j[k], x[k]);
+    p_setElements(n, i, j, x, ADD_VALUES);
+  }
+
+  /// Set or add to a dense block of elements with one MatSetValues() call
+  void p_setElementBlock(const IdxType& nrow, const IdxType *rows,
+                         const IdxType& ncol, const IdxType *cols,
+                         const TheType *x, InsertMode mode)
+  {
+    if (nrow <= 0 || ncol <= 0) return;
+    PetscErrorCode ierr(0);
+    try {
+      Mat *mat = p_mwrap->getMatrix();
+      MatrixValueTransferToLibrary<TheType, PetscScalar> 
+        trans(nrow*ncol, const_cast<TheType *>(x));
+      trans.go();
+      const PetscScalar *px(trans.to());
+      const int es(elementSize);
+      std::vector<PetscInt> iidx(nrow*es), jidx(ncol*es);
+      for (IdxType r = 0; r < nrow; ++r) {
+        for (int ii = 0; ii < es; ++ii) {
+          iidx[r*es + ii] = rows[r]*es + ii;
+        }
+      }
+      for (IdxType c = 0; c < ncol; ++c) {
+        for (int jj = 0; jj < es; ++jj) {
+          jidx[c*es + jj] = cols[c]*es + jj;
+        }
+      }
+      if (es == 1) {
+        ierr = MatSetValues(*mat, nrow, &iidx[0], ncol, &jidx[0], px, mode);
+        CHKERRXX(ierr);
+      } else {
+        std::vector<PetscScalar> vals(nrow*es*ncol*es);
+        const int ld(ncol*es);
+        for (IdxType r = 0; r < nrow; ++r) {
+          for (IdxType c = 0; c < ncol; ++c) {
+            const PetscScalar *b(px + (r*ncol + c)*es*es);
+            for (int ii = 0; ii < es; ++ii) {
+              for (int jj = 0; jj < es; ++jj) {
+                vals[(r*es + ii)*ld + c*es + jj] = b[ii*es + jj];
+              }
+            }
+          }
+        }
+        ierr = MatSetValues(*mat, nrow*es, &iidx[0], ncol*es, &jidx[0], &vals[0], mode);
+        CHKERRXX(ierr);
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
     }
   }
 
+  /// Set a dense block of elements (specialized)
+  void p_setElementBlock(const IdxType& nrow, const IdxType *rows,
+                         const IdxType& ncol, const IdxType *cols,
+                         const TheType *x)
+  {
+    p_setElementBlock(nrow, rows, ncol, cols, x, INSERT_VALUES);
+  }
+
+  /// Add to a dense block of elements (specialized)
+  void p_addElementBlock(const IdxType& nrow, const IdxType *rows,
+                         const IdxType& ncol, const IdxType *cols,
+                         const TheType *x)
+  {
+    p_setElementBlock(nrow, rows, ncol, cols, x, ADD_VALUES);
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   {
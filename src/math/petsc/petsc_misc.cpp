@@ -71,3 +71,60 @@ sillyMatScaleComplex(Mat A, const gridpack::ComplexType& px)
 
 
 
+
+/// Solve a DENSE block of right hand sides in column panels
+/** 
+ * The right hand side matrix @c B is split into panels of @c panel
+ * contiguous columns. Because dense matrices are stored column major,
+ * each panel is a contiguous piece of the local array and is wrapped
+ * in a dense matrix without copying. The solution for each panel is
+ * written directly into the corresponding columns of @c X.  If @c
+ * panel is not positive or the local arrays are padded, the whole
+ * block is solved at once.
+ * 
+ * @param B dense right hand side matrix
+ * @param X dense solution matrix, same layout as @c B
+ * @param panel number of columns solved together
+ * @param solve function that solves for a block of right hand sides
+ * @param ctx context passed to @c solve
+ * 
+ * @return PETSc error code
+ */
+PetscErrorCode
+denseBlockSolve(Mat B, Mat X, PetscInt panel,
+                PetscErrorCode (*solve)(void *ctx, Mat B, Mat X), void *ctx)
+{
+  PetscErrorCode ierr(0);
+  PetscInt m, n, M, N, ldb, ldx;
+
+  ierr = MatGetLocalSize(B, &m, &n); CHKERRQ(ierr);
+  ierr = MatGetSize(B, &M, &N); CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B, &ldb); CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X, &ldx); CHKERRQ(ierr);
+
+  if (panel <= 0 || panel >= N || ldb != m || ldx != m) {
+    ierr = (*solve)(ctx, B, X); CHKERRQ(ierr);
+    return ierr;
+  }
+
+  MPI_Comm comm;
+  const PetscScalar *barray;
+  PetscScalar *xarray;
+  ierr = PetscObjectGetComm((PetscObject)B, &comm); CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(B, &barray); CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X, &xarray); CHKERRQ(ierr);
+  for (PetscInt c = 0; c < N; c += panel) {
+    PetscInt nc(std::min(panel, N - c));
+    Mat Bp, Xp;
+    ierr = MatCreateDense(comm, m, PETSC_DECIDE, M, nc,
+                          const_cast<PetscScalar *>(barray) + c*m, &Bp); CHKERRQ(ierr);
+    ierr = MatCreateDense(comm, m, PETSC_DECIDE, M, nc,
+                          xarray + c*m, &Xp); CHKERRQ(ierr);
+    ierr = (*solve)(ctx, Bp, Xp); CHKERRQ(ierr);
+    ierr = MatDestroy(&Bp); CHKERRQ(ierr);
+    ierr = MatDestroy(&Xp); CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArray(X, &xarray); CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(B, &barray); CHKERRQ(ierr);
+  return ierr;
+}
@@ -25,6 +25,7 @@
 #define _petsc_misc_hpp_
 
 #include <petscsys.h>
+#include <petscmat.h>
 #include <vector>
 #include <algorithm>
 #include "gridpack/utilities/complex.hpp"
@@ -32,6 +33,11 @@
 /// Scale a complex DENSE matrix
 extern PetscErrorCode sillyMatScaleComplex(Mat A, const gridpack::ComplexType& px);
 
+/// Solve a DENSE block of right hand sides in column panels
+extern PetscErrorCode
+denseBlockSolve(Mat B, Mat X, PetscInt panel,
+                PetscErrorCode (*solve)(void *ctx, Mat B, Mat X), void *ctx);
+
 // -------------------------------------------------------------
 // sortPermutation
 // 
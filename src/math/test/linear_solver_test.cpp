@@ -218,6 +218,174 @@ BOOST_AUTO_TEST_CASE( Versteeg )
   }
 }
 
+// -------------------------------------------------------------
+// Check factorization counts with different reuse modes
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( VersteegReuse )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  boost::scoped_ptr<gridpack::math::RealMatrix>
+    A(new gridpack::math::RealMatrix(world, local_size, local_size,
+                                     gridpack::math::Sparse));
+  boost::scoped_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size)),
+    x(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  boost::scoped_ptr<gridpack::math::RealLinearSolver>
+    solver(new gridpack::math::RealLinearSolver(*A));
+
+  BOOST_REQUIRE(test_config);
+  solver->configure(test_config);
+  BOOST_CHECK_EQUAL(solver->reuseMode(), gridpack::math::ReuseNone);
+
+  // first solve needs a complete factorization
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->symbolicFactorizations(), 1);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 1);
+
+  // matrix did not change, so nothing is factored
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->symbolicFactorizations(), 1);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 1);
+
+  // values changed, pattern did not
+  solver->reuseMode(gridpack::math::SameNonzeroPattern);
+  A->scale(2.0);
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->symbolicFactorizations(), 1);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 2);
+
+  // keep the factorization for two solves even though values change
+  solver->reuseMode(gridpack::math::ReuseFactorization, 2);
+  A->scale(0.5);
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 2);
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 3);
+
+  // a forced refactor is done even if the values did not change
+  solver->refactor();
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->symbolicFactorizations(), 1);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 4);
+
+  // and is only done once
+  x->zero();
+  solver->solve(*b, *x);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 4);
+}
+
+// -------------------------------------------------------------
+// Solve for a block of right hand sides with LinearSolver
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( VersteegBlockSolve )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  boost::scoped_ptr<gridpack::math::RealMatrix>
+    A(new gridpack::math::RealMatrix(world, local_size, local_size,
+                                     gridpack::math::Sparse)),
+    I(new gridpack::math::RealMatrix(world, local_size, local_size,
+                                     gridpack::math::Dense));
+  I->identity();
+
+  boost::scoped_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  boost::scoped_ptr<gridpack::math::RealLinearSolver>
+    solver(new gridpack::math::RealLinearSolver(*A));
+
+  BOOST_REQUIRE(test_config);
+  solver->configure(test_config);
+
+  // the inverse is found by solving all columns of I together
+  boost::scoped_ptr<gridpack::math::RealMatrix>
+    Ainv(solver->solve(*I));
+  boost::scoped_ptr<gridpack::math::RealVector>
+    x(multiply(*Ainv, *b));
+  boost::scoped_ptr<gridpack::math::RealVector>
+    res(multiply(*A, *x));
+  res->add(*b, -1.0);
+
+  double l1norm(res->norm1());
+  double l2norm(res->norm2());
+
+  if (world.rank() == 0) {
+    std::cout << "Residual L1 Norm = " << l1norm << std::endl;
+    std::cout << "Residual L2 Norm = " << l2norm << std::endl;
+  }
+
+  BOOST_CHECK(l1norm < 1.0e-05);
+  BOOST_CHECK(l2norm < 1.0e-05);
+  BOOST_CHECK_EQUAL(solver->numericFactorizations(), 1);
+}
+
+// -------------------------------------------------------------
+// A diverged block solve has to be reported
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( VersteegBlockSolveDiverged )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  boost::scoped_ptr<gridpack::math::RealMatrix>
+    A(new gridpack::math::RealMatrix(world, local_size, local_size,
+                                     gridpack::math::Sparse)),
+    I(new gridpack::math::RealMatrix(world, local_size, local_size,
+                                     gridpack::math::Dense));
+  I->identity();
+
+  boost::scoped_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  boost::scoped_ptr<gridpack::math::RealLinearSolver>
+    solver(new gridpack::math::RealLinearSolver(*A));
+
+  BOOST_REQUIRE(test_config);
+  solver->configure(test_config);
+
+  // one iteration cannot reach these tolerances
+  solver->maximumIterations(1);
+  solver->tolerance(1.0e-30);
+  solver->relativeTolerance(1.0e-30);
+
+  boost::scoped_ptr<gridpack::math::RealMatrix> Ainv;
+  BOOST_CHECK_THROW(Ainv.reset(solver->solve(*I)), gridpack::Exception);
+}
+
 // FIXME
 BOOST_AUTO_TEST_CASE ( VersteegInverse )
 {
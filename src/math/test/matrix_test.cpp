@@ -329,6 +329,65 @@ BOOST_AUTO_TEST_CASE( multiple_set_and_get )
   }
 }
 
+BOOST_AUTO_TEST_CASE( block_set_and_add )
+{
+  gridpack::parallel::Communicator world;
+  int global_size;
+  boost::mpi::all_reduce(world, local_size, global_size, std::plus<int>());
+
+  TestMatrixType 
+    A(world, local_size, global_size, the_storage_type);
+
+  int lo, hi;
+  A.localRowRange(lo, hi);
+
+  // set each row of a tridiagonal matrix as a 1 x n block
+  for (int i = lo; i < hi; ++i) {
+    std::vector<int> jidx;
+    for (int j = std::max(i-1, 0); j <= std::min(i+1, global_size-1); ++j) {
+      jidx.push_back(j);
+    }
+    int n(jidx.size());
+    std::vector<TestType> x(n, static_cast<double>(i));
+    A.setElementBlock(1, &i, n, &jidx[0], &x[0]);
+  }
+  A.ready();
+
+  // add to the diagonal using coordinate arrays that are not sorted by
+  // row and contain duplicates, and then as 1 x 1 blocks
+  std::vector<int> iidx, jidx;
+  for (int i = lo; i < hi; ++i) {
+    iidx.push_back(i);
+    jidx.push_back(i);
+  }
+  for (int i = lo; i < hi; ++i) {
+    iidx.push_back(i);
+    jidx.push_back(i);
+  }
+  std::vector<TestType> one(iidx.size(), TestType(1.0));
+  if (!iidx.empty()) {
+    A.addElements(iidx.size(), &iidx[0], &jidx[0], &one[0]);
+  }
+  for (int i = lo; i < hi; ++i) {
+    A.addElementBlock(1, &i, 1, &i, &one[0]);
+  }
+  A.ready();
+
+  for (int i = lo; i < hi; ++i) {
+    TestType y;
+    A.getElement(i, i, y);
+    TEST_VALUE_CLOSE(TestType(static_cast<double>(i) + 3.0), y, delta);
+    if (i > 0) {
+      A.getElement(i, i-1, y);
+      TEST_VALUE_CLOSE(TestType(static_cast<double>(i)), y, delta);
+    }
+    if (i < global_size - 1) {
+      A.getElement(i, i+1, y);
+      TEST_VALUE_CLOSE(TestType(static_cast<double>(i)), y, delta);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( accumulate )
 {
   gridpack::parallel::Communicator world;
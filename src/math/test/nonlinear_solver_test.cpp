@@ -246,6 +246,41 @@ BOOST_AUTO_TEST_CASE( tiny_nr_serial_2 )
   TEST_VALUE_CLOSE(y, static_cast<TestType>(2.0), 1.0e-04);
 }
 
+BOOST_AUTO_TEST_CASE( tiny_nr_serial_2_inexact )
+{
+  gridpack::parallel::Communicator world;
+  gridpack::parallel::Communicator self = world.split(world.rank());
+
+  TheNewtonRaphsonSolver::JacobianBuilder j = &build_tiny_jacobian_2;
+  TheNewtonRaphsonSolver::FunctionBuilder f = &build_tiny_function_2;
+
+  TheNewtonRaphsonSolver solver(self, 2, j, f);
+
+  // lagged Jacobian, line search, and Eisenstat-Walker forcing terms
+  BOOST_REQUIRE(test_config);
+  solver.configurationKey("InexactNewtonSolver");
+  solver.configure(test_config);
+
+  BOOST_CHECK_CLOSE(solver.tolerance(), 1.0e-10, 1.0e-04);
+  BOOST_CHECK_EQUAL(solver.maximumIterations(), 100);
+
+  VectorType X(self, 2);
+  X.setElement(0, 2.00);
+  X.setElement(1, 3.00);
+  X.ready();
+  solver.solve(X);
+
+  BOOST_TEST_MESSAGE("tiny_nr_serial_2_inexact results:");
+  X.print();
+
+  TestType x, y;
+  X.getElement(0, x);
+  X.getElement(1, y);
+
+  TEST_VALUE_CLOSE(x, static_cast<TestType>(1.0), 1.0e-04);
+  TEST_VALUE_CLOSE(y, static_cast<TestType>(2.0), 1.0e-04);
+}
+
 // -------------------------------------------------------------
 // A larger test.  This is example 2 from the PETSc SNES examples
 // -------------------------------------------------------------
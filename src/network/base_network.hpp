@@ -22,6 +22,14 @@
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <deque>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <boost/serialization/singleton.hpp>
 #include <boost/serialization/extended_type_info.hpp>
@@ -35,6 +43,7 @@
 #include "gridpack/partition/graph_partitioner.hpp"
 #include "gridpack/parallel/shuffler.hpp"
 #include "gridpack/parallel/ga_shuffler.hpp"
+#include "gridpack/parallel/ghost_exchange.hpp"
 #include "gridpack/timer/coarse_timer.hpp"
 #include "gridpack/utilities/exception.hpp"
 #include "gridpack/environment/environment.hpp"
@@ -43,6 +52,26 @@
 namespace gridpack {
 namespace network {
 /** @cond */
+// -------------------------------------------------------------
+// Header of a binary network snapshot file. Snapshots are written
+// as a raw image, so they can only be read back on a machine with
+// the same architecture and by the same number of processes.
+// -------------------------------------------------------------
+#define GRIDPACK_SNAPSHOT_MAGIC "GPNETSNP"
+#define GRIDPACK_SNAPSHOT_VERSION 1
+
+struct SnapshotHeader {
+  char magic[8];       // GRIDPACK_SNAPSHOT_MAGIC
+  int version;         // GRIDPACK_SNAPSHOT_VERSION
+  int nprocs;          // number of processes that wrote snapshot
+  int rank;            // rank of process that wrote this file
+  int nbus;            // number of local buses (including ghosts)
+  int nbranch;         // number of local branches (including ghosts)
+  int nkeys;           // number of entries in data element name table
+  long long stamp;     // user supplied stamp (e.g. source file time)
+  long long size;      // total size of file in bytes
+};
+
 // -------------------------------------------------------------
 // A simple data class to assemble all bus related elements in
 // the network into a single struct.
@@ -246,7 +275,195 @@ private:
   }
 
 };
+
+// -------------------------------------------------------------
+// A bus or branch component together with the global index of its
+// bus or branch. Used to move the state of components to the process
+// that a bus or branch is moved to when the network is repartitioned.
+// Components are written with their own serialization.
+// -------------------------------------------------------------
+template <class _component>
+class ComponentState {
+public:
+
+  int p_globalIndex;
+  boost::shared_ptr<_component> p_component;
+
+private:
+
+  friend class boost::serialization::access;
+
+  /// Serialization method
+  template<class Archive> void serialize(Archive &ar, const unsigned int)
+  {
+    ar & p_globalIndex
+      & p_component;
+  }
+};
+
+/**
+ * Write the table of data element names to a shuffle buffer. Data
+ * collections are packed using the IDs interned on the sending process
+ * so the receiver needs the names to map them to its own IDs
+ * @param buf buffer
+ */
+inline void shuffleAppendKeys(std::vector<char> &buf)
+{
+  int nkeys = gridpack::component::DataKey::numKeys();
+  parallel::shuffleAppend(buf, &nkeys, 1);
+  for (int i=0; i<nkeys; i++) {
+    const std::string &name = gridpack::component::DataKey::name(i);
+    int len = name.size();
+    parallel::shuffleAppend(buf, &len, 1);
+    parallel::shuffleAppend(buf, name.c_str(), len);
+  }
+}
+
+/**
+ * Read the table of data element names from a shuffle buffer
+ * @param ptr current position in buffer
+ * @param idMap map from sender IDs to local IDs
+ */
+inline void shuffleReadKeys(const char *&ptr, std::vector<int> &idMap)
+{
+  int nkeys, len;
+  parallel::shuffleRead(ptr, &nkeys, 1);
+  idMap.resize(nkeys);
+  for (int i=0; i<nkeys; i++) {
+    parallel::shuffleRead(ptr, &len, 1);
+    idMap[i] = gridpack::component::DataKey(std::string(ptr,len)).id();
+    ptr += len;
+  }
+}
+/** @endcond */
+} // namespace network
+
+namespace parallel {
+/** @cond */
+
+// -------------------------------------------------------------
+// Flat packing of bus and branch records for the Shuffler. Bus and
+// branch objects are not sent, new objects are created on the
+// receiving process. The factory sets up the objects from the network
+// after partitioning, so they carry no state at this point.
+// -------------------------------------------------------------
+template <class _bus>
+struct ShufflePacker< network::BusData<_bus> >
+{
+  static void pack(const std::vector< network::BusData<_bus> > &things,
+      std::vector<char> &buf)
+  {
+    network::shuffleAppendKeys(buf);
+    int n = things.size();
+    shuffleAppend(buf, &n, 1);
+    for (int i=0; i<n; i++) {
+      const network::BusData<_bus> &bus = things[i];
+      int ival[3];
+      char flags[2];
+      ival[0] = bus.p_originalBusIndex;
+      ival[1] = bus.p_globalBusIndex;
+      ival[2] = bus.p_branchNeighbors.size();
+      flags[0] = static_cast<char>(bus.p_activeBus);
+      flags[1] = static_cast<char>(bus.p_refFlag);
+      shuffleAppend(buf, ival, 3);
+      shuffleAppend(buf, flags, 2);
+      if (ival[2] > 0) shuffleAppend(buf, &bus.p_branchNeighbors[0], ival[2]);
+      bus.p_data->pack(buf);
+    }
+  }
+
+  static void unpack(const char *ptr, size_t size,
+      std::vector< network::BusData<_bus> > &things)
+  {
+    const char *end = ptr + size;
+    std::vector<int> idMap;
+    network::shuffleReadKeys(ptr, idMap);
+    int n;
+    shuffleRead(ptr, &n, 1);
+    things.reserve(things.size()+n);
+    for (int i=0; i<n; i++) {
+      network::BusData<_bus> bus;
+      int ival[3];
+      char flags[2];
+      shuffleRead(ptr, ival, 3);
+      shuffleRead(ptr, flags, 2);
+      bus.p_originalBusIndex = ival[0];
+      bus.p_globalBusIndex = ival[1];
+      bus.p_branchNeighbors.resize(ival[2]);
+      if (ival[2] > 0) shuffleRead(ptr, &bus.p_branchNeighbors[0], ival[2]);
+      bus.p_activeBus = static_cast<bool>(flags[0]);
+      bus.p_refFlag = static_cast<bool>(flags[1]);
+      bus.p_data->unpack(ptr, idMap);
+      things.push_back(bus);
+    }
+    if (ptr != end) {
+      throw gridpack::Exception("Shuffler: corrupted bus buffer");
+    }
+  }
+};
+
+template <class _branch>
+struct ShufflePacker< network::BranchData<_branch> >
+{
+  static void pack(const std::vector< network::BranchData<_branch> > &things,
+      std::vector<char> &buf)
+  {
+    network::shuffleAppendKeys(buf);
+    int n = things.size();
+    shuffleAppend(buf, &n, 1);
+    for (int i=0; i<n; i++) {
+      const network::BranchData<_branch> &branch = things[i];
+      int ival[7];
+      char flag;
+      ival[0] = branch.p_globalBranchIndex;
+      ival[1] = branch.p_originalBusIndex1;
+      ival[2] = branch.p_originalBusIndex2;
+      ival[3] = branch.p_globalBusIndex1;
+      ival[4] = branch.p_globalBusIndex2;
+      ival[5] = branch.p_localBusIndex1;
+      ival[6] = branch.p_localBusIndex2;
+      flag = static_cast<char>(branch.p_activeBranch);
+      shuffleAppend(buf, ival, 7);
+      shuffleAppend(buf, &flag, 1);
+      branch.p_data->pack(buf);
+    }
+  }
+
+  static void unpack(const char *ptr, size_t size,
+      std::vector< network::BranchData<_branch> > &things)
+  {
+    const char *end = ptr + size;
+    std::vector<int> idMap;
+    network::shuffleReadKeys(ptr, idMap);
+    int n;
+    shuffleRead(ptr, &n, 1);
+    things.reserve(things.size()+n);
+    for (int i=0; i<n; i++) {
+      network::BranchData<_branch> branch;
+      int ival[7];
+      char flag;
+      shuffleRead(ptr, ival, 7);
+      shuffleRead(ptr, &flag, 1);
+      branch.p_globalBranchIndex = ival[0];
+      branch.p_originalBusIndex1 = ival[1];
+      branch.p_originalBusIndex2 = ival[2];
+      branch.p_globalBusIndex1 = ival[3];
+      branch.p_globalBusIndex2 = ival[4];
+      branch.p_localBusIndex1 = ival[5];
+      branch.p_localBusIndex2 = ival[6];
+      branch.p_activeBranch = static_cast<bool>(flag);
+      branch.p_data->unpack(ptr, idMap);
+      things.push_back(branch);
+    }
+    if (ptr != end) {
+      throw gridpack::Exception("Shuffler: corrupted branch buffer");
+    }
+  }
+};
 /** @endcond */
+} // namespace parallel
+
+namespace network {
 
 /**
  *  class BaseNetwork:
@@ -309,6 +526,8 @@ explicit BaseNetwork(const parallel::Communicator& comm)
   p_external_branch = false;
   p_allocatedBus = false;
   p_allocatedBranch = false;
+  p_neighborXC = false;
+  p_sharedXC = false;
   p_network_data.reset(new gridpack::component::DataCollection);
 
   gridpack::NoPrint *noprint = gridpack::NoPrint::instance();
@@ -1049,13 +1268,11 @@ void partition(void)
   timer = NULL;
 //  timer = gridpack::utility::CoarseTimer::instance();
 
-  int t_total(0), t_part(0), t_bus_dist(0), t_branch_dist(0);
+  int t_total(0), t_part(0);
 
   if (timer != NULL) {
     t_total = timer->createCategory("BaseNetwork<>::partition(): Total");
     t_part = timer->createCategory("BaseNetwork<>::partition(): Partitioner");
-    t_bus_dist = timer->createCategory("BaseNetwork<>::partition(): Bus Distribution");
-    t_branch_dist = timer->createCategory("BaseNetwork<>::partition(): Branch Distribution");
   }
 
   if (timer != NULL) timer->start(t_total);
@@ -1077,185 +1294,360 @@ void partition(void)
         branch->p_originalBusIndex2);
   }
   partitioner.partition();
-  // Recover global indices for branch ends from partitioner
-  int nbranch = p_branches.size();
-  int idx;
-  unsigned int index1, index2;
-  for (idx=0; idx<nbranch; idx++) {
-    partitioner.get_global_edge_ids(idx, &index1, &index2);
-    p_branches[idx].p_globalBusIndex1 = static_cast<int>(index1);
-    p_branches[idx].p_globalBusIndex2 = static_cast<int>(index2);
-  }
 
   if (timer != NULL) timer->stop(t_part);
 
-  int me(this->processor_rank());
-  GraphPartitioner::IndexVector dest, gdest;
-
-#if 1
-  typedef parallel::Shuffler<BusData<BusType>, GraphPartitioner::Index> BusShufflerType;
-  typedef parallel::Shuffler<BranchData<BranchType>, GraphPartitioner::Index> BranchShufflerType;
-#else 
-  typedef parallel::gaShuffler<BusData<BusType>, GraphPartitioner::Index> BusShufflerType;
-  typedef parallel::gaShuffler<BranchData<BranchType>, GraphPartitioner::Index> BranchShufflerType;
-#endif
-
-  BusShufflerType bus_shuffler(this->communicator());
-  BranchShufflerType branch_shuffler(this->communicator());
+  distributeComponents(partitioner);
 
-  // Need to make copies of buses and branches that will be ghosted.
-  // After active bus/branch distribution, they may not be on this
-  // processor.
+  if (timer != NULL) timer->stop(t_total);
+}
 
-  BusDataVector ghostbuses;
-  GraphPartitioner::MultiIndexVector gnodedest;
-  GraphPartitioner::IndexVector ghostbusdest;
-  BusIterator bus(p_buses.begin());
-  partitioner.ghost_node_destinations(gnodedest);
+/**
+ * Partition the network over the available processes so that the total
+ * cost of the buses on each process is balanced and the cost of the
+ * branches that are cut by the partition is minimized. This can be called
+ * on a network that has not been partitioned yet or on one that has
+ * already been partitioned, for example with weights that have been
+ * estimated by a factory after the network has been loaded. In the second
+ * case, all ghost buses and branches are removed first and buses and
+ * branches that move arrive with new components, so the network must be
+ * loaded by the factory again and all exchange buffers need to be set up
+ * again. This function is collective.
+ * @param busWeights cost of each local bus. Values on ghost buses are
+ *        ignored. If the vector is empty, all buses have a cost of 1
+ * @param branchWeights cost of cutting each local branch. Values on ghost
+ *        branches are ignored. If the vector is empty, all branches have a
+ *        cost of 1
+ */
+void partition(const std::vector<int> &busWeights,
+    const std::vector<int> &branchWeights)
+{
+  int me(this->processor_rank());
+  int nbus = p_buses.size();
+  int nbranch = p_branches.size();
+  int i;
+  if ((!busWeights.empty() && static_cast<int>(busWeights.size()) != nbus) ||
+      (!branchWeights.empty() &&
+       static_cast<int>(branchWeights.size()) != nbranch)) {
+    char buf[256];
+    sprintf(buf,"p[%d] BaseNetwork::partition: %d bus weights and %d branch"
+        " weights given for %d buses and %d branches\n",me,
+        static_cast<int>(busWeights.size()),
+        static_cast<int>(branchWeights.size()),nbus,nbranch);
+    throw gridpack::Exception(buf);
+  }
 
-  for (size_t i = 0; i < gnodedest.size(); ++i, ++bus) {
-    for (GraphPartitioner::IndexVector::iterator d = gnodedest[i].begin();
-        d != gnodedest[i].end(); ++d) {
-      ghostbuses.push_back(*bus);
-      ghostbusdest.push_back(*d);
+  // Weights are stored by global index, since clean() changes the local
+  // indices
+  std::map<int, int> busCost, branchCost;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      int w = busWeights.empty() ? 1 : busWeights[i];
+      if (w < 0) w = 0;
+      busCost.insert(std::pair<int,int>(p_buses[i].p_globalBusIndex,w));
     }
   }
-
-  // Branches can only be ghosted on one other process, so they're
-  // easy.
-
-  partitioner.edge_destinations(dest);
-  partitioner.ghost_edge_destinations(gdest);
-
-  BranchDataVector ghostbranches;
-  BranchIterator branch(p_branches.begin());
-  GraphPartitioner::IndexVector ghostbranchdest;
-
-  for (size_t i = 0; i < dest.size(); ++i, ++branch) {
-    if (dest[i] != gdest[i]) {
-      ghostbranches.push_back(*branch);
-      ghostbranches.back().p_activeBranch = false;
-      ghostbranchdest.push_back(gdest[i]);
+  for (i=0; i<nbranch; i++) {
+    if (p_branches[i].p_activeBranch) {
+      int w = branchWeights.empty() ? 1 : branchWeights[i];
+      if (w < 1) w = 1;
+      branchCost.insert(std::pair<int,int>(
+            p_branches[i].p_globalBranchIndex,w));
     }
   }
+  removeGhosts();
 
-
-  // distribute active nodes
-
-  // std::cout << me << ": distributing " << p_buses.size() << " active buses" << std::endl;
-
-  if (timer != NULL) timer->start(t_bus_dist);
-  partitioner.node_destinations(dest);
-  bus_shuffler(p_buses, dest);
-  if (timer != NULL) timer->stop(t_bus_dist);
-
-  // distribute active edges
-
-  if (timer != NULL) timer->start(t_branch_dist);
-  partitioner.edge_destinations(dest);
-  branch_shuffler(p_branches, dest);
-  if (timer != NULL) timer->stop(t_branch_dist);
-
-  // At this point, active buses and branches are on the proper
-  // process.  Now, we need to distribute and nodes and edges that
-  // are ghosted.  
-
-  // std::cout << me << ": distributing " << ghostbuses.size() << " ghost buses" << std::endl;
-
-  if (timer != NULL) timer->start(t_bus_dist);
-  bus_shuffler(ghostbuses, ghostbusdest);
-  for (bus = ghostbuses.begin(); bus != ghostbuses.end(); ++bus) {
-    bus->p_activeBus = false;
-    p_buses.push_back(*bus);
+  GraphPartitioner partitioner(this->communicator(),
+      p_buses.size(), p_branches.size());
+  for (BusIterator bus = p_buses.begin(); bus != p_buses.end(); ++bus) {
+    partitioner.add_node(bus->p_globalBusIndex,bus->p_originalBusIndex,
+        busCost[bus->p_globalBusIndex]);
   }
-  ghostbuses.clear();
-  if (timer != NULL) timer->stop(t_bus_dist);
-
-  if (timer != NULL) timer->start(t_branch_dist);
-  branch_shuffler(ghostbranches, ghostbranchdest);
-  std::copy(ghostbranches.begin(), ghostbranches.end(),
-      std::back_inserter(p_branches));
-  ghostbranches.clear();
-  if (timer != NULL) timer->stop(t_branch_dist);
+  for (BranchIterator branch = p_branches.begin();
+      branch != p_branches.end(); ++branch) {
+    partitioner.add_edge(branch->p_globalBranchIndex,
+        branch->p_originalBusIndex1,
+        branch->p_originalBusIndex2,
+        branchCost[branch->p_globalBranchIndex]);
+  }
+  partitioner.partition();
+  distributeComponents(partitioner);
+  resetReferenceBus();
+}
+
+/**
+ * Rebalance a network that has already been partitioned. Each active bus
+ * is given a cost and processes whose total cost exceeds the average by
+ * more than the tolerance hand buses to neighboring processes with less
+ * work. The amount of work exchanged between each pair of neighboring
+ * processes is found by diffusion on the graph of processes, in which each
+ * process only communicates with the processes it shares buses with. The
+ * buses that move are taken from the boundary with the receiving process,
+ * followed by the buses behind them, so most of the existing distribution
+ * is kept. Buses and branches that move take their components with them,
+ * using the serialization of the component classes. Ghost buses and
+ * branches change, so exchange buffers need to be allocated and the bus
+ * and branch updates initialized again after calling this function. This
+ * function is collective.
+ * @param weights cost of each local bus. Values on ghost buses are ignored
+ * @param tolerance network is rebalanced if the maximum cost on any
+ *        process is larger than tolerance times the average cost
+ * @return total number of buses that were moved
+ */
+int repartition(const std::vector<double> &weights, double tolerance = 1.05)
+{
+  int me(this->processor_rank());
+  int nproc(this->processor_size());
+  int nbus = p_buses.size();
+  int i, j, p, q;
+  if (static_cast<int>(weights.size()) != nbus) {
+    char buf[256];
+    sprintf(buf,"p[%d] BaseNetwork::repartition: %d weights given for"
+        " %d buses\n",me,static_cast<int>(weights.size()),nbus);
+    throw gridpack::Exception(buf);
+  }
+  MPI_Comm comm = static_cast<MPI_Comm>(this->communicator());
 
-  // At this point, each process should have a self-contained
-  // network, update local and global indexes, etc.
+  // Find the cost on each process and check if it needs to be rebalanced
+  double load = 0.0;
+  int nactive = 0;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      load += weights[i];
+      nactive++;
+    }
+  }
+  double avg, lmax;
+  MPI_Allreduce(&load,&avg,1,MPI_DOUBLE,MPI_SUM,comm);
+  MPI_Allreduce(&load,&lmax,1,MPI_DOUBLE,MPI_MAX,comm);
+  avg /= static_cast<double>(nproc);
+  if (nproc == 1 || lmax <= tolerance*avg) return 0;
 
-  // make an index of global bus index to local index and update
-  // the branch local bus indexes
-  int active_buses(0), active_branches(0);
+  // Find the process that owns each ghost bus
+  std::vector<int> owner(nbus, me);
   {
-    std::map<int, int> busindexes;
-    int lidx(0);
-    for (BusIterator b = p_buses.begin(); b != p_buses.end(); ++b, ++lidx) {
-      clearBranchNeighbors(lidx);
-      busindexes[b->p_globalBusIndex] = lidx;
-      if (b->p_activeBus) active_buses += 1;
+    int nglobal = totalBuses();
+    int grp = this->communicator().getGroup();
+    int one = 1;
+    int g_owner = GA_Create_handle();
+    GA_Set_data(g_owner,one,&nglobal,C_INT);
+    GA_Set_pgroup(g_owner,grp);
+    GA_Allocate(g_owner);
+    std::vector<int> idx, vals;
+    for (i=0; i<nbus; i++) {
+      if (p_buses[i].p_activeBus) idx.push_back(p_buses[i].p_globalBusIndex);
+    }
+    std::vector<int*> ptr(idx.size());
+    for (i=0; i<idx.size(); i++) ptr[i] = &idx[i];
+    vals.assign(idx.size(), me);
+    if (idx.size() > 0) NGA_Scatter(g_owner,&vals[0],&ptr[0],idx.size());
+    GA_Pgroup_sync(grp);
+    std::vector<int> ghosts;
+    idx.clear();
+    for (i=0; i<nbus; i++) {
+      if (!p_buses[i].p_activeBus) {
+        ghosts.push_back(i);
+        idx.push_back(p_buses[i].p_globalBusIndex);
+      }
     }
-
-    // go through the branches and set the local bus indexes and pointers
-    lidx = 0;
-    for (BranchIterator b = p_branches.begin(); b != p_branches.end(); ++b, ++lidx) {
-      int gbus, lbus1, lbus2;
-      BusPtr bus1, bus2;
-
-      // set local indexes
-
-      gbus = b->p_globalBusIndex1;
-      lbus1 = busindexes[gbus];
-      bus1 = p_buses[lbus1].p_bus;
-
-      gbus = b->p_globalBusIndex2;
-      lbus2 = busindexes[gbus];
-      bus2 = p_buses[lbus2].p_bus;
-
-      b->p_localBusIndex1 = lbus1;
-      addBranchNeighbor(lbus1, lidx);
-
-      b->p_localBusIndex2 = lbus2;
-      addBranchNeighbor(lbus2, lidx);
-
-      // set component pointers
-
-      b->p_branch->setBus1(bus1);
-      b->p_branch->setBus2(bus2);
-
-      gbus = b->p_globalBusIndex1;
-      bus1->addBranch(b->p_branch);
-      bus1->addBus(bus2);
-      setGlobalBusIndex1(lidx,gbus); 
-      gbus = b->p_globalBusIndex2;
-      bus2->addBranch(b->p_branch);
-      bus2->addBus(bus1);
-      setGlobalBusIndex2(lidx,gbus); 
-
-      if (b->p_activeBranch) active_branches += 1;
+    ptr.resize(idx.size());
+    for (i=0; i<idx.size(); i++) ptr[i] = &idx[i];
+    vals.resize(idx.size());
+    if (idx.size() > 0) NGA_Gather(g_owner,&vals[0],&ptr[0],idx.size());
+    for (i=0; i<ghosts.size(); i++) owner[ghosts[i]] = vals[i];
+    GA_Pgroup_sync(grp);
+    GA_Destroy(g_owner);
+  }
+
+  // Find the neighbors of each active bus and the processes that own
+  // buses on the boundary of this process. A process is a neighbor if
+  // either process has a ghost owned by the other, so the list is made
+  // symmetric with one exchange of flags.
+  std::vector<std::vector<int> > neighbors(nbus);
+  std::vector<int> isNeighbor(nproc, 0);
+  for (i=0; i<nbus; i++) {
+    if (!p_buses[i].p_activeBus) continue;
+    for (j=0; j<p_buses[i].p_branchNeighbors.size(); j++) {
+      const BranchData<BranchType> &branch
+        = p_branches[p_buses[i].p_branchNeighbors[j]];
+      int other = branch.p_localBusIndex1;
+      if (other == i) other = branch.p_localBusIndex2;
+      if (other < 0 || other == i) continue;
+      neighbors[i].push_back(other);
+      if (owner[other] != me) isNeighbor[owner[other]] = 1;
+    }
+  }
+  std::vector<int> neighborOf(nproc);
+  MPI_Alltoall(&isNeighbor[0],1,MPI_INT,&neighborOf[0],1,MPI_INT,comm);
+  std::vector<int> procs;
+  for (p=0; p<nproc; p++) {
+    if (p != me && (isNeighbor[p] || neighborOf[p])) procs.push_back(p);
+  }
+  int nnghbr = procs.size();
+
+  // Diffuse the excess cost over the graph of processes. In each sweep a
+  // process exchanges its current cost with its neighbors only and moves
+  // a fraction of the difference across each edge. Both ends of an edge
+  // compute the same amount with opposite signs.
+  std::vector<double> sndval(nnghbr), rcvval(nnghbr);
+  std::vector<MPI_Request> req(2*nnghbr);
+  double dgr = static_cast<double>(nnghbr);
+  for (q=0; q<nnghbr; q++) {
+    MPI_Irecv(&rcvval[q],1,MPI_DOUBLE,procs[q],0,comm,&req[q]);
+    MPI_Isend(&dgr,1,MPI_DOUBLE,procs[q],0,comm,&req[nnghbr+q]);
+  }
+  if (nnghbr > 0) MPI_Waitall(2*nnghbr,&req[0],MPI_STATUSES_IGNORE);
+  std::vector<double> alpha(nnghbr);
+  for (q=0; q<nnghbr; q++) {
+    alpha[q] = 1.0/(1.0+std::max(dgr,rcvval[q]));
+  }
+  std::vector<double> flow(nnghbr, 0.0);
+  double level = load;
+  int iter;
+  for (iter=0; iter<100; iter++) {
+    for (q=0; q<nnghbr; q++) {
+      MPI_Irecv(&rcvval[q],1,MPI_DOUBLE,procs[q],0,comm,&req[q]);
+      MPI_Isend(&level,1,MPI_DOUBLE,procs[q],0,comm,&req[nnghbr+q]);
+    }
+    if (nnghbr > 0) MPI_Waitall(2*nnghbr,&req[0],MPI_STATUSES_IGNORE);
+    double delta = 0.0;
+    for (q=0; q<nnghbr; q++) {
+      double d = alpha[q]*(level-rcvval[q]);
+      flow[q] += d;
+      delta -= d;
+    }
+    level += delta;
+    MPI_Allreduce(&level,&lmax,1,MPI_DOUBLE,MPI_MAX,comm);
+    if (lmax <= tolerance*avg) break;
+  }
+
+  // Pick buses to send to each process that receives work from this
+  // process. Buses are taken in breadth first order starting from the
+  // boundary with the receiving process. At least one bus is always kept.
+  std::vector<int> dest(nbus, me);
+  int nmoved = 0;
+  for (p=0; p<nnghbr; p++) {
+    double target = flow[p];
+    q = procs[p];
+    if (target <= 0.0) continue;
+    std::vector<char> seen(nbus, 0);
+    std::deque<int> queue;
+    for (i=0; i<nbus; i++) {
+      if (!p_buses[i].p_activeBus || dest[i] != me) continue;
+      for (j=0; j<neighbors[i].size(); j++) {
+        if (owner[neighbors[i][j]] == q) {
+          queue.push_back(i);
+          seen[i] = 1;
+          break;
+        }
+      }
+    }
+    double moved = 0.0;
+    while (!queue.empty() && moved < target && nactive - nmoved > 1) {
+      i = queue.front();
+      queue.pop_front();
+      if (dest[i] != me || moved + 0.5*weights[i] > target) continue;
+      dest[i] = q;
+      moved += weights[i];
+      nmoved++;
+      for (j=0; j<neighbors[i].size(); j++) {
+        int other = neighbors[i][j];
+        if (!seen[other] && p_buses[other].p_activeBus && dest[other] == me) {
+          queue.push_back(other);
+          seen[other] = 1;
+        }
+      }
     }
   }
-  setMap();
+  int total;
+  MPI_Allreduce(&nmoved,&total,1,MPI_INT,MPI_SUM,comm);
+  if (total == 0) return 0;
 
-  /* initialize network analytics functionality */
-  int nbus = p_buses.size();
-  for (size_t i=0; i<nbus; i++) {
-    getBus(i)->setData(getBusData(i));
+  // Remove ghosts and redistribute the network with the new destinations.
+  // Buses are identified by global index, since clean() changes the local
+  // indices
+  std::map<int, int> newdest;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus && dest[i] != me) {
+      newdest.insert(std::pair<int,int>(p_buses[i].p_globalBusIndex,dest[i]));
+    }
   }
-  nbranch = p_branches.size();
-  for (size_t i=0; i<nbranch; i++) {
-    getBranch(i)->setData(getBranchData(i));
+  removeGhosts();
+  GraphPartitioner partitioner(this->communicator(),
+      p_buses.size(), p_branches.size());
+  GraphPartitioner::IndexVector nodedest(p_buses.size(), me);
+  i = 0;
+  for (BusIterator bus = p_buses.begin(); bus != p_buses.end(); ++bus, ++i) {
+    partitioner.add_node(bus->p_globalBusIndex,bus->p_originalBusIndex);
+    std::map<int, int>::iterator it = newdest.find(bus->p_globalBusIndex);
+    if (it != newdest.end()) nodedest[i] = it->second;
   }
-
-
-  if (!p_no_print) {
-    std::cout << me << ": "
-      << "I have " 
-      << p_buses.size() << " buses and "
-      << p_branches.size() << " branches"
-      << std::endl;
-  }
-
-  if (timer != NULL) timer->stop(t_total);
-}
-
+  for (BranchIterator branch = p_branches.begin();
+      branch != p_branches.end(); ++branch) {
+    partitioner.add_edge(branch->p_globalBranchIndex,
+        branch->p_originalBusIndex1,
+        branch->p_originalBusIndex2);
+  }
+  partitioner.partition(nodedest);
+
+  // Send the components of buses and branches that move to their new
+  // process. The network records are moved without components, so the
+  // components that arrive replace the empty ones created for them.
+  std::vector<ComponentState<BusType> > busState;
+  std::vector<ComponentState<BranchType> > branchState;
+  GraphPartitioner::IndexVector busdest, branchdest, statedest;
+  partitioner.node_destinations(busdest);
+  for (i=0; i<busdest.size(); i++) {
+    if (busdest[i] == me) continue;
+    ComponentState<BusType> state;
+    state.p_globalIndex = p_buses[i].p_globalBusIndex;
+    state.p_component = p_buses[i].p_bus;
+    busState.push_back(state);
+    statedest.push_back(busdest[i]);
+  }
+  parallel::Shuffler<ComponentState<BusType>, GraphPartitioner::Index>
+    bus_state_shuffler(this->communicator());
+  bus_state_shuffler(busState, statedest);
+  statedest.clear();
+  partitioner.edge_destinations(branchdest);
+  for (i=0; i<branchdest.size(); i++) {
+    if (branchdest[i] == me) continue;
+    ComponentState<BranchType> state;
+    state.p_globalIndex = p_branches[i].p_globalBranchIndex;
+    state.p_component = p_branches[i].p_branch;
+    branchState.push_back(state);
+    statedest.push_back(branchdest[i]);
+  }
+  parallel::Shuffler<ComponentState<BranchType>, GraphPartitioner::Index>
+    branch_state_shuffler(this->communicator());
+  branch_state_shuffler(branchState, statedest);
+
+  distributeComponents(partitioner);
+  std::map<int, int> arrived;
+  for (i=0; i<busState.size(); i++) {
+    arrived.insert(std::pair<int,int>(busState[i].p_globalIndex,i));
+  }
+  for (i=0; i<p_buses.size(); i++) {
+    if (!p_buses[i].p_activeBus) continue;
+    std::map<int, int>::iterator it = arrived.find(p_buses[i].p_globalBusIndex);
+    if (it != arrived.end()) p_buses[i].p_bus = busState[it->second].p_component;
+  }
+  arrived.clear();
+  for (i=0; i<branchState.size(); i++) {
+    arrived.insert(std::pair<int,int>(branchState[i].p_globalIndex,i));
+  }
+  for (i=0; i<p_branches.size(); i++) {
+    if (!p_branches[i].p_activeBranch) continue;
+    std::map<int, int>::iterator it
+      = arrived.find(p_branches[i].p_globalBranchIndex);
+    if (it != arrived.end()) {
+      p_branches[i].p_branch = branchState[it->second].p_component;
+    }
+  }
+  linkComponents();
+  resetReferenceBus();
+  return total;
+}
 
 
 /**
@@ -1682,6 +2074,8 @@ void clear(void)
     GA_Destroy(p_busGA);
     NGA_Deregister_type(p_busXCBufType);
   }
+  p_busNeighborXC.reset();
+  p_branchNeighborXC.reset();
   // Get rid of all buses and branches
   p_buses.clear();
   p_branches.clear();
@@ -1988,6 +2382,24 @@ void setXCBranchBuffer(int idx, void* ptr)
   }
 }
 
+/**
+ * Select the algorithm used to update ghost buses and branches. By default,
+ * updates go through a global array and require several synchronizations
+ * across all processes. If flag is true, initBusUpdate and initBranchUpdate
+ * instead build a point-to-point exchange plan so that each update only
+ * communicates with processes that own or hold ghosts of local buses and
+ * branches. This must be called before initBusUpdate and initBranchUpdate.
+ * If shared is also true, processes on the same node read ghost values
+ * directly from each other's memory instead of exchanging messages.
+ * @param flag if true, use point-to-point exchange between neighbors
+ * @param shared if true, use shared memory between processes on a node
+ */
+void useNeighborExchange(bool flag, bool shared = false)
+{
+  p_neighborXC = flag;
+  p_sharedXC = flag && shared;
+}
+
 /**
  * This function must be called before calling the update bus routine.
  * It initializes data structures for the bus update
@@ -1995,6 +2407,11 @@ void setXCBranchBuffer(int idx, void* ptr)
 void initBusUpdate(void)
 {
   int i, size, numBuses;
+  if (p_neighborXC) {
+    initBusNeighborUpdate();
+    return;
+  }
+  p_busNeighborXC.reset();
   int grp = this->communicator().getGroup();
   GA_Pgroup_sync(grp);
   // Don't do anything if buffers are not allocated
@@ -2132,6 +2549,10 @@ void initBusUpdate(void)
  */
 void updateBuses(void)
 {
+  if (p_busNeighborXC) {
+    p_busNeighborXC->exchange(p_busXCBuffers);
+    return;
+  }
   int grp = this->communicator().getGroup();
   // Copy data from XC buffer to send buffer
   GA_Pgroup_sync(grp);
@@ -2188,6 +2609,11 @@ void updateBuses(void)
 void initBranchUpdate(void)
 {
   int i, size, numBranches;
+  if (p_neighborXC) {
+    initBranchNeighborUpdate();
+    return;
+  }
+  p_branchNeighborXC.reset();
   int grp = this->communicator().getGroup();
   GA_Pgroup_sync(grp);
   // Don't do anything if buffers are not allocated
@@ -2308,12 +2734,66 @@ void initBranchUpdate(void)
   GA_Pgroup_sync(grp);
 }
 
+/**
+ * Set up point-to-point exchange plan for ghost buses. The owner of each
+ * ghost bus is found by the exchange itself, so global indices do not need
+ * to be contiguous on each process, as they are not after partition
+ */
+void initBusNeighborUpdate(void)
+{
+  if (p_busXCBufSize <= 0) return;
+  int i;
+  int size = p_buses.size();
+  std::vector<int> ownedGlobal, ownedLocal, ghostGlobal, ghostLocal;
+  for (i=0; i<size; i++) {
+    if (getActiveBus(i)) {
+      ownedGlobal.push_back(getGlobalBusIndex(i));
+      ownedLocal.push_back(i);
+    } else {
+      ghostGlobal.push_back(getGlobalBusIndex(i));
+      ghostLocal.push_back(i);
+    }
+  }
+  p_busNeighborXC.reset(new parallel::GhostExchange(this->communicator()));
+  p_busNeighborXC->useSharedMemory(p_sharedXC);
+  p_busNeighborXC->setup(p_busXCBufSize, ownedGlobal, ownedLocal,
+      ghostGlobal, ghostLocal);
+}
+
+/**
+ * Set up point-to-point exchange plan for ghost branches
+ */
+void initBranchNeighborUpdate(void)
+{
+  if (p_branchXCBufSize <= 0) return;
+  int i;
+  int size = p_branches.size();
+  std::vector<int> ownedGlobal, ownedLocal, ghostGlobal, ghostLocal;
+  for (i=0; i<size; i++) {
+    if (getActiveBranch(i)) {
+      ownedGlobal.push_back(getGlobalBranchIndex(i));
+      ownedLocal.push_back(i);
+    } else {
+      ghostGlobal.push_back(getGlobalBranchIndex(i));
+      ghostLocal.push_back(i);
+    }
+  }
+  p_branchNeighborXC.reset(new parallel::GhostExchange(this->communicator()));
+  p_branchNeighborXC->useSharedMemory(p_sharedXC);
+  p_branchNeighborXC->setup(p_branchXCBufSize, ownedGlobal,
+      ownedLocal, ghostGlobal, ghostLocal);
+}
+
 /**
  * Update the branch ghost values. This is a
  * collective operation across all processors.
  */
 void updateBranches(void)
 {
+  if (p_branchNeighborXC) {
+    p_branchNeighborXC->exchange(p_branchXCBuffers);
+    return;
+  }
   // Copy data from XC buffer to send buffer
   int grp = this->communicator().getGroup();
   GA_Pgroup_sync(grp);
@@ -2563,6 +3043,216 @@ void broadcastNetworkData(int idx)
   boost::mpi::broadcast(comm, p_network_data, idx);
 }
 
+/**
+ * Write the local part of the partitioned network to a binary snapshot
+ * file. Each process writes its own file, containing its active and ghost
+ * buses and branches, their global indices and data collections, and the
+ * network data collection. The snapshot can be read back with
+ * loadSnapshot by the same number of processes without parsing the network
+ * files or partitioning the network again. This should be called after
+ * partition() and before the network data is modified by an application.
+ * This is a collective operation. If any process fails to write its file,
+ * all processes throw an exception.
+ * @param prefix path and file name prefix of snapshot. The file written
+ *        by each process is prefix.nprocs.rank.gpsnap
+ * @param stamp user supplied value that must match when the snapshot is
+ *        loaded. This can be used to detect stale snapshots, e.g. by using
+ *        the modification time of the source network file
+ */
+void saveSnapshot(const std::string &prefix, long long stamp = 0)
+{
+  int i, len;
+  int nbus = p_buses.size();
+  int nbranch = p_branches.size();
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, GRIDPACK_SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = GRIDPACK_SNAPSHOT_VERSION;
+  header.nprocs = this->processor_size();
+  header.rank = this->processor_rank();
+  header.nbus = nbus;
+  header.nbranch = nbranch;
+  header.nkeys = gridpack::component::DataKey::numKeys();
+  header.stamp = stamp;
+
+  std::vector<char> buf(sizeof(header));
+  // Table of data element names. Data collections are stored using the
+  // interned IDs on this process
+  for (i=0; i<header.nkeys; i++) {
+    const std::string &name = gridpack::component::DataKey::name(i);
+    len = name.size();
+    snapshotAppend(buf, &len, 1);
+    snapshotAppend(buf, name.c_str(), len);
+  }
+  p_network_data->pack(buf);
+  for (i=0; i<nbus; i++) {
+    int ival[2];
+    char flags[2];
+    ival[0] = p_buses[i].p_originalBusIndex;
+    ival[1] = p_buses[i].p_globalBusIndex;
+    flags[0] = static_cast<char>(p_buses[i].p_activeBus);
+    flags[1] = static_cast<char>(p_buses[i].p_refFlag);
+    snapshotAppend(buf, ival, 2);
+    snapshotAppend(buf, flags, 2);
+    p_buses[i].p_data->pack(buf);
+  }
+  for (i=0; i<nbranch; i++) {
+    int ival[5];
+    char flag;
+    ival[0] = p_branches[i].p_originalBusIndex1;
+    ival[1] = p_branches[i].p_originalBusIndex2;
+    ival[2] = p_branches[i].p_globalBranchIndex;
+    ival[3] = p_branches[i].p_globalBusIndex1;
+    ival[4] = p_branches[i].p_globalBusIndex2;
+    flag = static_cast<char>(p_branches[i].p_activeBranch);
+    snapshotAppend(buf, ival, 5);
+    snapshotAppend(buf, &flag, 1);
+    p_branches[i].p_data->pack(buf);
+  }
+  header.size = buf.size();
+  memcpy(&buf[0], &header, sizeof(header));
+
+  // Write to a temporary file and rename it so that a process reading the
+  // snapshot never sees a partially written file. Files are only renamed
+  // if all processes wrote their files
+  std::string file = snapshotFile(prefix, header.nprocs, header.rank);
+  std::string tmpfile = file + ".tmp";
+  FILE *fp = fopen(tmpfile.c_str(), "wb");
+  int ok = (fp != NULL);
+  if (ok) {
+    ok = (fwrite(&buf[0], 1, buf.size(), fp) == buf.size());
+    ok = (fclose(fp) == 0) && ok;
+  }
+  int grp = this->communicator().getGroup();
+  char plus[2];
+  strcpy(plus,"+");
+  int nok = ok;
+  GA_Pgroup_igop(grp,&nok,1,plus);
+  if (nok == header.nprocs) {
+    ok = (rename(tmpfile.c_str(), file.c_str()) == 0);
+    nok = ok;
+    GA_Pgroup_igop(grp,&nok,1,plus);
+  } else {
+    remove(tmpfile.c_str());
+  }
+  if (nok != header.nprocs) {
+    char ebuf[512];
+    if (!ok) {
+      sprintf(ebuf,"p[%d] BaseNetwork::saveSnapshot: unable to write file"
+          " %s\n",header.rank,file.c_str());
+    } else {
+      sprintf(ebuf,"p[%d] BaseNetwork::saveSnapshot: %d processes unable to"
+          " write snapshot %s\n",header.rank,header.nprocs-nok,
+          prefix.c_str());
+    }
+    throw gridpack::Exception(ebuf);
+  }
+}
+
+/**
+ * Replace the contents of the network with a snapshot written by
+ * saveSnapshot. Each process memory maps its own file and recreates its
+ * buses and branches, including ghosts, directly from the file, so neither
+ * the network parser nor partition() need to be called. This is a
+ * collective operation. The snapshot is only used if all processes find a
+ * snapshot written by the same number of processes with the same stamp.
+ * @param prefix path and file name prefix of snapshot
+ * @param stamp value that was passed to saveSnapshot
+ * @return false if no usable snapshot was found. The network is unchanged
+ *         in this case
+ */
+bool loadSnapshot(const std::string &prefix, long long stamp = 0)
+{
+  int i, len;
+  int me = this->processor_rank();
+  int nprocs = this->processor_size();
+  std::string file = snapshotFile(prefix, nprocs, me);
+
+  // Check that file exists and matches this run
+  int ok = 0;
+  size_t size = 0;
+  void *map = MAP_FAILED;
+  SnapshotHeader header;
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 &&
+        st.st_size >= static_cast<off_t>(sizeof(header))) {
+      size = st.st_size;
+      map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (map != MAP_FAILED) {
+      memcpy(&header, map, sizeof(header));
+      if (strncmp(header.magic, GRIDPACK_SNAPSHOT_MAGIC,
+            sizeof(header.magic)) == 0 &&
+          header.version == GRIDPACK_SNAPSHOT_VERSION &&
+          header.nprocs == nprocs && header.rank == me &&
+          header.stamp == stamp && header.size == size) {
+        ok = 1;
+      }
+    }
+  }
+  int grp = this->communicator().getGroup();
+  char plus[2];
+  strcpy(plus,"+");
+  GA_Pgroup_igop(grp,&ok,1,plus);
+
+  if (ok == nprocs) {
+    clear();
+    const char *ptr = static_cast<const char*>(map) + sizeof(header);
+    std::vector<int> idMap(header.nkeys);
+    for (i=0; i<header.nkeys; i++) {
+      snapshotRead(ptr, &len, 1);
+      idMap[i] = gridpack::component::DataKey(std::string(ptr,len)).id();
+      ptr += len;
+    }
+    p_network_data->unpack(ptr, idMap);
+    for (i=0; i<header.nbus; i++) {
+      int ival[2];
+      char flags[2];
+      snapshotRead(ptr, ival, 2);
+      snapshotRead(ptr, flags, 2);
+      addBus(ival[0]);
+      p_buses[i].p_globalBusIndex = ival[1];
+      p_buses[i].p_activeBus = static_cast<bool>(flags[0]);
+      if (flags[1]) setReferenceBus(i);
+      p_buses[i].p_data->unpack(ptr, idMap);
+    }
+    for (i=0; i<header.nbranch; i++) {
+      int ival[5];
+      char flag;
+      snapshotRead(ptr, ival, 5);
+      snapshotRead(ptr, &flag, 1);
+      addBranch(ival[0], ival[1]);
+      p_branches[i].p_globalBranchIndex = ival[2];
+      p_branches[i].p_globalBusIndex1 = ival[3];
+      p_branches[i].p_globalBusIndex2 = ival[4];
+      p_branches[i].p_activeBranch = static_cast<bool>(flag);
+      p_branches[i].p_data->unpack(ptr, idMap);
+    }
+    if (ptr != static_cast<const char*>(map) + size) {
+      char ebuf[512];
+      sprintf(ebuf,"p[%d] BaseNetwork::loadSnapshot: corrupted file %s\n",
+          me,file.c_str());
+      munmap(map, size);
+      close(fd);
+      throw gridpack::Exception(ebuf);
+    }
+    linkComponents();
+    if (!p_no_print) {
+      std::cout << me << ": "
+        << "I have " 
+        << p_buses.size() << " buses and "
+        << p_branches.size() << " branches"
+        << " from snapshot"
+        << std::endl;
+    }
+  }
+  if (map != MAP_FAILED) munmap(map, size);
+  if (fd >= 0) close(fd);
+  return (ok == nprocs);
+}
+
 protected:
 
 /**
@@ -2572,6 +3262,287 @@ BaseNetwork(const BaseNetwork& old)
 {
 }
 
+/**
+ * Remove all ghost buses and branches and the links between components
+ * before the network is partitioned again
+ */
+void removeGhosts(void)
+{
+  clean();
+  for (BusIterator bus = p_buses.begin(); bus != p_buses.end(); ++bus) {
+    bus->p_bus->clearBranches();
+    bus->p_bus->clearBuses();
+  }
+  for (BranchIterator branch = p_branches.begin();
+      branch != p_branches.end(); ++branch) {
+    branch->p_branch->clearBuses();
+  }
+}
+
+/**
+ * Find the local index of the reference bus after the network has been
+ * distributed
+ */
+void resetReferenceBus(void)
+{
+  int i;
+  p_refBus = -1;
+  for (i=0; i<p_buses.size(); i++) {
+    if (p_buses[i].p_activeBus && p_buses[i].p_refFlag) p_refBus = i;
+  }
+}
+
+/**
+ * Move buses and branches to the processes assigned to them by the
+ * partitioner and create ghost buses and branches
+ * @param partitioner partitioner that has been used to assign destinations
+ * to all local buses and branches
+ */
+void distributeComponents(GraphPartitioner &partitioner)
+{
+  gridpack::utility::CoarseTimer *timer;
+  timer = NULL;
+//  timer = gridpack::utility::CoarseTimer::instance();
+
+  int t_bus_dist(0), t_branch_dist(0);
+
+  if (timer != NULL) {
+    t_bus_dist = timer->createCategory("BaseNetwork<>::partition(): Bus Distribution");
+    t_branch_dist = timer->createCategory("BaseNetwork<>::partition(): Branch Distribution");
+  }
+
+  // Recover global indices for branch ends from partitioner
+  int nbranch = p_branches.size();
+  int idx;
+  unsigned int index1, index2;
+  for (idx=0; idx<nbranch; idx++) {
+    partitioner.get_global_edge_ids(idx, &index1, &index2);
+    p_branches[idx].p_globalBusIndex1 = static_cast<int>(index1);
+    p_branches[idx].p_globalBusIndex2 = static_cast<int>(index2);
+  }
+
+
+  int me(this->processor_rank());
+  GraphPartitioner::IndexVector dest, gdest;
+
+#if 1
+  typedef parallel::Shuffler<BusData<BusType>, GraphPartitioner::Index> BusShufflerType;
+  typedef parallel::Shuffler<BranchData<BranchType>, GraphPartitioner::Index> BranchShufflerType;
+#else 
+  typedef parallel::gaShuffler<BusData<BusType>, GraphPartitioner::Index> BusShufflerType;
+  typedef parallel::gaShuffler<BranchData<BranchType>, GraphPartitioner::Index> BranchShufflerType;
+#endif
+
+  BusShufflerType bus_shuffler(this->communicator());
+  BranchShufflerType branch_shuffler(this->communicator());
+
+  // Need to make copies of buses and branches that will be ghosted.
+  // After active bus/branch distribution, they may not be on this
+  // processor.
+
+  BusDataVector ghostbuses;
+  GraphPartitioner::MultiIndexVector gnodedest;
+  GraphPartitioner::IndexVector ghostbusdest;
+  BusIterator bus(p_buses.begin());
+  partitioner.ghost_node_destinations(gnodedest);
+
+  for (size_t i = 0; i < gnodedest.size(); ++i, ++bus) {
+    for (GraphPartitioner::IndexVector::iterator d = gnodedest[i].begin();
+        d != gnodedest[i].end(); ++d) {
+      ghostbuses.push_back(*bus);
+      ghostbusdest.push_back(*d);
+    }
+  }
+
+  // Branches can only be ghosted on one other process, so they're
+  // easy.
+
+  partitioner.edge_destinations(dest);
+  partitioner.ghost_edge_destinations(gdest);
+
+  BranchDataVector ghostbranches;
+  BranchIterator branch(p_branches.begin());
+  GraphPartitioner::IndexVector ghostbranchdest;
+
+  for (size_t i = 0; i < dest.size(); ++i, ++branch) {
+    if (dest[i] != gdest[i]) {
+      ghostbranches.push_back(*branch);
+      ghostbranches.back().p_activeBranch = false;
+      ghostbranchdest.push_back(gdest[i]);
+    }
+  }
+
+
+  // distribute active nodes
+
+  // std::cout << me << ": distributing " << p_buses.size() << " active buses" << std::endl;
+
+  if (timer != NULL) timer->start(t_bus_dist);
+  partitioner.node_destinations(dest);
+  bus_shuffler(p_buses, dest);
+  if (timer != NULL) timer->stop(t_bus_dist);
+
+  // distribute active edges
+
+  if (timer != NULL) timer->start(t_branch_dist);
+  partitioner.edge_destinations(dest);
+  branch_shuffler(p_branches, dest);
+  if (timer != NULL) timer->stop(t_branch_dist);
+
+  // At this point, active buses and branches are on the proper
+  // process.  Now, we need to distribute and nodes and edges that
+  // are ghosted.  
+
+  // std::cout << me << ": distributing " << ghostbuses.size() << " ghost buses" << std::endl;
+
+  if (timer != NULL) timer->start(t_bus_dist);
+  bus_shuffler(ghostbuses, ghostbusdest);
+  for (bus = ghostbuses.begin(); bus != ghostbuses.end(); ++bus) {
+    bus->p_activeBus = false;
+    p_buses.push_back(*bus);
+  }
+  ghostbuses.clear();
+  if (timer != NULL) timer->stop(t_bus_dist);
+
+  if (timer != NULL) timer->start(t_branch_dist);
+  branch_shuffler(ghostbranches, ghostbranchdest);
+  std::copy(ghostbranches.begin(), ghostbranches.end(),
+      std::back_inserter(p_branches));
+  ghostbranches.clear();
+  if (timer != NULL) timer->stop(t_branch_dist);
+
+  // At this point, each process should have a self-contained
+  // network, update local and global indexes, etc.
+  linkComponents();
+
+  if (!p_no_print) {
+    std::cout << me << ": "
+      << "I have " 
+      << p_buses.size() << " buses and "
+      << p_branches.size() << " branches"
+      << std::endl;
+  }
+}
+
+
+
+/**
+ * Set local bus indices of branches, the branch neighbors of buses and the
+ * pointers between bus and branch components. This assumes that each
+ * process has a self-contained network with global indices assigned to
+ * all buses and to both ends of all branches.
+ */
+void linkComponents(void)
+{
+
+  // make an index of global bus index to local index and update
+  // the branch local bus indexes
+  int active_buses(0), active_branches(0);
+  int nbranch;
+  {
+    std::map<int, int> busindexes;
+    int lidx(0);
+    for (BusIterator b = p_buses.begin(); b != p_buses.end(); ++b, ++lidx) {
+      clearBranchNeighbors(lidx);
+      // Components that were kept from an earlier distribution still
+      // point to their old neighbors
+      b->p_bus->clearBranches();
+      b->p_bus->clearBuses();
+      busindexes[b->p_globalBusIndex] = lidx;
+      if (b->p_activeBus) active_buses += 1;
+    }
+
+    // go through the branches and set the local bus indexes and pointers
+    lidx = 0;
+    for (BranchIterator b = p_branches.begin(); b != p_branches.end(); ++b, ++lidx) {
+      int gbus, lbus1, lbus2;
+      BusPtr bus1, bus2;
+
+      // set local indexes
+
+      gbus = b->p_globalBusIndex1;
+      lbus1 = busindexes[gbus];
+      bus1 = p_buses[lbus1].p_bus;
+
+      gbus = b->p_globalBusIndex2;
+      lbus2 = busindexes[gbus];
+      bus2 = p_buses[lbus2].p_bus;
+
+      b->p_localBusIndex1 = lbus1;
+      addBranchNeighbor(lbus1, lidx);
+
+      b->p_localBusIndex2 = lbus2;
+      addBranchNeighbor(lbus2, lidx);
+
+      // set component pointers
+
+      b->p_branch->setBus1(bus1);
+      b->p_branch->setBus2(bus2);
+
+      gbus = b->p_globalBusIndex1;
+      bus1->addBranch(b->p_branch);
+      bus1->addBus(bus2);
+      setGlobalBusIndex1(lidx,gbus); 
+      gbus = b->p_globalBusIndex2;
+      bus2->addBranch(b->p_branch);
+      bus2->addBus(bus1);
+      setGlobalBusIndex2(lidx,gbus); 
+
+      if (b->p_activeBranch) active_branches += 1;
+    }
+  }
+  setMap();
+
+  /* initialize network analytics functionality */
+  int nbus = p_buses.size();
+  for (size_t i=0; i<nbus; i++) {
+    getBus(i)->setData(getBusData(i));
+  }
+  nbranch = p_branches.size();
+  for (size_t i=0; i<nbranch; i++) {
+    getBranch(i)->setData(getBranchData(i));
+  }
+
+
+}
+
+/**
+ * Name of snapshot file written by a process
+ * @param prefix path and file name prefix of snapshot
+ * @param nprocs number of processes
+ * @param rank rank of process
+ */
+static std::string snapshotFile(const std::string &prefix, int nprocs,
+    int rank)
+{
+  char buf[64];
+  sprintf(buf,".%d.%d.gpsnap",nprocs,rank);
+  return prefix + buf;
+}
+
+/**
+ * Append plain data to snapshot buffer
+ */
+template <typename T>
+static void snapshotAppend(std::vector<char> &buf, const T *values, int n)
+{
+  if (n <= 0) return;
+  size_t size = buf.size();
+  buf.resize(size + n*sizeof(T));
+  memcpy(&buf[size], values, n*sizeof(T));
+}
+
+/**
+ * Copy plain data out of snapshot and advance pointer
+ */
+template <typename T>
+static void snapshotRead(const char *&ptr, T *values, int n)
+{
+  if (n <= 0) return;
+  memcpy(values, ptr, n*sizeof(T));
+  ptr += n*sizeof(T);
+}
+
 private:
 
   // add some typedefs so things are more readable and we don't have
@@ -2647,6 +3618,15 @@ private:
   void *p_branchSndBuf;
   void *p_branchRcvBuf;
 
+  /**
+   * Point-to-point exchange plans for ghost buses and branches. These are
+   * only set if useNeighborExchange has been called with a true argument
+   */
+  bool p_neighborXC;
+  bool p_sharedXC;
+  boost::shared_ptr<parallel::GhostExchange> p_busNeighborXC;
+  boost::shared_ptr<parallel::GhostExchange> p_branchNeighborXC;
+
   /**
    * Map structures that can map between Original and local indices
    */
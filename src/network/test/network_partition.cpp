@@ -36,21 +36,36 @@ public:
 
   /// Default constructor.
   BogusBus(void)
-    : gridpack::component::BaseBusComponent()
+    : gridpack::component::BaseBusComponent(), p_marker(0)
   {}
 
   /// Destructor
   ~BogusBus(void)
   {}
 
+  /// Set a value that is carried along when the bus moves
+  void setMarker(const int& marker)
+  {
+    p_marker = marker;
+  }
+
+  /// Get the value set with setMarker()
+  int getMarker(void) const
+  {
+    return p_marker;
+  }
+
 private:
 
+  int p_marker;
+
   friend class boost::serialization::access;
 
   template<class Archive>
   void serialize(Archive & ar, const unsigned int version)
   {
-    ar & boost::serialization::base_object<BaseBusComponent>(*this);
+    ar & boost::serialization::base_object<BaseBusComponent>(*this)
+      & p_marker;
   }  
 };
 
@@ -341,6 +356,72 @@ BOOST_AUTO_TEST_CASE (branch_data_shuffle)
 
 }  
 
+BOOST_AUTO_TEST_CASE (flat_data_shuffle)
+{
+  gridpack::parallel::Communicator world;
+  const int local_size(3);
+  typedef gridpack::network::BusData<BogusBus> BogusBusData;
+  typedef gridpack::network::BranchData<BogusBranch> BogusBranchData;
+  char key[] = "AValue";
+  char label[] = "ALabel";
+
+  // bus and branch records shuffled by value use the flat packers
+  std::vector<BogusBusData> buses;
+  std::vector<BogusBranchData> branches;
+  std::vector<int> dest;
+  if (world.rank() == 0) {
+    for (int i = 0; i < local_size*world.size(); ++i) {
+      BogusBusData bus;
+      bus.p_originalBusIndex = i;
+      bus.p_globalBusIndex = i;
+      bus.p_branchNeighbors.push_back(i);
+      bus.p_refFlag = (i == 0);
+      bus.p_data->addValue(key, i);
+      bus.p_data->addValue(label, "bus", i);
+      buses.push_back(bus);
+      BogusBranchData branch;
+      branch.p_globalBranchIndex = i;
+      branch.p_originalBusIndex1 = i;
+      branch.p_originalBusIndex2 = i+1;
+      branch.p_activeBranch = false;
+      branch.p_data->addValue(key, 2.0*i);
+      branches.push_back(branch);
+      dest.push_back(i % world.size());
+    }
+  }
+
+  gridpack::parallel::Shuffler<BogusBusData> bus_shuffler(world);
+  bus_shuffler(buses, dest);
+  gridpack::parallel::Shuffler<BogusBranchData> branch_shuffler(world);
+  branch_shuffler(branches, dest);
+
+  BOOST_CHECK_EQUAL(buses.size(), local_size);
+  BOOST_CHECK_EQUAL(branches.size(), local_size);
+  for (int i = 0; i < buses.size(); ++i) {
+    int idx = buses[i].p_originalBusIndex;
+    int ival;
+    std::string sval;
+    BOOST_CHECK_EQUAL(idx % world.size(), world.rank());
+    BOOST_CHECK_EQUAL(buses[i].p_globalBusIndex, idx);
+    BOOST_CHECK_EQUAL(buses[i].p_branchNeighbors.size(), 1);
+    BOOST_CHECK_EQUAL(buses[i].p_branchNeighbors[0], idx);
+    BOOST_CHECK_EQUAL(buses[i].p_refFlag, (idx == 0));
+    BOOST_CHECK(buses[i].p_data->getValue(key, &ival));
+    BOOST_CHECK_EQUAL(ival, idx);
+    BOOST_CHECK(buses[i].p_data->getValue(label, &sval, idx));
+    BOOST_CHECK_EQUAL(sval, "bus");
+  }
+  for (int i = 0; i < branches.size(); ++i) {
+    int idx = branches[i].p_globalBranchIndex;
+    double rval;
+    BOOST_CHECK_EQUAL(idx % world.size(), world.rank());
+    BOOST_CHECK_EQUAL(branches[i].p_originalBusIndex2, idx+1);
+    BOOST_CHECK(!branches[i].p_activeBranch);
+    BOOST_CHECK(branches[i].p_data->getValue(key, &rval));
+    BOOST_CHECK_EQUAL(rval, 2.0*idx);
+  }
+}
+
 BOOST_AUTO_TEST_CASE (branch_data_serialization )
 {
   gridpack::parallel::Communicator world;
@@ -427,6 +508,185 @@ BOOST_AUTO_TEST_CASE ( lattice_partition )
   net.writeGraph("lattice-after.dot");
 }
 
+BOOST_AUTO_TEST_CASE ( lattice_snapshot )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(5), cols(5);
+  BogusLatticeNetwork net(world, rows, cols);
+  int i;
+  for (i = 0; i < net.numBuses(); ++i) {
+    net.getBusData(i)->addValue("BUS_VALUE", 2.0*net.getOriginalBusIndex(i));
+  }
+  net.getNetworkData()->addValue("CASE_NAME", "lattice");
+  net.partition();
+  net.saveSnapshot("lattice-snapshot", 17);
+
+  // A snapshot with a different stamp is not used
+  BogusLatticeNetwork empty(world, 0, 0);
+  BOOST_CHECK(!empty.loadSnapshot("lattice-snapshot", 18));
+  BOOST_CHECK_EQUAL(empty.numBuses(), 0);
+
+  BogusLatticeNetwork copy(world, 0, 0);
+  BOOST_CHECK(copy.loadSnapshot("lattice-snapshot", 17));
+  BOOST_CHECK_EQUAL(copy.numBuses(), net.numBuses());
+  BOOST_CHECK_EQUAL(copy.numBranches(), net.numBranches());
+  BOOST_CHECK_EQUAL(copy.totalBuses(), rows*cols);
+  for (i = 0; i < net.numBuses(); ++i) {
+    BOOST_CHECK_EQUAL(copy.getOriginalBusIndex(i), net.getOriginalBusIndex(i));
+    BOOST_CHECK_EQUAL(copy.getGlobalBusIndex(i), net.getGlobalBusIndex(i));
+    BOOST_CHECK_EQUAL(copy.getActiveBus(i), net.getActiveBus(i));
+    BOOST_CHECK(copy.getConnectedBranches(i) == net.getConnectedBranches(i));
+    double value;
+    BOOST_CHECK(copy.getBusData(i)->getValue("BUS_VALUE", &value));
+    BOOST_CHECK_EQUAL(value, 2.0*net.getOriginalBusIndex(i));
+  }
+  for (i = 0; i < net.numBranches(); ++i) {
+    int b1, b2, c1, c2;
+    net.getBranchEndpoints(i, &b1, &b2);
+    copy.getBranchEndpoints(i, &c1, &c2);
+    BOOST_CHECK_EQUAL(c1, b1);
+    BOOST_CHECK_EQUAL(c2, b2);
+    BOOST_CHECK_EQUAL(copy.getGlobalBranchIndex(i), net.getGlobalBranchIndex(i));
+    BOOST_CHECK_EQUAL(copy.getActiveBranch(i), net.getActiveBranch(i));
+  }
+  std::string name;
+  BOOST_CHECK(copy.getNetworkData()->getValue("CASE_NAME", &name));
+  BOOST_CHECK_EQUAL(name, std::string("lattice"));
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_repartition )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(8), cols(8);
+  BogusLatticeNetwork net(world, rows, cols);
+  net.partition();
+
+  // Buses in the first rows are much more expensive than the rest
+  std::vector<double> weights(net.numBuses());
+  double load(0.0), before, after;
+  int i;
+  for (i = 0; i < net.numBuses(); ++i) {
+    weights[i] = (net.getOriginalBusIndex(i) < 2*cols ? 20.0 : 1.0);
+    if (net.getActiveBus(i)) load += weights[i];
+  }
+  boost::mpi::all_reduce(world, load, before, boost::mpi::maximum<double>());
+  for (i = 0; i < net.numBuses(); ++i) {
+    net.getBus(i)->setMarker(3*net.getOriginalBusIndex(i));
+  }
+
+  int moved = net.repartition(weights, 1.1);
+  if (world.size() == 1) {
+    BOOST_CHECK_EQUAL(moved, 0);
+  }
+  BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+  int nbranch(0), branches;
+  for (i = 0; i < net.numBranches(); ++i) {
+    if (net.getActiveBranch(i)) nbranch++;
+  }
+  boost::mpi::all_reduce(world, nbranch, branches, std::plus<int>());
+  BOOST_CHECK_EQUAL(branches, 2*rows*cols - rows - cols);
+
+  // Buses that moved keep the state of their components
+  for (i = 0; i < net.numBuses(); ++i) {
+    if (net.getActiveBus(i)) {
+      BOOST_CHECK_EQUAL(net.getBus(i)->getMarker(),
+                        3*net.getOriginalBusIndex(i));
+    }
+  }
+
+  load = 0.0;
+  for (i = 0; i < net.numBuses(); ++i) {
+    if (net.getActiveBus(i)) {
+      load += (net.getOriginalBusIndex(i) < 2*cols ? 20.0 : 1.0);
+    }
+  }
+  boost::mpi::all_reduce(world, load, after, boost::mpi::maximum<double>());
+  BOOST_CHECK(after <= before);
+  if (world.rank() == 0) {
+    std::cout << "repartition moved " << moved << " buses, maximum cost "
+              << before << " -> " << after << std::endl;
+  }
+
+  // A balanced network is left alone
+  std::vector<double> unit(net.numBuses(), 1.0);
+  BOOST_CHECK_EQUAL(net.repartition(unit, 1.0e6), 0);
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_weighted_partition )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(8), cols(8);
+  BogusLatticeNetwork net(world, rows, cols);
+  net.partition();
+
+  // Partition the already distributed network again with buses in the
+  // first rows much more expensive than the rest
+  std::vector<int> busWeights(net.numBuses());
+  std::vector<int> branchWeights(net.numBranches(), 1);
+  int i;
+  for (i = 0; i < net.numBuses(); ++i) {
+    busWeights[i] = (net.getOriginalBusIndex(i) < 2*cols ? 20 : 1);
+  }
+  net.partition(busWeights, branchWeights);
+  BOOST_CHECK_EQUAL(net.totalBuses(), rows*cols);
+  int nbranch(0), branches;
+  for (i = 0; i < net.numBranches(); ++i) {
+    if (net.getActiveBranch(i)) nbranch++;
+  }
+  boost::mpi::all_reduce(world, nbranch, branches, std::plus<int>());
+  BOOST_CHECK_EQUAL(branches, 2*rows*cols - rows - cols);
+
+  int load(0), total, lmax;
+  for (i = 0; i < net.numBuses(); ++i) {
+    if (net.getActiveBus(i)) {
+      load += (net.getOriginalBusIndex(i) < 2*cols ? 20 : 1);
+    }
+  }
+  boost::mpi::all_reduce(world, load, total, std::plus<int>());
+  boost::mpi::all_reduce(world, load, lmax, boost::mpi::maximum<int>());
+  BOOST_CHECK_EQUAL(total, 20*2*cols + (rows-2)*cols);
+  BOOST_CHECK(static_cast<double>(lmax*world.size()) <= 1.5*total);
+}
+
+BOOST_AUTO_TEST_CASE ( lattice_neighbor_exchange )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(8), cols(8);
+  BogusLatticeNetwork net(world, rows, cols);
+
+  // After partitioning, the global indices owned by a process are not a
+  // contiguous block, so the exchange has to find the owner of each ghost
+  net.partition();
+  net.allocXCBus(sizeof(int));
+  net.allocXCBranch(sizeof(int));
+  int i, shared;
+  for (shared = 0; shared < 2; ++shared) {
+    net.useNeighborExchange(true, shared == 1);
+    net.initBusUpdate();
+    net.initBranchUpdate();
+    for (i = 0; i < net.numBuses(); ++i) {
+      int *iptr = static_cast<int*>(net.getXCBusBuffer(i));
+      *iptr = (net.getActiveBus(i) ? net.getGlobalBusIndex(i) : -1);
+    }
+    for (i = 0; i < net.numBranches(); ++i) {
+      int *iptr = static_cast<int*>(net.getXCBranchBuffer(i));
+      *iptr = (net.getActiveBranch(i) ? net.getGlobalBranchIndex(i) : -1);
+    }
+    net.updateBuses();
+    net.updateBranches();
+    for (i = 0; i < net.numBuses(); ++i) {
+      int *iptr = static_cast<int*>(net.getXCBusBuffer(i));
+      BOOST_CHECK_EQUAL(*iptr, net.getGlobalBusIndex(i));
+    }
+    for (i = 0; i < net.numBranches(); ++i) {
+      int *iptr = static_cast<int*>(net.getXCBranchBuffer(i));
+      BOOST_CHECK_EQUAL(*iptr, net.getGlobalBranchIndex(i));
+    }
+  }
+  net.useNeighborExchange(false);
+  net.freeXCBus();
+  net.freeXCBranch();
+}
 
 BOOST_AUTO_TEST_SUITE_END( )
 
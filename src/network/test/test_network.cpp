@@ -629,6 +629,95 @@ BOOST_AUTO_TEST_CASE( TestNetworkTopology )
   }
   BOOST_CHECK(ok);
 
+  // Repeat ghost updates using point-to-point exchange between neighbors
+  for (i=0; i<nbus; i++) {
+    iptr = (int*)network.getXCBusBuffer(i);
+    if (!network.getActiveBus(i)) *iptr = -1;
+  }
+  for (i=0; i<nbranch; i++) {
+    iptr = (int*)network.getXCBranchBuffer(i);
+    if (!network.getActiveBranch(i)) *iptr = -1;
+  }
+  network.useNeighborExchange(true);
+  network.initBusUpdate();
+  network.initBranchUpdate();
+
+  network.updateBuses();
+  network.updateBranches();
+
+  ok = true;
+  for (i=0; i<nbus; i++) {
+    iptr = (int*)network.getXCBusBuffer(i);
+    if (!network.getActiveBus(i)) {
+      if (*iptr != network.getGlobalBusIndex(i)) {
+        ok = false;
+      }
+    }
+  }
+  for (i=0; i<nbranch; i++) {
+    iptr = (int*)network.getXCBranchBuffer(i);
+    if (!network.getActiveBranch(i)) {
+      if (*iptr != network.getGlobalBranchIndex(i)) {
+        ok = false;
+      }
+    }
+  }
+  oks = (int)ok;
+  ierr = MPI_Allreduce(&oks, &okr, 1, MPI_INT, MPI_PROD, mpi_world);
+  ok = (bool)okr;
+  if (me == 0 && ok) {
+    printf("\nNeighbor exchange update ok\n");
+  } else if (!ok) {
+    printf("\nMismatched neighbor exchange update on %d\n",me);
+  }
+  BOOST_CHECK(ok);
+
+  // Repeat using shared memory between processes on the same node. Update
+  // twice, since alternate updates use different shared buffers
+  network.useNeighborExchange(true, true);
+  network.initBusUpdate();
+  network.initBranchUpdate();
+  int iter;
+  ok = true;
+  for (iter=0; iter<2; iter++) {
+    for (i=0; i<nbus; i++) {
+      iptr = (int*)network.getXCBusBuffer(i);
+      if (network.getActiveBus(i)) {
+        *iptr = network.getGlobalBusIndex(i) + iter;
+      } else {
+        *iptr = -1;
+      }
+    }
+    for (i=0; i<nbranch; i++) {
+      iptr = (int*)network.getXCBranchBuffer(i);
+      if (network.getActiveBranch(i)) {
+        *iptr = network.getGlobalBranchIndex(i) + iter;
+      } else {
+        *iptr = -1;
+      }
+    }
+    network.updateBuses();
+    network.updateBranches();
+    for (i=0; i<nbus; i++) {
+      iptr = (int*)network.getXCBusBuffer(i);
+      if (*iptr != network.getGlobalBusIndex(i) + iter) ok = false;
+    }
+    for (i=0; i<nbranch; i++) {
+      iptr = (int*)network.getXCBranchBuffer(i);
+      if (*iptr != network.getGlobalBranchIndex(i) + iter) ok = false;
+    }
+  }
+  oks = (int)ok;
+  ierr = MPI_Allreduce(&oks, &okr, 1, MPI_INT, MPI_PROD, mpi_world);
+  ok = (bool)okr;
+  if (me == 0 && ok) {
+    printf("\nShared memory exchange update ok\n");
+  } else if (!ok) {
+    printf("\nMismatched shared memory exchange update on %d\n",me);
+  }
+  BOOST_CHECK(ok);
+  network.useNeighborExchange(false);
+
   network.freeXCBus();
   network.freeXCBranch();
 
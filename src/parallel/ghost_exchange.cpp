@@ -0,0 +1,423 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   ghost_exchange.cpp
+ *
+ * @brief
+ * Point-to-point exchange of fixed size data buffers between owned
+ * elements and their ghost copies on other processes.
+ *
+ */
+
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include "gridpack/utilities/exception.hpp"
+#include "ghost_exchange.hpp"
+#include "threads.hpp"
+
+#define GHOST_XC_TAG 2718
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class GhostExchange
+// -------------------------------------------------------------
+
+// Default constructor
+GhostExchange::GhostExchange(const Communicator &comm)
+  : p_world(comm)
+{
+  p_comm = static_cast<MPI_Comm>(comm);
+  p_me = comm.rank();
+  p_nprocs = comm.size();
+  p_size = 0;
+  p_useShared = false;
+  p_shrBuf = NULL;
+  p_half = 0;
+}
+
+// Default destructor
+GhostExchange::~GhostExchange(void)
+{
+  clear();
+}
+
+// Release persistent requests and buffers
+void GhostExchange::clear(void)
+{
+  int i;
+  for (i=0; i<p_requests.size(); i++) {
+    MPI_Request_free(&p_requests[i]);
+  }
+  p_requests.clear();
+  for (i=0; i<p_altRequests.size(); i++) {
+    MPI_Request_free(&p_altRequests[i]);
+  }
+  p_altRequests.clear();
+  if (p_shrBuf != NULL) {
+    MPI_Win_unlock_all(p_win);
+    MPI_Win_free(&p_win);
+    p_shrBuf = NULL;
+  }
+  p_shrProcs.clear();
+  p_shrBase.clear();
+  p_shrHalf.clear();
+  p_shrOffset.clear();
+  p_half = 0;
+  p_sndProcs.clear();
+  p_sndOffset.clear();
+  p_sndLocal.clear();
+  p_sndBuf.clear();
+  p_rcvProcs.clear();
+  p_rcvOffset.clear();
+  p_rcvLocal.clear();
+  p_rcvBuf.clear();
+}
+
+// Send a list of integers to each process and receive the lists that other
+// processes send to this one
+void GhostExchange::exchangeLists(const std::vector<int> &sndCount,
+    const std::vector<int> &sndData, std::vector<int> &rcvCount,
+    std::vector<int> &rcvData)
+{
+  int p;
+  rcvCount.resize(p_nprocs);
+  MPI_Alltoall(const_cast<int*>(&sndCount[0]),1,MPI_INT,&rcvCount[0],1,
+      MPI_INT,p_comm);
+  std::vector<int> sndDispl(p_nprocs,0), rcvDispl(p_nprocs,0);
+  for (p=1; p<p_nprocs; p++) {
+    sndDispl[p] = sndDispl[p-1] + sndCount[p-1];
+    rcvDispl[p] = rcvDispl[p-1] + rcvCount[p-1];
+  }
+  rcvData.resize(rcvDispl[p_nprocs-1]+rcvCount[p_nprocs-1]);
+  // Make sure buffers are never empty so that taking their address is legal
+  int dummy = 0;
+  MPI_Alltoallv(sndData.size() > 0 ? const_cast<int*>(&sndData[0]) : &dummy,
+      const_cast<int*>(&sndCount[0]),&sndDispl[0],MPI_INT,
+      rcvData.size() > 0 ? &rcvData[0] : &dummy,&rcvCount[0],&rcvDispl[0],
+      MPI_INT,p_comm);
+}
+
+// Throw an exception on all processes if any process found an error
+void GhostExchange::checkError(int err, const char *msg)
+{
+  int gerr;
+  MPI_Allreduce(&err,&gerr,1,MPI_INT,MPI_MAX,p_comm);
+  if (gerr == 0) return;
+  char buf[256];
+  if (err != 0) {
+    sprintf(buf,"p[%d] GhostExchange::setup: %s\n",p_me,msg);
+  } else {
+    sprintf(buf,"p[%d] GhostExchange::setup: error on another process\n",
+        p_me);
+  }
+  throw gridpack::Exception(buf);
+}
+
+// Set up the exchange plan
+void GhostExchange::setup(int size,
+    const std::vector<int> &ownedGlobal, const std::vector<int> &ownedLocal,
+    const std::vector<int> &ghostGlobal, const std::vector<int> &ghostLocal)
+{
+  int i, j, p;
+  clear();
+  p_size = size;
+
+  // Owners of ghost elements are found through a directory. Global indices
+  // are assigned to directory processes in contiguous blocks and each
+  // process registers the elements it owns with the directory process of
+  // their index. Nothing is assumed about which indices a process owns.
+  int nowned = ownedGlobal.size();
+  int nghost = ghostGlobal.size();
+  int err = 0;
+  int lmax = -1;
+  for (i=0; i<nowned; i++) {
+    if (ownedGlobal[i] < 0) err = 1;
+    if (ownedGlobal[i] > lmax) lmax = ownedGlobal[i];
+  }
+  for (i=0; i<nghost; i++) {
+    if (ghostGlobal[i] < 0) err = 1;
+    if (ghostGlobal[i] > lmax) lmax = ghostGlobal[i];
+  }
+  checkError(err,"negative global index");
+  int gmax;
+  MPI_Allreduce(&lmax,&gmax,1,MPI_INT,MPI_MAX,p_comm);
+  int block = gmax/p_nprocs + 1;
+
+  // Register owned elements with the directory
+  std::vector<int> sndCount(p_nprocs,0), rcvCount;
+  std::vector<std::pair<int,int> > order(nowned);
+  for (i=0; i<nowned; i++) {
+    order[i] = std::pair<int,int>(ownedGlobal[i]/block,ownedGlobal[i]);
+    sndCount[order[i].first]++;
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<int> sndData(nowned), rcvData;
+  for (i=0; i<nowned; i++) sndData[i] = order[i].second;
+  exchangeLists(sndCount,sndData,rcvCount,rcvData);
+  std::map<int,int> directory;
+  j = 0;
+  for (p=0; p<p_nprocs; p++) {
+    for (i=0; i<rcvCount[p]; i++) {
+      if (!directory.insert(std::pair<int,int>(rcvData[j],p)).second) {
+        err = 1;
+      }
+      j++;
+    }
+  }
+  checkError(err,"element owned by more than one process");
+
+  // Ask the directory for the owner of each ghost element. Replies come
+  // back in the same order as the requests.
+  order.resize(nghost);
+  std::fill(sndCount.begin(), sndCount.end(), 0);
+  for (i=0; i<nghost; i++) {
+    order[i] = std::pair<int,int>(ghostGlobal[i]/block,i);
+    sndCount[order[i].first]++;
+  }
+  std::sort(order.begin(), order.end());
+  sndData.resize(nghost);
+  for (i=0; i<nghost; i++) sndData[i] = ghostGlobal[order[i].second];
+  exchangeLists(sndCount,sndData,rcvCount,rcvData);
+  std::map<int,int>::iterator it;
+  for (i=0; i<rcvData.size(); i++) {
+    it = directory.find(rcvData[i]);
+    rcvData[i] = (it == directory.end() ? -1 : it->second);
+  }
+  std::vector<int> replyCount, reply;
+  exchangeLists(rcvCount,rcvData,replyCount,reply);
+
+  // Sort ghosts by owner
+  std::vector<std::pair<int,int> > owners(nghost);
+  for (i=0; i<nghost; i++) {
+    p = reply[i];
+    if (p < 0 || p == p_me) err = 1;
+    owners[i] = std::pair<int,int>(p,order[i].second);
+  }
+  checkError(err,"no owner for ghost element");
+  std::sort(owners.begin(), owners.end());
+
+  rcvCount.assign(p_nprocs,0);
+  sndCount.assign(p_nprocs,0);
+  std::vector<int> request(nghost);
+  p_rcvLocal.resize(nghost);
+  for (i=0; i<nghost; i++) {
+    p = owners[i].first;
+    if (rcvCount[p] == 0) {
+      p_rcvProcs.push_back(p);
+      p_rcvOffset.push_back(i);
+    }
+    rcvCount[p]++;
+    request[i] = ghostGlobal[owners[i].second];
+    p_rcvLocal[i] = ghostLocal[owners[i].second];
+  }
+  p_rcvOffset.push_back(nghost);
+
+  // Tell owners how many elements each process needs from them. This is the
+  // only collective in the exchange and it is only called once.
+  MPI_Alltoall(&rcvCount[0],1,MPI_INT,&sndCount[0],1,MPI_INT,p_comm);
+
+  int nsnd = 0;
+  for (p=0; p<p_nprocs; p++) {
+    if (sndCount[p] > 0) {
+      p_sndProcs.push_back(p);
+      p_sndOffset.push_back(nsnd);
+      nsnd += sndCount[p];
+    }
+  }
+  p_sndOffset.push_back(nsnd);
+
+  // Send list of requested global indices to owners
+  std::vector<int> sndGlobal(nsnd);
+  std::vector<MPI_Request> ireq;
+  MPI_Request req;
+  for (i=0; i<p_sndProcs.size(); i++) {
+    MPI_Irecv(&sndGlobal[p_sndOffset[i]],p_sndOffset[i+1]-p_sndOffset[i],
+        MPI_INT,p_sndProcs[i],GHOST_XC_TAG,p_comm,&req);
+    ireq.push_back(req);
+  }
+  for (i=0; i<p_rcvProcs.size(); i++) {
+    MPI_Isend(&request[p_rcvOffset[i]],p_rcvOffset[i+1]-p_rcvOffset[i],
+        MPI_INT,p_rcvProcs[i],GHOST_XC_TAG,p_comm,&req);
+    ireq.push_back(req);
+  }
+  if (ireq.size() > 0) {
+    MPI_Waitall(ireq.size(),&ireq[0],MPI_STATUSES_IGNORE);
+  }
+
+  // Convert requested global indices to local indices of owned elements
+  std::map<int,int> o_map;
+  for (i=0; i<ownedGlobal.size(); i++) {
+    o_map.insert(std::pair<int,int>(ownedGlobal[i],ownedLocal[i]));
+  }
+  p_sndLocal.resize(nsnd);
+  for (i=0; i<nsnd; i++) {
+    it = o_map.find(sndGlobal[i]);
+    if (it == o_map.end()) {
+      err = 1;
+      p_sndLocal[i] = 0;
+    } else {
+      p_sndLocal[i] = it->second;
+    }
+  }
+  checkError(err,"requested element is not owned by process");
+
+  // Processes on the same node read their data directly from the send
+  // buffer of the owner, so they need to know where it starts
+  std::vector<int> onNode(p_rcvProcs.size(), 0);
+  if (p_useShared) {
+    if (!p_nodes) p_nodes.reset(new NodeCommunicator(p_world));
+    std::vector<int> rcvStart(p_rcvProcs.size());
+    ireq.clear();
+    for (i=0; i<p_rcvProcs.size(); i++) {
+      if (p_nodes->nodeRank(p_rcvProcs[i]) < 0) continue;
+      MPI_Irecv(&rcvStart[i],1,MPI_INT,p_rcvProcs[i],GHOST_XC_TAG,p_comm,&req);
+      ireq.push_back(req);
+    }
+    for (i=0; i<p_sndProcs.size(); i++) {
+      if (p_nodes->nodeRank(p_sndProcs[i]) < 0) continue;
+      MPI_Isend(&p_sndOffset[i],1,MPI_INT,p_sndProcs[i],GHOST_XC_TAG,p_comm,
+          &req);
+      ireq.push_back(req);
+    }
+    if (ireq.size() > 0) {
+      MPI_Waitall(ireq.size(),&ireq[0],MPI_STATUSES_IGNORE);
+    }
+
+    // Each process allocates two copies of its send buffer in a window that
+    // is shared on the node
+    MPI_Aint bytes = static_cast<MPI_Aint>(2*nsnd*p_size);
+    void *ptr;
+    if (MPI_Win_allocate_shared(bytes,1,MPI_INFO_NULL,p_nodes->getNode(),
+          &ptr,&p_win) != MPI_SUCCESS) {
+      char buf[256];
+      sprintf(buf,"p[%d] GhostExchange::setup: unable to allocate shared"
+          " memory\n",p_me);
+      throw gridpack::Exception(buf);
+    }
+    p_shrBuf = static_cast<char*>(ptr);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, p_win);
+    for (i=0; i<p_rcvProcs.size(); i++) {
+      int rank = p_nodes->nodeRank(p_rcvProcs[i]);
+      if (rank < 0) continue;
+      MPI_Aint size;
+      int disp;
+      MPI_Win_shared_query(p_win,rank,&size,&disp,&ptr);
+      onNode[i] = 1;
+      p_shrProcs.push_back(i);
+      p_shrBase.push_back(static_cast<char*>(ptr));
+      p_shrHalf.push_back(static_cast<long>(size/2));
+      p_shrOffset.push_back(rcvStart[i]);
+    }
+  }
+
+  // Create persistent requests. Receives are listed first so that they are
+  // posted before the matching sends are started. Processes on the same
+  // node are left out if shared memory is used.
+  p_sndBuf.resize(nsnd*p_size);
+  p_rcvBuf.resize(nghost*p_size);
+  int half;
+  for (half=0; half<(p_useShared ? 2 : 1); half++) {
+    std::vector<MPI_Request> &requests = (half == 0 ? p_requests :
+        p_altRequests);
+    char *sndBuf = p_useShared ? p_shrBuf + half*nsnd*p_size : &p_sndBuf[0];
+    for (i=0; i<p_rcvProcs.size(); i++) {
+      if (onNode[i]) continue;
+      MPI_Recv_init(&p_rcvBuf[0]+p_rcvOffset[i]*p_size,
+          (p_rcvOffset[i+1]-p_rcvOffset[i])*p_size,MPI_BYTE,p_rcvProcs[i],
+          GHOST_XC_TAG,p_comm,&req);
+      requests.push_back(req);
+    }
+    for (i=0; i<p_sndProcs.size(); i++) {
+      if (p_useShared && p_nodes->nodeRank(p_sndProcs[i]) >= 0) continue;
+      MPI_Send_init(sndBuf+p_sndOffset[i]*p_size,
+          (p_sndOffset[i+1]-p_sndOffset[i])*p_size,MPI_BYTE,p_sndProcs[i],
+          GHOST_XC_TAG,p_comm,&req);
+      requests.push_back(req);
+    }
+  }
+  if (p_useShared) p_sndBuf.clear();
+}
+
+// Copy data from buffers of owned elements to the buffers of their ghosts
+void GhostExchange::exchange(void **buffers)
+{
+  int i, j, k;
+  int nsnd = p_sndLocal.size();
+  char *sndBuf = NULL;
+  if (p_useShared) {
+    sndBuf = p_shrBuf + p_half*nsnd*p_size;
+  } else if (nsnd > 0) {
+    sndBuf = &p_sndBuf[0];
+  }
+  // Copies are only spread over threads if there are enough of them to pay
+  // for starting the threads
+  int nthr = gridpack::parallel::Threads::get();
+  if (nsnd < p_minThreadCopies) nthr = 1;
+  GRIDPACK_PARALLEL_FOR(nthr)
+  for (i=0; i<nsnd; i++) {
+    memcpy(sndBuf+static_cast<size_t>(i)*p_size, buffers[p_sndLocal[i]],
+        p_size);
+  }
+  char *ptr;
+  std::vector<MPI_Request> &requests = (p_half == 0 ? p_requests :
+      p_altRequests);
+  if (requests.size() > 0) {
+    MPI_Startall(requests.size(),&requests[0]);
+  }
+  if (p_useShared) {
+    // Wait until all processes on the node have filled their send buffers
+    // and then copy data for ghosts owned by processes on the node directly
+    // into the local buffers. The other half of the send buffers is used in
+    // the next exchange, so nothing is overwritten before it has been read.
+    MPI_Win_sync(p_win);
+    MPI_Barrier(p_nodes->getNode());
+    MPI_Win_sync(p_win);
+    for (k=0; k<p_shrProcs.size(); k++) {
+      int p = p_shrProcs[k];
+      ptr = p_shrBase[k] + p_half*p_shrHalf[k] + p_shrOffset[k]*p_size;
+      for (j=p_rcvOffset[p]; j<p_rcvOffset[p+1]; j++) {
+        memcpy(buffers[p_rcvLocal[j]], ptr, p_size);
+        ptr += p_size;
+      }
+    }
+    p_half = 1 - p_half;
+  }
+  if (requests.size() > 0) {
+    MPI_Waitall(requests.size(),&requests[0],MPI_STATUSES_IGNORE);
+  }
+  int nrcv = p_rcvLocal.size();
+  if (p_shrProcs.empty() && nrcv >= p_minThreadCopies) {
+    nthr = gridpack::parallel::Threads::get();
+    GRIDPACK_PARALLEL_FOR(nthr)
+    for (j=0; j<nrcv; j++) {
+      memcpy(buffers[p_rcvLocal[j]], &p_rcvBuf[0]+static_cast<size_t>(j)*p_size,
+          p_size);
+    }
+    return;
+  }
+  k = 0;
+  for (i=0; i<p_rcvProcs.size(); i++) {
+    if (k < p_shrProcs.size() && p_shrProcs[k] == i) {
+      k++;
+      continue;
+    }
+    ptr = &p_rcvBuf[0] + p_rcvOffset[i]*p_size;
+    for (j=p_rcvOffset[i]; j<p_rcvOffset[i+1]; j++) {
+      memcpy(buffers[p_rcvLocal[j]], ptr, p_size);
+      ptr += p_size;
+    }
+  }
+}
+
+} // namespace parallel
+} // namespace gridpack
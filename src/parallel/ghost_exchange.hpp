@@ -0,0 +1,164 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   ghost_exchange.hpp
+ *
+ * @brief
+ * Point-to-point exchange of fixed size data buffers between owned
+ * elements and their ghost copies on other processes. The exchange plan
+ * is computed once and the data is moved using persistent MPI requests,
+ * so that each update only involves processes that actually share
+ * elements and no global synchronization is required.
+ *
+ */
+
+// -------------------------------------------------------------
+
+#ifndef _ghost_exchange_hpp_
+#define _ghost_exchange_hpp_
+
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include "gridpack/parallel/communicator.hpp"
+#include "gridpack/parallel/shared_array.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class GhostExchange
+// -------------------------------------------------------------
+class GhostExchange {
+public:
+
+  // Default constructor
+  // @param comm communicator over which exchange takes place
+  GhostExchange(const Communicator &comm);
+
+  // Default destructor
+  ~GhostExchange(void);
+
+  // Copy data between processes on the same node through shared memory
+  // instead of messages. Each process leaves the data for its ghosts in a
+  // shared memory window and processes on the same node read it directly.
+  // Processes on other nodes are still reached with messages. This must be
+  // called before setup.
+  // @param flag if true, use shared memory within nodes
+  void useSharedMemory(bool flag)
+  {
+    p_useShared = flag;
+  }
+
+  // Set up the exchange plan. This is a collective operation. Global indices
+  // can be distributed arbitrarily over processes, the owner of each ghost
+  // element is found by exchanging the owned indices with a directory. If
+  // any process finds an error, an exception is thrown on all processes.
+  // @param size size in bytes of data that is exchanged for each element
+  // @param ownedGlobal global indices of elements owned by this process
+  // @param ownedLocal local indices of elements owned by this process
+  // @param ghostGlobal global indices of ghost elements on this process
+  // @param ghostLocal local indices of ghost elements on this process
+  void setup(int size,
+      const std::vector<int> &ownedGlobal, const std::vector<int> &ownedLocal,
+      const std::vector<int> &ghostGlobal, const std::vector<int> &ghostLocal);
+
+  // Copy data from buffers of owned elements to the buffers of their ghosts.
+  // Only processes that share elements communicate with each other.
+  // @param buffers array of buffers indexed by local element index
+  void exchange(void **buffers);
+
+  // Number of processes this process sends data to
+  int numSendNeighbors(void) const
+  {
+    return p_sndProcs.size();
+  }
+
+  // Number of processes this process receives data from
+  int numRecvNeighbors(void) const
+  {
+    return p_rcvProcs.size();
+  }
+
+  // Number of processes on the same node that this process reads data from
+  // directly
+  int numSharedNeighbors(void) const
+  {
+    return p_shrProcs.size();
+  }
+
+private:
+
+  // Release persistent requests and buffers
+  void clear(void);
+
+  // Send a list of integers to each process and receive the lists that
+  // other processes send to this one. This is a collective operation.
+  // @param sndCount number of values sent to each process
+  // @param sndData values sent to each process, ordered by process
+  // @param rcvCount returned number of values received from each process
+  // @param rcvData returned values received from each process
+  void exchangeLists(const std::vector<int> &sndCount,
+      const std::vector<int> &sndData, std::vector<int> &rcvCount,
+      std::vector<int> &rcvData);
+
+  // Throw an exception on all processes if err is set on any process
+  // @param err non-zero if an error was found on this process
+  // @param msg description of the error
+  void checkError(int err, const char *msg);
+
+  // smallest number of buffer copies that is spread over threads
+  static const int p_minThreadCopies = 1024;
+
+  Communicator p_world;
+  MPI_Comm p_comm;
+  int p_me;
+  int p_nprocs;
+  int p_size;
+
+  // processes to send to, offsets into send list for each process and
+  // local indices of owned elements in the order they are sent
+  std::vector<int> p_sndProcs;
+  std::vector<int> p_sndOffset;
+  std::vector<int> p_sndLocal;
+  std::vector<char> p_sndBuf;
+
+  // processes to receive from, offsets into receive list for each process
+  // and local indices of ghost elements in the order they are received
+  std::vector<int> p_rcvProcs;
+  std::vector<int> p_rcvOffset;
+  std::vector<int> p_rcvLocal;
+  std::vector<char> p_rcvBuf;
+
+  // persistent requests (receives followed by sends). If shared memory is
+  // used there is a separate set of requests for each half of the send
+  // buffer
+  std::vector<MPI_Request> p_requests;
+  std::vector<MPI_Request> p_altRequests;
+
+  // shared memory window holding two copies of the send buffer, which are
+  // used in alternate exchanges so that a process can fill one copy while
+  // processes on the same node are still reading the other
+  bool p_useShared;
+  boost::scoped_ptr<NodeCommunicator> p_nodes;
+  MPI_Win p_win;
+  char *p_shrBuf;
+  int p_half;
+
+  // for each process on the same node that this process receives from,
+  // its index in p_rcvProcs, the start of its send buffer and the offset
+  // of the data for this process in that buffer
+  std::vector<int> p_shrProcs;
+  std::vector<char*> p_shrBase;
+  std::vector<long> p_shrHalf;
+  std::vector<int> p_shrOffset;
+};
+
+} // namespace parallel
+} // namespace gridpack
+
+#endif
@@ -21,9 +21,12 @@
 #define _global_store_hpp_
 
 #include <iostream>
+#include <cstring>
 #include <ga.h>
+#include <boost/scoped_ptr.hpp>
 #include "gridpack/utilities/exception.hpp"
 #include "gridpack/parallel/communicator.hpp"
+#include "gridpack/parallel/shared_array.hpp"
 
 namespace gridpack {
 namespace parallel {
@@ -41,9 +44,14 @@ public:
    * Default constructor
    * @param comm communicator over which GlobalStore object runs.
    *             Data is accessible from any process on the communicator
+   * @param shared if true, keep one copy of all data on each node in
+   *             memory that is shared by the processes on the node, instead
+   *             of distributing it over all processes. Reading a vector
+   *             then requires no communication
    */
-  GlobalStore(const gridpack::parallel::Communicator &comm)
-    : p_comm(comm)
+  GlobalStore(const gridpack::parallel::Communicator &comm,
+      bool shared = false)
+    : p_comm(comm), p_shared(shared)
   {
     p_begin = NULL;
     p_end = NULL;
@@ -59,7 +67,7 @@ public:
   ~GlobalStore(void)
   {
     // Assume that if p_begin is allocated, other data objects are allocated
-    if (p_uploaded) {
+    if (p_uploaded && !p_shared) {
       GA_Destroy(p_GA);
     }
     if (p_begin != NULL) delete [] p_begin;
@@ -148,6 +156,25 @@ public:
       return;
     }
 
+    if (p_shared) {
+      // Each process copies its vectors into the array on its node and the
+      // arrays on all nodes are then combined
+      p_shm.reset(new SharedArray<char>(p_comm,
+            static_cast<size_t>(ndata)*p_datasize));
+      for (i=0; i<p_index.size(); i++) {
+        int idx = p_index[i];
+        if (p_data[i].size() > 0) {
+          memcpy(p_shm->data()+static_cast<size_t>(p_begin[idx])*p_datasize,
+              &((p_data[i])[0]),p_data[i].size()*p_datasize);
+        }
+        p_data[i].clear();
+      }
+      p_data.clear();
+      p_index.clear();
+      p_shm->merge();
+      p_uploaded = true;
+      return;
+    }
     // Create a GA to hold data
     int one = 1;
     int GA_type = NGA_Register_type(p_datasize);
@@ -189,6 +216,12 @@ public:
     int lo = p_begin[idx];
     int hi = p_end[idx]-1;
     int size = p_end[idx]-p_begin[idx];
+    if (p_shared) {
+      const _data_type *ptr = reinterpret_cast<const _data_type*>(
+          p_shm->data()+static_cast<size_t>(lo)*p_datasize);
+      vec.assign(ptr, ptr+size);
+      return;
+    }
     _data_type *dbuf = new _data_type[size];
     NGA_Get(p_GA,&lo,&hi,dbuf,&ld);
     // Copy results to vector
@@ -211,6 +244,10 @@ private:
   // global array handle for storing distributed data
   int p_GA;
 
+  // shared memory copy of data on this node
+  bool p_shared;
+  boost::scoped_ptr<SharedArray<char> > p_shm;
+
   // size of data type in bytes, processor configuration information,
   // total number stored vectors
   int p_datasize;
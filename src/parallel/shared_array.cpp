@@ -0,0 +1,81 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   shared_array.cpp
+ *
+ * @brief
+ * Grouping of the processes of a communicator into nodes that share memory.
+ *
+ */
+
+// -------------------------------------------------------------
+
+#include "shared_array.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class NodeCommunicator
+// -------------------------------------------------------------
+
+// Find the processes of a communicator that share memory with this process
+NodeCommunicator::NodeCommunicator(const Communicator &comm)
+{
+  MPI_Comm world = static_cast<MPI_Comm>(comm);
+  int me = comm.rank();
+  int nprocs = comm.size();
+  MPI_Comm_split_type(world, MPI_COMM_TYPE_SHARED, me, MPI_INFO_NULL,
+      &p_node);
+  MPI_Comm_rank(p_node, &p_rank);
+  MPI_Comm_size(p_node, &p_size);
+  MPI_Comm_split(world, p_rank == 0 ? 0 : MPI_UNDEFINED, me, &p_leaders);
+
+  // Number the nodes in the order of their first process and let all
+  // processes on the node know the index of their node
+  p_nodeIndex = 0;
+  p_numNodes = 0;
+  if (p_leaders != MPI_COMM_NULL) {
+    MPI_Comm_rank(p_leaders, &p_nodeIndex);
+    MPI_Comm_size(p_leaders, &p_numNodes);
+  }
+  int info[2];
+  info[0] = p_nodeIndex;
+  info[1] = p_numNodes;
+  MPI_Bcast(info, 2, MPI_INT, 0, p_node);
+  p_nodeIndex = info[0];
+  p_numNodes = info[1];
+
+  p_procNode.resize(nprocs);
+  MPI_Allgather(&p_nodeIndex, 1, MPI_INT, &p_procNode[0], 1, MPI_INT, world);
+
+  // Find the node rank of all processes in the original communicator
+  std::vector<int> ranks(nprocs);
+  int i;
+  for (i=0; i<nprocs; i++) ranks[i] = i;
+  p_nodeRank.resize(nprocs);
+  MPI_Group wgroup, ngroup;
+  MPI_Comm_group(world, &wgroup);
+  MPI_Comm_group(p_node, &ngroup);
+  MPI_Group_translate_ranks(wgroup, nprocs, &ranks[0], ngroup,
+      &p_nodeRank[0]);
+  for (i=0; i<nprocs; i++) {
+    if (p_nodeRank[i] == MPI_UNDEFINED) p_nodeRank[i] = -1;
+  }
+  MPI_Group_free(&wgroup);
+  MPI_Group_free(&ngroup);
+}
+
+// Default destructor
+NodeCommunicator::~NodeCommunicator(void)
+{
+  if (p_leaders != MPI_COMM_NULL) MPI_Comm_free(&p_leaders);
+  MPI_Comm_free(&p_node);
+}
+
+} // namespace parallel
+} // namespace gridpack
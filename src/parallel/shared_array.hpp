@@ -0,0 +1,296 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   shared_array.hpp
+ *
+ * @brief
+ * Memory that is shared by all processes of a communicator that run on the
+ * same node, built on MPI-3 shared memory windows. NodeCommunicator
+ * describes how the processes of a communicator are grouped into nodes and
+ * SharedArray holds one copy of an array on each node that all processes
+ * on the node can read and write directly.
+ */
+// -------------------------------------------------------------
+
+#ifndef _shared_array_hpp_
+#define _shared_array_hpp_
+
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include "gridpack/utilities/exception.hpp"
+#include "gridpack/utilities/uncopyable.hpp"
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class NodeCommunicator
+// -------------------------------------------------------------
+class NodeCommunicator : private utility::Uncopyable {
+public:
+
+  /**
+   * Find the processes of a communicator that share memory with this
+   * process. This is a collective operation
+   * @param comm communicator that is divided into nodes
+   */
+  NodeCommunicator(const Communicator &comm);
+
+  /**
+   * Default destructor
+   */
+  ~NodeCommunicator(void);
+
+  /**
+   * @return communicator of processes on this node
+   */
+  MPI_Comm getNode(void) const
+  {
+    return p_node;
+  }
+
+  /**
+   * @return communicator containing the first process on each node. This
+   * is MPI_COMM_NULL on all other processes
+   */
+  MPI_Comm getLeaders(void) const
+  {
+    return p_leaders;
+  }
+
+  /**
+   * @return rank of this process on its node
+   */
+  int rank(void) const
+  {
+    return p_rank;
+  }
+
+  /**
+   * @return number of processes on this node
+   */
+  int size(void) const
+  {
+    return p_size;
+  }
+
+  /**
+   * @return number of nodes
+   */
+  int numNodes(void) const
+  {
+    return p_numNodes;
+  }
+
+  /**
+   * @return index of the node that this process is on
+   */
+  int nodeIndex(void) const
+  {
+    return p_nodeIndex;
+  }
+
+  /**
+   * Get the rank on this node of a process in the original communicator
+   * @param proc rank of process in original communicator
+   * @return rank of process on this node or -1 if it runs on another node
+   */
+  int nodeRank(int proc) const
+  {
+    return p_nodeRank[proc];
+  }
+
+  /**
+   * Get the index of the node that a process runs on
+   * @param proc rank of process in original communicator
+   * @return node index
+   */
+  int node(int proc) const
+  {
+    return p_procNode[proc];
+  }
+
+private:
+
+  MPI_Comm p_node;
+  MPI_Comm p_leaders;
+  int p_rank;
+  int p_size;
+  int p_numNodes;
+  int p_nodeIndex;
+  std::vector<int> p_nodeRank;
+  std::vector<int> p_procNode;
+};
+
+// -------------------------------------------------------------
+//  class SharedArray
+// -------------------------------------------------------------
+/**
+ * An array that is stored once on each node and can be read and written by
+ * all processes on the node without communication. Data must be plain
+ * values that can be copied byte by byte. Processes synchronize their
+ * access to the array by calling fence(). Copies on different nodes are
+ * independent of each other until they are made the same with replicate()
+ * or merge().
+ */
+template <typename _data_type>
+class SharedArray : private utility::Uncopyable {
+public:
+
+  /**
+   * Allocate array on each node. The array is initialized to zero. This
+   * is a collective operation
+   * @param comm communicator of processes that share array
+   * @param size number of elements in array
+   */
+  SharedArray(const Communicator &comm, size_t size)
+    : p_nodes(comm), p_size(size), p_data(NULL)
+  {
+    MPI_Aint bytes = 0;
+    if (p_nodes.rank() == 0) {
+      bytes = static_cast<MPI_Aint>(size*sizeof(_data_type));
+    }
+    void *ptr;
+    if (MPI_Win_allocate_shared(bytes, sizeof(_data_type), MPI_INFO_NULL,
+          p_nodes.getNode(), &ptr, &p_win) != MPI_SUCCESS) {
+      char buf[256];
+      sprintf(buf,"p[%d] SharedArray: unable to allocate %ld bytes\n",
+          comm.rank(),static_cast<long>(size*sizeof(_data_type)));
+      throw gridpack::Exception(buf);
+    }
+    MPI_Aint qsize;
+    int disp;
+    MPI_Win_shared_query(p_win, 0, &qsize, &disp, &ptr);
+    p_data = static_cast<_data_type*>(ptr);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, p_win);
+    if (p_nodes.rank() == 0 && size > 0) {
+      memset(ptr, 0, size*sizeof(_data_type));
+    }
+    fence();
+  }
+
+  /**
+   * Default destructor. This is collective
+   */
+  ~SharedArray(void)
+  {
+    MPI_Win_unlock_all(p_win);
+    MPI_Win_free(&p_win);
+  }
+
+  /**
+   * @return number of elements in array
+   */
+  size_t size(void) const
+  {
+    return p_size;
+  }
+
+  /**
+   * @return pointer to copy of array on this node
+   */
+  _data_type* data(void)
+  {
+    return p_data;
+  }
+
+  /**
+   * @return pointer to copy of array on this node
+   */
+  const _data_type* data(void) const
+  {
+    return p_data;
+  }
+
+  /**
+   * Access an element of the array on this node
+   * @param idx index of element
+   */
+  _data_type& operator[](size_t idx)
+  {
+    return p_data[idx];
+  }
+
+  const _data_type& operator[](size_t idx) const
+  {
+    return p_data[idx];
+  }
+
+  /**
+   * Make changes to the array by any process on the node visible to all
+   * other processes on the node. This is collective on the node
+   */
+  void fence(void)
+  {
+    MPI_Win_sync(p_win);
+    MPI_Barrier(p_nodes.getNode());
+    MPI_Win_sync(p_win);
+  }
+
+  /**
+   * Copy the array on the node of process root to all other nodes. This is
+   * a collective operation and includes a fence
+   * @param root rank of process whose node holds the data
+   */
+  void replicate(int root)
+  {
+    fence();
+    if (p_nodes.getLeaders() != MPI_COMM_NULL) {
+      int node = p_nodes.node(root);
+      char *ptr = reinterpret_cast<char*>(p_data);
+      size_t bytes = p_size*sizeof(_data_type);
+      while (bytes > 0) {
+        int chunk = bytes > p_maxChunk ? p_maxChunk : static_cast<int>(bytes);
+        MPI_Bcast(ptr, chunk, MPI_BYTE, node, p_nodes.getLeaders());
+        ptr += chunk;
+        bytes -= chunk;
+      }
+    }
+    fence();
+  }
+
+  /**
+   * Combine the arrays on all nodes into one array that is copied back to
+   * every node. Each element must have been set on at most one node and be
+   * left at zero on all others. This is a collective operation and
+   * includes a fence
+   */
+  void merge(void)
+  {
+    fence();
+    if (p_nodes.getLeaders() != MPI_COMM_NULL && p_nodes.numNodes() > 1) {
+      char *ptr = reinterpret_cast<char*>(p_data);
+      size_t bytes = p_size*sizeof(_data_type);
+      while (bytes > 0) {
+        int chunk = bytes > p_maxChunk ? p_maxChunk : static_cast<int>(bytes);
+        MPI_Allreduce(MPI_IN_PLACE, ptr, chunk, MPI_BYTE, MPI_BOR,
+            p_nodes.getLeaders());
+        ptr += chunk;
+        bytes -= chunk;
+      }
+    }
+    fence();
+  }
+
+private:
+
+  // largest message used when copying arrays between nodes
+  static const size_t p_maxChunk = 1 << 30;
+
+  NodeCommunicator p_nodes;
+  size_t p_size;
+  _data_type *p_data;
+  MPI_Win p_win;
+};
+
+} // namespace parallel
+} // namespace gridpack
+
+#endif
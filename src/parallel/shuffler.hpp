@@ -25,13 +25,22 @@
 // Last Change: 2013-05-03 12:23:12 d3g096
 // -------------------------------------------------------------
 #include <iostream>
+#include <sstream>
 #include <vector>
+#include <iterator>
+#include <algorithm>
 #include <utility>
+#include <climits>
+#include <cstring>
+#include <cstdio>
 #include <boost/mpi.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/utility.hpp>
 
 #include "gridpack/parallel/distributed.hpp"
+#include "gridpack/utilities/exception.hpp"
 
 #ifndef _shuffler_hpp_
 #define _shuffler_hpp_
@@ -39,6 +48,74 @@
 namespace gridpack {
 namespace parallel {
 
+/**
+ * Append plain data to a shuffle buffer
+ * @param buf buffer
+ * @param values pointer to values
+ * @param n number of values
+ */
+template <typename T>
+inline void shuffleAppend(std::vector<char> &buf, const T *values, int n)
+{
+  if (n <= 0) return;
+  size_t size = buf.size();
+  buf.resize(size + n*sizeof(T));
+  memcpy(&buf[size], values, n*sizeof(T));
+}
+
+/**
+ * Copy plain data out of a shuffle buffer and advance pointer
+ * @param ptr current position in buffer
+ * @param values pointer to values
+ * @param n number of values
+ */
+template <typename T>
+inline void shuffleRead(const char *&ptr, T *values, int n)
+{
+  if (n <= 0) return;
+  memcpy(values, ptr, n*sizeof(T));
+  ptr += n*sizeof(T);
+}
+
+// -------------------------------------------------------------
+//  struct ShufflePacker
+// -------------------------------------------------------------
+/// Convert the things sent to one process to and from bytes
+/**
+ * The default packer writes the things through a boost binary
+ * archive, so any serializable thing can be shuffled. Types that are
+ * moved in bulk, such as the bus and branch records of a network, can
+ * specialize this struct and write their contents directly.
+ * 
+ */
+template <typename Thing>
+struct ShufflePacker
+{
+  /// Append the image of a vector of things to a buffer
+  static void pack(const std::vector<Thing>& things, std::vector<char>& buf)
+  {
+    std::ostringstream os(std::ios::binary);
+    {
+      boost::archive::binary_oarchive ar(os);
+      ar << things;
+    }
+    std::string image(os.str());
+    buf.insert(buf.end(), image.begin(), image.end());
+  }
+
+  /// Append the things in an image created by pack() to a vector
+  static void unpack(const char *ptr, size_t size, std::vector<Thing>& things)
+  {
+    std::istringstream is(std::string(ptr, size), std::ios::binary);
+    std::vector<Thing> tmp;
+    {
+      boost::archive::binary_iarchive ar(is);
+      ar >> tmp;
+    }
+    things.insert(things.end(), tmp.begin(), tmp.end());
+  }
+};
+
 // -------------------------------------------------------------
 //  class Shuffler
 // -------------------------------------------------------------
@@ -48,11 +125,15 @@ namespace parallel {
  * Each process starts with a (possibly empty) vector of things and a
  * vector of equal size that containing a destination process for each
  * thing.  After execution, each process will contain a vector of the
- * things assigned to it.
+ * things assigned to it, in order of the process they came from.
  *
- * This uses blocking send/receive.  
+ * The things going to each process are packed into a single buffer
+ * using ShufflePacker<Thing> and all buffers are exchanged with one
+ * all-to-all of the buffer sizes and one variable size all-to-all of
+ * the data. Things that stay on the local process are not packed.
  *
- * The things redistributed must be copy constructable and serializable.  
+ * The things redistributed must be copy constructable and either
+ * serializable or have a ShufflePacker specialization.
  * 
  */
 
@@ -84,90 +165,122 @@ public:
 
     if (comm.size() <= 1) return;
 
-    size_t nthings(0);
-    all_reduce(comm, locthings.size(), nthings, std::plus<size_t>());
-    if (nthings <= 0) return;
+    int me = comm.rank();
+    int nprocs = comm.size();
+    MPI_Comm mpicomm = static_cast<MPI_Comm>(comm);
 
-    // save the original list of local things 
+    // sort local things by destination
 
-    ThingVector tvect(locthings); 
+    ThingVector keep;
+    std::vector<ThingVector> tosend(nprocs);
+    for (size_t i = 0; i < destproc.size(); ++i) {
+      int dest = static_cast<int>(destproc[i]);
+      if (dest == me) {
+        keep.push_back(locthings[i]);
+      } else {
+        tosend[dest].push_back(locthings[i]);
+      }
+    }
     locthings.clear();
 
-    // Work on each processors list of things separately
+    // pack things for all other processes into one buffer
 
-    std::vector<ThingVector> tosend(comm.size());
+    std::vector<char> sendbuf;
+    std::vector<int> sendcounts(nprocs, 0), sdispls(nprocs, 0);
+    std::vector<int> recvcounts(nprocs, 0), rdispls(nprocs, 0);
+    int overflow = 0;
+    for (int p = 0; p < nprocs; ++p) {
+      size_t start = sendbuf.size();
+      if (!tosend[p].empty()) {
+        ShufflePacker<Thing>::pack(tosend[p], sendbuf);
+        ThingVector().swap(tosend[p]);
+      }
+      if (sendbuf.size() > static_cast<size_t>(INT_MAX)) {
+        overflow = 1;
+        break;
+      }
+      sdispls[p] = static_cast<int>(start);
+      sendcounts[p] = static_cast<int>(sendbuf.size() - start);
+    }
 
-    // all processes go through the destinations and makes a vector to
-    // send to each of the other processes
+    // all processes must agree on overflows before the exchange so that
+    // they throw together
 
-    size_t locidx(0);
+    int ierr;
+    checkOverflow(overflow, "send", mpicomm);
 
-    for (typename IndexVector::const_iterator dest = destproc.begin(); 
-         dest != destproc.end(); ++dest) {
-      if (*dest == comm.rank()) {
-        locthings.push_back(tvect[locidx]);
-      } else {
-        tosend[*dest].push_back(tvect[locidx]);
+    // exchange buffer sizes and then the buffers themselves
+
+    ierr = MPI_Alltoall(&sendcounts[0], 1, MPI_INT,
+                        &recvcounts[0], 1, MPI_INT, mpicomm);
+    if (ierr != MPI_SUCCESS) {
+      char buf[256];
+      sprintf(buf,"p[%d] Shuffler: MPI_Alltoall failed\n",me);
+      throw gridpack::Exception(buf);
+    }
+    size_t rtotal = 0;
+    for (int p = 0; p < nprocs; ++p) {
+      if (rtotal > static_cast<size_t>(INT_MAX - recvcounts[p])) {
+        overflow = 1;
+        break;
       }
-      locidx += 1;
+      rdispls[p] = static_cast<int>(rtotal);
+      rtotal += recvcounts[p];
     }
+    checkOverflow(overflow, "receive", mpicomm);
+    std::vector<char> recvbuf(rtotal > 0 ? rtotal : 1);
+    if (sendbuf.empty()) sendbuf.resize(1);
+    ierr = MPI_Alltoallv(&sendbuf[0], &sendcounts[0], &sdispls[0], MPI_CHAR,
+                         &recvbuf[0], &recvcounts[0], &rdispls[0], MPI_CHAR,
+                         mpicomm);
+    if (ierr != MPI_SUCCESS) {
+      char buf[256];
+      sprintf(buf,"p[%d] Shuffler: MPI_Alltoallv failed\n",me);
+      throw gridpack::Exception(buf);
+    }
+    std::vector<char>().swap(sendbuf);
 
-#if 0
-    for (int src = 0; src < comm.size(); ++src) {
-      ThingVector tmp;
-      if (comm.rank() == src) {
-        scatter(comm, tosend, tmp, src);
-      } else {
-        scatter(comm, tmp, src);
+    // unpack things in order of the process they came from
+
+    for (int p = 0; p < nprocs; ++p) {
+      if (p == me) {
+        std::copy(keep.begin(), keep.end(), std::back_inserter(locthings));
+      } else if (recvcounts[p] > 0) {
+        ShufflePacker<Thing>::unpack(&recvbuf[rdispls[p]],
+            static_cast<size_t>(recvcounts[p]), locthings);
       }
-      std::copy(tmp.begin(), tmp.end(), std::back_inserter(locthings));
     }
   }
-#else
-    int me = comm.rank();
-    int nprocs = comm.size();
-    for (int src = 0; src < nprocs; ++src) {
-      // Don't send messages of zero size. Exchange sizes with all processors
-      // first
-      //printf("p[%d] Got to 1\n",me);
-      std::vector<int> srcsizes(nprocs);
-      std::vector<int> tsizes(nprocs);
-      for (int i = 0; i<nprocs; i++) {
-        if (src == me) {
-          srcsizes[i] = tosend[i].size();
-        } else {
-          srcsizes[i] = 0;
-        }
-      }
-      int ierr;
-      ierr = MPI_Allreduce(&srcsizes[0],&tsizes[0],nprocs,MPI_INT,MPI_SUM,
-                           static_cast<MPI_Comm>(comm));
-      if (ierr != 0) {
-        // FIXME: throw
-      }
-      //create receive buffer
-     // printf("p[%d] Got to 2\n",me);
-      ThingVector tmp;
-      if (me == src) {
-        for (int i=0; i<nprocs; i++) {
-          if (i == me) {
-            //printf("p[%d] Got to 2\n",me);
-            tmp = tosend[i];
-          } else {
-            //printf("p[%d] Got to 3 size: %d send to: %d\n",me,tsizes[i],i);
-            if (tsizes[i] > 0) 
-              static_cast<boost::mpi::communicator>(comm).send(i,src,tosend[i]);
-          }
-        }
+
+protected:
+
+  /**
+   * Find out if any process has a buffer that is too large for MPI counts
+   * and throw on all processes if one does. This is collective
+   * @param overflow 1 if buffer on this process is too large
+   * @param which name of buffer used in error message
+   * @param mpicomm communicator
+   */
+  void checkOverflow(int overflow, const char *which, MPI_Comm mpicomm)
+  {
+    int any = 0;
+    int ierr = MPI_Allreduce(&overflow, &any, 1, MPI_INT, MPI_MAX, mpicomm);
+    if (ierr != MPI_SUCCESS || any) {
+      int me;
+      MPI_Comm_rank(mpicomm, &me);
+      char buf[256];
+      if (overflow) {
+        sprintf(buf,"p[%d] Shuffler: %s buffer exceeds %d bytes\n",
+            me,which,INT_MAX);
+      } else if (any) {
+        sprintf(buf,"p[%d] Shuffler: %s buffer on another process exceeds"
+            " %d bytes\n",me,which,INT_MAX);
       } else {
-            //printf("p[%d] Got to 4 size: %d recieve from: %d\n",me,tsizes[me],src);
-        if (tsizes[me] > 0) 
-          static_cast<boost::mpi::communicator>(comm).recv(src,src,tmp);
+        sprintf(buf,"p[%d] Shuffler: MPI_Allreduce failed\n",me);
       }
-      std::copy(tmp.begin(), tmp.end(), std::back_inserter(locthings));
+      throw gridpack::Exception(buf);
     }
   }
-#endif
 
 };
 
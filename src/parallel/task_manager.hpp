@@ -12,7 +12,10 @@
  * 
  * @brief  
  * 
- * 
+ * Distribute tasks over processors or groups of processors. Tasks can be
+ * handed out one at a time from a single global counter or, if the task
+ * manager is set up with setLeased, in leases of several tasks that are
+ * taken from per-group ranges that other groups can steal from.
  */
 
 // -------------------------------------------------------------
@@ -21,7 +24,12 @@
 #define _task_manager_hpp_
 
 #include "gridpack/parallel/communicator.hpp"
+#include "gridpack/utilities/exception.hpp"
 #include <ga.h>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
 
 namespace gridpack {
 namespace parallel {
@@ -48,6 +56,11 @@ public:
     }
     GA_Zero(p_GAcounter);
     p_ntasks = 0;
+    p_task_count = 0;
+    p_leased = false;
+    p_leaseGA = false;
+    p_leaseNext = 0;
+    p_leaseEnd = 0;
   }
 
   /**
@@ -67,6 +80,11 @@ public:
     }
     GA_Zero(p_GAcounter);
     p_ntasks = 0;
+    p_task_count = 0;
+    p_leased = false;
+    p_leaseGA = false;
+    p_leaseNext = 0;
+    p_leaseEnd = 0;
   }
 
   /**
@@ -75,6 +93,7 @@ public:
   ~TaskManager(void)
   {
     GA_Destroy(p_GAcounter);
+    if (p_leaseGA) GA_Destroy(p_GAleases);
   }
 
   /**
@@ -86,6 +105,42 @@ public:
     GA_Zero(p_GAcounter);
     p_ntasks = ntasks;
     p_task_count = 0;
+    p_leased = false;
+  }
+
+  /**
+   * Specify total number of tasks and hand out tasks in leases (guided
+   * scheduling). The tasks are divided into contiguous ranges, one for
+   * each task communicator. Each communicator takes leases from its own
+   * range, with lease sizes that decrease as the range is used up, and
+   * starts taking leases from the ranges of other communicators once its
+   * own range is exhausted. This is a collective operation on all
+   * processors in the task manager.
+   * @param ntasks total number of tasks
+   * @param comm communicator that is used in subsequent calls to nextTask
+   * @param minLease minimum number of tasks in a lease
+   */
+  void setLeased(int ntasks, Communicator &comm, int minLease = 1)
+  {
+    std::vector<double> cost;
+    setupLeases(ntasks, cost, comm, minLease);
+  }
+
+  /**
+   * Specify estimated cost of each task and hand out tasks in leases. Tasks
+   * are evaluated in order of decreasing cost and are dealt out to the
+   * ranges of the task communicators so that each range has a similar
+   * total cost. This is a collective operation on all processors in the
+   * task manager.
+   * @param cost estimated cost of each task. The total number of tasks is
+   *        equal to the length of this vector
+   * @param comm communicator that is used in subsequent calls to nextTask
+   * @param minLease minimum number of tasks in a lease
+   */
+  void setLeased(const std::vector<double> &cost, Communicator &comm,
+      int minLease = 1)
+  {
+    setupLeases(cost.size(), cost, comm, minLease);
   }
   
   /**
@@ -96,6 +151,24 @@ public:
    * @return false if no other tasks are found
    */
   bool nextTask(int *next) {
+    if (p_leased) {
+      if (p_leaseNext >= p_leaseEnd) {
+        if (!fetchLease(p_leaseNext, p_leaseEnd)) {
+          p_leaseNext = 0;
+          p_leaseEnd = 0;
+        }
+      }
+      if (p_leaseNext < p_leaseEnd) {
+        *next = p_order[p_leaseNext];
+        p_leaseNext++;
+        p_task_count++;
+        return true;
+      } else {
+        *next = -1;
+        GA_Pgroup_sync(p_grp);
+        return false;
+      }
+    }
     int zero = 0;
     long one = 1;
     *next = static_cast<int>(NGA_Read_inc(p_GAcounter,&zero,one));
@@ -120,6 +193,18 @@ public:
    */
 
   bool nextTask(Communicator &comm, int *next) {
+    if (p_leased) {
+      if (p_leaseNext < p_leaseEnd || nextLease(comm)) {
+        *next = p_order[p_leaseNext];
+        p_leaseNext++;
+        p_task_count++;
+        return true;
+      } else {
+        *next = -1;
+        GA_Pgroup_sync(p_grp);
+        return false;
+      }
+    }
     int zero = 0;
     long one = 1;
     int me = comm.rank();
@@ -141,6 +226,59 @@ public:
     }
   }
 
+  /**
+   * Get a block of consecutive tasks for the whole communicator. The counter
+   * is only incremented once for the entire block so that the cost of
+   * accessing the counter is amortized over several tasks. The same list of
+   * tasks is returned for all processors in the communicator comm. The last
+   * block may contain fewer than nblock tasks.
+   * @param comm communicator for next block of tasks
+   * @param nblock maximum number of tasks in block
+   * @param tasks indices of tasks in block
+   * @return false if no other tasks are found
+   */
+  bool nextTaskBlock(Communicator &comm, int nblock, std::vector<int> &tasks) {
+    if (p_leased) {
+      tasks.clear();
+      if (p_leaseNext < p_leaseEnd || nextLease(comm)) {
+        int nmax = nblock > 0 ? nblock : 1;
+        while (p_leaseNext < p_leaseEnd && tasks.size() < nmax) {
+          tasks.push_back(p_order[p_leaseNext]);
+          p_leaseNext++;
+        }
+        p_task_count += tasks.size();
+        return true;
+      } else {
+        GA_Pgroup_sync(p_grp);
+        return false;
+      }
+    }
+    int zero = 0;
+    long lblock = static_cast<long>(nblock > 0 ? nblock : 1);
+    int me = comm.rank();
+    int first;
+    if (me == 0) {
+      first = static_cast<int>(NGA_Read_inc(p_GAcounter,&zero,lblock));
+    } else {
+      first = 0;
+    }
+    char plus[2];
+    strcpy(plus,"+");
+    GA_Pgroup_igop(comm.getGroup(),&first,1,plus);
+    tasks.clear();
+    if (first < p_ntasks) {
+      int last = first + static_cast<int>(lblock);
+      if (last > p_ntasks) last = p_ntasks;
+      int i;
+      for (i=first; i<last; i++) tasks.push_back(i);
+      p_task_count += tasks.size();
+      return true;
+    } else {
+      GA_Pgroup_sync(p_grp);
+      return false;
+    }
+  }
+
   /**
    * Set the task counter to the maximum value so that all subsequent calls to
    * nextTask return false.
@@ -148,6 +286,16 @@ public:
    * function or the counter will hang
    */
   void cancel(void) {
+    if (p_leased) {
+      int i;
+      for (i=0; i<p_owners.size(); i++) {
+        int idx = p_owners[i];
+        int n = static_cast<int>(NGA_Read_inc(p_GAleases,&idx,p_ntasks));
+      }
+      p_leaseNext = 0;
+      p_leaseEnd = 0;
+      return;
+    }
     int zero = 0;
     int n = static_cast<int>(NGA_Read_inc(p_GAcounter,&zero, p_ntasks));
   }
@@ -175,11 +323,192 @@ public:
   }
 
 protected:
-  
+
+  /**
+   * Set up per-communicator ranges of tasks and the counters that are used
+   * to take leases from them
+   * @param ntasks total number of tasks
+   * @param cost estimated cost of each task (may be empty)
+   * @param comm communicator that is used in subsequent calls to nextTask
+   * @param minLease minimum number of tasks in a lease
+   */
+  void setupLeases(int ntasks, const std::vector<double> &cost,
+      Communicator &comm, int minLease)
+  {
+    int i, k;
+    int nprocs = GA_Pgroup_nnodes(p_grp);
+    int me = GA_Pgroup_nodeid(p_grp);
+    p_ntasks = ntasks;
+    p_task_count = 0;
+    p_leased = true;
+    p_minLease = minLease > 0 ? minLease : 1;
+    p_leaseNext = 0;
+    p_leaseEnd = 0;
+
+    // Create lease counters, one per processor, so that each communicator
+    // takes leases from its own range using a local counter
+    if (!p_leaseGA) {
+      p_GAleases = GA_Create_handle();
+      int one = 1;
+      GA_Set_data(p_GAleases,one,&nprocs,C_INT);
+      std::vector<int> map(nprocs);
+      for (i=0; i<nprocs; i++) map[i] = i;
+      GA_Set_irreg_distr(p_GAleases,&map[0],&nprocs);
+      GA_Set_pgroup(p_GAleases,p_grp);
+      if (!GA_Allocate(p_GAleases)) {
+        char buf[256];
+        sprintf(buf,"Unable to allocate lease counters in"
+            " TaskManager::setupLeases on process %d\n",me);
+        throw gridpack::Exception(buf);
+      }
+      p_leaseGA = true;
+    }
+
+    // Find processors that are rank 0 on their task communicator. These own
+    // the task ranges
+    std::vector<int> leader(nprocs,0);
+    if (comm.rank() == 0) leader[me] = 1;
+    char plus[2];
+    strcpy(plus,"+");
+    GA_Pgroup_igop(p_grp,&leader[0],nprocs,plus);
+    p_owners.clear();
+    p_myOwner = -1;
+    for (i=0; i<nprocs; i++) {
+      if (leader[i] != 0) {
+        if (i == me) p_myOwner = p_owners.size();
+        p_owners.push_back(i);
+      }
+    }
+    int nowner = p_owners.size();
+    p_exhausted.assign(nowner,false);
+    p_rangeEnd.assign(nowner,0);
+    std::vector<int> start(nowner,0);
+
+    // Order tasks and divide them into ranges. Without cost estimates each
+    // range is a contiguous block of task indices. With cost estimates,
+    // tasks are dealt out in order of decreasing cost.
+    p_order.resize(ntasks);
+    if (cost.size() == 0) {
+      for (i=0; i<ntasks; i++) p_order[i] = i;
+      for (k=0; k<nowner; k++) {
+        start[k] = static_cast<int>((static_cast<long>(k)*ntasks)/nowner);
+        p_rangeEnd[k] = static_cast<int>((static_cast<long>(k+1)*ntasks)/nowner);
+      }
+    } else {
+      std::vector<std::pair<double,int> > sorted(ntasks);
+      for (i=0; i<ntasks; i++) {
+        sorted[i] = std::pair<double,int>(cost[i],i);
+      }
+      std::stable_sort(sorted.begin(),sorted.end(),
+          std::greater<std::pair<double,int> >());
+      int ncnt = 0;
+      for (k=0; k<nowner; k++) {
+        start[k] = ncnt;
+        for (i=k; i<ntasks; i+=nowner) {
+          p_order[ncnt] = sorted[i].second;
+          ncnt++;
+        }
+        p_rangeEnd[k] = ncnt;
+      }
+    }
+
+    // Initialize counter for range owned by this processor
+    if (p_myOwner >= 0) {
+      int one = 1;
+      NGA_Put(p_GAleases,&me,&me,&start[p_myOwner],&one);
+    } else {
+      int one = 1;
+      int zero = 0;
+      NGA_Put(p_GAleases,&me,&me,&zero,&one);
+    }
+    GA_Pgroup_sync(p_grp);
+  }
+
+  /**
+   * Take a lease of tasks, starting with the range owned by this
+   * processor and then checking ranges owned by other processors. The
+   * lease size is a fraction of the remaining tasks in the range, so
+   * leases get smaller as the range is used up
+   * @param first position in task ordering of first task in lease
+   * @param last position in task ordering past last task in lease
+   * @return false if all ranges are exhausted
+   */
+  bool fetchLease(int &first, int &last)
+  {
+    int nowner = p_owners.size();
+    int k0 = p_myOwner >= 0 ? p_myOwner : 0;
+    int n;
+    for (n=0; n<nowner; n++) {
+      int k = (k0+n)%nowner;
+      if (p_exhausted[k]) continue;
+      int idx = p_owners[k];
+      int end = p_rangeEnd[k];
+      int current;
+      int one = 1;
+      NGA_Get(p_GAleases,&idx,&idx,&current,&one);
+      int remaining = end - current;
+      if (remaining <= 0) {
+        p_exhausted[k] = true;
+        continue;
+      }
+      // Take a quarter of the remaining tasks in own range and half of
+      // the remaining tasks in another range
+      int lease = (k == p_myOwner) ? remaining/4 : remaining/2;
+      if (lease < p_minLease) lease = p_minLease;
+      first = static_cast<int>(NGA_Read_inc(p_GAleases,&idx,
+            static_cast<long>(lease)));
+      if (first < end) {
+        last = first + lease;
+        if (last > end) last = end;
+        return true;
+      }
+      p_exhausted[k] = true;
+    }
+    return false;
+  }
+
+  /**
+   * Get a new lease on rank 0 of the communicator and distribute it to
+   * all processors in the communicator
+   * @param comm communicator for next lease
+   * @return false if no other tasks are found
+   */
+  bool nextLease(Communicator &comm)
+  {
+    int lease[2];
+    lease[0] = 0;
+    lease[1] = 0;
+    if (comm.rank() == 0) {
+      if (!fetchLease(lease[0],lease[1])) {
+        lease[0] = 0;
+        lease[1] = 0;
+      }
+    }
+    char plus[2];
+    strcpy(plus,"+");
+    GA_Pgroup_igop(comm.getGroup(),lease,2,plus);
+    p_leaseNext = lease[0];
+    p_leaseEnd = lease[1];
+    return p_leaseNext < p_leaseEnd;
+  }
+
   int p_GAcounter;
   int p_ntasks;
   int p_grp;
   int p_task_count;
+
+  // Data for handing out tasks in leases
+  bool p_leased;
+  bool p_leaseGA;
+  int p_GAleases;
+  int p_minLease;
+  int p_myOwner;
+  int p_leaseNext;
+  int p_leaseEnd;
+  std::vector<int> p_order;
+  std::vector<int> p_owners;
+  std::vector<int> p_rangeEnd;
+  std::vector<bool> p_exhausted;
 };
 
 
@@ -103,6 +103,52 @@ main(int argc, char **argv)
     } else if (chk < nproc && me == 0) {
       printf("Error found in vectors\n");
     }
+
+    // Repeat the test with one copy of the data on each node in shared
+    // memory
+    gridpack::parallel::GlobalStore<data_type> shared_bank(world, true);
+    lo = me*MAX_VEC/nproc;
+    hi = (me+1)*MAX_VEC/nproc-1;
+    for (i=lo; i<=hi; i++) {
+      std::vector<data_type> vec;
+      for (j=0; j<VEC_LEN+me; j++) {
+        data_type item;
+        item.ival = j+me;
+        item.dval = static_cast<double>(j+me+1);
+        vec.push_back(item);
+      }
+      shared_bank.addVector(i,vec);
+    }
+    shared_bank.upload();
+    if (me < nproc-1) {
+      lo = (me+1)*MAX_VEC/nproc;
+      hi = (me+2)*MAX_VEC/nproc-1;
+    } else {
+      lo = 0;
+      hi = MAX_VEC/nproc-1;
+    }
+    chk = 1;
+    for (i=lo; i<=hi; i++) {
+      std::vector<data_type> vec;
+      shared_bank.getVector(i, vec);
+      for (j=0; j<VEC_LEN+ichk; j++) {
+        if (vec[j].ival != j+ichk ||
+            vec[j].dval != static_cast<double>(j+ichk+1)) {
+          if (chk == 1) {
+            printf("p[%d] Mistake found in shared memory at (vec[%d])[%d]\n",
+                me,i,j);
+          }
+          chk = 0;
+        }
+      }
+    }
+    world.sync();
+    world.sum(&chk,1);
+    if (chk == nproc && me == 0) {
+      printf("Shared memory vectors OK\n");
+    } else if (chk < nproc && me == 0) {
+      printf("Error found in shared memory vectors\n");
+    }
   }
   return 0;
 }
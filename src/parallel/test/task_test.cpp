@@ -79,6 +79,51 @@ main(int argc, char **argv)
         printf("Evaluating task %d on processor %d (global id %d) in sub-communicator of size %d\n",
             itask,lcomm.rank(),me,lcomm.size());
       }
+
+      // Fetch tasks in blocks and check that every task is evaluated exactly
+      // once
+      std::vector<int> block;
+      std::vector<int> count(ntasks,0);
+      tskmgr.set(ntasks);
+      while(tskmgr.nextTaskBlock(lcomm,3,block)) {
+        if (lcomm.rank() == 0) {
+          for (i=0; i<block.size(); i++) count[block[i]]++;
+        }
+      }
+      world.sum(&count[0],ntasks);
+      bool ok = true;
+      for (i=0; i<ntasks; i++) {
+        if (count[i] != 1) ok = false;
+      }
+      if (me == 0) {
+        if (ok) {
+          printf("\nBlock task distribution ok\n");
+        } else {
+          printf("\nBlock task distribution failed\n");
+        }
+      }
+
+      // Hand out tasks in leases using estimated task costs and check that
+      // every task is evaluated exactly once
+      std::vector<double> cost(ntasks);
+      for (i=0; i<ntasks; i++) cost[i] = static_cast<double>((i*7)%11);
+      for (i=0; i<ntasks; i++) count[i] = 0;
+      tskmgr.setLeased(cost,lcomm);
+      while(tskmgr.nextTask(lcomm,&itask)) {
+        if (lcomm.rank() == 0) count[itask]++;
+      }
+      world.sum(&count[0],ntasks);
+      ok = true;
+      for (i=0; i<ntasks; i++) {
+        if (count[i] != 1) ok = false;
+      }
+      if (me == 0) {
+        if (ok) {
+          printf("\nLeased task distribution ok\n");
+        } else {
+          printf("\nLeased task distribution failed\n");
+        }
+      }
     }
     // Check performance of task manager. Create a very large number of tasks.
     ntasks = 1000000*nprocs;
@@ -0,0 +1,163 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   threads.hpp
+ *
+ * @brief
+ * Control of the threads used inside each process for loops over network
+ * components. Threads are only available if GridPACK is configured with
+ * GRIDPACK_USE_OPENMP. Otherwise all loops run serially and the number of
+ * threads is always 1.
+ *
+ * Loops that run on threads call component functions such as load(),
+ * setMode() and the matrix and vector value functions concurrently on
+ * different components. These functions may only modify the component
+ * they are called on.
+ */
+// -------------------------------------------------------------
+
+#ifndef _threads_hpp_
+#define _threads_hpp_
+
+#include <exception>
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+// Insert an OpenMP directive if GridPACK is built with OpenMP
+#ifdef USE_OPENMP
+#define GRIDPACK_OMP_PRAGMA(x) _Pragma(#x)
+#else
+#define GRIDPACK_OMP_PRAGMA(x)
+#endif
+
+// Run the following loop over components on nthr threads. Components can
+// vary a lot in cost so iterations are handed out dynamically
+#define GRIDPACK_PARALLEL_FOR(nthr)                                       \
+  GRIDPACK_OMP_PRAGMA(omp parallel for schedule(dynamic,32)               \
+      num_threads(nthr) if((nthr) > 1))
+
+// Run the following loop on nthr threads and sum variable var over threads
+#define GRIDPACK_PARALLEL_FOR_SUM(nthr, var)                              \
+  GRIDPACK_OMP_PRAGMA(omp parallel for schedule(dynamic,32)               \
+      num_threads(nthr) if((nthr) > 1) reduction(+:var))
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class Threads
+// -------------------------------------------------------------
+class Threads {
+public:
+
+  /**
+   * @return number of threads used in component loops
+   */
+  static int get(void)
+  {
+    return p_number();
+  }
+
+  /**
+   * Set the number of threads used in component loops. This has no effect
+   * unless GridPACK is built with OpenMP
+   * @param nthreads number of threads. If this is 0, the number of threads
+   * set by OMP_NUM_THREADS is used
+   */
+  static void set(int nthreads)
+  {
+#ifdef USE_OPENMP
+    if (nthreads <= 0) nthreads = omp_get_max_threads();
+    p_number() = nthreads;
+#else
+    p_number() = 1;
+#endif
+  }
+
+  /**
+   * @return true if called from inside a loop that is running on more
+   * than one thread
+   */
+  static bool inParallel(void)
+  {
+#ifdef USE_OPENMP
+    return omp_in_parallel() != 0;
+#else
+    return false;
+#endif
+  }
+
+private:
+
+  static int& p_number(void)
+  {
+    static int number = 1;
+    return number;
+  }
+};
+
+// -------------------------------------------------------------
+//  class ThreadErrors
+// -------------------------------------------------------------
+/**
+ * Exceptions cannot leave a threaded loop. Errors in the body of the loop
+ * are caught and saved and the first one is thrown again, unchanged, after
+ * the loop has finished. The body of every threaded loop that calls
+ * component functions should catch all exceptions:
+ *
+ *   try {
+ *     ...
+ *   } catch (...) {
+ *     errors.save(std::current_exception());
+ *   }
+ */
+class ThreadErrors {
+public:
+
+  /**
+   * Default constructor
+   */
+  ThreadErrors(void)
+  { }
+
+  /**
+   * Save an error raised in the body of a loop. Only the first error is
+   * kept
+   * @param e exception returned by std::current_exception
+   */
+  void save(std::exception_ptr e)
+  {
+    GRIDPACK_OMP_PRAGMA(omp critical(gridpack_thread_errors))
+    {
+      if (!p_error) p_error = e;
+    }
+  }
+
+  /**
+   * Throw the first saved error, if any, and clear it. Call this after the
+   * loop
+   */
+  void check(void)
+  {
+    if (p_error) {
+      std::exception_ptr e = p_error;
+      p_error = std::exception_ptr();
+      std::rethrow_exception(e);
+    }
+  }
+
+private:
+
+  std::exception_ptr p_error;
+};
+
+} // namespace parallel
+} // namespace gridpack
+
+#endif
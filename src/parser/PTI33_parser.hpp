@@ -20,6 +20,9 @@
 #include <map>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
 
 #include "gridpack/utilities/exception.hpp"
 #include "gridpack/timer/coarse_timer.hpp"
@@ -65,7 +68,7 @@ class PTI33_parser : public BasePTIParser<_network>
      * of network configuration file (must be child of network::BaseNetwork<>)
      */
     PTI33_parser(boost::shared_ptr<_network> network)
-      : p_network(network), p_maxBusIndex(-1)
+      : p_network(network), p_maxBusIndex(-1), p_parallelRead(false)
     {
       this->setNetwork(network);
       p_network_data = network->getNetworkData();
@@ -95,8 +98,12 @@ class PTI33_parser : public BasePTIParser<_network>
       util.trim(tmpstr);
       std::string ext = this->getExtension(tmpstr);
       if (ext == "raw") {
-        openStream(tmpstr);
-        getCase();
+        if (p_parallelRead) {
+          getCaseParallel(tmpstr);
+        } else {
+          openStream(tmpstr);
+          getCase();
+        }
         this->createNetwork(p_busData,p_branchData);
       } else if (ext == "dyr") {
         this->getDS(tmpstr);
@@ -127,6 +134,17 @@ class PTI33_parser : public BasePTIParser<_network>
       p_timer->configTimer(true);
     }
 
+    /**
+     * Read RAW files in parallel instead of reading them on process 0 and
+     * distributing the data afterwards. This only applies to parsing from
+     * a file.
+     * @param flag if true, all processors read and parse the file
+     */
+    void setParallelRead(bool flag)
+    {
+      p_parallelRead = flag;
+    }
+
     /**
      * Return values of impedence correction table corresponding to tableID
      * @param tableID ID of correction table
@@ -331,6 +349,929 @@ class PTI33_parser : public BasePTIParser<_network>
       p_timer->stop(t_case);
     }
 
+    /**
+     * Read a RAW file in parallel. The bus, load, fixed shunt, generator,
+     * branch, transformer, multi-section line and switched shunt sections
+     * are split into byte ranges that are read concurrently by all
+     * processors. Each record is sent to the processor that owns its bus
+     * or branch, based on a hash of the bus numbers, and is parsed there,
+     * so no processor holds more than its own part of these sections.
+     * Area data is read on process 0 and impedance correction tables are
+     * read by all processors. The remaining sections are skipped, since
+     * their data is not stored. Buses must be referred to by number in the
+     * parallel sections.
+     * @param fileName name of RAW file
+     */
+    void getCaseParallel(const std::string &fileName)
+    {
+      int t_case = p_timer->createCategory("Parser:getCaseParallel");
+      int t_scan = p_timer->createCategory("Parser:find sections");
+      int t_route = p_timer->createCategory("Parser:route records");
+      p_timer->start(t_case);
+      p_busData.clear();
+      p_branchData.clear();
+      p_busMap.clear();
+      p_nameMap.clear();
+      p_branchMap.clear();
+      p_maxBusIndex = -1;
+
+      MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+      int me(p_network->communicator().rank());
+      int nprocs(p_network->communicator().size());
+      int ierr;
+
+      std::ifstream fin(fileName.c_str(), std::ios::in | std::ios::binary);
+      int sok = fin.is_open() ? 1 : 0;
+      int rok;
+      ierr = MPI_Allreduce(&sok,&rok,1,MPI_INT,MPI_MIN,comm);
+      if (rok == 0) {
+        char buf[512];
+        sprintf(buf,"Failed to open network configuration file: %s\n\n",
+            fileName.c_str());
+        throw gridpack::Exception(buf);
+      }
+      fin.seekg(0,std::ios::end);
+      long long fsize = static_cast<long long>(fin.tellg());
+
+      // Parse case data on process 0. The header consists of any leading
+      // comments followed by three lines
+      long long header = 0;
+      if (me == 0) {
+        std::vector<std::string> lines;
+        gridpack::parser::BaseBlockParser base(&p_busMap, &p_nameMap,
+            &p_branchMap);
+        std::string line;
+        fin.clear();
+        fin.seekg(0);
+        int ncase = 0;
+        while (ncase < 3 && std::getline(fin,line)) {
+          header += static_cast<long long>(line.size())+1;
+          if (ncase > 0 || !base.check_comment(line)) ncase++;
+          lines.push_back(line);
+        }
+        if (header > fsize) header = fsize;
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::CaseParser33 case_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        case_parser.parse(stream,p_network_data,p_case_sbase,p_case_id);
+        stream.close();
+      }
+      ierr = MPI_Bcast(&header,1,MPI_LONG_LONG,0,comm);
+      ierr = MPI_Bcast(&p_case_sbase,1,MPI_DOUBLE,0,comm);
+      ierr = MPI_Bcast(&p_case_id,1,MPI_INT,0,comm);
+      this->setCaseID(p_case_id);
+      this->setCaseSBase(p_case_sbase);
+
+      // Find the lines that terminate the first five sections. Each
+      // processor scans its own part of the file and reports the first
+      // terminators that it finds.
+      p_timer->start(t_scan);
+      const int nsect = 5;
+      std::vector<std::string> lines;
+      std::vector<long long> offsets;
+      long long lo = header + (fsize-header)*me/nprocs;
+      long long hi = header + (fsize-header)*(me+1)/nprocs;
+      readLines(fin,lo,hi,header,lines,&offsets);
+      std::vector<long long> ends;
+      findTerminators(lines,offsets,nsect,ends);
+      lines.clear();
+      offsets.clear();
+      std::vector<long long> allEnds(2*nsect*nprocs);
+      ierr = MPI_Allgather(&ends[0],2*nsect,MPI_LONG_LONG,&allEnds[0],
+          2*nsect,MPI_LONG_LONG,comm);
+      std::vector<std::pair<long long, long long> > terms;
+      int i, j;
+      for (i=0; i<nsect*nprocs; i++) {
+        if (allEnds[2*i] >= 0) {
+          terms.push_back(std::pair<long long, long long>(allEnds[2*i],
+                allEnds[2*i+1]));
+        }
+      }
+      std::sort(terms.begin(),terms.end());
+      if (terms.size() < nsect) {
+        char buf[512];
+        sprintf(buf,"Network configuration file %s is missing bus, load,"
+            " shunt, generator or branch sections\n\n",fileName.c_str());
+        throw gridpack::Exception(buf);
+      }
+      p_timer->stop(t_scan);
+
+      // Read and parse each section
+      long long start = header;
+      for (j=0; j<nsect; j++) {
+        readRoutedSection(fin,start,terms[j].first,j==nsect-1,lines,t_route);
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        if (j == 0) {
+          gridpack::parser::BusParser33 bus_parser(&p_busMap,
+              &p_nameMap, &p_branchMap);
+          bus_parser.parse(stream,p_busData,p_case_sbase,p_case_id,
+              &p_maxBusIndex);
+        } else if (j == 1) {
+          gridpack::parser::LoadParser33 load_parser(&p_busMap,
+              &p_nameMap, &p_branchMap);
+          load_parser.parse(stream,p_busData);
+        } else if (j == 2) {
+          gridpack::parser::FixedShuntParser33 fixed_shunt_parser(&p_busMap,
+              &p_nameMap, &p_branchMap);
+          fixed_shunt_parser.parse(stream,p_busData);
+        } else if (j == 3) {
+          gridpack::parser::GeneratorParser33 generator_parser(&p_busMap,
+              &p_nameMap, &p_branchMap);
+          generator_parser.parse(stream,p_busData);
+        } else {
+          gridpack::parser::BranchParser33 branch_parser(&p_busMap,
+              &p_nameMap, &p_branchMap);
+          branch_parser.parse(stream,p_branchData);
+        }
+        stream.close();
+        lines.clear();
+        start = terms[j].second;
+      }
+      int imax = p_maxBusIndex;
+      ierr = MPI_Allreduce(&imax,&p_maxBusIndex,1,MPI_INT,MPI_MAX,comm);
+
+      // Transformer records are split by byte range as well and sent to
+      // the processors that own the resulting branches and buses
+      int nlocal = p_busData.size();
+      int nghost;
+      start = readTransformers(fin,start,fsize,fileName,&nghost);
+
+      // Find the ends of the sections that follow the transformer section
+      // in the same way as for the first sections. Sections that are
+      // missing at the end of the file are treated as empty
+      p_timer->start(t_scan);
+      const int ntail = 11;
+      lo = start + (fsize-start)*me/nprocs;
+      hi = start + (fsize-start)*(me+1)/nprocs;
+      readLines(fin,lo,hi,start,lines,&offsets);
+      findTerminators(lines,offsets,ntail,ends);
+      lines.clear();
+      offsets.clear();
+      allEnds.resize(2*ntail*nprocs);
+      ierr = MPI_Allgather(&ends[0],2*ntail,MPI_LONG_LONG,&allEnds[0],
+          2*ntail,MPI_LONG_LONG,comm);
+      terms.clear();
+      for (i=0; i<ntail*nprocs; i++) {
+        if (allEnds[2*i] >= 0) {
+          terms.push_back(std::pair<long long, long long>(allEnds[2*i],
+                allEnds[2*i+1]));
+        }
+      }
+      std::sort(terms.begin(),terms.end());
+      while (terms.size() < ntail) {
+        terms.push_back(std::pair<long long, long long>(fsize,fsize));
+      }
+      p_timer->stop(t_scan);
+
+      // Sections are area, two-terminal DC, VSC DC, impedance correction,
+      // multi-terminal DC, multi-section line, zone, inter-area transfer,
+      // owner, FACTS and switched shunt data. Only area data, impedance
+      // correction tables, multi-section lines and switched shunts are
+      // stored by the block parsers, so the other sections are not read.
+      // Area data is only needed on process 0, since network data is
+      // broadcast from there, while the impedance correction tables are
+      // needed everywhere. These sections contain one line per area or
+      // table. Multi-section lines and switched shunts are routed to the
+      // owners of their branches and buses
+      std::vector<long long> sstart(ntail);
+      sstart[0] = start;
+      for (j=1; j<ntail; j++) sstart[j] = terms[j-1].second;
+      if (me == 0) {
+        readLines(fin,sstart[0],terms[0].first,sstart[0],lines,NULL);
+        lines.push_back("0 / END OF DATA");
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::AreaParser33 area_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        area_parser.parse(stream,p_network_data);
+        stream.close();
+        lines.clear();
+      }
+      {
+        readLines(fin,sstart[3],terms[3].first,sstart[3],lines,NULL);
+        lines.push_back("0 / END OF DATA");
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::ImpedCorrParser33 imped_corr_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        imped_corr_parser.parse(stream,p_imp_corr_table);
+        stream.close();
+        lines.clear();
+      }
+      {
+        readRoutedSection(fin,sstart[5],terms[5].first,true,lines,t_route);
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::MultiSectParser33 multi_section_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        multi_section_parser.parse(stream,p_branchData);
+        stream.close();
+        lines.clear();
+      }
+      {
+        readRoutedSection(fin,sstart[10],terms[10].first,false,lines,
+            t_route);
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::SwitchedShuntParser33 switched_shunt_parser(
+            &p_busMap, &p_nameMap, &p_branchMap);
+        switched_shunt_parser.parse(stream,p_busData);
+        stream.close();
+        lines.clear();
+      }
+      fin.close();
+
+      // Remove copies of buses owned by other processors and buses and
+      // branches created by transformers that belong to other processors
+      std::vector<boost::shared_ptr<gridpack::component::DataCollection> >
+        tmpData;
+      int nsize = p_busData.size();
+      p_busMap.clear();
+      for (i=0; i<nsize; i++) {
+        int idx;
+        p_busData[i]->getValue(BUS_NUMBER,&idx);
+        if (i < nlocal || (i >= nlocal+nghost && busOwner(idx) == me)) {
+          p_busMap.insert(std::pair<int,int>(idx,tmpData.size()));
+          tmpData.push_back(p_busData[i]);
+        }
+      }
+      p_busData = tmpData;
+      tmpData.clear();
+      nsize = p_branchData.size();
+      p_branchMap.clear();
+      for (i=0; i<nsize; i++) {
+        int idx1, idx2;
+        p_branchData[i]->getValue(BRANCH_FROMBUS,&idx1);
+        p_branchData[i]->getValue(BRANCH_TOBUS,&idx2);
+        if (branchOwner(idx1,idx2) == me) {
+          p_branchMap.insert(std::pair<std::pair<int,int>,int>(
+                std::pair<int,int>(idx1,idx2),tmpData.size()));
+          tmpData.push_back(p_branchData[i]);
+        }
+      }
+      p_branchData = tmpData;
+
+      p_network->broadcastNetworkData(0);
+      p_network_data = p_network->getNetworkData();
+      p_timer->stop(t_case);
+    }
+
+    /**
+     * Find the first terminator lines in a block of lines
+     * @param lines lines from RAW file
+     * @param offsets byte offset of each line followed by the offset of
+     * the first byte after the last line
+     * @param nterm maximum number of terminators to find
+     * @param ends byte offset of each terminator line followed by the offset
+     * of the next line. Unused entries are set to -1
+     */
+    void findTerminators(std::vector<std::string> &lines,
+        const std::vector<long long> &offsets, int nterm,
+        std::vector<long long> &ends)
+    {
+      gridpack::parser::BaseBlockParser base(&p_busMap, &p_nameMap,
+          &p_branchMap);
+      ends.assign(2*nterm,-1);
+      int nend = 0;
+      int i;
+      for (i=0; i<lines.size() && nend<nterm; i++) {
+        if (!base.check_comment(lines[i]) && !base.test_end(lines[i])) {
+          ends[2*nend] = offsets[i];
+          ends[2*nend+1] = offsets[i+1];
+          nend++;
+        }
+      }
+    }
+
+    /**
+     * Read a section with single line records by byte range on all
+     * processors and send each record to the processor that owns it. A
+     * terminator line is appended so that the result can be passed to a
+     * block parser
+     * @param fin file stream
+     * @param start start of section
+     * @param end start of terminator line of section
+     * @param branch true if records are keyed by a bus pair
+     * @param lines records owned by this processor in file order
+     * @param t_route timer category for routing records
+     */
+    void readRoutedSection(std::ifstream &fin, long long start,
+        long long end, bool branch, std::vector<std::string> &lines,
+        int t_route)
+    {
+      int me(p_network->communicator().rank());
+      int nprocs(p_network->communicator().size());
+      long long lo = start + (end-start)*me/nprocs;
+      long long hi = start + (end-start)*(me+1)/nprocs;
+      readLines(fin,lo,hi,start,lines,NULL);
+      p_timer->start(t_route);
+      std::vector<int> dest;
+      routeLines(lines,branch,dest);
+      exchangeLines(lines,dest);
+      p_timer->stop(t_route);
+      lines.push_back("0 / END OF DATA");
+    }
+
+    /**
+     * Check if a transformer record starting with a line has three
+     * windings. The K field is nonzero or a quoted bus name for
+     * three-winding transformers
+     * @param split_line fields of first line of record
+     * @return true if record has five lines, false if it has four
+     */
+    bool isWinding3(const std::vector<std::string> &split_line)
+    {
+      if (split_line.size() < 3) return false;
+      const std::string &k = split_line[2];
+      if (k.find('\'') != std::string::npos ||
+          k.find('\"') != std::string::npos) return true;
+      return atoi(k.c_str()) != 0;
+    }
+
+    /**
+     * Walk through lines from the transformer section. The number of lines
+     * in each record is found from the K field of its first line. Comment
+     * lines are not part of any record
+     * @param lines lines from transformer section
+     * @param carry number of lines at the beginning that belong to a record
+     * that started before the first line
+     * @param starts indices of lines that start a record. If not NULL,
+     * the terminator line is not included
+     * @param term index of the terminator line or -1 if it is not found
+     * @return number of lines of the last record that follow the last line,
+     * or -1 if the terminator is found
+     */
+    int walkTransformers(std::vector<std::string> &lines, int carry,
+        std::vector<int> *starts, int *term)
+    {
+      gridpack::parser::BaseBlockParser base(&p_busMap, &p_nameMap,
+          &p_branchMap);
+      if (starts) starts->clear();
+      *term = -1;
+      int i;
+      int nlines = lines.size();
+      for (i=0; i<nlines; i++) {
+        if (base.check_comment(lines[i])) continue;
+        if (carry > 0) {
+          carry--;
+          continue;
+        }
+        if (!base.test_end(lines[i])) {
+          *term = i;
+          return -1;
+        }
+        if (starts) starts->push_back(i);
+        std::string line = lines[i];
+        base.cleanComment(line);
+        carry = isWinding3(base.splitPSSELine(line)) ? 4 : 3;
+      }
+      return carry;
+    }
+
+    /**
+     * Read the transformer section in parallel. Each processor reads a byte
+     * range of the file and finds the transformer records in its range.
+     * Since records have four or five lines, the number of lines that a
+     * record started in an earlier range extends into each range is found
+     * by combining the results of all earlier ranges. Records for
+     * two-winding transformers are sent to the owner of their branch.
+     * Three-winding transformers are replaced by a new bus and three
+     * branches. The number of the new bus is the same as in a serial read
+     * and records are sent to the owners of the new bus and of all three
+     * branches, together with copies of the data of the three terminal
+     * buses.
+     * @param fin file stream
+     * @param start start of transformer section
+     * @param fsize size of file
+     * @param fileName name of RAW file
+     * @param nghost number of copies of buses owned by other processors
+     * that are added after the buses owned by this processor
+     * @return start of line following the terminator of the section
+     */
+    long long readTransformers(std::ifstream &fin, long long start,
+        long long fsize, const std::string &fileName, int *nghost)
+    {
+      MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+      int me(p_network->communicator().rank());
+      int nprocs(p_network->communicator().size());
+      int i, j, ierr;
+      const int maxcarry = 5;
+
+      // The section extends at most to the end of the file
+      std::vector<std::string> lines;
+      std::vector<long long> offsets;
+      long long lo = start + (fsize-start)*me/nprocs;
+      long long hi = start + (fsize-start)*(me+1)/nprocs;
+      readLines(fin,lo,hi,start,lines,&offsets);
+
+      // Number of lines of a record extending past this range for each
+      // number of lines extending into it, and the same for all ranges
+      std::vector<int> carries(maxcarry), allCarries(maxcarry*nprocs);
+      int term;
+      for (i=0; i<maxcarry; i++) {
+        carries[i] = walkTransformers(lines,i,NULL,&term);
+      }
+      ierr = MPI_Allgather(&carries[0],maxcarry,MPI_INT,&allCarries[0],
+          maxcarry,MPI_INT,comm);
+      int carry = 0;
+      for (i=0; i<me && carry >= 0; i++) {
+        carry = allCarries[maxcarry*i+carry];
+      }
+
+      // Find record starts and the terminator. The range containing the
+      // terminator is the only one that reports it, since later ranges
+      // know that the section has ended
+      std::vector<int> starts;
+      term = -1;
+      if (carry >= 0) walkTransformers(lines,carry,&starts,&term);
+      long long tend[2];
+      tend[0] = fsize+1;
+      tend[1] = fsize+1;
+      if (term >= 0) {
+        tend[0] = offsets[term];
+        tend[1] = offsets[term+1];
+      }
+      long long rend[2];
+      ierr = MPI_Allreduce(tend,rend,2,MPI_LONG_LONG,MPI_MIN,comm);
+      if (rend[0] > fsize) {
+        char buf[512];
+        sprintf(buf,"Network configuration file %s is missing the end of"
+            " the transformer section\n\n",fileName.c_str());
+        throw gridpack::Exception(buf);
+      }
+
+      // Each processor takes the records that start in its range and
+      // reads the remaining lines of its last record
+      long long first = rend[0];
+      if (starts.size() > 0) first = offsets[starts[0]];
+      std::vector<long long> allFirst(nprocs);
+      ierr = MPI_Allgather(&first,1,MPI_LONG_LONG,&allFirst[0],1,
+          MPI_LONG_LONG,comm);
+      long long last = rend[0];
+      for (i=nprocs-1; i>me; i--) {
+        if (allFirst[i] < last) last = allFirst[i];
+      }
+      std::vector<std::string> rlines;
+      if (starts.size() > 0) {
+        int iend = term >= 0 ? term : lines.size();
+        for (i=starts[0]; i<iend; i++) rlines.push_back(lines[i]);
+        long long pos = offsets.back();
+        if (term < 0 && last > pos) {
+          readLines(fin,pos,last,pos,lines,NULL);
+          for (i=0; i<lines.size(); i++) rlines.push_back(lines[i]);
+        }
+      }
+      lines.clear();
+      offsets.clear();
+      walkTransformers(rlines,0,&starts,&term);
+
+      // Assemble records and find their destinations. Three-winding
+      // transformers only create a new bus if the transformer is active
+      // and the second line is complete, as in TransformerParser33
+      gridpack::parser::BaseBlockParser base(&p_busMap, &p_nameMap,
+          &p_branchMap);
+      int nrec = starts.size();
+      std::vector<std::string> records;
+      std::vector<int> dest, bus3;
+      std::vector<int> nw3(nrec,0);
+      int nactive = 0;
+      for (i=0; i<nrec; i++) {
+        std::string line = rlines[starts[i]];
+        base.cleanComment(line);
+        std::vector<std::string> split_line = base.splitPSSELine(line);
+        int nl = isWinding3(split_line) ? 5 : 4;
+        std::string record;
+        int n = 0;
+        std::vector<std::string> split_line2;
+        for (j=starts[i]; j<rlines.size() && n<nl; j++) {
+          if (base.check_comment(rlines[j])) continue;
+          if (n > 0) record.append("\n");
+          record.append(rlines[j]);
+          if (n == 1) {
+            line = rlines[j];
+            base.cleanComment(line);
+            split_line2 = base.splitPSSELine(line);
+          }
+          n++;
+        }
+        records.push_back(record);
+        if (nl == 5) {
+          int stat = split_line.size() > 11 ?
+            atoi(split_line[11].c_str()) : 0;
+          if (split_line2.size() >= 4 && stat != 0) {
+            nactive++;
+            nw3[i] = nactive;
+          } else {
+            nw3[i] = -1;
+          }
+        }
+      }
+      int offset = 0;
+      ierr = MPI_Exscan(&nactive,&offset,1,MPI_INT,MPI_SUM,comm);
+      if (me == 0) offset = 0;
+      std::vector<std::string> srecords;
+      std::vector<int> values;
+      for (i=0; i<nrec; i++) {
+        std::string line = rlines[starts[i]];
+        base.cleanComment(line);
+        std::vector<std::string> split_line = base.splitPSSELine(line);
+        int idx1 = std::abs(atoi(split_line[0].c_str()));
+        int idx2 = split_line.size() > 1 ?
+          std::abs(atoi(split_line[1].c_str())) : 0;
+        if (nw3[i] == 0) {
+          srecords.push_back(records[i]);
+          values.push_back(0);
+          dest.push_back(branchOwner(idx1,idx2));
+        } else if (nw3[i] > 0) {
+          int idx3 = std::abs(atoi(split_line[2].c_str()));
+          int nbus = p_maxBusIndex + offset + nw3[i];
+          int owners[4];
+          owners[0] = busOwner(nbus);
+          owners[1] = branchOwner(idx1,nbus);
+          owners[2] = branchOwner(idx2,nbus);
+          owners[3] = branchOwner(idx3,nbus);
+          std::sort(owners,owners+4);
+          for (j=0; j<4; j++) {
+            if (j > 0 && owners[j] == owners[j-1]) continue;
+            srecords.push_back(records[i]);
+            values.push_back(nbus);
+            dest.push_back(owners[j]);
+          }
+        }
+      }
+      records.clear();
+      rlines.clear();
+      exchangeRecords(srecords,values,dest);
+
+      // Parse two-winding transformers together, in file order
+      nrec = srecords.size();
+      for (i=0; i<nrec; i++) {
+        if (values[i] == 0) {
+          splitRecord(srecords[i],lines);
+        } else {
+          std::string line = srecords[i].substr(0,srecords[i].find('\n'));
+          base.cleanComment(line);
+          std::vector<std::string> split_line = base.splitPSSELine(line);
+          for (j=0; j<3; j++) {
+            bus3.push_back(std::abs(atoi(split_line[j].c_str())));
+          }
+        }
+      }
+      lines.push_back("0 / END OF DATA");
+      {
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::TransformerParser33 transformer_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        transformer_parser.parse(stream,p_busData,p_branchData,p_case_sbase,
+            p_maxBusIndex);
+        stream.close();
+      }
+      lines.clear();
+
+      // Three-winding transformers need data from all three buses. Add
+      // copies of buses that are owned by other processors. Each record is
+      // parsed separately so that its new bus gets the number assigned
+      // above
+      int nbus = p_busData.size();
+      addRemoteBuses(bus3);
+      *nghost = p_busData.size() - nbus;
+      for (i=0; i<nrec; i++) {
+        if (values[i] == 0) continue;
+        splitRecord(srecords[i],lines);
+        lines.push_back("0 / END OF DATA");
+        gridpack::stream::InputStream stream;
+        stream.openStringVector(lines);
+        gridpack::parser::TransformerParser33 transformer_parser(&p_busMap,
+            &p_nameMap, &p_branchMap);
+        transformer_parser.parse(stream,p_busData,p_branchData,p_case_sbase,
+            values[i]-1);
+        stream.close();
+        lines.clear();
+      }
+      return rend[1];
+    }
+
+    /**
+     * Append the lines of a multi-line record to a list of lines
+     * @param record lines of record separated by newlines
+     * @param lines list of lines
+     */
+    void splitRecord(const std::string &record,
+        std::vector<std::string> &lines)
+    {
+      size_t first = 0;
+      size_t pos;
+      while ((pos = record.find('\n',first)) != std::string::npos) {
+        lines.push_back(record.substr(first,pos-first));
+        first = pos+1;
+      }
+      lines.push_back(record.substr(first));
+    }
+
+    /**
+     * Send records to their destination processors together with one
+     * integer value per record. Records may contain several lines. On
+     * return, records and values contain the records and values received
+     * by this processor in file order
+     * @param records records to send, replaced by records received
+     * @param values values to send, replaced by values received
+     * @param dest destination processor of each record
+     */
+    void exchangeRecords(std::vector<std::string> &records,
+        std::vector<int> &values, const std::vector<int> &dest)
+    {
+      MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+      int nprocs(p_network->communicator().size());
+      int i, ierr;
+      int nrec = records.size();
+      // Number of characters and number of records for each processor
+      std::vector<int> scounts(2*nprocs,0), rcounts(2*nprocs);
+      for (i=0; i<nrec; i++) {
+        scounts[2*dest[i]] += records[i].size()+1;
+        scounts[2*dest[i]+1]++;
+      }
+      ierr = MPI_Alltoall(&scounts[0],2,MPI_INT,&rcounts[0],2,MPI_INT,comm);
+      std::vector<int> ccounts(nprocs), crcounts(nprocs);
+      std::vector<int> vcounts(nprocs), vrcounts(nprocs);
+      std::vector<int> cdispl(nprocs), crdispl(nprocs);
+      std::vector<int> vdispl(nprocs), vrdispl(nprocs);
+      int csize = 0, crsize = 0, vsize = 0, vrsize = 0;
+      for (i=0; i<nprocs; i++) {
+        ccounts[i] = scounts[2*i];
+        vcounts[i] = scounts[2*i+1];
+        crcounts[i] = rcounts[2*i];
+        vrcounts[i] = rcounts[2*i+1];
+        cdispl[i] = csize;
+        vdispl[i] = vsize;
+        crdispl[i] = crsize;
+        vrdispl[i] = vrsize;
+        csize += ccounts[i];
+        vsize += vcounts[i];
+        crsize += crcounts[i];
+        vrsize += vrcounts[i];
+      }
+      std::vector<char> sbuf(csize+1), rbuf(crsize+1);
+      std::vector<int> svals(vsize+1), rvals(vrsize+1);
+      std::vector<int> cpos(cdispl), vpos(vdispl);
+      for (i=0; i<nrec; i++) {
+        int p = dest[i];
+        int len = records[i].size();
+        memcpy(&sbuf[cpos[p]],records[i].c_str(),len);
+        sbuf[cpos[p]+len] = '\0';
+        cpos[p] += len+1;
+        svals[vpos[p]] = values[i];
+        vpos[p]++;
+      }
+      records.clear();
+      ierr = MPI_Alltoallv(&sbuf[0],&ccounts[0],&cdispl[0],MPI_CHAR,
+          &rbuf[0],&crcounts[0],&crdispl[0],MPI_CHAR,comm);
+      ierr = MPI_Alltoallv(&svals[0],&vcounts[0],&vdispl[0],MPI_INT,
+          &rvals[0],&vrcounts[0],&vrdispl[0],MPI_INT,comm);
+      int first = 0;
+      for (i=0; i<crsize; i++) {
+        if (rbuf[i] == '\0') {
+          records.push_back(std::string(&rbuf[first],i-first));
+          first = i+1;
+        }
+      }
+      values.assign(rvals.begin(),rvals.begin()+vrsize);
+    }
+
+    /**
+     * Add copies of buses owned by other processors. Each bus is requested
+     * from the processor that owns it while the file is being read
+     * @param buses bus numbers. Buses that are already on this processor
+     * are ignored
+     */
+    void addRemoteBuses(std::vector<int> &buses)
+    {
+      MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+      int nprocs(p_network->communicator().size());
+      int i, j, ierr;
+      std::sort(buses.begin(),buses.end());
+      buses.erase(std::unique(buses.begin(),buses.end()),buses.end());
+      std::vector<std::vector<int> > req(nprocs);
+      for (i=0; i<buses.size(); i++) {
+        if (p_busMap.find(buses[i]) == p_busMap.end()) {
+          req[busOwner(buses[i])].push_back(buses[i]);
+        }
+      }
+      std::vector<int> scounts(nprocs), rcounts(nprocs);
+      std::vector<int> sdispl(nprocs), rdispl(nprocs);
+      std::vector<int> sbuf;
+      for (i=0; i<nprocs; i++) {
+        scounts[i] = req[i].size();
+        sdispl[i] = sbuf.size();
+        sbuf.insert(sbuf.end(),req[i].begin(),req[i].end());
+      }
+      ierr = MPI_Alltoall(&scounts[0],1,MPI_INT,&rcounts[0],1,MPI_INT,comm);
+      int rsize = 0;
+      for (i=0; i<nprocs; i++) {
+        rdispl[i] = rsize;
+        rsize += rcounts[i];
+      }
+      int ssize = sbuf.size();
+      sbuf.push_back(0);
+      std::vector<int> rbuf(rsize+1);
+      ierr = MPI_Alltoallv(&sbuf[0],&scounts[0],&sdispl[0],MPI_INT,
+          &rbuf[0],&rcounts[0],&rdispl[0],MPI_INT,comm);
+
+      // Return flag, area, owner, voltage magnitude and angle of each
+      // requested bus
+      const int nval = 5;
+      std::vector<double> vbuf(nval*rsize+1,0.0);
+      std::map<int,int>::iterator it;
+      for (i=0; i<rsize; i++) {
+        it = p_busMap.find(rbuf[i]);
+        if (it == p_busMap.end()) continue;
+        int ival;
+        double rval;
+        boost::shared_ptr<gridpack::component::DataCollection>
+          data = p_busData[it->second];
+        vbuf[nval*i] = 1.0;
+        if (data->getValue(BUS_AREA,&ival))
+          vbuf[nval*i+1] = static_cast<double>(ival);
+        if (data->getValue(BUS_OWNER,&ival))
+          vbuf[nval*i+2] = static_cast<double>(ival);
+        if (data->getValue(BUS_VOLTAGE_MAG,&rval)) vbuf[nval*i+3] = rval;
+        if (data->getValue(BUS_VOLTAGE_ANG,&rval)) vbuf[nval*i+4] = rval;
+      }
+      for (i=0; i<nprocs; i++) {
+        scounts[i] *= nval;
+        sdispl[i] *= nval;
+        rcounts[i] *= nval;
+        rdispl[i] *= nval;
+      }
+      std::vector<double> dbuf(nval*ssize+1);
+      ierr = MPI_Alltoallv(&vbuf[0],&rcounts[0],&rdispl[0],MPI_DOUBLE,
+          &dbuf[0],&scounts[0],&sdispl[0],MPI_DOUBLE,comm);
+      for (i=0; i<ssize; i++) {
+        if (dbuf[nval*i] == 0.0) continue;
+        boost::shared_ptr<gridpack::component::DataCollection>
+          data(new gridpack::component::DataCollection);
+        data->addValue(BUS_NUMBER,sbuf[i]);
+        data->addValue(BUS_AREA,static_cast<int>(dbuf[nval*i+1]));
+        data->addValue(BUS_OWNER,static_cast<int>(dbuf[nval*i+2]));
+        data->addValue(BUS_VOLTAGE_MAG,dbuf[nval*i+3]);
+        data->addValue(BUS_VOLTAGE_ANG,dbuf[nval*i+4]);
+        p_busMap.insert(std::pair<int,int>(sbuf[i],p_busData.size()));
+        p_busData.push_back(data);
+      }
+    }
+
+    /**
+     * Read all lines that start in the byte range [lo,hi) of a file. A
+     * line that starts before lo is left to the processor reading the
+     * previous range
+     * @param fin file stream
+     * @param lo first byte of range
+     * @param hi one past the last byte of range
+     * @param start start of the section containing the range. This is
+     * always the beginning of a line
+     * @param lines lines that start in range
+     * @param offsets if not NULL, the byte offset of each line followed
+     * by the offset of the first byte after the last line
+     */
+    void readLines(std::ifstream &fin, long long lo, long long hi,
+        long long start, std::vector<std::string> &lines,
+        std::vector<long long> *offsets)
+    {
+      lines.clear();
+      if (offsets) offsets->clear();
+      if (lo >= hi) return;
+      std::string line;
+      long long pos = lo;
+      fin.clear();
+      if (lo > start) {
+        // Skip remainder of line that started in the previous range. If
+        // the previous byte is a newline, this reads an empty line
+        fin.seekg(lo-1);
+        std::getline(fin,line);
+        pos = lo-1+static_cast<long long>(line.size())+1;
+      } else {
+        fin.seekg(lo);
+      }
+      while (pos < hi && std::getline(fin,line)) {
+        if (offsets) offsets->push_back(pos);
+        pos += static_cast<long long>(line.size())+1;
+        if (line.size() > 0 && line[line.size()-1] == '\r') {
+          line.resize(line.size()-1);
+        }
+        lines.push_back(line);
+      }
+      if (offsets) offsets->push_back(pos);
+    }
+
+    /**
+     * Find the processor that owns a bus while the file is being read
+     * @param idx bus number
+     * @return rank of owning processor
+     */
+    int busOwner(int idx)
+    {
+      int nprocs(p_network->communicator().size());
+      return static_cast<int>(static_cast<unsigned int>(idx)%nprocs);
+    }
+
+    /**
+     * Find the processor that owns a branch while the file is being read.
+     * The owner does not depend on the direction of the branch
+     * @param idx1, idx2 bus numbers at either end of branch
+     * @return rank of owning processor
+     */
+    int branchOwner(int idx1, int idx2)
+    {
+      int nprocs(p_network->communicator().size());
+      unsigned long lo = static_cast<unsigned int>(std::min(idx1,idx2));
+      unsigned long hi = static_cast<unsigned int>(std::max(idx1,idx2));
+      return static_cast<int>((lo*2654435761ul+hi)%nprocs);
+    }
+
+    /**
+     * Find the destination of each record in a block of lines. Comment
+     * lines are removed.
+     * @param lines lines from a single section
+     * @param branch true if lines are branch records, otherwise records
+     * start with a bus number
+     * @param dest destination processor of each line
+     */
+    void routeLines(std::vector<std::string> &lines, bool branch,
+        std::vector<int> &dest)
+    {
+      gridpack::parser::BaseBlockParser base(&p_busMap, &p_nameMap,
+          &p_branchMap);
+      dest.clear();
+      int i;
+      int nlines = lines.size();
+      int ncnt = 0;
+      for (i=0; i<nlines; i++) {
+        if (base.check_comment(lines[i]) || base.isBlank(lines[i])) continue;
+        if (branch) {
+          std::string line = lines[i];
+          base.cleanComment(line);
+          std::vector<std::string> split_line = base.splitPSSELine(line);
+          int idx1 = atoi(split_line[0].c_str());
+          int idx2 = split_line.size() > 1 ? atoi(split_line[1].c_str()) : 0;
+          dest.push_back(branchOwner(std::abs(idx1),std::abs(idx2)));
+        } else {
+          dest.push_back(busOwner(std::abs(atoi(lines[i].c_str()))));
+        }
+        if (ncnt != i) lines[ncnt] = lines[i];
+        ncnt++;
+      }
+      lines.resize(ncnt);
+    }
+
+    /**
+     * Send lines to their destination processors. On return, lines
+     * contains the lines received by this processor in file order
+     * @param lines lines to send, replaced by lines received
+     * @param dest destination processor of each line
+     */
+    void exchangeLines(std::vector<std::string> &lines,
+        const std::vector<int> &dest)
+    {
+      MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+      int nprocs(p_network->communicator().size());
+      int i, ierr;
+      int nlines = lines.size();
+      std::vector<int> scounts(nprocs,0), rcounts(nprocs);
+      std::vector<int> sdispl(nprocs), rdispl(nprocs);
+      for (i=0; i<nlines; i++) {
+        scounts[dest[i]] += lines[i].size()+1;
+      }
+      ierr = MPI_Alltoall(&scounts[0],1,MPI_INT,&rcounts[0],1,MPI_INT,comm);
+      int ssize = 0;
+      int rsize = 0;
+      for (i=0; i<nprocs; i++) {
+        sdispl[i] = ssize;
+        rdispl[i] = rsize;
+        ssize += scounts[i];
+        rsize += rcounts[i];
+      }
+      std::vector<char> sbuf(ssize+1), rbuf(rsize+1);
+      std::vector<int> pos(sdispl);
+      for (i=0; i<nlines; i++) {
+        int len = lines[i].size();
+        memcpy(&sbuf[pos[dest[i]]],lines[i].c_str(),len);
+        sbuf[pos[dest[i]]+len] = '\n';
+        pos[dest[i]] += len+1;
+      }
+      lines.clear();
+      ierr = MPI_Alltoallv(&sbuf[0],&scounts[0],&sdispl[0],MPI_CHAR,
+          &rbuf[0],&rcounts[0],&rdispl[0],MPI_CHAR,comm);
+      int first = 0;
+      for (i=0; i<rsize; i++) {
+        if (rbuf[i] == '\n') {
+          lines.push_back(std::string(&rbuf[first],i-first));
+          first = i+1;
+        }
+      }
+    }
+
     // Distribute data uniformly on processors
     void brdcst_data(void)
     {
@@ -507,6 +1448,9 @@ class PTI33_parser : public BasePTIParser<_network>
     double p_case_sbase;
     gridpack::utility::CoarseTimer *p_timer;
 
+    // Read RAW file on all processors
+    bool p_parallelRead;
+
     /**
      * Data collection object associated with network as a whole
      */
@@ -82,7 +82,10 @@ void gridpack::parser::MultiSectParser33::parse(
     }
     nelems = split_line.size() - 3;
 
-    if (!found || nelems <= 0) continue;
+    if (!found || nelems <= 0) {
+      stream.nextLine(line);
+      continue;
+    }
 
     // Clean up 2 character tag
     gridpack::utility::StringUtils util;
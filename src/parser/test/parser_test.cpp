@@ -28,6 +28,7 @@
 #include "gridpack/component/base_component.hpp"
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/parser/PTI23_parser.hpp"
+#include "gridpack/parser/PTI33_parser.hpp"
 #include "gridpack/parser/hash_distr.hpp"
 
 class TestBus
@@ -57,6 +58,41 @@ typedef gridpack::network::BaseNetwork<TestBus, TestBranch> TestNetwork;
 struct bus_data {int idx;};
 struct branch_data {int idx1; int idx2;};
 
+// Evaluate global sums that characterize the contents of a network
+void networkSums(boost::shared_ptr<TestNetwork> network, double *sums)
+{
+  double lsums[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  int i, j, n;
+  double rval;
+  int nbus = network->numBuses();
+  for (i=0; i<nbus; i++) {
+    gridpack::component::DataCollection *data = network->getBusData(i).get();
+    lsums[0] += 1.0;
+    if (data->getValue(LOAD_NUMBER,&n)) {
+      for (j=0; j<n; j++) {
+        if (data->getValue(LOAD_PL,&rval,j)) lsums[1] += rval;
+      }
+    }
+    if (data->getValue(GENERATOR_NUMBER,&n)) {
+      for (j=0; j<n; j++) {
+        if (data->getValue(GENERATOR_PG,&rval,j)) lsums[2] += rval;
+      }
+    }
+  }
+  int nbranch = network->numBranches();
+  for (i=0; i<nbranch; i++) {
+    gridpack::component::DataCollection *data = network->getBranchData(i).get();
+    lsums[3] += 1.0;
+    if (data->getValue(BRANCH_NUM_ELEMENTS,&n)) {
+      for (j=0; j<n; j++) {
+        if (data->getValue(BRANCH_X,&rval,j)) lsums[4] += rval;
+      }
+    }
+  }
+  MPI_Allreduce(lsums,sums,5,MPI_DOUBLE,MPI_SUM,
+      static_cast<MPI_Comm>(network->communicator()));
+}
+
 // -------------------------------------------------------------
 //  Main Program
 // -------------------------------------------------------------
@@ -171,6 +207,36 @@ main(int argc, char **argv)
     } else if (world.rank() == 0) {
       printf("\nError in hash distribution\n");
     }
+
+    // Check that reading a PSS/E v33 file on all processors gives the
+    // same network as reading it on process 0. The second file contains
+    // a three-winding transformer, a comment line inside the transformer
+    // block and a switched shunt
+    const char *v33files[2] = {"IEEE14_PTIv33.raw", "IEEE14_3wind_v33.raw"};
+    int ifile;
+    for (ifile=0; ifile<2; ifile++) {
+      boost::shared_ptr<TestNetwork> seqNetwork(new TestNetwork(world));
+      gridpack::parser::PTI33_parser<TestNetwork> seqParser(seqNetwork);
+      seqParser.parse(v33files[ifile]);
+      boost::shared_ptr<TestNetwork> parNetwork(new TestNetwork(world));
+      gridpack::parser::PTI33_parser<TestNetwork> parParser(parNetwork);
+      parParser.setParallelRead(true);
+      parParser.parse(v33files[ifile]);
+      double seqSums[5], parSums[5];
+      networkSums(seqNetwork,seqSums);
+      networkSums(parNetwork,parSums);
+      schk = 0;
+      for (i=0; i<5; i++) {
+        if (fabs(seqSums[i]-parSums[i]) > 1.0e-8*(1.0+fabs(seqSums[i]))) {
+          schk = 1;
+        }
+      }
+      if (schk == 0 && world.rank() == 0) {
+        printf("\nParallel parsing of %s is ok\n",v33files[ifile]);
+      } else if (world.rank() == 0) {
+        printf("\nError in parallel parsing of %s\n",v33files[ifile]);
+      }
+    }
   }
 
   GA_Terminate();
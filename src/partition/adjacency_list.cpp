@@ -47,7 +47,8 @@ const AdjacencyList::Index AdjacencyList::bogus(-1);
 AdjacencyList::AdjacencyList(const parallel::Communicator& comm)
   : parallel::Distributed(comm),
     utility::Uncopyable(),
-    p_global_nodes(), p_original_nodes(), p_edges(), p_adjacency()
+    p_global_nodes(), p_original_nodes(), p_node_weights(), p_edges(),
+    p_adjacency(), p_adjacency_weights()
 {
   // empty
 }
@@ -56,10 +57,12 @@ AdjacencyList::AdjacencyList(const parallel::Communicator& comm,
                              const int& local_nodes, const int& local_edges)
   : parallel::Distributed(comm),
     utility::Uncopyable(),
-    p_global_nodes(), p_original_nodes(), p_edges(), p_adjacency()
+    p_global_nodes(), p_original_nodes(), p_node_weights(), p_edges(),
+    p_adjacency(), p_adjacency_weights()
 {
   p_global_nodes.reserve(local_nodes);
   p_original_nodes.reserve(local_nodes);
+  p_node_weights.reserve(local_nodes);
   p_edges.reserve(local_edges);
   p_adjacency.reserve(local_nodes);
 }
@@ -89,6 +92,16 @@ AdjacencyList::edge_index(const int& local_index) const
   return p_edges[local_index].index;
 }
 
+// -------------------------------------------------------------
+// AdjacencyList::node_weight
+// -------------------------------------------------------------
+int
+AdjacencyList::node_weight(const int& local_index) const
+{
+  BOOST_ASSERT(local_index < this->nodes());
+  return p_node_weights[local_index];
+}
+
 // -------------------------------------------------------------
 // AdjacencyList::edge
 // -------------------------------------------------------------
@@ -112,6 +125,8 @@ AdjacencyList::ready(void)
   int nprocs = GA_Pgroup_nnodes(grp);
   p_adjacency.clear();
   p_adjacency.resize(p_global_nodes.size());
+  p_adjacency_weights.clear();
+  p_adjacency_weights.resize(p_global_nodes.size());
 
   // Find total number of nodes and edges. Assume no duplicates
   int nedges = p_edges.size();
@@ -205,15 +220,17 @@ AdjacencyList::ready(void)
   GA_Destroy(g_nodes);
 
   // All edges now have global indices assigned to them. Begin constructing
-  // adjacency list. Start by creating a global array containing all edges
+  // adjacency list. Start by creating a global array containing all edges.
+  // Each edge is stored as the global indices of its ends followed by its
+  // weight
   dist[0] = 0;
   for (p=1; p<nprocs; p++) {
     double max = static_cast<double>(total_edges);
     max = (static_cast<double>(p))*(max/(static_cast<double>(nprocs)));
-    dist[p] = 2*(static_cast<int>(max));
+    dist[p] = 3*(static_cast<int>(max));
   }
   int g_edges = GA_Create_handle();
-  dims = 2*total_edges;
+  dims = 3*total_edges;
   NGA_Set_data(g_edges,1,&dims,C_INT);
   NGA_Set_irreg_distr(g_edges,&dist[0],&nprocs);
   NGA_Set_pgroup(g_edges, grp);
@@ -235,15 +252,16 @@ AdjacencyList::ready(void)
   std::vector<int> offset(nprocs);
   offset[0] = 0;
   for (p=1; p<nprocs; p++) {
-    offset[p] = offset[p-1] + 2*dist[p-1];
+    offset[p] = offset[p-1] + 3*dist[p-1];
   }
   // Figure out where local data goes in GA and then copy it to GA
   lo = offset[me];
-  hi = lo + 2*nedges - 1;
-  std::vector<int> edge_ids(2*nedges);
+  hi = lo + 3*nedges - 1;
+  std::vector<int> edge_ids(3*nedges);
   for (i=0; i<nedges; i++) {
-    edge_ids[2*i] = static_cast<int>(p_edges[i].global_conn.first);
-    edge_ids[2*i+1] = static_cast<int>(p_edges[i].global_conn.second);
+    edge_ids[3*i] = static_cast<int>(p_edges[i].global_conn.first);
+    edge_ids[3*i+1] = static_cast<int>(p_edges[i].global_conn.second);
+    edge_ids[3*i+2] = p_edges[i].weight;
   }
   if (lo <= hi) {
     int ld = 1;
@@ -269,22 +287,25 @@ AdjacencyList::ready(void)
     int *buf = new int[size];
     int ld = 1;
     NGA_Get(g_edges,&lo,&hi,buf,&ld);
-    BOOST_ASSERT(size%2 == 0);
-    size = size/2;
-    int idx1, idx2;
+    BOOST_ASSERT(size%3 == 0);
+    size = size/3;
+    int idx1, idx2, wgt;
     Index idx;
     for (i=0; i<size; i++) {
-      idx1 = buf[2*i];
-      idx2 = buf[2*i+1];
+      idx1 = buf[3*i];
+      idx2 = buf[3*i+1];
+      wgt = buf[3*i+2];
       it = gmap.find(idx1);
       if (it != gmap.end()) {
         idx = static_cast<Index>(idx2);
         p_adjacency[it->second].push_back(idx);
+        p_adjacency_weights[it->second].push_back(wgt);
       }
       it = gmap.find(idx2);
       if (it != gmap.end()) {
         idx = static_cast<Index>(idx1);
         p_adjacency[it->second].push_back(idx);
+        p_adjacency_weights[it->second].push_back(wgt);
       }
     }
     delete [] buf;
@@ -414,6 +435,20 @@ AdjacencyList::node_neighbors(const int& local_index,
 
 }
 
+// -------------------------------------------------------------
+// AdjacencyList::node_neighbor_weights
+// -------------------------------------------------------------
+void
+AdjacencyList::node_neighbor_weights(const int& local_index,
+                                     std::vector<int>& weights) const
+{
+  BOOST_ASSERT(local_index < p_adjacency_weights.size());
+  weights.clear();
+  std::copy(p_adjacency_weights[local_index].begin(),
+            p_adjacency_weights[local_index].end(),
+            std::back_inserter(weights));
+}
+
 
 } // namespace network
 } // namespace gridpack
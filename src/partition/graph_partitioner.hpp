@@ -49,19 +49,23 @@ public:
   /// Destructor
   ~GraphPartitioner(void);
 
-  /// Add the global index of a local node and the original index of local node
-  void add_node(const Index& global_index, const Index& original_index)
+  /// Add the global index of a local node and the original index of local
+  /// node. The weight is the cost of the node used to balance the partition
+  void add_node(const Index& global_index, const Index& original_index,
+                const int& weight = 1)
   {
-    p_impl->add_node(global_index, original_index);
+    p_impl->add_node(global_index, original_index, weight);
   }
   
   /// Add the global index of a local edge and what it connects using the original
-  /// indices of the buses at either end of the node 
+  /// indices of the buses at either end of the node. The weight is the cost
+  /// of cutting the edge
   void add_edge(const Index& edge_index, 
                 const Index& node_index_1,
-                const Index& node_index_2)
+                const Index& node_index_2,
+                const int& weight = 1)
   {
-    p_impl->add_edge(edge_index, node_index_1, node_index_2);
+    p_impl->add_edge(edge_index, node_index_1, node_index_2, weight);
   }
 
   /// Get the global indices of the buses at either end of a branch
@@ -100,6 +104,12 @@ public:
     p_impl->partition();
   }
 
+  /// Distribute the graph using known destinations for local nodes
+  void partition(const IndexVector& node_dest)
+  {
+    p_impl->partition(node_dest);
+  }
+
   /// Get the node destinations
   void node_destinations(IndexVector& dest) const
   {
@@ -120,6 +120,32 @@ GraphPartitionerImplementation::ghost_edge_destinations(GraphPartitionerImplemen
 // -------------------------------------------------------------
 void
 GraphPartitionerImplementation::partition(void)
+{
+  p_distribute(NULL);
+}
+
+// -------------------------------------------------------------
+// GraphPartitionerImplementation::partition
+// -------------------------------------------------------------
+/** 
+ * The partitioner is not called. Instead, local nodes are sent to the
+ * processes given in @c node_dest and edge and ghost destinations are
+ * derived from these in the same way as for a partitioned graph. This
+ * is used to move part of a graph that has already been distributed.
+ * 
+ * @param node_dest destination process of each local node
+ */
+void
+GraphPartitionerImplementation::partition(const IndexVector& node_dest)
+{
+  p_distribute(&node_dest);
+}
+
+// -------------------------------------------------------------
+// GraphPartitionerImplementation::p_distribute
+// -------------------------------------------------------------
+void
+GraphPartitionerImplementation::p_distribute(const IndexVector *node_dest)
 {
   static const bool verbose(false);
 
@@ -174,7 +200,19 @@ GraphPartitionerImplementation::partition(void)
 
   if (timer != NULL) timer->start(t_part);
 
-  this->p_partition();          // fills p_node_destinations
+  if (node_dest != NULL) {
+    if (node_dest->size() != static_cast<size_t>(locnodes)) {
+      boost::format fmt("%d: GraphPartitioner::partition(): %d node destinations given for %d nodes");
+      std::string msg = boost::str(fmt % communicator().worldRank() %
+                                   node_dest->size() % locnodes);
+      throw Exception(msg);
+    }
+    p_node_destinations.clear();
+    std::copy(node_dest->begin(), node_dest->end(),
+              std::back_inserter(p_node_destinations));
+  } else {
+    this->p_partition();          // fills p_node_destinations
+  }
 
   if (timer != NULL) timer->stop(t_part);
 
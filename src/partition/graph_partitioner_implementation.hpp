@@ -53,19 +53,24 @@ public:
   /// Destructor
   virtual ~GraphPartitionerImplementation(void);
 
-  /// Add the global index and original index of a local node
-  void add_node(const Index& global_index, const Index& original_index)
+  /// Add the global index and original index of a local node and the
+  /// cost of the node used to balance the partition
+  void add_node(const Index& global_index, const Index& original_index,
+                const int& weight = 1)
   {
-    p_adjacency_list.add_node(global_index, original_index);
+    p_adjacency_list.add_node(global_index, original_index, weight);
   }
   
   /// Add the global index of a local edge and what it connects using the
-  /// original indices of buses at either end
+  /// original indices of buses at either end. The weight is the cost of
+  /// cutting the edge
   void add_edge(const Index& edge_index, 
                 const Index& node_index_1,
-                const Index& node_index_2)
+                const Index& node_index_2,
+                const int& weight = 1)
   {
-    p_adjacency_list.add_edge(edge_index, node_index_1, node_index_2);
+    p_adjacency_list.add_edge(edge_index, node_index_1, node_index_2,
+                              weight);
   }
 
   /// Get the global indices of the buses at either end of a branch
@@ -101,6 +106,9 @@ public:
   /// Partition the graph
   void partition(void);
 
+  /// Distribute the graph using known destinations for local nodes
+  void partition(const IndexVector& node_dest);
+
   /// Get the node destinations
   void node_destinations(IndexVector& dest) const;
 
@@ -133,6 +141,9 @@ protected:
   /// Partition the graph (specialized)
   virtual void p_partition(void) = 0;
 
+  /// Find destinations of edges and ghosts (partition first if @c node_dest is NULL)
+  void p_distribute(const IndexVector *node_dest);
+
 private:
 
   /// local variable to suppress printing
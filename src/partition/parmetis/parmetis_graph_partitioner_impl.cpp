@@ -61,7 +61,10 @@ ParMETISGraphPartitionerImpl::~ParMETISGraphPartitionerImpl(void)
  * vector that contains adjacency information for all local
  * vertexes/nodes (adjncy), and (3) an index into the adjacency vector
  * that indicates the adjacency info for individual nodes (xadj).
- * These are named as in the ParMETIS documentation.
+ * These are named as in the ParMETIS documentation. The node and edge
+ * weights given to the adjacency list are passed along as vwgt and
+ * adjwgt, so ParMETIS balances the total node weight on each processor
+ * and minimizes the weight of the cut edges.
  * 
  * (I'm starting to remember why I don't like ParMETIS. Serious
  * problems with ParMETIS:
@@ -80,10 +83,12 @@ ParMETISGraphPartitionerImpl::p_partition(void)
   std::vector<idx_t> vtxdist;
   std::vector<idx_t> xadj;
   std::vector<idx_t> adjncy;
+  std::vector<idx_t> vwgt;
+  std::vector<idx_t> adjwgt;
 
   ParMETISGraphWrapper wrap(p_adjacency_list);
 
-  wrap.get_csr_local(vtxdist, xadj, adjncy);
+  wrap.get_csr_local(vtxdist, xadj, adjncy, vwgt, adjwgt);
 
   int nnodes(vtxdist[me+1] - vtxdist[me]);
 
@@ -119,8 +124,6 @@ ParMETISGraphPartitionerImpl::p_partition(void)
   idx_t ncon(1);
   idx_t wgtflag(3), numflag(0);
   idx_t nparts(this->processor_size());
-  std::vector<idx_t> vwgt(nnodes, 1);
-  std::vector<idx_t> adjwgt(adjncy.size(), 2);
   std::vector<real_t> tpwgts(nparts*ncon, 1.0/static_cast<real_t>(nparts));
   real_t ubvec(1.05);
   std::vector<idx_t> options(3);
@@ -29,7 +29,7 @@ namespace bl = boost::lambda;
 static const int one(1);
 static const int two(2);
 
-static const int num_node_data(3);
+static const int num_node_data(4);
 
 namespace gridpack {
 namespace network {
@@ -48,7 +48,7 @@ ParMETISGraphWrapper::ParMETISGraphWrapper(const AdjacencyList& alist)
     p_global_nodes(0), p_global_edges(0),
     p_node_data(), p_local_node_id(), 
     p_node_lo(-1), p_node_hi(-1), 
-    p_xadj_gbl(), p_adjncy_gbl()
+    p_xadj_gbl(), p_adjncy_gbl(), p_adjwgt_gbl()
 {
   p_initialize();
 }
@@ -112,6 +112,15 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
     hi[1] = p_node_hi; hi[1] = 1;
     p_node_data->put(lo, hi, &ndata[0], ld);
 
+    // put the node weight
+
+    for (int n = 0; n < locnodes; ++n) {
+      ndata[n] = p_adjacency.node_weight(n);
+    }
+    lo[0] = p_node_lo; lo[1] = 3;
+    hi[0] = p_node_hi; hi[1] = 3;
+    p_node_data->put(lo, hi, &ndata[0], ld);
+
   }
 
   communicator().sync();
@@ -168,8 +177,13 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
                                          "ParMETIS Adjacency List", NULL));
   p_adjncy_gbl->zero();
 
+  p_adjwgt_gbl.reset(new GA::GlobalArray(MT_C_INT, one, dims,
+                                         "ParMETIS Adjacency Weights", NULL));
+  p_adjwgt_gbl->zero();
+
   std::vector<AdjacencyList::Index> nbrs;
   std::vector<int> inbrs;
+  std::vector<int> wnbrs;
   for (int p = 0; p < this->processor_size(); ++p) {
     if (p == this->processor_rank()) {
       if (locnodes > 0) {
@@ -181,10 +195,14 @@ ParMETISGraphWrapper::p_initialize_gbl(const int& gblnodes, const int& locnodes,
 	  p_adjacency.node_neighbors(i, nbrs);
 	  inbrs.clear();
 	  std::copy(nbrs.begin(), nbrs.end(), std::back_inserter(inbrs));
+	  p_adjacency.node_neighbor_weights(i, wnbrs);
 
 	  lo[0] = tmp[0];
 	  hi[0] = tmp[0] + inbrs.size() - 1;
-	  if (hi[0] >= lo[0]) p_adjncy_gbl->put(lo, hi, &inbrs[0], ld);
+	  if (hi[0] >= lo[0]) {
+            p_adjncy_gbl->put(lo, hi, &inbrs[0], ld);
+            p_adjwgt_gbl->put(lo, hi, &wnbrs[0], ld);
+          }
 
 	  int idx(p_node_lo + i + 1);
 	  tmp[0] += inbrs.size();
@@ -247,11 +265,28 @@ void
 ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
                                     std::vector<idx_t>& xadj,
                                     std::vector<idx_t>& adjncy) const
+{
+  std::vector<idx_t> vwgt, adjwgt;
+  get_csr_local(vtxdist, xadj, adjncy, vwgt, adjwgt);
+}
+
+/** 
+ * The node weights (@c vwgt) and edge weights (@c adjwgt) are
+ * distributed in the same way as the nodes and adjacency list.
+ * 
+ */
+void
+ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
+                                    std::vector<idx_t>& xadj,
+                                    std::vector<idx_t>& adjncy,
+                                    std::vector<idx_t>& vwgt,
+                                    std::vector<idx_t>& adjwgt) const
 {
   BOOST_ASSERT(p_node_data);
   BOOST_ASSERT(p_local_node_id);
   BOOST_ASSERT(p_xadj_gbl);
   BOOST_ASSERT(p_adjncy_gbl);
+  BOOST_ASSERT(p_adjwgt_gbl);
   BOOST_ASSERT(p_global_nodes > 0);
   BOOST_ASSERT(p_global_edges > 0);
 
@@ -316,6 +351,27 @@ ParMETISGraphWrapper::get_csr_local(std::vector<idx_t>& vtxdist,
   adjncy.clear();
   adjncy.reserve(tmp.size());
   std::copy(tmp.begin(), tmp.end(), std::back_inserter(adjncy));
+
+                                // extract edge weights
+
+  adjwgt.clear();
+  adjwgt.resize(nidxsize);
+  if (nidxsize > 0) {
+    p_adjwgt_gbl->get(&lo[0], &hi[0], &nidx[0], &ld[0]);
+    std::copy(nidx.begin(), nidx.end(), adjwgt.begin());
+  }
+
+                                // extract node weights
+
+  vwgt.clear();
+  vwgt.resize(localnodes);
+  if (localnodes > 0) {
+    lo[0] = vtxdist[me]; lo[1] = 3;
+    hi[0] = vtxdist[me+1] - 1; hi[1] = 3;
+    tmp.resize(localnodes);
+    p_node_data->get(&lo[0], &hi[0], &tmp[0], &ld[0]);
+    std::copy(tmp.begin(), tmp.end(), vwgt.begin());
+  }
   communicator().sync();
 }
 
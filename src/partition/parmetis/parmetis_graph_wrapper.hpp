@@ -71,6 +71,13 @@ public:
                      std::vector<idx_t>& xadj,
                      std::vector<idx_t>& adjncy) const;
 
+  /// Get the local part of the "Distributed CSR graph" with node and edge weights
+  void get_csr_local(std::vector<idx_t>& vtxdist,
+                     std::vector<idx_t>& xadj,
+                     std::vector<idx_t>& adjncy,
+                     std::vector<idx_t>& vwgt,
+                     std::vector<idx_t>& adjwgt) const;
+
   /// Assign partition number for local ParMETIS graph nodes
   void set_partition(const std::vector<idx_t>& vtxdist, 
                      const std::vector<idx_t>& part);
@@ -93,7 +100,7 @@ protected:
   /**
    * This is a 2D GA. It's used to hold several things that need to be
    * remembered about the graph nodes: global node id (j=0), initial
-   * owner process(j=1), destination process (j=2)
+   * owner process(j=1), destination process (j=2), node weight (j=3)
    * 
    */
   boost::scoped_ptr<GA::GlobalArray> p_node_data;
@@ -137,6 +144,9 @@ protected:
    */
   boost::scoped_ptr<GA::GlobalArray> p_adjncy_gbl;
 
+  /// The weights of the edges in ::p_adjncy_gbl
+  boost::scoped_ptr<GA::GlobalArray> p_adjwgt_gbl;
+
   /// The initialize routine
   void p_initialize(void);
 
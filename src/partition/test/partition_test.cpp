@@ -225,6 +225,59 @@ BOOST_AUTO_TEST_CASE( unbalanced_partition )
 
 }
 
+/**
+ * @test
+ * 
+ * A linear graph is created on process zero in which the nodes in the
+ * first quarter of the graph are ten times more expensive than the
+ * rest. The total weight of the nodes assigned to each process should
+ * be roughly the same, not the number of nodes.
+ */
+BOOST_AUTO_TEST_CASE( weighted_partition )
+{
+  gridpack::parallel::Communicator world;
+  const int global_nodes(20*world.size());
+  const int global_edges(global_nodes - 1);
+  const int heavy(10);
+  
+  using gridpack::network::GraphPartitioner;
+
+  GraphPartitioner partitioner(world);
+
+  if (world.rank() == 0) {
+    for (int i = 0; i < global_nodes; ++i) {
+      partitioner.add_node(i, i, (4*i < global_nodes ? heavy : 1));
+    }
+    for (int i = 0; i < global_edges; ++i) {
+      partitioner.add_edge(i, i, i+1, 1);
+    }
+  }
+
+  partitioner.partition();
+
+  GraphPartitioner::IndexVector node_dest;
+  partitioner.node_destinations(node_dest);
+  BOOST_CHECK_EQUAL(node_dest.size(), partitioner.nodes());
+
+  std::vector<int> load(world.size(), 0), total(world.size(), 0);
+  for (size_t i = 0; i < node_dest.size(); ++i) {
+    int idx(partitioner.node_index(i));
+    load[node_dest[i]] += (4*idx < global_nodes ? heavy : 1);
+  }
+  boost::mpi::all_reduce(world, &load[0], world.size(), &total[0],
+                         std::plus<int>());
+  if (world.size() > 1) {
+    double avg(0.0);
+    int lmax(0);
+    for (int p = 0; p < world.size(); ++p) {
+      avg += total[p];
+      lmax = std::max(lmax, total[p]);
+    }
+    avg /= static_cast<double>(world.size());
+    BOOST_CHECK(static_cast<double>(lmax) <= 1.5*avg);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
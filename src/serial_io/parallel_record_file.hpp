@@ -0,0 +1,310 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   parallel_record_file.hpp
+ *
+ * @brief  A binary file that all processors write output records to in
+ * parallel using MPI-IO. Each call to write() adds a frame to the file
+ * containing optional header text from process 0 followed by the records
+ * of all processors. Records are stored without the padding of the fixed
+ * length buffers they were created in, together with the global index of
+ * the bus or branch that created them. The text that the serial writers
+ * would have produced can be reconstructed from the file with toText().
+ *
+ * File layout:
+ *   RecordFileHeader
+ *   frames, each consisting of
+ *     RecordFrameHeader
+ *     header text (textBytes)
+ *     index table (nrecords pairs of global index and record length)
+ *     record text (recordBytes)
+ */
+// -------------------------------------------------------------
+
+#ifndef _parallel_record_file_h_
+#define _parallel_record_file_h_
+
+#include <mpi.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include "gridpack/utilities/exception.hpp"
+
+#define GRIDPACK_RECORD_MAGIC "GPRECS\0\0"
+#define GRIDPACK_RECORD_VERSION 1
+
+namespace gridpack {
+namespace serial_io {
+
+/** @cond */
+struct RecordFileHeader {
+  char magic[8];        // GRIDPACK_RECORD_MAGIC
+  int version;          // GRIDPACK_RECORD_VERSION
+  int nprocs;           // number of processes that wrote the file
+};
+
+struct RecordFrameHeader {
+  long long textBytes;   // length of header text from process 0
+  long long nrecords;    // number of records in frame
+  long long recordBytes; // total length of record text
+};
+
+struct RecordIndex {
+  int index;             // global index of bus or branch
+  int length;            // length of record text
+};
+/** @endcond */
+
+class ParallelRecordFile {
+  public:
+
+  /**
+   * Open file for parallel output. This is collective on the communicator
+   * @param comm communicator of processes writing the file
+   * @param filename name of file
+   */
+  ParallelRecordFile(MPI_Comm comm, const char *filename)
+    : p_comm(comm), p_offset(0), p_open(false)
+  {
+    MPI_Comm_rank(p_comm,&p_me);
+    MPI_Comm_size(p_comm,&p_nprocs);
+    int ierr = MPI_File_open(p_comm, const_cast<char*>(filename),
+        MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &p_file);
+    if (ierr != MPI_SUCCESS) {
+      char buf[512];
+      sprintf(buf,"p[%d] ParallelRecordFile: could not open file %s\n",
+          p_me,filename);
+      throw gridpack::Exception(buf);
+    }
+    MPI_File_set_size(p_file, 0);
+    RecordFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRIDPACK_RECORD_MAGIC, sizeof(header.magic));
+    header.version = GRIDPACK_RECORD_VERSION;
+    header.nprocs = p_nprocs;
+    if (p_me == 0) {
+      MPI_File_write_at(p_file, 0, &header, sizeof(header), MPI_BYTE,
+          MPI_STATUS_IGNORE);
+    }
+    p_offset = sizeof(header);
+    p_open = true;
+  }
+
+  /**
+   * Destructor. Closing the file is collective, so this does not close it.
+   * The file must be closed with close() on all processes before the
+   * object is destroyed
+   */
+  ~ParallelRecordFile(void)
+  {
+    if (p_open) {
+      fprintf(stderr,"p[%d] ParallelRecordFile destroyed without calling"
+          " close()\n",p_me);
+    }
+  }
+
+  /**
+   * Flush remaining header text and close file. This is collective
+   */
+  void close(void)
+  {
+    if (!p_open) return;
+    // Only process 0 knows if there is header text left, so all processes
+    // take part in writing a final frame
+    std::vector<int> index;
+    flush(index, NULL, 0);
+    MPI_File_close(&p_file);
+    p_open = false;
+  }
+
+  /**
+   * Add text to be written by process 0 at the start of the next frame.
+   * This is not collective and is ignored on all other processes
+   * @param str text
+   */
+  void header(const char *str)
+  {
+    if (p_me == 0) p_text.append(str);
+  }
+
+  /**
+   * Write records from all processes as one frame. This is collective
+   * @param index global indices of the local records
+   * @param records buffer of local records. Each record is a null
+   * terminated string stored in a block of size characters
+   * @param size length of the block holding each record
+   */
+  void write(const std::vector<int> &index, const char *records, int size)
+  {
+    if (!p_open) {
+      char buf[128];
+      sprintf(buf,"p[%d] ParallelRecordFile: write to closed file\n",p_me);
+      throw gridpack::Exception(buf);
+    }
+    flush(index, records, size);
+  }
+
+  /**
+   * Reconstruct the text written by the serial IO classes from a file
+   * created by ParallelRecordFile. Records in each frame are listed in
+   * order of their global index. This is a serial operation
+   * @param filename name of file
+   * @param out stream that text is written to
+   * @return false if file could not be read
+   */
+  static bool toText(const char *filename, std::ostream &out)
+  {
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) return false;
+    RecordFileHeader header;
+    bool ok = (fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, GRIDPACK_RECORD_MAGIC, sizeof(header.magic)) == 0
+        && header.version == GRIDPACK_RECORD_VERSION);
+    RecordFrameHeader frame;
+    std::vector<char> text;
+    std::vector<RecordIndex> table;
+    std::vector<long long> start;
+    std::vector<int> order;
+    while (ok && fread(&frame, sizeof(frame), 1, fp) == 1) {
+      text.resize(frame.textBytes+frame.recordBytes+1);
+      table.resize(frame.nrecords);
+      if (frame.textBytes > 0 &&
+          fread(&text[0], 1, frame.textBytes, fp) != frame.textBytes) {
+        ok = false;
+        break;
+      }
+      out.write(&text[0], frame.textBytes);
+      if (frame.nrecords > 0 &&
+          fread(&table[0], sizeof(RecordIndex), frame.nrecords, fp)
+          != frame.nrecords) {
+        ok = false;
+        break;
+      }
+      if (frame.recordBytes > 0 &&
+          fread(&text[0], 1, frame.recordBytes, fp) != frame.recordBytes) {
+        ok = false;
+        break;
+      }
+      // Records are stored in order of processor. Sort them by global
+      // index to recover the order of the serial writers
+      long long i, pos = 0;
+      start.resize(frame.nrecords);
+      order.resize(frame.nrecords);
+      for (i=0; i<frame.nrecords; i++) {
+        start[i] = pos;
+        pos += table[i].length;
+        order[i] = i;
+      }
+      if (pos != frame.recordBytes) {
+        ok = false;
+        break;
+      }
+      std::stable_sort(order.begin(), order.end(), IndexOrder(table));
+      for (i=0; i<frame.nrecords; i++) {
+        out.write(&text[start[order[i]]], table[order[i]].length);
+      }
+    }
+    fclose(fp);
+    return ok;
+  }
+
+  private:
+
+  /**
+   * Comparison of records by global index
+   */
+  struct IndexOrder {
+    const std::vector<RecordIndex> &p_table;
+    IndexOrder(const std::vector<RecordIndex> &table) : p_table(table) {}
+    bool operator()(int a, int b) const
+    {
+      return p_table[a].index < p_table[b].index;
+    }
+  };
+
+  /**
+   * Write pending header text and records from all processes as one frame
+   * @param index global indices of the local records
+   * @param records buffer of local records
+   * @param size length of the block holding each record
+   */
+  void flush(const std::vector<int> &index, const char *records, int size)
+  {
+    // Strip padding from local records
+    int i, nrec = index.size();
+    std::vector<RecordIndex> table(nrec);
+    std::vector<char> buf;
+    for (i=0; i<nrec; i++) {
+      const char *rec = records + static_cast<size_t>(i)*size;
+      int len = strnlen(rec, size);
+      table[i].index = index[i];
+      table[i].length = len;
+      buf.insert(buf.end(), rec, rec+len);
+    }
+
+    // Exchange sizes to find where each process writes
+    long long local[3], prefix[3], total[3];
+    local[0] = p_text.size();
+    local[1] = nrec;
+    local[2] = buf.size();
+    std::vector<long long> sizes(3*p_nprocs);
+    MPI_Allgather(local, 3, MPI_LONG_LONG, &sizes[0], 3, MPI_LONG_LONG,
+        p_comm);
+    int j;
+    for (j=0; j<3; j++) {
+      prefix[j] = 0;
+      total[j] = 0;
+    }
+    for (i=0; i<p_nprocs; i++) {
+      for (j=0; j<3; j++) {
+        if (i < p_me) prefix[j] += sizes[3*i+j];
+        total[j] += sizes[3*i+j];
+      }
+    }
+    if (total[0] == 0 && total[1] == 0) return;
+
+    MPI_Offset textOffset = p_offset + sizeof(RecordFrameHeader);
+    MPI_Offset tableOffset = textOffset + total[0];
+    MPI_Offset recordOffset = tableOffset + total[1]*sizeof(RecordIndex);
+    if (p_me == 0) {
+      RecordFrameHeader frame;
+      frame.textBytes = total[0];
+      frame.nrecords = total[1];
+      frame.recordBytes = total[2];
+      MPI_File_write_at(p_file, p_offset, &frame, sizeof(frame), MPI_BYTE,
+          MPI_STATUS_IGNORE);
+      if (!p_text.empty()) {
+        MPI_File_write_at(p_file, textOffset, &p_text[0], p_text.size(),
+            MPI_BYTE, MPI_STATUS_IGNORE);
+      }
+      p_text.clear();
+    }
+    char dummy = 0;
+    MPI_File_write_at_all(p_file, tableOffset + prefix[1]*sizeof(RecordIndex),
+        nrec > 0 ? static_cast<void*>(&table[0]) : static_cast<void*>(&dummy),
+        nrec*sizeof(RecordIndex), MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_write_at_all(p_file, recordOffset + prefix[2],
+        buf.size() > 0 ? &buf[0] : &dummy,
+        buf.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+    p_offset = recordOffset + total[2];
+  }
+
+  MPI_Comm p_comm;
+  MPI_File p_file;
+  MPI_Offset p_offset;
+  int p_me;
+  int p_nprocs;
+  bool p_open;
+  std::string p_text;
+};
+
+}   // serial_io
+}   // gridpack
+#endif  // _parallel_record_file_h_
@@ -0,0 +1,45 @@
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   record_to_text.cpp
+ *
+ * @brief  Convert a file written by SerialBusIO::openParallel or
+ * SerialBranchIO::openParallel back to the text listing that the serial
+ * writers would have produced. Usage:
+ *
+ *   record_to_text input.bin [output.txt]
+ *
+ * Text is written to standard out if no output file is given.
+ */
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include "gridpack/serial_io/parallel_record_file.hpp"
+
+int
+main (int argc, char **argv)
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr,"Usage: %s input_file [output_file]\n",argv[0]);
+    return 1;
+  }
+  bool ok;
+  if (argc == 3) {
+    std::ofstream fout(argv[2]);
+    ok = gridpack::serial_io::ParallelRecordFile::toText(argv[1],fout);
+  } else {
+    ok = gridpack::serial_io::ParallelRecordFile::toText(argv[1],std::cout);
+  }
+  if (!ok) {
+    fprintf(stderr,"%s: could not read records from %s\n",argv[0],argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/component/base_component.hpp"
 #include "gridpack/utilities/exception.hpp"
+#include "gridpack/serial_io/parallel_record_file.hpp"
 #ifdef USE_GOSS
 #include "gridpack/serial_io/goss_client.hpp"
 #endif
@@ -37,7 +38,9 @@ namespace serial_io {
 // and branches to standard output. Each bus or branch is
 // responsible for creating a string that can be written to
 // standard out. These modules then organize these sequentially
-// and write them from process 0
+// and write them from process 0. Alternatively, output can be sent
+// to a binary file that all processes write to in parallel (see
+// openParallel)
 // -------------------------------------------------------------
 
 template <class _network>
@@ -108,18 +111,34 @@ class SerialBusIO {
   }
 
   /**
-   * Redirect output to a file instead of standard out
+   * Redirect output to a file instead of standard out. This is collective
+   * if a file was previously opened with openParallel
    * @param filename name of file that output goes to
    */
   void open(const char *filename)
   {
+    this->close();
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
-      this->close();
       p_fout.reset(new std::ofstream);
       p_fout->open(filename);
     }
   }
 
+  /**
+   * Redirect output to a binary file that all processes write their own
+   * bus records to, instead of sending all records to process 0. Records
+   * are stored together with the global index of the bus that wrote them.
+   * The text output can be recovered from the file with
+   * ParallelRecordFile::toText. This function is collective
+   * @param filename name of file that output goes to
+   */
+  void openParallel(const char *filename)
+  {
+    this->close();
+    p_pfile.reset(new ParallelRecordFile(
+          static_cast<MPI_Comm>(p_network->communicator()), filename));
+  }
+
   /**
    * return IO stream
    * @return IO stream to file
@@ -139,10 +158,13 @@ class SerialBusIO {
   }
 
   /**
-   * Close file and redirect output to standard out 
+   * Close file and redirect output to standard out. This is collective
+   * if the file was opened with openParallel
    */
   void close()
   {
+    if (p_pfile) p_pfile->close();
+    p_pfile.reset();
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
       if (p_fout) {
         if (p_fout->is_open()) p_fout->close();
@@ -158,7 +180,9 @@ class SerialBusIO {
    */
   void write(const char *signal = NULL)
   {
-    if (p_fout) {
+    if (p_pfile) {
+      writeParallel(signal);
+    } else if (p_fout) {
       write(*p_fout, signal);
     } else {
       write(std::cout, signal);
@@ -227,6 +251,10 @@ class SerialBusIO {
    */
   void header(const char *str)
   {
+    if (p_pfile) {
+      p_pfile->header(str);
+      return;
+    }
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
       if (p_fout) 
       {
@@ -652,6 +680,31 @@ class SerialBusIO {
     }
   }*/
 
+  /**
+   * Write output from buses to the parallel output file. Each process
+   * writes its own records and no data is moved to process 0
+   * @param signal an optional character string used to control contents of
+   *                output
+   */
+  void writeParallel(const char *signal = NULL)
+  {
+    int nBus = p_network->numBuses();
+    int i;
+    std::vector<int> index;
+    std::vector<char> strbuf(p_size);
+    int ncnt = 0;
+    for (i=0; i<nBus; i++) {
+      if (p_network->getActiveBus(i) &&
+          p_network->getBus(i)->serialWrite(&strbuf[ncnt*p_size],
+            p_size,signal)) {
+        index.push_back(p_network->getGlobalBusIndex(i));
+        ncnt++;
+        strbuf.resize((ncnt+1)*p_size);
+      }
+    }
+    p_pfile->write(index,&strbuf[0],p_size);
+  }
+
   private:
     int p_GA_type;
     boost::shared_ptr<_network> p_network;
@@ -659,6 +712,7 @@ class SerialBusIO {
     int p_maskGA;
     int p_size;
     boost::shared_ptr<std::ofstream> p_fout;
+    boost::shared_ptr<ParallelRecordFile> p_pfile;
     int p_GAgrp;
 #ifdef USE_GOSS
     gridpack::goss::GOSSClient m_client;
@@ -738,18 +792,34 @@ class SerialBranchIO {
   }
 #endif
   /**
-   * Redirect output to a file instead of standard out
+   * Redirect output to a file instead of standard out. This is collective
+   * if a file was previously opened with openParallel
    * @param filename name of file that output goes to
    */
   void open(const char *filename)
   {
+    this->close();
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
-      this->close();
       p_fout.reset(new std::ofstream);
       p_fout->open(filename);
     }
   }
 
+  /**
+   * Redirect output to a binary file that all processes write their own
+   * branch records to, instead of sending all records to process 0. Records
+   * are stored together with the global index of the branch that wrote them.
+   * The text output can be recovered from the file with
+   * ParallelRecordFile::toText. This function is collective
+   * @param filename name of file that output goes to
+   */
+  void openParallel(const char *filename)
+  {
+    this->close();
+    p_pfile.reset(new ParallelRecordFile(
+          static_cast<MPI_Comm>(p_network->communicator()), filename));
+  }
+
   /**
    * return IO stream
    * @return IO stream to file
@@ -769,10 +839,13 @@ class SerialBranchIO {
   }
 
   /**
-   * Close file and redirect output to standard out 
+   * Close file and redirect output to standard out. This is collective
+   * if the file was opened with openParallel
    */
   void close()
   {
+    if (p_pfile) p_pfile->close();
+    p_pfile.reset();
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
       if (p_fout) {
         if (p_fout->is_open()) p_fout->close();
@@ -788,7 +861,9 @@ class SerialBranchIO {
    */
   void write(const char *signal = NULL)
   {
-    if (p_fout) {
+    if (p_pfile) {
+      writeParallel(signal);
+    } else if (p_fout) {
       write(*p_fout, signal);
     } else {
       write(std::cout, signal);
@@ -1169,6 +1244,10 @@ public:
 
   void header(const char *str)
   {
+    if (p_pfile) {
+      p_pfile->header(str);
+      return;
+    }
     if (GA_Pgroup_nodeid(p_GAgrp) == 0) {
       if (p_fout)
       {
@@ -1187,6 +1266,33 @@ public:
 
   }
 
+  protected:
+
+  /**
+   * Write output from branches to the parallel output file. Each process
+   * writes its own records and no data is moved to process 0
+   * @param signal an optional character string used to control contents of
+   *                output
+   */
+  void writeParallel(const char *signal = NULL)
+  {
+    int nBranch = p_network->numBranches();
+    int i;
+    std::vector<int> index;
+    std::vector<char> strbuf(p_size);
+    int ncnt = 0;
+    for (i=0; i<nBranch; i++) {
+      if (p_network->getActiveBranch(i) &&
+          p_network->getBranch(i)->serialWrite(&strbuf[ncnt*p_size],
+            p_size,signal)) {
+        index.push_back(p_network->getGlobalBranchIndex(i));
+        ncnt++;
+        strbuf.resize((ncnt+1)*p_size);
+      }
+    }
+    p_pfile->write(index,&strbuf[0],p_size);
+  }
+
   private:
     int p_GA_type;
     boost::shared_ptr<_network> p_network;
@@ -1194,6 +1300,7 @@ public:
     int p_maskGA;
     int p_size;
     boost::shared_ptr<std::ofstream> p_fout;
+    boost::shared_ptr<ParallelRecordFile> p_pfile;
     int p_GAgrp;
 #ifdef USE_GOSS
     gridpack::goss::GOSSClient m_client;
@@ -6,6 +6,8 @@
 
 #include "mpi.h"
 #include <vector>
+#include <sstream>
+#include <algorithm>
 #include <macdecls.h>
 #include "gridpack/environment/environment.hpp"
 #include "gridpack/utilities/complex.hpp"
@@ -338,6 +340,52 @@ void run (const int &me, const int &nprocs)
       printf("\n    Values of gathered data on branches are ok\n");
     }
   }
+
+  // Test parallel output file. Write buses twice to check that frames are
+  // appended and compare the reconstructed text with the expected listing
+  busIO.openParallel("buses.bin");
+  busIO.header("Frame 1\n");
+  busIO.write();
+  busIO.header("Frame 2\n");
+  busIO.write();
+  busIO.close();
+  if (me == 0) {
+    std::ostringstream text;
+    bool ok = gridpack::serial_io::ParallelRecordFile::toText("buses.bin",text);
+    std::string expected;
+    char sbuf[128];
+    for (j=1; j<=2; j++) {
+      sprintf(sbuf,"Frame %d\n",j);
+      expected.append(sbuf);
+      for (i=0; i<XDIM*YDIM; i++) {
+        sprintf(sbuf,"  Bus: %4d      %4d\n",2*i,i);
+        expected.append(sbuf);
+      }
+    }
+    if (!ok || text.str() != expected) {
+      printf("\n    Text reconstructed from parallel bus file is wrong\n");
+    } else {
+      printf("\n    Text reconstructed from parallel bus file is ok\n");
+    }
+  }
+  // Switch directly to a text file so that open must finish the parallel
+  // file
+  branchIO.openParallel("branches.bin");
+  branchIO.write();
+  branchIO.open("branches.txt");
+  branchIO.close();
+  if (me == 0) {
+    std::ostringstream text;
+    bool ok = gridpack::serial_io::ParallelRecordFile::toText("branches.bin",
+        text);
+    std::string str = text.str();
+    int nlines = std::count(str.begin(), str.end(), '\n');
+    if (!ok || nlines != (XDIM-1)*YDIM+XDIM*(YDIM-1)) {
+      printf("\n    Number of records in parallel branch file is wrong\n");
+    } else {
+      printf("\n    Number of records in parallel branch file is ok\n");
+    }
+  }
 }
 
 int
@@ -5,6 +5,8 @@
  */
 
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
 
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
@@ -18,6 +20,7 @@
 #include "gridpack/parallel/distributed.hpp"
 #include "gridpack/timer/coarse_timer.hpp"
 #include "gridpack/timer/local_timer.hpp"
+#include "gridpack/timer/trace_timer.hpp"
 
 #define LOOPSIZE 1000000
 
@@ -102,6 +105,64 @@ BOOST_AUTO_TEST_CASE( Timings )
 
 }
 
+BOOST_AUTO_TEST_CASE( TraceTimings )
+{
+  gridpack::parallel::Communicator comm;
+  MPI_Comm mpi_world = static_cast<MPI_Comm>(comm);
+  int i, j;
+  double t = 0.0;
+  int me, nprocs;
+  int ierr = MPI_Comm_rank(mpi_world, &me);
+  ierr = MPI_Comm_size(mpi_world, &nprocs);
+
+  gridpack::utility::TraceTimer *trace =
+    gridpack::utility::TraceTimer::instance();
+  BOOST_REQUIRE(trace != NULL);
+  BOOST_CHECK(!trace->enabled());
+
+  // Registering the same name twice returns the same handle
+  int t_outer = trace->registerRegion("TraceTimer: Outer");
+  int t_inner = trace->registerRegion("TraceTimer: Inner");
+  BOOST_CHECK(t_outer != t_inner);
+  BOOST_CHECK_EQUAL(trace->registerRegion("TraceTimer: Outer"), t_outer);
+
+  // Nested regions with more work on higher ranks so that the output shows
+  // some imbalance
+  trace->configTimer(true);
+  trace->configTrace(true);
+  int nloop = LOOPSIZE/10;
+  nloop += static_cast<int>(static_cast<double>(nloop*me)
+        / static_cast<double>(nprocs));
+  for (j=0; j<5; j++) {
+    GRIDPACK_TRACE_SCOPE("TraceTimer: Step");
+    trace->begin(t_outer);
+    trace->begin(t_inner);
+    for (i=1; i<nloop; i++) {
+      t += exp(1.0/static_cast<double>(i));
+    }
+    trace->end(t_inner);
+    trace->end(t_outer);
+  }
+  trace->dump(mpi_world);
+  BOOST_CHECK(trace->writeTrace("trace_test.json", mpi_world));
+
+  // Check that trace file contains an entry for every region call
+  if (me == 0) {
+    FILE *fp = fopen("trace_test.json","r");
+    BOOST_REQUIRE(fp != NULL);
+    char line[1024];
+    int ncalls = 0;
+    while (fgets(line, 1024, fp) != NULL) {
+      if (strstr(line, "\"ph\":\"X\"") != NULL) ncalls++;
+    }
+    fclose(fp);
+    BOOST_CHECK_EQUAL(ncalls, 15*nprocs);
+  }
+  trace->configTrace(false);
+  trace->configTimer(false);
+  trace->reset();
+}
+
 BOOST_AUTO_TEST_SUITE_END( )
 
 bool init_function(void)
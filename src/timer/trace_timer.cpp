@@ -0,0 +1,393 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <set>
+#include <algorithm>
+#include "gridpack/timer/trace_timer.hpp"
+
+// Separator between region names in the path of a node. It sorts before
+// any printable character so that a node is always followed by its children
+#define TRACE_SEPARATOR '\1'
+
+gridpack::utility::TraceTimer
+         *gridpack::utility::TraceTimer::p_instance = NULL;
+
+/**
+ * Retrieve instance of the TraceTimer object
+ */
+gridpack::utility::TraceTimer
+         *gridpack::utility::TraceTimer::instance()
+{
+  if (p_instance == NULL) {
+    p_instance = new TraceTimer();
+  }
+  return p_instance;
+}
+
+/**
+ * Register a region and return a handle to it. Registering the same name
+ * more than once returns the same handle. This should be done once
+ * outside of the code that is being timed.
+ * @param name name used to label region in output
+ * @return handle for region
+ */
+int gridpack::utility::TraceTimer::registerRegion(const std::string &name)
+{
+  std::map<std::string, int>::iterator it = p_name_map.find(name);
+  if (it != p_name_map.end()) return it->second;
+  int idx = p_name.size();
+  p_name_map.insert(std::pair<std::string, int>(name,idx));
+  p_name.push_back(name);
+  return idx;
+}
+
+/**
+ * Turn timing on and off. If timing is off, no data is collected.
+ * @param flag turn timer on (true) or off (false)
+ */
+void gridpack::utility::TraceTimer::configTimer(bool flag)
+{
+  p_enabled = flag;
+}
+
+/**
+ * Turn recording of individual region calls for trace output on and off.
+ * @param flag record calls (true) or not (false)
+ * @param maxEvents maximum number of calls recorded on each processor
+ */
+void gridpack::utility::TraceTimer::configTrace(bool flag, int maxEvents)
+{
+  p_trace = flag;
+  p_maxEvents = maxEvents;
+  p_events.clear();
+  p_dropped = 0;
+  int i;
+  for (i=0; i<p_nodes.size(); i++) p_nodes[i].event = -1;
+  p_origin = MPI_Wtime();
+}
+
+/**
+ * Discard all timing data and recorded calls
+ */
+void gridpack::utility::TraceTimer::reset(void)
+{
+  TraceNode root;
+  root.region = -1;
+  root.parent = -1;
+  root.first = -1;
+  root.next = -1;
+  root.calls = 0;
+  root.event = -1;
+  root.start = 0.0;
+  root.time = 0.0;
+  p_nodes.clear();
+  p_nodes.push_back(root);
+  p_current = 0;
+  p_events.clear();
+  p_dropped = 0;
+  p_errors = 0;
+  p_origin = MPI_Wtime();
+}
+
+/**
+ * Enter region
+ * @param handle region handle
+ */
+void gridpack::utility::TraceTimer::enter(const int handle)
+{
+  // Find node for region among children of the current node
+  int child = p_nodes[p_current].first;
+  while (child >= 0 && p_nodes[child].region != handle) {
+    child = p_nodes[child].next;
+  }
+  if (child < 0) {
+    TraceNode node;
+    node.region = handle;
+    node.parent = p_current;
+    node.first = -1;
+    node.next = p_nodes[p_current].first;
+    node.calls = 0;
+    node.event = -1;
+    node.start = 0.0;
+    node.time = 0.0;
+    child = p_nodes.size();
+    p_nodes.push_back(node);
+    p_nodes[p_current].first = child;
+  }
+  TraceNode &node = p_nodes[child];
+  node.calls++;
+  node.start = MPI_Wtime();
+  node.event = -1;
+  if (p_trace) {
+    if (static_cast<int>(p_events.size()) < p_maxEvents) {
+      TraceEvent event;
+      event.node = child;
+      event.start = node.start - p_origin;
+      event.duration = -1.0;
+      node.event = p_events.size();
+      p_events.push_back(event);
+    } else {
+      p_dropped++;
+    }
+  }
+  p_current = child;
+}
+
+/**
+ * Exit region
+ * @param handle region handle
+ */
+void gridpack::utility::TraceTimer::exit(const int handle)
+{
+  if (p_current == 0 || p_nodes[p_current].region != handle) {
+    // Region is not the active region. Ignore it and report it in the
+    // statistics
+    p_errors++;
+    return;
+  }
+  TraceNode &node = p_nodes[p_current];
+  double elapsed = MPI_Wtime() - node.start;
+  node.time += elapsed;
+  if (node.event >= 0) p_events[node.event].duration = elapsed;
+  p_current = node.parent;
+}
+
+/**
+ * Create a list of the paths of all nodes in the tree of region calls
+ * over all processors
+ * @param comm communicator
+ * @param paths list of paths on all processors
+ * @param index location of each local node in the list of paths
+ */
+void gridpack::utility::TraceTimer::globalPaths(MPI_Comm comm,
+    std::vector<std::string> &paths, std::vector<int> &index) const
+{
+  int nproc, i;
+  MPI_Comm_size(comm, &nproc);
+
+  // Nodes are always created after their parent so the path of the parent
+  // is available when the path of a node is constructed
+  int nnodes = p_nodes.size();
+  std::vector<std::string> local(nnodes);
+  std::vector<char> sbuf;
+  for (i=1; i<nnodes; i++) {
+    int parent = p_nodes[i].parent;
+    if (parent > 0) {
+      local[i] = local[parent];
+      local[i].push_back(TRACE_SEPARATOR);
+    }
+    local[i].append(p_name[p_nodes[i].region]);
+    sbuf.insert(sbuf.end(), local[i].begin(), local[i].end());
+    sbuf.push_back('\0');
+  }
+
+  // Gather paths from all processors
+  int ssize = sbuf.size();
+  std::vector<int> sizes(nproc), offsets(nproc);
+  MPI_Allgather(&ssize, 1, MPI_INT, &sizes[0], 1, MPI_INT, comm);
+  int rsize = 0;
+  for (i=0; i<nproc; i++) {
+    offsets[i] = rsize;
+    rsize += sizes[i];
+  }
+  std::vector<char> rbuf(rsize+1);
+  char dummy = 0;
+  MPI_Allgatherv(ssize > 0 ? &sbuf[0] : &dummy, ssize, MPI_CHAR, &rbuf[0],
+      &sizes[0], &offsets[0], MPI_CHAR, comm);
+
+  std::set<std::string> all;
+  int pos = 0;
+  while (pos < rsize) {
+    std::string path(&rbuf[pos]);
+    pos += path.length() + 1;
+    all.insert(path);
+  }
+  paths.assign(all.begin(), all.end());
+  index.resize(nnodes);
+  index[0] = -1;
+  for (i=1; i<nnodes; i++) {
+    index[i] = std::lower_bound(paths.begin(), paths.end(), local[i])
+      - paths.begin();
+  }
+}
+
+/**
+ * Write statistics for the tree of regions to standard out
+ * @param comm communicator of processors that are included in statistics
+ */
+void gridpack::utility::TraceTimer::dump(MPI_Comm comm) const
+{
+  int me, nproc, i;
+  MPI_Comm_rank(comm, &me);
+  MPI_Comm_size(comm, &nproc);
+
+  std::vector<std::string> paths;
+  std::vector<int> index;
+  globalPaths(comm, paths, index);
+  int npaths = paths.size();
+  if (npaths == 0) return;
+
+  // Regions that were not called on a processor count as zero time on that
+  // processor
+  std::vector<double> stime(npaths,0.0), tmin(npaths), tmax(npaths);
+  std::vector<double> tsum(npaths);
+  std::vector<int> scalls(npaths,0), calls(npaths);
+  for (i=1; i<p_nodes.size(); i++) {
+    stime[index[i]] = p_nodes[i].time;
+    scalls[index[i]] = p_nodes[i].calls;
+  }
+  MPI_Reduce(&stime[0], &tmin[0], npaths, MPI_DOUBLE, MPI_MIN, 0, comm);
+  MPI_Reduce(&stime[0], &tmax[0], npaths, MPI_DOUBLE, MPI_MAX, 0, comm);
+  MPI_Reduce(&stime[0], &tsum[0], npaths, MPI_DOUBLE, MPI_SUM, 0, comm);
+  MPI_Reduce(&scalls[0], &calls[0], npaths, MPI_INT, MPI_SUM, 0, comm);
+  int serr[2], rerr[2];
+  serr[0] = p_errors;
+  serr[1] = p_dropped;
+  MPI_Reduce(serr, rerr, 2, MPI_INT, MPI_SUM, 0, comm);
+
+  if (me == 0) {
+    printf("Timing statistics for regions\n");
+    printf("%-50s %10s %12s %12s %12s %9s\n","Region","Calls","Average",
+        "Minimum","Maximum","Imbalance");
+    for (i=0; i<npaths; i++) {
+      // Indent region by its depth in tree
+      size_t last = paths[i].rfind(TRACE_SEPARATOR);
+      int depth = std::count(paths[i].begin(), paths[i].end(),
+          TRACE_SEPARATOR);
+      std::string label(2*depth, ' ');
+      if (last == std::string::npos) {
+        label.append(paths[i]);
+      } else {
+        label.append(paths[i].substr(last+1));
+      }
+      double avg = tsum[i]/static_cast<double>(nproc);
+      double imbalance = 1.0;
+      if (avg > 0.0) imbalance = tmax[i]/avg;
+      printf("%-50s %10d %12.4f %12.4f %12.4f %9.3f\n",label.c_str(),
+          calls[i],avg,tmin[i],tmax[i],imbalance);
+    }
+    if (rerr[0] > 0) {
+      printf("Invalid time statistics. %d regions exited out of order\n",
+          rerr[0]);
+    }
+    if (rerr[1] > 0) {
+      printf("%d region calls were not recorded for trace output\n",rerr[1]);
+    }
+  }
+}
+
+/**
+ * Write recorded region calls from all processors to a file in Chrome
+ * trace event (JSON) format
+ * @param filename name of trace file
+ * @param comm communicator of processors that are included in trace
+ * @return false if file could not be written
+ */
+bool gridpack::utility::TraceTimer::writeTrace(const char *filename,
+    MPI_Comm comm) const
+{
+  int me, nproc, i, j;
+  MPI_Comm_rank(comm, &me);
+  MPI_Comm_size(comm, &nproc);
+
+  std::vector<std::string> paths;
+  std::vector<int> index;
+  globalPaths(comm, paths, index);
+
+  // Pack completed calls as (path, start, duration)
+  std::vector<double> sbuf;
+  for (i=0; i<p_events.size(); i++) {
+    if (p_events[i].duration < 0.0) continue;
+    sbuf.push_back(static_cast<double>(index[p_events[i].node]));
+    sbuf.push_back(p_events[i].start);
+    sbuf.push_back(p_events[i].duration);
+  }
+  int ssize = sbuf.size();
+  std::vector<int> sizes(nproc), offsets(nproc);
+  MPI_Gather(&ssize, 1, MPI_INT, &sizes[0], 1, MPI_INT, 0, comm);
+  int rsize = 0;
+  for (i=0; i<nproc; i++) {
+    offsets[i] = rsize;
+    rsize += sizes[i];
+  }
+  std::vector<double> rbuf(rsize+1);
+  double dummy = 0.0;
+  MPI_Gatherv(ssize > 0 ? &sbuf[0] : &dummy, ssize, MPI_DOUBLE, &rbuf[0],
+      &sizes[0], &offsets[0], MPI_DOUBLE, 0, comm);
+
+  int ok = 1;
+  if (me == 0) {
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) {
+      ok = 0;
+    } else {
+      // Region names and paths as JSON strings
+      std::vector<std::string> names(paths.size()), full(paths.size());
+      for (i=0; i<paths.size(); i++) {
+        std::string escaped;
+        for (j=0; j<paths[i].length(); j++) {
+          char c = paths[i][j];
+          if (c == TRACE_SEPARATOR) {
+            escaped.append(" / ");
+            names[i].clear();
+            continue;
+          }
+          if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+            names[i].push_back('\\');
+          }
+          escaped.push_back(c);
+          names[i].push_back(c);
+        }
+        full[i] = escaped;
+      }
+      fprintf(fp,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+      for (i=0; i<nproc; i++) {
+        fprintf(fp,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"args\":{\"name\":\"process %d\"}}",i>0?",\n":"",i,i);
+      }
+      for (i=0; i<nproc; i++) {
+        for (j=offsets[i]; j<offsets[i]+sizes[i]; j+=3) {
+          int path = static_cast<int>(rbuf[j]);
+          fprintf(fp,",\n{\"name\":\"%s\",\"cat\":\"gridpack\",\"ph\":\"X\","
+              "\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,"
+              "\"args\":{\"path\":\"%s\"}}",names[path].c_str(),i,
+              1.0e6*rbuf[j+1],1.0e6*rbuf[j+2],full[path].c_str());
+        }
+      }
+      fprintf(fp,"\n]}\n");
+      if (fclose(fp) != 0) ok = 0;
+    }
+  }
+  MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+  return (ok == 1);
+}
+
+/**
+ * Constructor
+ */
+gridpack::utility::TraceTimer::TraceTimer()
+{
+  p_name_map.clear();
+  p_name.clear();
+  p_maxEvents = 0;
+  p_enabled = false;
+  p_trace = false;
+  reset();
+}
+
+/**
+ * Destructor
+ */
+gridpack::utility::TraceTimer::~TraceTimer()
+{
+  p_name_map.clear();
+  p_name.clear();
+  p_nodes.clear();
+  p_events.clear();
+}
@@ -0,0 +1,231 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+#ifndef _trace_timer_h
+#define _trace_timer_h
+
+#include <map>
+#include <string>
+#include <vector>
+#include "mpi.h"
+
+// Hierarchical timer. Regions are registered once and then referred to by
+// an integer handle. Regions that are entered while another region is
+// active are accumulated as children of that region, so the same region
+// called from different places shows up separately in the output. Timing
+// statistics are reduced over all processors and individual region calls
+// can be exported as a trace file in the Chrome trace event format
+// (chrome://tracing, Perfetto).
+//
+// Timing is off by default and begin/end reduce to a single test of a flag
+// until it is turned on with configTimer. Defining GRIDPACK_NO_TRACE
+// removes regions created with GRIDPACK_TRACE_SCOPE at compile time.
+
+namespace gridpack{
+namespace utility{
+
+class TraceTimer {
+public:
+
+  /**
+   * Retrieve instance of the TraceTimer object
+   */
+  static TraceTimer *instance();
+
+  /**
+   * Register a region and return a handle to it. Registering the same name
+   * more than once returns the same handle. This should be done once
+   * outside of the code that is being timed.
+   * @param name name used to label region in output
+   * @return handle for region
+   */
+  int registerRegion(const std::string &name);
+
+  /**
+   * Enter a region. Regions must be exited in the reverse order in which
+   * they were entered
+   * @param handle region handle
+   */
+  void begin(const int handle)
+  {
+    if (p_enabled) enter(handle);
+  }
+
+  /**
+   * Exit a region
+   * @param handle region handle
+   */
+  void end(const int handle)
+  {
+    if (p_enabled) exit(handle);
+  }
+
+  /**
+   * Turn timing on and off. If timing is off, no data is collected.
+   * @param flag turn timer on (true) or off (false)
+   */
+  void configTimer(bool flag);
+
+  /**
+   * Turn recording of individual region calls for trace output on and off.
+   * Recording starts a new trace so this should be called on all processors
+   * at roughly the same time
+   * @param flag record calls (true) or not (false)
+   * @param maxEvents maximum number of calls recorded on each processor.
+   *        Calls after this are still timed but do not appear in the trace
+   */
+  void configTrace(bool flag, int maxEvents = 1000000);
+
+  /**
+   * @return true if timing is on
+   */
+  bool enabled(void) const
+  {
+    return p_enabled;
+  }
+
+  /**
+   * Discard all timing data and recorded calls. Registered handles remain
+   * valid. This should not be called while any region is active
+   */
+  void reset(void);
+
+  /**
+   * Write statistics for the tree of regions to standard out. For each
+   * region the number of calls and the average, minimum and maximum time
+   * over processors is listed along with the load imbalance (maximum
+   * divided by average time). This function is collective on the
+   * communicator
+   * @param comm communicator of processors that are included in statistics
+   */
+  void dump(MPI_Comm comm = MPI_COMM_WORLD) const;
+
+  /**
+   * Write recorded region calls from all processors to a file in Chrome
+   * trace event (JSON) format. Each processor is listed as a separate
+   * process. This function is collective on the communicator
+   * @param filename name of trace file
+   * @param comm communicator of processors that are included in trace
+   * @return false if file could not be written
+   */
+  bool writeTrace(const char *filename, MPI_Comm comm = MPI_COMM_WORLD) const;
+
+protected:
+  /**
+   * Constructor
+   */
+  TraceTimer();
+
+  /**
+   * Destructor
+   */
+  ~TraceTimer();
+
+private:
+
+  // Node in tree of region calls. Children of a node are stored as a linked
+  // list using first and next
+  struct TraceNode {
+    int region;
+    int parent;
+    int first;
+    int next;
+    int calls;
+    int event;
+    double start;
+    double time;
+  };
+
+  // Single recorded region call
+  struct TraceEvent {
+    int node;
+    double start;
+    double duration;
+  };
+
+  /**
+   * Enter region
+   * @param handle region handle
+   */
+  void enter(const int handle);
+
+  /**
+   * Exit region
+   * @param handle region handle
+   */
+  void exit(const int handle);
+
+  /**
+   * Create a list of the paths of all nodes in the tree of region calls
+   * over all processors. Paths are sorted so that each node is followed by
+   * its children
+   * @param comm communicator
+   * @param paths list of paths on all processors
+   * @param index location of each local node in the list of paths
+   */
+  void globalPaths(MPI_Comm comm, std::vector<std::string> &paths,
+      std::vector<int> &index) const;
+
+  std::map<std::string, int> p_name_map;
+  std::vector<std::string> p_name;
+  std::vector<TraceNode> p_nodes;
+  std::vector<TraceEvent> p_events;
+  int p_current;
+  int p_maxEvents;
+  int p_dropped;
+  int p_errors;
+  bool p_enabled;
+  bool p_trace;
+  double p_origin;
+
+  static TraceTimer *p_instance;
+};
+
+/**
+ * Region that is entered when the object is created and exited when it goes
+ * out of scope
+ */
+class TraceScope {
+public:
+  /**
+   * Enter region
+   * @param handle region handle
+   */
+  explicit TraceScope(const int handle)
+    : p_handle(handle)
+  {
+    TraceTimer::instance()->begin(p_handle);
+  }
+
+  /**
+   * Exit region
+   */
+  ~TraceScope()
+  {
+    TraceTimer::instance()->end(p_handle);
+  }
+
+private:
+  int p_handle;
+};
+
+}    // utility
+}    // gridpack
+
+// Time the remainder of the enclosing block as a region with the given name.
+// The region is registered the first time the block is executed.
+#ifndef GRIDPACK_NO_TRACE
+#define GRIDPACK_TRACE_CONCAT2(a, b) a ## b
+#define GRIDPACK_TRACE_CONCAT(a, b) GRIDPACK_TRACE_CONCAT2(a, b)
+#define GRIDPACK_TRACE_SCOPE(name)                                        \
+  static const int GRIDPACK_TRACE_CONCAT(gp_trace_handle_, __LINE__) =    \
+    gridpack::utility::TraceTimer::instance()->registerRegion(name);      \
+  gridpack::utility::TraceScope GRIDPACK_TRACE_CONCAT(gp_trace_scope_,    \
+      __LINE__)(GRIDPACK_TRACE_CONCAT(gp_trace_handle_, __LINE__))
+#else
+#define GRIDPACK_TRACE_SCOPE(name)
+#endif
+
+#endif // _trace_timer_h